@@ -187,6 +187,9 @@ class MainActivity : ComponentActivity() {
                                 Log.d("Max HDR value", "$maxNits whitePoint $whitePoint")
                             }
 
+//                            ProgressiveBenchmark.run(this@MainActivity)
+//                            YuvBenchmark.run(this@MainActivity)
+
                             var assets =
                                 (this@MainActivity.assets.list("") ?: return@launch).toList()
 //                            assets = assets.filter { it.contains("20181110_213419__MMC1561-HDR.jxl") }
@@ -0,0 +1,86 @@
+package com.awxkee.jxlcoder
+
+import android.content.Context
+import android.util.Log
+import okio.buffer
+import okio.source
+
+/**
+ * Compares the default and the progressive encoding profile on the bundled assets:
+ * bytes needed for the first DC render, bytes needed for a render scoring [qualityScore]
+ * and the size overhead of the progressive layout
+ */
+object ProgressiveBenchmark {
+
+    private const val TAG = "ProgressiveBenchmark"
+
+    fun run(context: Context, quality: Int = 90, qualityScore: Float = 90f) {
+        var defaultTotal = 0L
+        var progressiveTotal = 0L
+        var defaultDcTotal = 0L
+        var progressiveDcTotal = 0L
+        var defaultQualityTotal = 0L
+        var progressiveQualityTotal = 0L
+
+        val assets = context.assets.list("")?.filter { it.endsWith(".jxl") } ?: return
+        for (asset in assets) {
+            try {
+                val source = context.assets.open(asset).source().buffer().readByteArray()
+                val bitmap = JxlCoder.decode(source)
+                val channels = if (bitmap.hasAlpha()) {
+                    JxlChannelsConfiguration.RGBA
+                } else {
+                    JxlChannelsConfiguration.RGB
+                }
+                val reports = JxlEncodingProfile.entries.associateWith { profile ->
+                    val encoded = JxlCoder.encode(
+                        bitmap,
+                        channelsConfiguration = channels,
+                        quality = quality,
+                        profile = profile,
+                    )
+                    JxlMetrics.measureProgression(encoded, qualityScore)
+                }
+                bitmap.recycle()
+
+                val default = reports.getValue(JxlEncodingProfile.DEFAULT)
+                val progressive = reports.getValue(JxlEncodingProfile.PROGRESSIVE)
+                defaultTotal += default.totalBytes
+                progressiveTotal += progressive.totalBytes
+                defaultDcTotal += default.dcBytes
+                progressiveDcTotal += progressive.dcBytes
+                defaultQualityTotal += default.qualityBytes
+                progressiveQualityTotal += progressive.qualityBytes
+
+                Log.d(
+                    TAG,
+                    "$asset: size ${default.totalBytes} -> ${progressive.totalBytes} " +
+                            "(${percent(progressive.totalBytes, default.totalBytes)}), " +
+                            "DC ${default.dcBytes} -> ${progressive.dcBytes}, " +
+                            "score $qualityScore ${default.qualityBytes} -> ${progressive.qualityBytes}, " +
+                            "steps ${default.progressionSteps} -> ${progressive.progressionSteps}"
+                )
+            } catch (e: Exception) {
+                Log.e(TAG, "$asset failed", e)
+            }
+        }
+
+        Log.d(
+            TAG,
+            "Corpus: size overhead ${percent(progressiveTotal, defaultTotal)}, " +
+                    "DC at ${share(defaultDcTotal, defaultTotal)} -> ${share(progressiveDcTotal, progressiveTotal)} " +
+                    "of the stream, score $qualityScore at ${share(defaultQualityTotal, defaultTotal)} -> " +
+                    "${share(progressiveQualityTotal, progressiveTotal)} of the stream"
+        )
+    }
+
+    private fun percent(value: Long, base: Long): String {
+        if (base == 0L) return "n/a"
+        return "%+.1f%%".format((value - base) * 100.0 / base)
+    }
+
+    private fun share(value: Long, total: Long): String {
+        if (total == 0L) return "n/a"
+        return "%.1f%%".format(value * 100.0 / total)
+    }
+}
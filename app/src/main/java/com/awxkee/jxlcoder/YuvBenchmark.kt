@@ -0,0 +1,115 @@
+package com.awxkee.jxlcoder
+
+import android.content.Context
+import android.graphics.Bitmap
+import android.os.SystemClock
+import android.util.Log
+import okio.buffer
+import okio.source
+import java.nio.ByteBuffer
+import kotlin.math.roundToInt
+
+/**
+ * Compares encoding of NV21 camera frames through an RGBA bitmap converted on the java side
+ * with encoding straight from the YUV planes, frames are made from the bundled assets
+ */
+object YuvBenchmark {
+
+    private const val TAG = "YuvBenchmark"
+
+    fun run(context: Context, quality: Int = 90, iterations: Int = 3) {
+        var bitmapNanos = 0L
+        var planesNanos = 0L
+        var pixels = 0L
+
+        val assets = context.assets.list("")?.filter { it.endsWith(".jxl") } ?: return
+        for (asset in assets) {
+            try {
+                val source = context.assets.open(asset).source().buffer().readByteArray()
+                val bitmap = JxlCoder.decode(source)
+                val width = bitmap.width and 1.inv()
+                val height = bitmap.height and 1.inv()
+                val nv21 = toNv21(bitmap, width, height)
+                bitmap.recycle()
+
+                var assetBitmapNanos = 0L
+                var assetPlanesNanos = 0L
+                repeat(iterations) {
+                    var start = SystemClock.elapsedRealtimeNanos()
+                    val rgba = nv21ToBitmap(nv21, width, height)
+                    JxlCoder.encode(rgba, quality = quality)
+                    rgba.recycle()
+                    assetBitmapNanos += SystemClock.elapsedRealtimeNanos() - start
+
+                    start = SystemClock.elapsedRealtimeNanos()
+                    JxlCoder.encode(JxlYuvSource.fromNv21(nv21, width, height), quality = quality)
+                    assetPlanesNanos += SystemClock.elapsedRealtimeNanos() - start
+                }
+                bitmapNanos += assetBitmapNanos
+                planesNanos += assetPlanesNanos
+                pixels += width.toLong() * height * iterations
+
+                Log.d(
+                    TAG,
+                    "$asset ${width}x$height: bitmap ${assetBitmapNanos / iterations / 1_000_000} ms, " +
+                            "planes ${assetPlanesNanos / iterations / 1_000_000} ms"
+                )
+            } catch (e: Exception) {
+                Log.e(TAG, "$asset failed", e)
+            }
+        }
+
+        Log.d(
+            TAG,
+            "Corpus: bitmap ${megapixelsPerSecond(pixels, bitmapNanos)} MP/s, " +
+                    "planes ${megapixelsPerSecond(pixels, planesNanos)} MP/s"
+        )
+    }
+
+    private fun megapixelsPerSecond(pixels: Long, nanos: Long): String {
+        if (nanos == 0L) return "n/a"
+        return "%.2f".format(pixels * 1000.0 / nanos)
+    }
+
+    private fun toNv21(bitmap: Bitmap, width: Int, height: Int): ByteBuffer {
+        val argb = IntArray(width * height)
+        bitmap.getPixels(argb, 0, width, 0, 0, width, height)
+        val frame = ByteBuffer.allocateDirect(width * height * 3 / 2)
+        for (i in argb.indices) {
+            val c = argb[i]
+            val y = 0.299f * (c shr 16 and 0xFF) + 0.587f * (c shr 8 and 0xFF) + 0.114f * (c and 0xFF)
+            frame.put(i, y.roundToInt().coerceIn(0, 255).toByte())
+        }
+        for (y in 0 until height step 2) {
+            for (x in 0 until width step 2) {
+                val c = argb[y * width + x]
+                val r = c shr 16 and 0xFF
+                val g = c shr 8 and 0xFF
+                val b = c and 0xFF
+                val u = 128f - 0.168736f * r - 0.331264f * g + 0.5f * b
+                val v = 128f + 0.5f * r - 0.418688f * g - 0.081312f * b
+                val offset = width * height + y / 2 * width + x
+                frame.put(offset, v.roundToInt().coerceIn(0, 255).toByte())
+                frame.put(offset + 1, u.roundToInt().coerceIn(0, 255).toByte())
+            }
+        }
+        return frame
+    }
+
+    private fun nv21ToBitmap(frame: ByteBuffer, width: Int, height: Int): Bitmap {
+        val argb = IntArray(width * height)
+        for (y in 0 until height) {
+            for (x in 0 until width) {
+                val luma = frame.get(y * width + x).toInt() and 0xFF
+                val offset = width * height + y / 2 * width + (x and 1.inv())
+                val cr = (frame.get(offset).toInt() and 0xFF) - 128
+                val cb = (frame.get(offset + 1).toInt() and 0xFF) - 128
+                val r = (luma + 1.402f * cr).roundToInt().coerceIn(0, 255)
+                val g = (luma - 0.344136f * cb - 0.714136f * cr).roundToInt().coerceIn(0, 255)
+                val b = (luma + 1.772f * cb).roundToInt().coerceIn(0, 255)
+                argb[y * width + x] = (0xFF shl 24) or (r shl 16) or (g shl 8) or b
+            }
+        }
+        return Bitmap.createBitmap(argb, width, height, Bitmap.Config.ARGB_8888)
+    }
+}
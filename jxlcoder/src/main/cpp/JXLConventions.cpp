@@ -32,8 +32,10 @@
 #include <string>
 #include <vector>
 #include "JniExceptions.h"
+#include "JniOutputTarget.h"
 #include "EasyGifReader.h"
 #include "interop/JxlAnimatedEncoder.hpp"
+#include "interop/JxlResourceGovernor.hpp"
 #include "pnglibconf.h"
 #include "png.h"
 #include <memory>
@@ -100,6 +102,7 @@ extern "C"
 JNIEXPORT jbyteArray JNICALL
 Java_com_awxkee_jxlcoder_JxlCoder_gif2JXLImpl(JNIEnv *env, jobject thiz, jbyteArray gifData,
                                               jint quality, jint effort, jint decodingSpeed) {
+  coder::JxlResourceGovernor governor;
   try {
     if (effort < 0 || effort > 10) {
       throwInvalidCompressionOptionException(env);
@@ -131,12 +134,16 @@ Java_com_awxkee_jxlcoder_JxlCoder_gif2JXLImpl(JNIEnv *env, jobject thiz, jbyteAr
     const int height = gifReader.height();
     const int repeatCount = gifReader.repeatCount();
 
+    governor.checkImageSize(width, height);
+    governor.checkFrameCount(frameCount);
+
     JxlAnimatedEncoder encoder(width, height, rgba,
                                UNSIGNED_8,
                                lossy,
                                repeatCount,
                                quality,
-                               effort, decodingSpeed);
+                               effort, decodingSpeed,
+                               PROFILE_DEFAULT);
 
     const size_t frameSize = width * height * sizeof(uint8_t) * 4;
     std::vector<uint8_t> mPixelStore(frameSize);
@@ -145,28 +152,35 @@ Java_com_awxkee_jxlcoder_JxlCoder_gif2JXLImpl(JNIEnv *env, jobject thiz, jbyteAr
       const std::uint32_t *framePixels = frame.pixels();
       int frameDuration = frame.duration().milliseconds();
       const auto *mSource = reinterpret_cast<const uint8_t *>(framePixels);
+      governor.onFrame(frameSize);
       std::copy(mSource, mSource + frameSize, mPixelStore.begin());
       encoder.addFrame(mPixelStore, frameDuration);
     }
 
     mPixelStore.resize(0);
 
-    std::vector<uint8_t> buffer;
-    encoder.encode(buffer);
-    jbyteArray byteArray = env->NewByteArray((jsize) buffer.size());
-    char *memBuf = reinterpret_cast<char *>(buffer.data());
-    env->SetByteArrayRegion(byteArray, 0, (jint) buffer.size(),
-                            reinterpret_cast<const jbyte *>(memBuf));
-    buffer.clear();
-    return byteArray;
+    return NewByteArrayFromSink(env, encoder.encode());
   } catch (std::bad_alloc &err) {
     std::string errorString = "Not enough memory to encode this image";
     throwException(env, errorString);
     return nullptr;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return nullptr;
   } catch (EasyGifReader::Error gifError) {
     std::string errorString = getGifError(gifError);
     throwException(env, errorString);
     return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    // Time limit is delivered through the cancellation token, report it as the limit it is
+    try {
+      governor.checkTime();
+    } catch (coder::JxlResourceLimitException &limitErr) {
+      throwResourceLimitException(env, limitErr.what());
+      return nullptr;
+    }
+    throwCancellationException(env, err.what());
+    return nullptr;
   }
 }
 
@@ -205,6 +219,7 @@ Java_com_awxkee_jxlcoder_JxlCoder_apng2JXLImpl(JNIEnv *env,
                                                jint quality,
                                                jint effort,
                                                jint decodingSpeed) {
+  coder::JxlResourceGovernor governor;
   try {
     if (effort < 0 || effort > 10) {
       throwInvalidCompressionOptionException(env);
@@ -286,17 +301,20 @@ Java_com_awxkee_jxlcoder_JxlCoder_apng2JXLImpl(JNIEnv *env,
       }
     }
 
-    const size_t frameSize = rowbytes * height;
-    std::vector<uint8_t> mFrame(frameSize);
-    std::vector<uint8_t> mImage(frameSize);
-    std::vector<uint8_t> mTempImage(frameSize);
-
     png_uint_32 frames = 1;
     png_uint_32 repeatCount = 0;
 
     if (png_get_valid(pngPtr.get(), infoPtr, PNG_INFO_acTL))
       png_get_acTL(pngPtr.get(), infoPtr, &frames, &repeatCount);
 
+    governor.checkImageSize(width, height);
+    governor.checkFrameCount(frames);
+
+    const size_t frameSize = rowbytes * height;
+    std::vector<uint8_t> mFrame(frameSize);
+    std::vector<uint8_t> mImage(frameSize);
+    std::vector<uint8_t> mTempImage(frameSize);
+
     JxlColorPixelType colorPixelType = channels > 3 ? rgba : rgb;
 
     JxlAnimatedEncoder encoder(width, height, colorPixelType,
@@ -304,7 +322,8 @@ Java_com_awxkee_jxlcoder_JxlCoder_apng2JXLImpl(JNIEnv *env,
                                lossy,
                                repeatCount,
                                quality,
-                               effort, decodingSpeed);
+                               effort, decodingSpeed,
+                               PROFILE_DEFAULT);
 
     if (!iccProfile.empty()) {
       encoder.setICCProfile(iccProfile);
@@ -340,6 +359,7 @@ Java_com_awxkee_jxlcoder_JxlCoder_apng2JXLImpl(JNIEnv *env,
             dop = PNG_DISPOSE_OP_BACKGROUND;
         }
       }
+      governor.onFrame(frameSize);
       png_read_image(pngPtr.get(), rowsFrame.data());
 
       if (dop == PNG_DISPOSE_OP_PREVIOUS)
@@ -369,20 +389,27 @@ Java_com_awxkee_jxlcoder_JxlCoder_apng2JXLImpl(JNIEnv *env,
     mFrame.resize(0);
     mImage.resize(0);
 
-    std::vector<uint8_t> buffer;
-    encoder.encode(buffer);
-    jbyteArray byteArray = env->NewByteArray((jsize) buffer.size());
-    char *memBuf = reinterpret_cast<char *>(buffer.data());
-    env->SetByteArrayRegion(byteArray, 0, (jint) buffer.size(), reinterpret_cast<const jbyte *>(memBuf));
-    buffer.clear();
-    return byteArray;
+    return NewByteArrayFromSink(env, encoder.encode());
   } catch (std::bad_alloc &err) {
     std::string errorString = "Not enough memory to encode this image";
     throwException(env, errorString);
     return nullptr;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return nullptr;
   } catch (AnimatedEncoderError &err) {
     std::string errorString = err.what();
     throwException(env, errorString);
     return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    // Time limit is delivered through the cancellation token, report it as the limit it is
+    try {
+      governor.checkTime();
+    } catch (coder::JxlResourceLimitException &limitErr) {
+      throwResourceLimitException(env, limitErr.what());
+      return nullptr;
+    }
+    throwCancellationException(env, err.what());
+    return nullptr;
   }
 }
\ No newline at end of file
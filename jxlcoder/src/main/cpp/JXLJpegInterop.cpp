@@ -32,6 +32,7 @@
 #include <vector>
 #include <exception>
 #include "JniExceptions.h"
+#include "JniOutputTarget.h"
 #include "interop/JxlConstruction.hpp"
 #include "interop/JxlReconstruction.hpp"
 
@@ -53,11 +54,7 @@ Java_com_awxkee_jxlcoder_JxlCoder_constructImpl(JNIEnv *env, jobject thiz, jbyte
       throwException(env, errorString);
       return nullptr;
     }
-    std::vector<uint8_t> constructedJpegXL = construction.getCompressedData();
-    jbyteArray byteArray = env->NewByteArray(static_cast<jint>(constructedJpegXL.size()));
-    env->SetByteArrayRegion(byteArray, 0, static_cast<jint>(constructedJpegXL.size()),
-                            reinterpret_cast<const jbyte *>(constructedJpegXL.data()));
-    return byteArray;
+    return NewByteArrayFromSink(env, construction.getCompressedData());
   } catch (std::bad_alloc &err) {
     std::string errorString = "Not enough memory to construct this image";
     throwException(env, errorString);
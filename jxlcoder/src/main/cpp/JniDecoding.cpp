@@ -40,22 +40,19 @@
 #include "colorspaces/ColorSpaceProfile.h"
 #include "hwy/highway.h"
 #include "imagebit/CopyUnalignedRGBA.h"
+#include "imagebit/RgbaAdapt.h"
+#include "imagebit/RgbaToTensor.h"
+#include "imagebit/RgbaToYuv.h"
+#include "imagebit/RGBAlpha.h"
+#include "JxlCancellation.h"
+#include "JniDecoding.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlResourceGovernor.hpp"
 
-jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jint scaledWidth,
-                               jint scaledHeight,
-                               jint javaPreferredColorConfig,
-                               jint javaScaleMode, jint javaResizeFilter, jint javaToneMapper) {
-  ScaleMode scaleMode;
-  PreferredColorConfig preferredColorConfig;
-  XSampler sampler;
-  CurveToneMapper toneMapper;
-  if (!checkDecodePreconditions(env, javaPreferredColorConfig, &preferredColorConfig,
-                                javaScaleMode, &scaleMode, javaResizeFilter, &sampler,
-                                javaToneMapper, &toneMapper)) {
-    return nullptr;
-  }
-
-  std::vector<uint8_t> rgbaPixels;
+static bool DecodeGovernedPixels(std::vector<uint8_t> &imageData, int scaledWidth, int scaledHeight,
+                                 ScaleMode scaleMode, XSampler sampler, CurveToneMapper toneMapper,
+                                 uint32_t maxThreads, JxlDecodedImage *image) {
+  pooled_uint8_vector rgbaPixels;
   std::vector<uint8_t> iccProfile;
   size_t xsize = 0, ysize = 0;
   bool useBitmapFloats = false;
@@ -67,30 +64,16 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
   bool preferEncoding = false;
   bool hasAlphaInOrigin = true;
   float intensityTarget = 255.f;
-  try {
-    if (!DecodeJpegXlOneShot(reinterpret_cast<uint8_t *>(imageData.data()), imageData.size(),
-                             &rgbaPixels,
-                             &xsize, &ysize,
-                             &iccProfile, &useBitmapFloats, &bitDepth, &alphaPremultiplied,
-                             osVersion >= 26,
-                             &jxlOrientation,
-                             &preferEncoding, &colorEncoding,
-                             &hasAlphaInOrigin, &intensityTarget)) {
-      throwInvalidJXLException(env);
-      return nullptr;
-    }
-  } catch (std::bad_alloc &err) {
-    std::string errorString = "Not enough memory to decode this image";
-    throwException(env, errorString);
-    return nullptr;
-  } catch (std::runtime_error &err) {
-    std::string m1 = err.what();
-    std::string errorString = "Error: " + m1;
-    throwException(env, errorString);
-    return nullptr;
-  } catch (InvalidImageSizeException &err) {
-    throwImageSizeException(env, err.what());
-    return nullptr;
+  if (!DecodeJpegXlOneShot(reinterpret_cast<uint8_t *>(imageData.data()), imageData.size(),
+                           &rgbaPixels,
+                           &xsize, &ysize,
+                           &iccProfile, &useBitmapFloats, &bitDepth, &alphaPremultiplied,
+                           osVersion >= 26,
+                           &jxlOrientation,
+                           &preferEncoding, &colorEncoding,
+                           &hasAlphaInOrigin, &intensityTarget,
+                           maxThreads)) {
+    return false;
   }
 
   if (jxlOrientation == JXL_ORIENT_ROTATE_90_CW || jxlOrientation == JXL_ORIENT_ROTATE_90_CCW ||
@@ -123,7 +106,7 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
       * static_cast<uint32_t >(useBitmapFloats ? sizeof(uint16_t) : sizeof(uint8_t));
 
   if (useSampler) {
-    auto scaleResult = RescaleImage(rgbaPixels, env, &stride, useBitmapFloats,
+    auto scaleResult = RescaleImage(rgbaPixels, nullptr, &stride, useBitmapFloats,
                                     reinterpret_cast<uint32_t *>(&finalWidth),
                                     reinterpret_cast<uint32_t *>(&finalHeight),
                                     static_cast<uint32_t >(scaledWidth),
@@ -132,7 +115,7 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
                                     alphaPremultiplied, scaleMode,
                                     sampler, hasAlphaInOrigin);
     if (!scaleResult) {
-      return nullptr;
+      return false;
     }
   }
 
@@ -226,11 +209,40 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
     }
   }
 
+  image->pixels = std::move(rgbaPixels);
+  image->width = finalWidth;
+  image->height = finalHeight;
+  image->stride = stride;
+  image->useFloats = useBitmapFloats;
+  image->bitDepth = bitDepth;
+  image->alphaPremultiplied = alphaPremultiplied;
+  image->hasAlphaInOrigin = hasAlphaInOrigin;
+  return true;
+}
+
+bool DecodeSampledPixels(std::vector<uint8_t> &imageData, int scaledWidth, int scaledHeight,
+                         ScaleMode scaleMode, XSampler sampler, CurveToneMapper toneMapper,
+                         uint32_t maxThreads, JxlDecodedImage *image) {
+  coder::JxlResourceGovernor governor;
+  try {
+    return DecodeGovernedPixels(imageData, scaledWidth, scaledHeight, scaleMode, sampler,
+                                toneMapper, maxThreads, image);
+  } catch (concurrency::OperationCancelledException &err) {
+    // Time limit is delivered through the cancellation token, report it as the limit it is
+    governor.checkTime();
+    throw;
+  }
+}
+
+jobject CreateBitmapFromDecoded(JNIEnv *env, JxlDecodedImage &image,
+                                PreferredColorConfig preferredColorConfig) {
+  uint32_t stride = image.stride;
+  bool useBitmapFloats = image.useFloats;
   std::string bitmapPixelConfig = useBitmapFloats ? "RGBA_F16" : "ARGB_8888";
   jobject hwBuffer = nullptr;
-  ReformatColorConfig(env, rgbaPixels, bitmapPixelConfig, preferredColorConfig, bitDepth,
-                      finalWidth, finalHeight, &stride, &useBitmapFloats,
-                      &hwBuffer, alphaPremultiplied, hasAlphaInOrigin);
+  ReformatColorConfig(env, image.pixels, bitmapPixelConfig, preferredColorConfig, image.bitDepth,
+                      image.width, image.height, &stride, &useBitmapFloats,
+                      &hwBuffer, image.alphaPremultiplied, image.hasAlphaInOrigin);
 
   if (bitmapPixelConfig == "HARDWARE") {
     jclass bitmapClass = env->FindClass("android/graphics/Bitmap");
@@ -255,8 +267,8 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
                                                           "createBitmap",
                                                           "(IILandroid/graphics/Bitmap$Config;)Landroid/graphics/Bitmap;");
   jobject bitmapObj = env->CallStaticObjectMethod(bitmapClass, createBitmapMethodID,
-                                                  static_cast<jint>(finalWidth),
-                                                  static_cast<jint>(finalHeight),
+                                                  static_cast<jint>(image.width),
+                                                  static_cast<jint>(image.height),
                                                   rgba8888Obj);
 
   AndroidBitmapInfo info;
@@ -272,18 +284,18 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
   }
 
   if (bitmapPixelConfig == "RGB_565") {
-    coder::CopyUnaligned(reinterpret_cast<const uint16_t *>(rgbaPixels.data()), stride,
+    coder::CopyUnaligned(reinterpret_cast<const uint16_t *>(image.pixels.data()), stride,
                          reinterpret_cast<uint16_t *>(addr), (uint32_t) info.stride,
                          (uint32_t) info.width,
                          (uint32_t) info.height);
   } else {
     if (useBitmapFloats) {
-      coder::CopyUnaligned(reinterpret_cast<const uint16_t *>(rgbaPixels.data()), stride,
+      coder::CopyUnaligned(reinterpret_cast<const uint16_t *>(image.pixels.data()), stride,
                            reinterpret_cast<uint16_t *>(addr), (uint32_t) info.stride,
                            (uint32_t) info.width * 4,
                            (uint32_t) info.height);
     } else {
-      coder::CopyUnaligned(reinterpret_cast<const uint8_t *>(rgbaPixels.data()), stride,
+      coder::CopyUnaligned(reinterpret_cast<const uint8_t *>(image.pixels.data()), stride,
                            reinterpret_cast<uint8_t *>(addr), (uint32_t) info.stride,
                            (uint32_t) info.width * 4,
                            (uint32_t) info.height);
@@ -295,11 +307,55 @@ jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jin
     return static_cast<jobject>(nullptr);
   }
 
-  rgbaPixels.clear();
+  image.pixels.clear();
 
   return bitmapObj;
 }
 
+jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jint scaledWidth,
+                               jint scaledHeight,
+                               jint javaPreferredColorConfig,
+                               jint javaScaleMode, jint javaResizeFilter, jint javaToneMapper) {
+  ScaleMode scaleMode;
+  PreferredColorConfig preferredColorConfig;
+  XSampler sampler;
+  CurveToneMapper toneMapper;
+  if (!checkDecodePreconditions(env, javaPreferredColorConfig, &preferredColorConfig,
+                                javaScaleMode, &scaleMode, javaResizeFilter, &sampler,
+                                javaToneMapper, &toneMapper)) {
+    return nullptr;
+  }
+
+  JxlDecodedImage image;
+  try {
+    if (!DecodeSampledPixels(imageData, scaledWidth, scaledHeight, scaleMode, sampler, toneMapper,
+                             0, &image)) {
+      throwInvalidJXLException(env);
+      return nullptr;
+    }
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to decode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (InvalidImageSizeException &err) {
+    throwImageSizeException(env, err.what());
+    return nullptr;
+  }
+
+  return CreateBitmapFromDecoded(env, image, preferredColorConfig);
+}
+
 extern "C"
 JNIEXPORT jobject JNICALL
 Java_com_awxkee_jxlcoder_JxlCoder_decodeSampledImpl(JNIEnv *env, jobject thiz,
@@ -308,8 +364,10 @@ Java_com_awxkee_jxlcoder_JxlCoder_decodeSampledImpl(JNIEnv *env, jobject thiz,
                                                     jint javaPreferredColorConfig,
                                                     jint javaScaleMode,
                                                     jint resizeSampler,
-                                                    jint javaToneMapper) {
+                                                    jint javaToneMapper,
+                                                    jlong cancellationToken) {
   try {
+    concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
     auto totalLength = env->GetArrayLength(byte_array);
     std::vector<uint8_t> srcBuffer(totalLength);
     env->GetByteArrayRegion(byte_array, 0, totalLength,
@@ -326,6 +384,9 @@ Java_com_awxkee_jxlcoder_JxlCoder_decodeSampledImpl(JNIEnv *env, jobject thiz,
     std::string errorString = "Error while decoding: " + w1;
     throwException(env, errorString);
     return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
   }
 }
 
@@ -337,8 +398,10 @@ Java_com_awxkee_jxlcoder_JxlCoder_decodeByteBufferSampledImpl(JNIEnv *env, jobje
                                                               jint preferredColorConfig,
                                                               jint scaleMode,
                                                               jint resizeSampler,
-                                                              jint javaToneMapper) {
+                                                              jint javaToneMapper,
+                                                              jlong cancellationToken) {
   try {
+    concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
     auto bufferAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(byteBuffer));
     int length = (int) env->GetDirectBufferCapacity(byteBuffer);
     if (!bufferAddress || length <= 0) {
@@ -360,6 +423,258 @@ Java_com_awxkee_jxlcoder_JxlCoder_decodeByteBufferSampledImpl(JNIEnv *env, jobje
     std::string errorString = "Error while decoding: " + w1;
     throwException(env, errorString);
     return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_decodeTensorImpl(JNIEnv *env, jobject thiz,
+                                                   jbyteArray byteArray, jint width, jint height,
+                                                   jint channels, jint javaLayout,
+                                                   jint javaSampleType,
+                                                   jfloatArray javaMean, jfloatArray javaStd,
+                                                   jint javaScaleMode, jint resizeSampler,
+                                                   jint javaToneMapper,
+                                                   jobject outputBuffer, jint outputOffset,
+                                                   jlong cancellationToken) {
+  try {
+    concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+    ScaleMode scaleMode;
+    PreferredColorConfig preferredColorConfig;
+    XSampler sampler;
+    CurveToneMapper toneMapper;
+    if (!checkDecodePreconditions(env, Default, &preferredColorConfig,
+                                  javaScaleMode, &scaleMode, resizeSampler, &sampler,
+                                  javaToneMapper, &toneMapper)) {
+      return -1;
+    }
+    // Tensor has the exact input size of a model, fitting would leave it partially filled
+    if (scaleMode != Fill && scaleMode != Resize) {
+      std::string exc = "Tensor output supports only FILL and RESIZE scale modes";
+      throwException(env, exc);
+      return -1;
+    }
+    auto layout = static_cast<coder::TensorLayout>(javaLayout);
+    auto sampleType = static_cast<coder::TensorSampleType>(javaSampleType);
+    if ((layout != coder::TENSOR_NHWC && layout != coder::TENSOR_NCHW) ||
+        (sampleType != coder::TENSOR_U8 && sampleType != coder::TENSOR_F16 &&
+            sampleType != coder::TENSOR_F32) ||
+        (channels != 1 && channels != 3 && channels != 4)) {
+      std::string exc = "Unknown tensor layout, sample type or channels";
+      throwException(env, exc);
+      return -1;
+    }
+    if (width <= 0 || height <= 0) {
+      std::string exc = "Tensor dimensions must be positive";
+      throwException(env, exc);
+      return -1;
+    }
+
+    float mean[4] = {0.f, 0.f, 0.f, 0.f};
+    float std[4] = {1.f, 1.f, 1.f, 1.f};
+    bool normalized = javaMean != nullptr || javaStd != nullptr;
+    if (normalized && sampleType == coder::TENSOR_U8) {
+      std::string exc = "Unsigned tensors can't be normalized";
+      throwException(env, exc);
+      return -1;
+    }
+    if ((javaMean != nullptr && env->GetArrayLength(javaMean) != channels) ||
+        (javaStd != nullptr && env->GetArrayLength(javaStd) != channels)) {
+      std::string exc = "Mean and std must have a value for each channel";
+      throwException(env, exc);
+      return -1;
+    }
+    if (javaMean != nullptr) {
+      env->GetFloatArrayRegion(javaMean, 0, channels, mean);
+    }
+    if (javaStd != nullptr) {
+      env->GetFloatArrayRegion(javaStd, 0, channels, std);
+      for (int c = 0; c < channels; ++c) {
+        if (!(std[c] > 0.f)) {
+          std::string exc = "Std of every channel must be positive";
+          throwException(env, exc);
+          return -1;
+        }
+      }
+    }
+
+    size_t tensorSize = static_cast<size_t>(width) * static_cast<size_t>(height)
+        * static_cast<size_t>(channels) * coder::TensorSampleSize(sampleType);
+    auto outputAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(outputBuffer));
+    int64_t outputCapacity = env->GetDirectBufferCapacity(outputBuffer);
+    if (outputAddress == nullptr || outputOffset < 0 ||
+        outputCapacity - outputOffset < static_cast<int64_t>(tensorSize)) {
+      std::string exc = "Output must be a direct byte buffer with enough space for the tensor";
+      throwException(env, exc);
+      return -1;
+    }
+
+    auto totalLength = env->GetArrayLength(byteArray);
+    std::vector<uint8_t> srcBuffer(totalLength);
+    env->GetByteArrayRegion(byteArray, 0, totalLength,
+                            reinterpret_cast<jbyte *>(srcBuffer.data()));
+
+    JxlDecodedImage image;
+    if (!DecodeSampledPixels(srcBuffer, width, height, scaleMode, sampler, toneMapper,
+                             0, &image)) {
+      throwInvalidJXLException(env);
+      return -1;
+    }
+
+    if (image.width != static_cast<uint32_t>(width) ||
+        image.height != static_cast<uint32_t>(height)) {
+      throw std::runtime_error("Resized image doesn't match the tensor size");
+    }
+
+    if (image.alphaPremultiplied && image.hasAlphaInOrigin) {
+      coder::AdaptToRgba(image.pixels.data(), image.stride, image.pixels.data(), image.stride,
+                         image.width, image.height,
+                         image.useFloats ? coder::SAMPLE_F16 : coder::SAMPLE_U8,
+                         coder::ORDER_RGBA, true);
+    }
+
+    // Last stage of the pipeline, the color managed and resized pixels go straight to the tensor
+    coder::RgbaToTensor(image.pixels.data(), image.stride, image.useFloats,
+                        image.width, image.height, static_cast<uint32_t>(channels),
+                        layout, sampleType,
+                        normalized ? mean : nullptr, normalized ? std : nullptr,
+                        outputAddress + outputOffset);
+    return static_cast<jlong>(tensorSize);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return -1;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to decode this image";
+    throwException(env, errorString);
+    return -1;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return -1;
+  } catch (std::runtime_error &err) {
+    std::string w1 = err.what();
+    std::string errorString = "Error while decoding: " + w1;
+    throwException(env, errorString);
+    return -1;
+  } catch (InvalidImageSizeException &err) {
+    throwImageSizeException(env, err.what());
+    return -1;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return -1;
+  }
+}
+
+static bool YuvPlaneFits(JNIEnv *env, jobject buffer, uint32_t rows, uint32_t rowStride,
+                         uint32_t rowLength, uint8_t **address) {
+  *address = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+  int64_t capacity = env->GetDirectBufferCapacity(buffer);
+  if (*address == nullptr || rowStride < rowLength) {
+    return false;
+  }
+  return capacity >= static_cast<int64_t>(rows - 1) * rowStride + rowLength;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_decodeYuvImpl(JNIEnv *env, jobject thiz,
+                                                jbyteArray byteArray, jint width, jint height,
+                                                jobject yBuffer, jobject uBuffer, jobject vBuffer,
+                                                jint yStride, jint uvStride, jint uvPixelStride,
+                                                jint javaMatrix, jint javaRange,
+                                                jint javaScaleMode, jint resizeSampler,
+                                                jint javaToneMapper, jlong cancellationToken) {
+  try {
+    concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+    ScaleMode scaleMode;
+    PreferredColorConfig preferredColorConfig;
+    XSampler sampler;
+    CurveToneMapper toneMapper;
+    if (!checkDecodePreconditions(env, Default, &preferredColorConfig,
+                                  javaScaleMode, &scaleMode, resizeSampler, &sampler,
+                                  javaToneMapper, &toneMapper)) {
+      return;
+    }
+    // Video frame has the exact size of the encoder input, fitting would leave it partially filled
+    if (scaleMode != Fill && scaleMode != Resize) {
+      std::string exc = "YUV output supports only FILL and RESIZE scale modes";
+      throwException(env, exc);
+      return;
+    }
+    auto matrix = static_cast<coder::YuvMatrix>(javaMatrix);
+    auto range = static_cast<coder::YuvRange>(javaRange);
+    if ((matrix != coder::YUV_MATRIX_BT601 && matrix != coder::YUV_MATRIX_BT709) ||
+        (range != coder::YUV_RANGE_FULL && range != coder::YUV_RANGE_LIMITED) ||
+        (uvPixelStride != 1 && uvPixelStride != 2)) {
+      std::string exc = "Unknown YUV matrix, range or chroma pixel stride";
+      throwException(env, exc);
+      return;
+    }
+    if (width <= 0 || height <= 0 || yStride <= 0 || uvStride <= 0) {
+      std::string exc = "YUV dimensions and strides must be positive";
+      throwException(env, exc);
+      return;
+    }
+
+    uint32_t chromaWidth = (static_cast<uint32_t>(width) + 1) / 2;
+    uint32_t chromaHeight = (static_cast<uint32_t>(height) + 1) / 2;
+    uint32_t chromaRowLength = (chromaWidth - 1) * static_cast<uint32_t>(uvPixelStride) + 1;
+    coder::YuvOutputPlanes planes = {
+        .yStride = static_cast<uint32_t>(yStride),
+        .uvStride = static_cast<uint32_t>(uvStride),
+        .uvPixelStride = static_cast<uint32_t>(uvPixelStride),
+    };
+    if (!YuvPlaneFits(env, yBuffer, height, yStride, width, &planes.y) ||
+        !YuvPlaneFits(env, uBuffer, chromaHeight, uvStride, chromaRowLength, &planes.u) ||
+        !YuvPlaneFits(env, vBuffer, chromaHeight, uvStride, chromaRowLength, &planes.v)) {
+      std::string exc = "Planes must be direct byte buffers with enough space for the frame";
+      throwException(env, exc);
+      return;
+    }
+
+    auto totalLength = env->GetArrayLength(byteArray);
+    std::vector<uint8_t> srcBuffer(totalLength);
+    env->GetByteArrayRegion(byteArray, 0, totalLength,
+                            reinterpret_cast<jbyte *>(srcBuffer.data()));
+
+    JxlDecodedImage image;
+    if (!DecodeSampledPixels(srcBuffer, width, height, scaleMode, sampler, toneMapper,
+                             0, &image)) {
+      throwInvalidJXLException(env);
+      return;
+    }
+
+    if (image.width != static_cast<uint32_t>(width) ||
+        image.height != static_cast<uint32_t>(height)) {
+      throw std::runtime_error("Resized image doesn't match the frame size");
+    }
+
+    // Alpha is dropped, so transparent areas are always composed over black
+    if (image.hasAlphaInOrigin && !image.alphaPremultiplied && !image.useFloats) {
+      coder::AssociateAlphaRgba8(image.pixels.data(), image.stride,
+                                 image.pixels.data(), image.stride, image.width, image.height);
+    }
+
+    // Resized rows are read once, luma and filtered chroma are written in the same pass
+    coder::RgbaToYuv420(image.pixels.data(), image.stride, image.useFloats,
+                        image.width, image.height, planes, matrix, range);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to decode this image";
+    throwException(env, errorString);
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+  } catch (std::runtime_error &err) {
+    std::string w1 = err.what();
+    std::string errorString = "Error while decoding: " + w1;
+    throwException(env, errorString);
+  } catch (InvalidImageSizeException &err) {
+    throwImageSizeException(env, err.what());
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
   }
 }
 
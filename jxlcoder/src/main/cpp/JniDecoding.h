@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_JNIDECODING_H
+#define JXLCODER_JNIDECODING_H
+
+#include <jni.h>
+#include <vector>
+#include "definitions.h"
+#include "SizeScaler.h"
+#include "Support.h"
+#include "XScaler.h"
+
+/**
+ * Decoded, color managed and rescaled image before converting into target bitmap config
+ */
+struct JxlDecodedImage {
+  pooled_uint8_vector pixels;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t stride = 0;
+  bool useFloats = false;
+  uint32_t bitDepth = 8;
+  bool alphaPremultiplied = false;
+  bool hasAlphaInOrigin = true;
+};
+
+/**
+ * JNI free part of the decoding, might be run on any thread.
+ * @param maxThreads upper bound of decoder threads, 0 lets libjxl decide
+ * @return false if the data is not a valid JPEG XL, other failures are thrown
+ */
+bool DecodeSampledPixels(std::vector<uint8_t> &imageData, int scaledWidth, int scaledHeight,
+                         ScaleMode scaleMode, XSampler sampler, CurveToneMapper toneMapper,
+                         uint32_t maxThreads, JxlDecodedImage *image);
+
+/**
+ * Converts decoded image into the requested config and wraps it into android.graphics.Bitmap.
+ * Image pixels are consumed.
+ */
+jobject CreateBitmapFromDecoded(JNIEnv *env, JxlDecodedImage &image,
+                                PreferredColorConfig preferredColorConfig);
+
+/**
+ * Decodes JPEG XL into a bitmap, on failure returns nullptr with a pending java exception
+ * or throws a native exception that the caller must translate.
+ * Honors cancellation token installed for the current thread.
+ */
+jobject decodeSampledImageImpl(JNIEnv *env, std::vector<uint8_t> &imageData, jint scaledWidth,
+                               jint scaledHeight,
+                               jint javaPreferredColorConfig,
+                               jint javaScaleMode, jint javaResizeFilter, jint javaToneMapper);
+
+#endif //JXLCODER_JNIDECODING_H
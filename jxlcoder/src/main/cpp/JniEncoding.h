@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_JNIENCODING_H
+#define JXLCODER_JNIENCODING_H
+
+#include <jni.h>
+#include "encode.h"
+#include "definitions.h"
+#include "interop/JxlDefinitions.h"
+#include "interop/JxlEncodingProfile.hpp"
+#include "interop/JxlOutputSink.hpp"
+
+/**
+ * Bitmap pixels converted into the layout handed to libjxl,
+ * converted once they can be encoded any number of times.
+ */
+struct JxlBitmapPixels {
+  pooled_uint8_vector pixels;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  JxlColorPixelType colorspace = rgba;
+  JxlEncodingPixelDataFormat dataFormat = UNSIGNED_8;
+  JxlColorEncoding colorEncoding = {};
+};
+
+/**
+ * Reads the bitmap and converts it for encoding, resolving JXL_CHANNELS_AUTO from its content.
+ * On invalid input returns false with a pending java exception,
+ * allocation failures and cancellation are thrown as by the encoder itself.
+ */
+bool PrepareBitmapPixels(JNIEnv *env, jobject bitmap, jint javaColorSpace,
+                         jstring bitmapColorProfile, jint dataSpace, JxlBitmapPixels &out);
+
+/**
+ * Encodes converted pixels into the sink and feeds the time taken to the throughput model.
+ * Returns false when libjxl has failed, allocation failures and cancellation are thrown.
+ * Pixels are not modified, so the same image may be encoded from several threads.
+ * @param maxThreads workers of the libjxl runner, 0 uses one per core
+ */
+bool EncodeBitmapPixels(const JxlBitmapPixels &image, JxlCompressionOption compressionOption,
+                        int effort, int quality, int decodingSpeed, JxlEncodingProfile profile,
+                        coder::JxlOutputSink &sink, uint32_t maxThreads);
+
+/**
+ * Encodes bitmap into JPEG XL writing the stream into the sink,
+ * on failure returns false with a pending java exception.
+ * Honors cancellation token installed for the current thread.
+ */
+bool encodeBitmapInto(JNIEnv *env, jobject bitmap,
+                      jint javaColorSpace, jint javaCompressionOption,
+                      jint effort, jstring bitmapColorProfile,
+                      jint dataSpace, jint jQuality, jint decodingSpeed,
+                      jint javaProfile, coder::JxlOutputSink &sink);
+
+/**
+ * Encodes bitmap into JPEG XL, on failure returns nullptr with a pending java exception.
+ * Honors cancellation token installed for the current thread.
+ */
+jbyteArray encodeBitmapImpl(JNIEnv *env, jobject bitmap,
+                            jint javaColorSpace, jint javaCompressionOption,
+                            jint effort, jstring bitmapColorProfile,
+                            jint dataSpace, jint jQuality, jint decodingSpeed,
+                            jint javaProfile);
+
+/**
+ * Color encoding matching the name of bitmap color space or its data space
+ */
+JxlColorEncoding ResolveBitmapColorEncoding(JNIEnv *env, jstring bitmapColorProfile,
+                                            jint dataSpace, bool isImageMono);
+
+#endif //JXLCODER_JNIENCODING_H
@@ -28,22 +28,92 @@
 
 #include "JniExceptions.h"
 #include <string>
+#include <algorithm>
+
+static JavaVM *jxlJavaVM = nullptr;
+static jobject jxlClassLoader = nullptr;
+static jmethodID jxlLoadClassMethod = nullptr;
+
+extern "C"
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+  jxlJavaVM = vm;
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) {
+    return JNI_VERSION_1_6;
+  }
+  // Library load happens on a thread that sees the application class loader, keep it for native workers.
+  // Any class without a static initializer calling System.loadLibrary is fine here
+  jclass coderClass = env->FindClass("com/awxkee/jxlcoder/InvalidJXLException");
+  if (coderClass == nullptr) {
+    env->ExceptionClear();
+    return JNI_VERSION_1_6;
+  }
+  jclass classClass = env->FindClass("java/lang/Class");
+  jmethodID getClassLoader = env->GetMethodID(classClass, "getClassLoader", "()Ljava/lang/ClassLoader;");
+  jobject classLoader = env->CallObjectMethod(coderClass, getClassLoader);
+  jclass classLoaderClass = env->FindClass("java/lang/ClassLoader");
+  jxlLoadClassMethod = env->GetMethodID(classLoaderClass, "loadClass",
+                                        "(Ljava/lang/String;)Ljava/lang/Class;");
+  jxlClassLoader = env->NewGlobalRef(classLoader);
+  env->DeleteLocalRef(classLoader);
+  env->DeleteLocalRef(classLoaderClass);
+  env->DeleteLocalRef(classClass);
+  env->DeleteLocalRef(coderClass);
+  return JNI_VERSION_1_6;
+}
+
+JavaVM *getJxlJavaVM() {
+  return jxlJavaVM;
+}
+
+jclass findJxlClass(JNIEnv *env, const char *name) {
+  jclass clazz = env->FindClass(name);
+  if (clazz != nullptr || jxlClassLoader == nullptr) {
+    return clazz;
+  }
+  env->ExceptionClear();
+  std::string binaryName(name);
+  std::replace(binaryName.begin(), binaryName.end(), '/', '.');
+  jstring className = env->NewStringUTF(binaryName.c_str());
+  auto loaded = reinterpret_cast<jclass>(env->CallObjectMethod(jxlClassLoader, jxlLoadClassMethod,
+                                                               className));
+  env->DeleteLocalRef(className);
+  return loaded;
+}
 
 jint throwImageSizeException(JNIEnv *env, const char* message) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/InvalidImageSizeException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/InvalidImageSizeException");
+  return env->ThrowNew(exClass, message);
+}
+
+jint throwCancellationException(JNIEnv *env, const char* message) {
+  jclass exClass;
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/JxlCancellationException");
+  return env->ThrowNew(exClass, message);
+}
+
+jint throwMemoryBudgetException(JNIEnv *env, const char* message) {
+  jclass exClass;
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/JxlMemoryBudgetExceededException");
+  return env->ThrowNew(exClass, message);
+}
+
+jint throwResourceLimitException(JNIEnv *env, const char* message) {
+  jclass exClass;
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/JxlResourceLimitException");
   return env->ThrowNew(exClass, message);
 }
 
 jint throwInvalidJXLException(JNIEnv *env) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/InvalidJXLException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/InvalidJXLException");
   return env->ThrowNew(exClass, "");
 }
 
 jint throwPixelsException(JNIEnv *env) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/LockPixelsException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/LockPixelsException");
   return env->ThrowNew(exClass, "");
 }
 
@@ -55,22 +125,47 @@ jint throwException(JNIEnv *env, std::string &msg) {
 
 jint throwCantCompressImage(JNIEnv *env) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/JXLCoderCompressionException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/JXLCoderCompressionException");
   return env->ThrowNew(exClass, "");
 }
 
 jint throwInvalidColorSpaceException(JNIEnv *env) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/InvalidColorSpaceException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/InvalidColorSpaceException");
   return env->ThrowNew(exClass, "");
 }
 
 jint throwInvalidCompressionOptionException(JNIEnv *env) {
   jclass exClass;
-  exClass = env->FindClass("com/awxkee/jxlcoder/InvalidCompressionOptionException");
+  exClass = findJxlClass(env, "com/awxkee/jxlcoder/InvalidCompressionOptionException");
   return env->ThrowNew(exClass, "");
 }
 
+jthrowable createBatchError(JNIEnv *env, JxlBatchError error, const std::string &message) {
+  switch (error) {
+    case BATCH_INVALID_JXL:throwInvalidJXLException(env);
+      break;
+    case BATCH_IMAGE_SIZE:throwImageSizeException(env, message.c_str());
+      break;
+    case BATCH_CANCELLED:throwCancellationException(env, message.c_str());
+      break;
+    case BATCH_MEMORY_BUDGET:throwMemoryBudgetException(env, message.c_str());
+      break;
+    case BATCH_RESOURCE_LIMIT:throwResourceLimitException(env, message.c_str());
+      break;
+    case BATCH_CANT_COMPRESS:throwCantCompressImage(env);
+      break;
+    default: {
+      std::string msg = message;
+      throwException(env, msg);
+      break;
+    }
+  }
+  jthrowable throwable = env->ExceptionOccurred();
+  env->ExceptionClear();
+  return throwable;
+}
+
 int androidOSVersion() {
   return android_get_device_api_level();
 }
\ No newline at end of file
@@ -39,7 +39,40 @@ jint throwCantCompressImage(JNIEnv *env);
 jint throwInvalidColorSpaceException(JNIEnv *env);
 jint throwInvalidCompressionOptionException(JNIEnv *env);
 jint throwImageSizeException(JNIEnv *env, const char* message);
+jint throwCancellationException(JNIEnv *env, const char* message);
+
+jint throwMemoryBudgetException(JNIEnv *env, const char* message);
+
+jint throwResourceLimitException(JNIEnv *env, const char* message);
+
+/**
+ * Failure of a single batch item recorded on a worker, turned into an exception
+ * once the batch is back on a thread attached to the JVM
+ */
+enum JxlBatchError {
+  BATCH_NO_ERROR = 0,
+  BATCH_INVALID_JXL = 1,
+  BATCH_IMAGE_SIZE = 2,
+  BATCH_CANCELLED = 3,
+  BATCH_GENERIC = 4,
+  BATCH_MEMORY_BUDGET = 5,
+  BATCH_RESOURCE_LIMIT = 6,
+  BATCH_CANT_COMPRESS = 7,
+};
+
+/**
+ * @return exception matching the batch error, nothing is left pending
+ */
+jthrowable createBatchError(JNIEnv *env, JxlBatchError error, const std::string &message);
 
 int androidOSVersion();
 
+/**
+ * Resolves a class of the library package, works also on native threads attached to the JVM,
+ * where plain FindClass sees only the system class loader.
+ */
+jclass findJxlClass(JNIEnv *env, const char *name);
+
+JavaVM *getJxlJavaVM();
+
 #endif //JXLCODER_JNIEXCEPTIONS_H
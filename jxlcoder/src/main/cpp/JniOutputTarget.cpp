@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JniOutputTarget.h"
+#include "JniExceptions.h"
+#include <stdexcept>
+#include <string>
+
+jbyteArray NewByteArrayFromSink(JNIEnv *env, const coder::JxlBlockOutputSink &sink) {
+  if (sink.size() > static_cast<uint64_t>(INT32_MAX)) {
+    std::string errorString = "Encoded image exceeds the maximum size of a java array";
+    throwException(env, errorString);
+    return nullptr;
+  }
+  jbyteArray byteArray = env->NewByteArray(static_cast<jsize>(sink.size()));
+  if (byteArray == nullptr) {
+    return nullptr;
+  }
+  jsize position = 0;
+  sink.forEachBlock([&](const uint8_t *data, size_t size) {
+    env->SetByteArrayRegion(byteArray, position, static_cast<jsize>(size),
+                            reinterpret_cast<const jbyte *>(data));
+    position += static_cast<jsize>(size);
+  });
+  return byteArray;
+}
+
+JniOutputTarget::JniOutputTarget(JNIEnv *env, jobject directBuffer, jbyteArray array,
+                                 jint offset, jint fd) : array(array), offset(offset) {
+  if (offset < 0) {
+    throw std::runtime_error("Output offset must not be negative");
+  }
+  if (directBuffer != nullptr) {
+    auto data = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(directBuffer));
+    jlong capacity = env->GetDirectBufferCapacity(directBuffer);
+    if (data == nullptr || capacity < 0) {
+      throw std::runtime_error("Output ByteBuffer must be a direct buffer");
+    }
+    if (offset > capacity) {
+      throw std::runtime_error("Output offset is out of the buffer bounds");
+    }
+    output = std::make_unique<coder::JxlMemoryOutputSink>(data + offset,
+                                                          static_cast<size_t>(capacity - offset));
+  } else if (array != nullptr) {
+    // Java heap arrays can't be pinned for the whole encoding, blocks are copied in once it's done
+    if (offset > env->GetArrayLength(array)) {
+      throw std::runtime_error("Output offset is out of the array bounds");
+    }
+    output = std::make_unique<coder::JxlBlockOutputSink>();
+  } else if (fd >= 0) {
+    output = std::make_unique<coder::JxlFdOutputSink>(fd);
+  } else {
+    throw std::runtime_error("Output destination wasn't provided");
+  }
+}
+
+jlong JniOutputTarget::complete(JNIEnv *env) {
+  if (array != nullptr) {
+    auto &blocks = static_cast<coder::JxlBlockOutputSink &>(*output);
+    jsize available = env->GetArrayLength(array) - offset;
+    if (blocks.size() > static_cast<uint64_t>(available)) {
+      throw std::runtime_error("Output array is too small, " + std::to_string(blocks.size())
+                                   + " bytes are required");
+    }
+    jsize position = offset;
+    blocks.forEachBlock([&](const uint8_t *data, size_t size) {
+      env->SetByteArrayRegion(array, position, static_cast<jsize>(size),
+                              reinterpret_cast<const jbyte *>(data));
+      position += static_cast<jsize>(size);
+    });
+  }
+  return static_cast<jlong>(output->size());
+}
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_JNIOUTPUTTARGET_H
+#define JXLCODER_JNIOUTPUTTARGET_H
+
+#include <jni.h>
+#include <memory>
+#include "interop/JxlOutputSink.hpp"
+
+/**
+ * Java byte array holding the whole stream, the blocks are copied once into it.
+ * Returns nullptr with a pending java exception when the array can't be allocated.
+ */
+jbyteArray NewByteArrayFromSink(JNIEnv *env, const coder::JxlBlockOutputSink &sink);
+
+/**
+ * Destination of an encoded stream requested from java: a direct ByteBuffer,
+ * a pre-sized byte array or a file descriptor. Exactly one of them is expected.
+ */
+class JniOutputTarget {
+ public:
+  /**
+   * @param offset position in the buffer or in the array the stream starts at
+   * @throws std::runtime_error when the destination can't be used
+   */
+  JniOutputTarget(JNIEnv *env, jobject directBuffer, jbyteArray array, jint offset, jint fd);
+
+  coder::JxlOutputSink &sink() {
+    return *output;
+  }
+
+  /**
+   * Delivers the stream into the byte array when it's the destination
+   * @return count of written bytes
+   * @throws std::runtime_error when the stream doesn't fit the array
+   */
+  jlong complete(JNIEnv *env);
+
+ private:
+  std::unique_ptr<coder::JxlOutputSink> output;
+  jbyteArray array = nullptr;
+  jint offset = 0;
+};
+
+#endif //JXLCODER_JNIOUTPUTTARGET_H
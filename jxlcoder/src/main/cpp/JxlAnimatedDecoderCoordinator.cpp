@@ -38,9 +38,145 @@
 #include "hwy/highway.h"
 #include "colorspaces/ColorSpaceProfile.h"
 #include "imagebit/CopyUnalignedRGBA.h"
+#include "imagebit/RGBAlpha.h"
+#include <cmath>
+#include <cstring>
 
 using namespace std;
 
+/**
+ * Converts decoded frame into sRGB RGBA 8888 pixels and rescales it
+ * according to the coordinator scale mode, when scaling is requested
+ */
+static bool ManageFramePixels(JNIEnv *env, JxlAnimatedDecoderCoordinator *coordinator,
+                              const JxlFrame &frame, uint32_t scaleWidth, uint32_t scaleHeight,
+                              pooled_uint8_vector &rgbaPixels, uint32_t *stride,
+                              uint32_t *finalWidth, uint32_t *finalHeight) {
+  const vector<uint8_t> &iccProfile = frame.iccProfile;
+  rgbaPixels.assign(frame.pixels.begin(), frame.pixels.end());
+  // Currently always in 8bpp;
+  bool useFloat16 = false;
+  const uint32_t bitDepth = 8;
+  const bool alphaPremultiplied = coordinator->isAlphaAttenuated();
+
+  auto preferEncoding = frame.preferColorEncoding;
+  auto colorEncoding = frame.colorEncoding;
+
+  *stride = coordinator->getWidth() * 4 * static_cast<uint32_t>(useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t));
+
+  if (preferEncoding && (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_PQ ||
+      colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_HLG ||
+      colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_DCI ||
+      colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_709 ||
+      colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_GAMMA ||
+      colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_SRGB)
+      && colorEncoding.color_space == JXL_COLOR_SPACE_RGB) {
+    Eigen::Matrix3f sourceProfile;
+    TransferFunction transferFunction = TransferFunction::Srgb;
+    CurveToneMapper toneMapper = CurveToneMapper::TONE_SKIP;
+    bool useChromaticAdaptation = false;
+    float gamma = 2.2f;
+    if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_HLG) {
+      transferFunction = TransferFunction::Hlg;
+    } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_DCI) {
+      toneMapper = TONE_SKIP;
+      transferFunction = TransferFunction::Smpte428;
+    } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_PQ) {
+      transferFunction = TransferFunction::Pq;
+    } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_GAMMA) {
+      toneMapper = TONE_SKIP;
+      // Make real gamma
+      transferFunction = TransferFunction::Gamma2p2;
+      gamma = 1.f / colorEncoding.gamma;
+    } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_709) {
+      toneMapper = TONE_SKIP;
+      transferFunction = TransferFunction::Itur709;
+    } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_SRGB) {
+      toneMapper = TONE_SKIP;
+      transferFunction = TransferFunction::Srgb;
+    }
+
+    Eigen::Matrix<float, 3, 2> primaries;
+    Eigen::Vector2f whitePoint;
+
+    if (colorEncoding.primaries == JXL_PRIMARIES_2100) {
+      sourceProfile = GamutRgbToXYZ(getRec2020Primaries(), getIlluminantD65());
+      primaries << getRec2020Primaries();
+      whitePoint << getIlluminantD65();
+    } else if (colorEncoding.primaries == JXL_PRIMARIES_P3) {
+      sourceProfile = GamutRgbToXYZ(getDisplayP3Primaries(), getIlluminantD65());
+      primaries << getDisplayP3Primaries();
+      whitePoint << getIlluminantD65();
+    } else if (colorEncoding.primaries == JXL_PRIMARIES_SRGB) {
+      sourceProfile = GamutRgbToXYZ(getSRGBPrimaries(), getIlluminantD65());
+      primaries << getSRGBPrimaries();
+      whitePoint << getIlluminantD65();
+    } else {
+      primaries << static_cast<float>(colorEncoding.primaries_red_xy[0]),
+          static_cast<float>(colorEncoding.primaries_red_xy[1]),
+          static_cast<float>(colorEncoding.primaries_green_xy[0]),
+          static_cast<float>(colorEncoding.primaries_green_xy[1]),
+          static_cast<float>(colorEncoding.primaries_blue_xy[0]),
+          static_cast<float>(colorEncoding.primaries_blue_xy[1]);
+      whitePoint << static_cast<float>(colorEncoding.white_point_xy[0]),
+          static_cast<float>(colorEncoding.white_point_xy[1]);
+      if (whitePoint != getIlluminantD65()) {
+        useChromaticAdaptation = true;
+      }
+      sourceProfile = GamutRgbToXYZ(primaries, whitePoint);
+    }
+
+    Eigen::Matrix3f dstProfile = GamutRgbToXYZ(getRec709Primaries(), getIlluminantD65());
+    Eigen::Matrix3f conversion = dstProfile.inverse() * sourceProfile;
+
+    ITURColorCoefficients coeffs = colorPrimariesComputeYCoeffs(primaries, whitePoint);
+
+    const float matrix[9] = {
+        conversion(0, 0), conversion(0, 1), conversion(0, 2),
+        conversion(1, 0), conversion(1, 1), conversion(1, 2),
+        conversion(2, 0), conversion(2, 1), conversion(2, 2),
+    };
+
+    applyColorMatrix(reinterpret_cast<uint8_t *>(rgbaPixels.data()),
+                     *stride,
+                     (uint32_t) coordinator->getWidth(),
+                     (uint32_t) coordinator->getHeight(),
+                     matrix,
+                     transferFunction,
+                     TransferFunction::Srgb,
+                     toneMapper,
+                     coeffs, 255.);
+  }
+
+  if (!iccProfile.empty() && !frame.preferColorEncoding) {
+    convertUseDefinedColorSpace(rgbaPixels,
+                                *stride,
+                                (uint32_t) coordinator->getWidth(),
+                                (uint32_t) coordinator->getHeight(), iccProfile.data(),
+                                iccProfile.size(),
+                                useFloat16);
+  }
+  uint32_t scaledWidth = scaleWidth;
+  uint32_t scaledHeight = scaleHeight;
+  bool useSampler = (scaledWidth > 0 || scaledHeight > 0) && (scaledWidth != 0 && scaledHeight != 0);
+
+  *finalWidth = coordinator->getWidth();
+  *finalHeight = coordinator->getHeight();
+
+  if (useSampler && scaledHeight > 0 && scaledWidth > 0) {
+    auto scaleResult = RescaleImage(rgbaPixels, env, stride, useFloat16,
+                                    finalWidth, finalHeight,
+                                    scaledWidth, scaledHeight, bitDepth,
+                                    alphaPremultiplied,
+                                    coordinator->getScaleMode(),
+                                    coordinator->getSampler(), frame.hasAlphaInOrigin);
+    if (!scaleResult) {
+      return false;
+    }
+  }
+  return true;
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_com_awxkee_jxlcoder_JxlAnimatedImage_createCoordinator(JNIEnv *env, jobject thiz,
@@ -89,6 +225,12 @@ Java_com_awxkee_jxlcoder_JxlAnimatedImage_createCoordinator(JNIEnv *env, jobject
     std::string errorString = "OOM: " + string(err.what());
     throwException(env, errorString);
     return 0;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return 0;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return 0;
   }
 }
 
@@ -128,6 +270,12 @@ Java_com_awxkee_jxlcoder_JxlAnimatedImage_createCoordinatorByteArray(JNIEnv *env
     std::string errorString = "OOM: " + string(err.what());
     throwException(env, errorString);
     return 0;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return 0;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return 0;
   }
 }
 
@@ -171,128 +319,16 @@ Java_com_awxkee_jxlcoder_JxlAnimatedImage_getFrameImpl(JNIEnv *env, jobject thiz
     auto coordinator = reinterpret_cast<JxlAnimatedDecoderCoordinator *>(coordinatorPtr);
 
     JxlFrame frame = coordinator->getFrame(frameIndex);
-    vector<uint8_t> iccProfile = frame.iccProfile;
-    vector<uint8_t> rgbaPixels = frame.pixels;
+    pooled_uint8_vector rgbaPixels;
     // Currently always in 8bpp;
     bool useFloat16 = false;
-    const uint32_t bitDepth = 8;
     const bool alphaPremultiplied = coordinator->isAlphaAttenuated();
-
-    auto preferEncoding = frame.preferColorEncoding;
-    auto colorEncoding = frame.colorEncoding;
-
-    uint32_t stride = coordinator->getWidth() * 4 * static_cast<uint32_t>(useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t));
-
-    if (preferEncoding && (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_PQ ||
-        colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_HLG ||
-        colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_DCI ||
-        colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_709 ||
-        colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_GAMMA ||
-        colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_SRGB)
-        && colorEncoding.color_space == JXL_COLOR_SPACE_RGB) {
-      Eigen::Matrix3f sourceProfile;
-      TransferFunction transferFunction = TransferFunction::Srgb;
-      CurveToneMapper toneMapper = CurveToneMapper::TONE_SKIP;
-      bool useChromaticAdaptation = false;
-      float gamma = 2.2f;
-      if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_HLG) {
-        transferFunction = TransferFunction::Hlg;
-      } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_DCI) {
-        toneMapper = TONE_SKIP;
-        transferFunction = TransferFunction::Smpte428;
-      } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_PQ) {
-        transferFunction = TransferFunction::Pq;
-      } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_GAMMA) {
-        toneMapper = TONE_SKIP;
-        // Make real gamma
-        transferFunction = TransferFunction::Gamma2p2;
-        gamma = 1.f / colorEncoding.gamma;
-      } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_709) {
-        toneMapper = TONE_SKIP;
-        transferFunction = TransferFunction::Itur709;
-      } else if (colorEncoding.transfer_function == JXL_TRANSFER_FUNCTION_SRGB) {
-        toneMapper = TONE_SKIP;
-        transferFunction = TransferFunction::Srgb;
-      }
-
-      Eigen::Matrix<float, 3, 2> primaries;
-      Eigen::Vector2f whitePoint;
-
-      if (colorEncoding.primaries == JXL_PRIMARIES_2100) {
-        sourceProfile = GamutRgbToXYZ(getRec2020Primaries(), getIlluminantD65());
-        primaries << getRec2020Primaries();
-        whitePoint << getIlluminantD65();
-      } else if (colorEncoding.primaries == JXL_PRIMARIES_P3) {
-        sourceProfile = GamutRgbToXYZ(getDisplayP3Primaries(), getIlluminantD65());
-        primaries << getDisplayP3Primaries();
-        whitePoint << getIlluminantD65();
-      } else if (colorEncoding.primaries == JXL_PRIMARIES_SRGB) {
-        sourceProfile = GamutRgbToXYZ(getSRGBPrimaries(), getIlluminantD65());
-        primaries << getSRGBPrimaries();
-        whitePoint << getIlluminantD65();
-      } else {
-        primaries << static_cast<float>(colorEncoding.primaries_red_xy[0]),
-            static_cast<float>(colorEncoding.primaries_red_xy[1]),
-            static_cast<float>(colorEncoding.primaries_green_xy[0]),
-            static_cast<float>(colorEncoding.primaries_green_xy[1]),
-            static_cast<float>(colorEncoding.primaries_blue_xy[0]),
-            static_cast<float>(colorEncoding.primaries_blue_xy[1]);
-        whitePoint << static_cast<float>(colorEncoding.white_point_xy[0]),
-            static_cast<float>(colorEncoding.white_point_xy[1]);
-        if (whitePoint != getIlluminantD65()) {
-          useChromaticAdaptation = true;
-        }
-        sourceProfile = GamutRgbToXYZ(primaries, whitePoint);
-      }
-
-      Eigen::Matrix3f dstProfile = GamutRgbToXYZ(getRec709Primaries(), getIlluminantD65());
-      Eigen::Matrix3f conversion = dstProfile.inverse() * sourceProfile;
-
-      ITURColorCoefficients coeffs = colorPrimariesComputeYCoeffs(primaries, whitePoint);
-
-      const float matrix[9] = {
-          conversion(0, 0), conversion(0, 1), conversion(0, 2),
-          conversion(1, 0), conversion(1, 1), conversion(1, 2),
-          conversion(2, 0), conversion(2, 1), conversion(2, 2),
-      };
-
-      applyColorMatrix(reinterpret_cast<uint8_t *>(rgbaPixels.data()),
-                       stride,
-                       (uint32_t) coordinator->getWidth(),
-                       (uint32_t) coordinator->getHeight(),
-                       matrix,
-                       transferFunction,
-                       TransferFunction::Srgb,
-                       toneMapper,
-                       coeffs, 255.);
-    }
-
-    if (!iccProfile.empty() && !frame.preferColorEncoding) {
-      convertUseDefinedColorSpace(rgbaPixels,
-                                  stride,
-                                  (uint32_t) coordinator->getWidth(),
-                                  (uint32_t) coordinator->getHeight(), iccProfile.data(),
-                                  iccProfile.size(),
-                                  useFloat16);
-    }
-    uint32_t scaledWidth = scaleWidth;
-    uint32_t scaledHeight = scaleHeight;
-    bool useSampler = (scaledWidth > 0 || scaledHeight > 0) && (scaledWidth != 0 && scaledHeight != 0);
-
-    uint32_t finalWidth = coordinator->getWidth();
-    uint32_t finalHeight = coordinator->getHeight();
-
-    if (useSampler && scaledHeight > 0 && scaledWidth > 0) {
-      auto scaleResult = RescaleImage(rgbaPixels, env, &stride, useFloat16,
-                                      reinterpret_cast<uint32_t *>(&finalWidth),
-                                      reinterpret_cast<uint32_t *>(&finalHeight),
-                                      scaledWidth, scaledHeight, alphaPremultiplied,
-                                      bitDepth,
-                                      coordinator->getScaleMode(),
-                                      coordinator->getSampler(), frame.hasAlphaInOrigin);
-      if (!scaleResult) {
-        return nullptr;
-      }
+    uint32_t stride = 0;
+    uint32_t finalWidth = 0;
+    uint32_t finalHeight = 0;
+    if (!ManageFramePixels(env, coordinator, frame, scaleWidth, scaleHeight,
+                           rgbaPixels, &stride, &finalWidth, &finalHeight)) {
+      return nullptr;
     }
 
     std::string bitmapPixelConfig = useFloat16 ? "RGBA_F16" : "ARGB_8888";
@@ -375,10 +411,133 @@ Java_com_awxkee_jxlcoder_JxlAnimatedImage_getFrameImpl(JNIEnv *env, jobject thiz
     std::string errorString = err.what();
     throwException(env, errorString);
     return nullptr;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return nullptr;
   } catch (std::runtime_error &err) {
     std::string errorString = "Error: " + string(err.what());
     throwException(env, errorString);
     return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlAnimatedImage_decodeAtlasImpl(JNIEnv *env, jobject thiz,
+                                                          jlong coordinatorPtr,
+                                                          jint firstFrame, jint frameCount,
+                                                          jint cellWidth, jint cellHeight,
+                                                          jint columns, jint padding,
+                                                          jboolean premultiplied,
+                                                          jobject outputBuffer, jint outputOffset,
+                                                          jintArray frameTable) {
+  try {
+    auto coordinator = reinterpret_cast<JxlAnimatedDecoderCoordinator *>(coordinatorPtr);
+    if (frameCount < 1 || cellWidth < 1 || cellHeight < 1 || padding < 0) {
+      std::string errorString = "Atlas needs at least one frame, positive cell size and non negative padding";
+      throwException(env, errorString);
+      return;
+    }
+    if (env->GetArrayLength(frameTable) < frameCount * 5) {
+      std::string errorString = "Frame table must hold 5 values for each frame";
+      throwException(env, errorString);
+      return;
+    }
+
+    // Grid is laid out row by row, padding separates cells and surrounds the atlas
+    // so linear sampling of a frame never picks up its neighbour
+    uint32_t atlasColumns = columns > 0
+                            ? std::min(static_cast<uint32_t>(columns), static_cast<uint32_t>(frameCount))
+                            : static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(frameCount))));
+    uint32_t atlasRows = (static_cast<uint32_t>(frameCount) + atlasColumns - 1) / atlasColumns;
+    uint64_t atlasWidth = static_cast<uint64_t>(atlasColumns) * cellWidth
+        + static_cast<uint64_t>(atlasColumns + 1) * padding;
+    uint64_t atlasHeight = static_cast<uint64_t>(atlasRows) * cellHeight
+        + static_cast<uint64_t>(atlasRows + 1) * padding;
+    uint64_t atlasStride = atlasWidth * 4;
+    uint64_t atlasSize = atlasStride * atlasHeight;
+    if (atlasSize >= static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+      std::string errorString = "Atlas of " + std::to_string(atlasWidth) + "x"
+          + std::to_string(atlasHeight) + " exceeds the maximum buffer size";
+      throwException(env, errorString);
+      return;
+    }
+
+    auto outputAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(outputBuffer));
+    int64_t outputCapacity = env->GetDirectBufferCapacity(outputBuffer);
+    if (outputAddress == nullptr || outputOffset < 0 ||
+        outputCapacity - outputOffset < static_cast<int64_t>(atlasSize)) {
+      std::string errorString = "Output must be a direct byte buffer with enough space for the atlas";
+      throwException(env, errorString);
+      return;
+    }
+    uint8_t *atlas = outputAddress + outputOffset;
+    std::memset(atlas, 0, atlasSize);
+
+    const bool alphaPremultiplied = coordinator->isAlphaAttenuated();
+    std::vector<jint> table(static_cast<size_t>(frameCount) * 5);
+    pooled_uint8_vector rgbaPixels;
+    uint32_t cell = 0;
+    bool rescaleFailed = false;
+
+    // Frames are decoded in one pass, every frame lands in its cell before the next one is decoded
+    coordinator->decodeFrames(firstFrame, frameCount, [&](JxlFrame &frame) {
+      uint32_t stride = 0;
+      uint32_t frameWidth = 0;
+      uint32_t frameHeight = 0;
+      // Java exception is already pending after a failed rescale, the rest of frames is skipped
+      if (rescaleFailed || !ManageFramePixels(env, coordinator, frame, cellWidth, cellHeight,
+                                              rgbaPixels, &stride, &frameWidth, &frameHeight)) {
+        rescaleFailed = true;
+        return;
+      }
+      if (frameWidth > static_cast<uint32_t>(cellWidth) || frameHeight > static_cast<uint32_t>(cellHeight)) {
+        throw std::runtime_error("Rescaled frame doesn't fit into the atlas cell");
+      }
+
+      if (frame.hasAlphaInOrigin && premultiplied && !alphaPremultiplied) {
+        coder::AssociateAlphaRgba8(rgbaPixels.data(), stride, rgbaPixels.data(), stride,
+                                   frameWidth, frameHeight);
+      } else if (frame.hasAlphaInOrigin && !premultiplied && alphaPremultiplied) {
+        coder::UnassociateRgba8(rgbaPixels.data(), stride, rgbaPixels.data(), stride,
+                                frameWidth, frameHeight);
+      }
+
+      uint32_t x = padding + (cell % atlasColumns) * (cellWidth + padding);
+      uint32_t y = padding + (cell / atlasColumns) * (cellHeight + padding);
+      coder::CopyUnaligned(reinterpret_cast<const uint8_t *>(rgbaPixels.data()), stride,
+                           atlas + y * atlasStride + x * 4, static_cast<uint32_t>(atlasStride),
+                           frameWidth * 4, frameHeight);
+
+      jint *entry = table.data() + static_cast<size_t>(cell) * 5;
+      entry[0] = static_cast<jint>(x);
+      entry[1] = static_cast<jint>(y);
+      entry[2] = static_cast<jint>(frameWidth);
+      entry[3] = static_cast<jint>(frameHeight);
+      entry[4] = static_cast<jint>(frame.duration);
+      cell += 1;
+    });
+
+    if (rescaleFailed) {
+      return;
+    }
+    env->SetIntArrayRegion(frameTable, 0, frameCount * 5, table.data());
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "OOM: " + string(err.what());
+    throwException(env, errorString);
+  } catch (AnimatedDecoderError &err) {
+    std::string errorString = err.what();
+    throwException(env, errorString);
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + string(err.what());
+    throwException(env, errorString);
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
   }
 }
 
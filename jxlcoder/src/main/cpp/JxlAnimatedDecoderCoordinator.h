@@ -65,6 +65,10 @@ class JxlAnimatedDecoderCoordinator {
     return decoder->getFrame(at);
   }
 
+  void decodeFrames(int from, int count, const std::function<void(JxlFrame &)> &onFrame) {
+    decoder->decodeFrames(from, count, onFrame);
+  }
+
   JxlFrame nextFrame() {
     return decoder->nextFrame();
   }
@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 #include "JniExceptions.h"
+#include "JniOutputTarget.h"
 #include <android/data_space.h>
 #include <android/bitmap.h>
 #include "conversion/RgbChannels.h"
@@ -40,9 +41,10 @@
 #include "imagebit/Rgb565.h"
 #include "imagebit/RGBAlpha.h"
 #include "imagebit/CopyUnalignedRGBA.h"
-#include "imagebit/RgbaF16bitToNBitU16.h"
+#include "imagebit/Rgba8ToF16.h"
 #include "imagebit/RgbaF16bitNBitU8.h"
 #include "imagebit/RgbaToRgb.h"
+#include "interop/JxlRawPixels.hpp"
 
 using namespace std;
 
@@ -66,8 +68,11 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_createEncodeCoordinator(JNIEnv *env,
                                                                     jint javaDataSpaceValue,
                                                                     jint effort,
                                                                     jint decodingSpeed,
-                                                                    jint javaDataPixelFormat) {
-  auto colorspace = static_cast<JxlColorPixelType>(javaColorSpace);
+                                                                    jint javaDataPixelFormat,
+                                                                    jint javaProfile) {
+  // The header is written before later frames are seen, so nothing can be dropped safely
+  auto colorspace = javaColorSpace == JXL_CHANNELS_AUTO ? rgba
+                                                        : static_cast<JxlColorPixelType>(javaColorSpace);
   if (!colorspace) {
     throwInvalidColorSpaceException(env);
     return 0;
@@ -89,6 +94,11 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_createEncodeCoordinator(JNIEnv *env,
     return 0;
   }
 
+  if (javaProfile != PROFILE_DEFAULT && javaProfile != PROFILE_PROGRESSIVE) {
+    throwInvalidCompressionOptionException(env);
+    return 0;
+  }
+
   auto dataPixelFormat = static_cast<JxlEncodingPixelDataFormat>(javaDataPixelFormat);
 
   JxlColorMatrix colorSpaceMatrix = MATRIX_UNKNOWN;
@@ -116,7 +126,8 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_createEncodeCoordinator(JNIEnv *env,
     auto encoder = new JxlAnimatedEncoder(width, height, colorspace,
                                           dataPixelFormat,
                                           compressionOption, numLoops, jQuality,
-                                          effort, decodingSpeed);
+                                          effort, decodingSpeed,
+                                          static_cast<JxlEncodingProfile>(javaProfile));
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "MemoryLeak"
     auto coordinator = new JxlAnimatedEncoderCoordinator(encoder,
@@ -204,12 +215,12 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_addFrameImpl(JNIEnv *env, jobject th
       if (dataPixelFormat == BINARY_16) {
         imageStride = info.width * 4 * sizeof(uint16_t);
         vector<uint8_t> halfFloatPixels(imageStride * info.height);
-        coder::RGBA1010102ToUnsigned(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
-                                     (uint32_t) info.stride,
-                                     reinterpret_cast<uint16_t *>(halfFloatPixels.data()),
-                                     imageStride,
-                                     info.width,
-                                     info.height, 16);
+        coder::RGBA1010102ToF16(reinterpret_cast<const uint8_t *>(rgbaPixels.data()),
+                                (uint32_t) info.stride,
+                                reinterpret_cast<uint16_t *>(halfFloatPixels.data()),
+                                imageStride,
+                                info.width,
+                                info.height);
         rgbaPixels = halfFloatPixels;
       } else {
         imageStride = info.width * 4 * sizeof(uint8_t);
@@ -234,11 +245,14 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_addFrameImpl(JNIEnv *env, jobject th
         rgbaPixels = rgba8888Pixels;
       } else {
         int b16Stride = (int) info.width * 4 * (int) sizeof(uint16_t);
-        vector<uint8_t> halfFloatPixels(imageStride * info.height);
-        coder::Rgb565ToRgba16(reinterpret_cast<uint16_t *>(rgbaPixels.data()), newStride,
-                              reinterpret_cast<uint16_t *>(halfFloatPixels.data()), b16Stride,
-                              std::numeric_limits<uint16_t>::max(),
-                              info.width, info.height, 16);
+        vector<uint8_t> halfFloatPixels(b16Stride * info.height);
+        coder::Rgb565ToUnsigned8(reinterpret_cast<uint16_t *>(rgbaPixels.data()),
+                                 info.stride,
+                                 rgba8888Pixels.data(), newStride,
+                                 info.width, info.height, 255);
+        coder::Rgba8ToF16(rgba8888Pixels.data(), newStride,
+                          reinterpret_cast<uint16_t *>(halfFloatPixels.data()), b16Stride,
+                          info.width, info.height, false);
         imageStride = b16Stride;
         rgbaPixels = halfFloatPixels;
       }
@@ -251,9 +265,13 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_addFrameImpl(JNIEnv *env, jobject th
       } else if (dataPixelFormat == BINARY_16) {
         int b16Stride = (int) info.width * 4 * (int) sizeof(uint16_t);
         vector<uint8_t> halfFloatPixels(b16Stride * info.height);
-        coder::RGBAF16BitToNBitU16(reinterpret_cast<uint16_t *>(rgbaPixels.data()), imageStride,
-                                   reinterpret_cast<uint16_t *>(halfFloatPixels.data()), b16Stride,
-                                   info.width, info.height, 16);
+        coder::UnassociateRgba8(rgbaPixels.data(), imageStride,
+                                rgbaPixels.data(), imageStride,
+                                (uint32_t) info.width,
+                                (uint32_t) info.height);
+        coder::Rgba8ToF16(rgbaPixels.data(), imageStride,
+                          reinterpret_cast<uint16_t *>(halfFloatPixels.data()), b16Stride,
+                          info.width, info.height, false);
         imageStride = b16Stride;
         rgbaPixels = halfFloatPixels;
       }
@@ -353,20 +371,80 @@ Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_addFrameImpl(JNIEnv *env, jobject th
   }
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_addRawFrameImpl(JNIEnv *env, jobject thiz,
+                                                            jlong coordinatorPtr,
+                                                            jobject byteBuffer,
+                                                            jint width, jint height, jint stride,
+                                                            jint javaChannels,
+                                                            jint javaSampleType,
+                                                            jboolean premultiplied,
+                                                            jint duration) {
+  try {
+    auto coordinator = reinterpret_cast<JxlAnimatedEncoderCoordinator *>(coordinatorPtr);
+
+    if (width != coordinator->getWidth() || height != coordinator->getHeight()) {
+      std::string exc = "Bounds of each frames must be the same to origin (" +
+          to_string(coordinator->getWidth()) + "," +
+          to_string(coordinator->getHeight()) + "), but were provided (" +
+          to_string(width) + ", " +
+          to_string(height) + ")";
+      throwException(env, exc);
+      return;
+    }
+
+    if (stride <= 0) {
+      std::string exc = "Invalid image dimensions or stride";
+      throwException(env, exc);
+      return;
+    }
+
+    coder::JxlRawPixels pixels = {
+        .data = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(byteBuffer)),
+        .size = static_cast<size_t>(std::max(env->GetDirectBufferCapacity(byteBuffer),
+                                             static_cast<jlong>(0))),
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .stride = static_cast<uint32_t>(stride),
+        .channels = static_cast<coder::JxlRawChannels>(javaChannels),
+        .sampleType = static_cast<coder::RgbaSampleType>(javaSampleType),
+        .premultiplied = static_cast<bool>(premultiplied),
+    };
+    std::string invalid = coder::ValidateJxlRawPixels(pixels);
+    if (!invalid.empty()) {
+      throwException(env, invalid);
+      return;
+    }
+
+    JxlAnimatedEncoder *encoder = coordinator->getEncoder();
+    if (coder::JxlRawChannelsCount(pixels.channels) != encoder->getPixelFormat().num_channels) {
+      std::string exc = "Channels of the frame must match channels of the animated encoder";
+      throwException(env, exc);
+      return;
+    }
+
+    pooled_uint8_vector storage;
+    coder::JxlRawFrame frame = coder::PrepareJxlRawFrame(pixels, storage);
+    encoder->addFrame(frame.data, frame.size, frame.pixelFormat, duration);
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "OOM: " + string(err.what());
+    throwException(env, errorString);
+    return;
+  } catch (AnimatedEncoderError &err) {
+    std::string errorString = err.what();
+    throwException(env, errorString);
+    return;
+  }
+}
+
 extern "C"
 JNIEXPORT jbyteArray JNICALL
 Java_com_awxkee_jxlcoder_JxlAnimatedEncoder_encodeAnimatedImpl(JNIEnv *env, jobject thiz,
                                                                jlong coordinatorPtr) {
   try {
     auto coordinator = reinterpret_cast<JxlAnimatedEncoderCoordinator *>(coordinatorPtr);
-    vector<uint8_t> buffer;
-    coordinator->finish(ref(buffer));
-    jbyteArray byteArray = env->NewByteArray((jsize) buffer.size());
-    char *memBuf = (char *) ((void *) buffer.data());
-    env->SetByteArrayRegion(byteArray, 0, (jint) buffer.size(),
-                            reinterpret_cast<const jbyte *>(memBuf));
-    buffer.clear();
-    return byteArray;
+    return NewByteArrayFromSink(env, coordinator->finish());
   } catch (std::bad_alloc &err) {
     std::string errorString = "OOM: " + string(err.what());
     throwException(env, errorString);
@@ -73,8 +73,8 @@ class JxlAnimatedEncoderCoordinator {
     return encoder;
   }
 
-  void finish(vector<uint8_t> &dst) {
-    return encoder->encode(dst);
+  const coder::JxlBlockOutputSink &finish() {
+    return encoder->encode();
   }
 
   ~JxlAnimatedEncoderCoordinator() {
@@ -0,0 +1,292 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "JniDecoding.h"
+#include "JniExceptions.h"
+#include "JxlCancellation.h"
+#include "Support.h"
+#include "interop/JxlDecoding.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlResourceGovernor.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+struct JxlBatchItem {
+  std::vector<uint8_t> data;
+  int fd = -1;
+  int scaledWidth = 0;
+  int scaledHeight = 0;
+  bool large = false;
+  bool decoded = false;
+  JxlDecodedImage image;
+  JxlBatchError error = BATCH_NO_ERROR;
+  std::string errorMessage;
+};
+
+// Images up to this amount of pixels are decoded one per worker with a single decoder thread
+static const uint64_t batchSmallImagePixels = 1024 * 1024;
+
+static void readDescriptor(int fd, std::vector<uint8_t> &data) {
+  struct stat fileStat = {};
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    throw std::runtime_error("Cannot read file descriptor size");
+  }
+  data.resize(static_cast<size_t>(fileStat.st_size));
+  size_t offset = 0;
+  while (offset < data.size()) {
+    ssize_t read = pread(fd, data.data() + offset, data.size() - offset, static_cast<off_t>(offset));
+    if (read <= 0) {
+      throw std::runtime_error("Cannot read file descriptor");
+    }
+    offset += static_cast<size_t>(read);
+  }
+}
+
+static void decodeBatchItem(JxlBatchItem &item, ScaleMode scaleMode, XSampler sampler,
+                            CurveToneMapper toneMapper, uint32_t maxThreads) {
+  try {
+    if (!DecodeSampledPixels(item.data, item.scaledWidth, item.scaledHeight, scaleMode, sampler,
+                             toneMapper, maxThreads, &item.image)) {
+      item.error = BATCH_INVALID_JXL;
+    } else {
+      item.decoded = true;
+    }
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    item.error = BATCH_MEMORY_BUDGET;
+    item.errorMessage = err.what();
+  } catch (std::bad_alloc &err) {
+    item.error = BATCH_GENERIC;
+    item.errorMessage = "Not enough memory to decode this image";
+  } catch (coder::JxlResourceLimitException &err) {
+    item.error = BATCH_RESOURCE_LIMIT;
+    item.errorMessage = err.what();
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    item.error = BATCH_GENERIC;
+    item.errorMessage = "Error: " + m1;
+  } catch (InvalidImageSizeException &err) {
+    item.error = BATCH_IMAGE_SIZE;
+    item.errorMessage = err.what();
+  } catch (concurrency::OperationCancelledException &err) {
+    item.error = BATCH_CANCELLED;
+    item.errorMessage = err.what();
+  }
+  // Compressed data is not needed anymore, release it before the rest of the batch finishes
+  std::vector<uint8_t>().swap(item.data);
+}
+
+/**
+ * Decodes running on the shared pool in submission order, all of them are awaited on destruction
+ * because the workers reference items owned by the calling frame
+ */
+class JxlPendingDecodes {
+ public:
+  ~JxlPendingDecodes() {
+    for (auto &decode : decodes) {
+      decode.second.wait();
+    }
+  }
+
+  void push(jsize index, std::future<void> future) {
+    decodes.emplace_back(index, std::move(future));
+  }
+
+  [[nodiscard]] size_t size() const {
+    return decodes.size();
+  }
+
+  // Waits for the oldest decode and returns index of its item
+  jsize waitOldest() {
+    auto decode = std::move(decodes.front());
+    decodes.pop_front();
+    decode.second.wait();
+    return decode.first;
+  }
+
+ private:
+  std::deque<std::pair<jsize, std::future<void>>> decodes;
+};
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_decodeSampledBatchImpl(JNIEnv *env, jobject thiz,
+                                                         jobjectArray sources,
+                                                         jintArray fds,
+                                                         jintArray scaledWidths,
+                                                         jintArray scaledHeights,
+                                                         jint javaPreferredColorConfig,
+                                                         jint javaScaleMode,
+                                                         jint javaResizeFilter,
+                                                         jint javaToneMapper,
+                                                         jboolean sequential,
+                                                         jlong cancellationToken,
+                                                         jlongArray stats) {
+  ScaleMode scaleMode;
+  PreferredColorConfig preferredColorConfig;
+  XSampler sampler;
+  CurveToneMapper toneMapper;
+  if (!checkDecodePreconditions(env, javaPreferredColorConfig, &preferredColorConfig,
+                                javaScaleMode, &scaleMode, javaResizeFilter, &sampler,
+                                javaToneMapper, &toneMapper)) {
+    return nullptr;
+  }
+
+  auto token = cancellationTokenFromHandle(cancellationToken);
+  concurrency::CancellationScope cancellationScope(token);
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+
+    jsize count = env->GetArrayLength(scaledWidths);
+    std::vector<jint> descriptors(count), widths(count), heights(count);
+    env->GetIntArrayRegion(fds, 0, count, descriptors.data());
+    env->GetIntArrayRegion(scaledWidths, 0, count, widths.data());
+    env->GetIntArrayRegion(scaledHeights, 0, count, heights.data());
+
+    jclass objectClass = env->FindClass("java/lang/Object");
+    jobjectArray results = env->NewObjectArray(count, objectClass, nullptr);
+    jlong decodedPixels = 0;
+
+    std::vector<JxlBatchItem> items(count);
+    // Declared after the items, so every worker is finished before they are gone on any unwind
+    JxlPendingDecodes pending;
+
+    auto &pool = concurrency::sharedThreadPool();
+    // Waiting on the pool from one of its workers would deadlock, so decode inline there
+    bool spreadAcrossImages = !sequential && !pool.isWorkerThread();
+    // Only this many inputs and decoded images are alive at once, instead of the whole batch
+    const size_t maxInFlight = std::max<size_t>(pool.size(), 1);
+
+    // Bitmap is created as soon as an item is done and its pixels are released right away
+    auto deliver = [&](jsize i) {
+      JxlBatchItem &item = items[i];
+      jobject result;
+      if (item.decoded) {
+        uint64_t pixels = static_cast<uint64_t>(item.image.width) * static_cast<uint64_t>(item.image.height);
+        result = CreateBitmapFromDecoded(env, item.image, preferredColorConfig);
+        if (env->ExceptionCheck() || result == nullptr) {
+          result = env->ExceptionOccurred();
+          env->ExceptionClear();
+        } else {
+          decodedPixels += static_cast<jlong>(pixels);
+        }
+      } else {
+        result = createBatchError(env, item.error, item.errorMessage);
+      }
+      env->SetObjectArrayElement(results, i, result);
+      env->DeleteLocalRef(result);
+      pooled_uint8_vector().swap(item.image.pixels);
+    };
+
+    for (jsize i = 0; i < count; ++i) {
+      JxlBatchItem &item = items[i];
+      item.scaledWidth = widths[i];
+      item.scaledHeight = heights[i];
+      item.fd = descriptors[i];
+      try {
+        if (item.fd >= 0) {
+          readDescriptor(item.fd, item.data);
+        } else {
+          jobject source = env->GetObjectArrayElement(sources, i);
+          auto bufferAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(source));
+          if (bufferAddress != nullptr) {
+            auto length = static_cast<size_t>(env->GetDirectBufferCapacity(source));
+            item.data.assign(bufferAddress, bufferAddress + length);
+          } else {
+            // Not a direct buffer, therefore it is a byte array
+            auto byteArray = reinterpret_cast<jbyteArray>(source);
+            auto length = env->GetArrayLength(byteArray);
+            item.data.resize(length);
+            env->GetByteArrayRegion(byteArray, 0, length,
+                                    reinterpret_cast<jbyte *>(item.data.data()));
+          }
+          env->DeleteLocalRef(source);
+        }
+        size_t xsize = 0, ysize = 0;
+        if (DecodeBasicInfo(item.data.data(), item.data.size(), &xsize, &ysize)) {
+          item.large = static_cast<uint64_t>(xsize) * static_cast<uint64_t>(ysize) > batchSmallImagePixels;
+        }
+      } catch (std::runtime_error &err) {
+        std::string m1 = err.what();
+        item.error = BATCH_GENERIC;
+        item.errorMessage = "Error: " + m1;
+      }
+
+      if (item.error != BATCH_NO_ERROR) {
+        std::vector<uint8_t>().swap(item.data);
+        deliver(i);
+      } else if (spreadAcrossImages && !item.large) {
+        while (pending.size() >= maxInFlight) {
+          deliver(pending.waitOldest());
+        }
+        JxlBatchItem *pendingItem = &item;
+        pending.push(i, pool.enqueue([pendingItem, token, scaleMode, sampler, toneMapper]() {
+          concurrency::CancellationScope workerScope(token);
+          decodeBatchItem(*pendingItem, scaleMode, sampler, toneMapper, 1);
+        }));
+      } else {
+        // Large images use intra-image parallelism while the pool drains small ones
+        decodeBatchItem(item, scaleMode, sampler, toneMapper, 0);
+        deliver(i);
+      }
+    }
+
+    while (pending.size() > 0) {
+      deliver(pending.waitOldest());
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    jlong values[2] = {static_cast<jlong>(elapsed), decodedPixels};
+    env->SetLongArrayRegion(stats, 0, 2, values);
+
+    return results;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to decode this batch";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string w1 = err.what();
+    std::string errorString = "Error while decoding: " + w1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
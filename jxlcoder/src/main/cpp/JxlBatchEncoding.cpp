@@ -0,0 +1,496 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "android/bitmap.h"
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlEncoding.h"
+#include "interop/JxlChunkedSource.hpp"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlOutputSink.hpp"
+#include "thread_parallel_runner.h"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct JxlBatchEncodeOptions {
+  JxlColorPixelType rawColorspace;
+  JxlCompressionOption compressionOption;
+  int effort;
+  int quality;
+  int decodingSpeed;
+  JxlEncodingProfile profile;
+};
+
+struct JxlBatchEncodeItem {
+  jsize index = 0;
+  // Bitmaps are converted on the calling thread, raw sources are read while encoding
+  bool raw = false;
+  JxlBitmapPixels image;
+  const uint8_t *buffer = nullptr;
+  int fd = -1;
+  int64_t offset = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t stride = 0;
+  coder::JxlSourceLayout layout = coder::SOURCE_RGBA_8888;
+  bool premultiplied = false;
+  // Charged against the in-flight budget until the result is delivered
+  uint64_t cost = 0;
+  coder::JxlBlockOutputSink sink;
+  JxlBatchError error = BATCH_NO_ERROR;
+  std::string errorMessage;
+};
+
+/**
+ * Items finished by the workers, waiting to be delivered on the calling thread
+ */
+class JxlBatchCompletion {
+ public:
+  void push(std::unique_ptr<JxlBatchEncodeItem> item) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      completed.push_back(std::move(item));
+    }
+    condition.notify_one();
+  }
+
+  std::unique_ptr<JxlBatchEncodeItem> take() {
+    std::unique_lock<std::mutex> guard(mutex);
+    condition.wait(guard, [this]() { return !completed.empty(); });
+    auto item = std::move(completed.front());
+    completed.pop_front();
+    return item;
+  }
+
+ private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::unique_ptr<JxlBatchEncodeItem>> completed;
+};
+
+void encodeBatchItem(JxlBatchEncodeItem &item, const JxlBatchEncodeOptions &options,
+                     uint32_t maxThreads) {
+  try {
+    bool encoded;
+    if (item.raw) {
+      std::unique_ptr<coder::JxlPixelReader> reader;
+      if (item.buffer != nullptr) {
+        reader = std::make_unique<coder::JxlMemoryPixelReader>(item.buffer, item.stride, item.layout);
+      } else {
+        reader = std::make_unique<coder::JxlFdPixelReader>(item.fd, item.offset, item.stride,
+                                                           item.layout);
+      }
+      coder::JxlChunkedFrameSource source(*reader, item.layout, item.premultiplied,
+                                          options.rawColorspace);
+      JxlColorEncoding colorEncoding = {};
+      JxlColorEncodingSetToSRGB(&colorEncoding, options.rawColorspace == mono);
+      std::vector<uint8_t> iccProfile;
+      encoded = EncodeJxlChunked(source, item.sink, item.width, item.height,
+                                 options.rawColorspace, options.compressionOption, iccProfile,
+                                 options.effort, options.quality, options.decodingSpeed,
+                                 colorEncoding, maxThreads == 0
+                                                ? JxlThreadParallelRunnerDefaultNumWorkerThreads()
+                                                : maxThreads);
+    } else {
+      encoded = EncodeBitmapPixels(item.image, options.compressionOption, options.effort,
+                                   options.quality, options.decodingSpeed, options.profile,
+                                   item.sink, maxThreads);
+    }
+    if (!encoded) {
+      item.error = BATCH_CANT_COMPRESS;
+    }
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    item.error = BATCH_MEMORY_BUDGET;
+    item.errorMessage = err.what();
+  } catch (std::bad_alloc &err) {
+    item.error = BATCH_GENERIC;
+    item.errorMessage = "Not enough memory to encode this image";
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    item.error = BATCH_GENERIC;
+    item.errorMessage = "Error: " + m1;
+  } catch (concurrency::OperationCancelledException &err) {
+    item.error = BATCH_CANCELLED;
+    item.errorMessage = err.what();
+  }
+  // Converted pixels are not needed anymore, release them before the result is delivered
+  pooled_uint8_vector().swap(item.image.pixels);
+}
+
+/**
+ * Validates a raw source and captures its pixels
+ * @return failure of the item or nullptr when it can be encoded
+ */
+jthrowable prepareRawItem(JNIEnv *env, JxlBatchEncodeItem &item, jobject byteBuffer) {
+  const auto pixelSize = static_cast<int64_t>(coder::JxlSourcePixelSize(item.layout));
+  if (item.layout != coder::SOURCE_RGBA_8888 && item.layout != coder::SOURCE_RGBA_F16 &&
+      item.layout != coder::SOURCE_RGBA_1010102 && item.layout != coder::SOURCE_RGB_565) {
+    return createBatchError(env, BATCH_GENERIC, "Unknown pixels layout");
+  }
+  if (item.width == 0 || item.height == 0 ||
+      static_cast<int64_t>(item.stride) < static_cast<int64_t>(item.width) * pixelSize) {
+    return createBatchError(env, BATCH_GENERIC, "Invalid image dimensions or stride");
+  }
+  if (byteBuffer != nullptr) {
+    item.buffer = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(byteBuffer));
+    int64_t bufferSize = env->GetDirectBufferCapacity(byteBuffer);
+    if (item.buffer == nullptr || bufferSize < static_cast<int64_t>(item.stride) * (item.height - 1)
+        + static_cast<int64_t>(item.width) * pixelSize) {
+      return createBatchError(env, BATCH_GENERIC,
+                              "Pixels must be provided in a direct byte buffer large enough to hold the image");
+    }
+  } else if (item.fd < 0) {
+    return createBatchError(env, BATCH_GENERIC, "Source of pixels is not provided");
+  }
+  item.raw = true;
+  item.cost = static_cast<uint64_t>(item.stride) * item.height;
+  return nullptr;
+}
+
+/**
+ * Size of the bitmap pixels, which is about the size of the converted frame
+ */
+uint64_t bitmapCost(JNIEnv *env, jobject bitmap) {
+  AndroidBitmapInfo info;
+  if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+    // Conversion reports the failure
+    return 0;
+  }
+  return static_cast<uint64_t>(info.stride) * info.height;
+}
+
+/**
+ * Converts a bitmap source
+ * @return failure of the item or nullptr when it can be encoded
+ */
+jthrowable prepareBitmapItem(JNIEnv *env, JxlBatchEncodeItem &item, jobject bitmap,
+                             jint javaColorSpace, jstring bitmapColorProfile, jint dataSpace) {
+  try {
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace,
+                             item.image)) {
+      jthrowable error = env->ExceptionOccurred();
+      env->ExceptionClear();
+      return error;
+    }
+    return nullptr;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    return createBatchError(env, BATCH_MEMORY_BUDGET, err.what());
+  } catch (std::bad_alloc &err) {
+    return createBatchError(env, BATCH_GENERIC, "Not enough memory to encode this image");
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    return createBatchError(env, BATCH_GENERIC, "Error: " + m1);
+  }
+}
+
+/**
+ * Hands results to the java callback on the calling thread and keeps the batch statistics
+ */
+class JxlBatchDelivery {
+ public:
+  JxlBatchDelivery(JNIEnv *env, jobject callback) : env(env), callback(callback) {
+    jclass callbackClass = env->GetObjectClass(callback);
+    onEncoded = env->GetMethodID(callbackClass, "onEncoded", "(I[B)V");
+    onError = env->GetMethodID(callbackClass, "onError", "(ILjava/lang/Throwable;)V");
+    env->DeleteLocalRef(callbackClass);
+  }
+
+  /**
+   * @return false when the callback has thrown, the exception is left pending
+   */
+  bool deliver(JxlBatchEncodeItem &item) {
+    if (item.error != BATCH_NO_ERROR) {
+      return fail(item.index, createBatchError(env, item.error, item.errorMessage));
+    }
+    jbyteArray data = NewByteArrayFromSink(env, item.sink);
+    if (data == nullptr) {
+      jthrowable error = env->ExceptionOccurred();
+      env->ExceptionClear();
+      return fail(item.index, error);
+    }
+    succeeded += 1;
+    encodedBytes += static_cast<jlong>(item.sink.size());
+    encodedPixels += static_cast<jlong>(item.width) * static_cast<jlong>(item.height);
+    env->CallVoidMethod(callback, onEncoded, item.index, data);
+    env->DeleteLocalRef(data);
+    return !env->ExceptionCheck();
+  }
+
+  bool fail(jsize index, jthrowable error) {
+    failed += 1;
+    env->CallVoidMethod(callback, onError, index, error);
+    env->DeleteLocalRef(error);
+    return !env->ExceptionCheck();
+  }
+
+  jlong succeeded = 0;
+  jlong failed = 0;
+  jlong encodedPixels = 0;
+  jlong encodedBytes = 0;
+
+ private:
+  JNIEnv *env;
+  jobject callback;
+  jmethodID onEncoded;
+  jmethodID onError;
+};
+
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeBatchImpl(JNIEnv *env, jobject thiz,
+                                                  jobjectArray bitmaps, jobjectArray buffers,
+                                                  jintArray fds, jlongArray offsets,
+                                                  jintArray widths, jintArray heights,
+                                                  jintArray strides, jintArray layouts,
+                                                  jbooleanArray premultiplied,
+                                                  jobjectArray colorProfiles, jintArray dataSpaces,
+                                                  jint javaColorSpace, jint javaCompressionOption,
+                                                  jint effort, jint jQuality, jint decodingSpeed,
+                                                  jint javaProfile, jlong maxInFlightBytes,
+                                                  jobject callback, jlong cancellationToken,
+                                                  jlongArray stats) {
+  auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+  if (compressionOption != lossy && compressionOption != loseless) {
+    throwInvalidCompressionOptionException(env);
+    return;
+  }
+  if (effort < 0 || effort > 10) {
+    throwInvalidCompressionOptionException(env);
+    return;
+  }
+  if (jQuality < 0 || jQuality > 100) {
+    std::string exc = "Quality must be in 0...100";
+    throwException(env, exc);
+    return;
+  }
+  if (javaProfile != PROFILE_DEFAULT && javaProfile != PROFILE_PROGRESSIVE) {
+    throwInvalidCompressionOptionException(env);
+    return;
+  }
+  // Raw sources are encoded in chunks, there is no pass over the whole image to analyze it
+  auto rawColorspace = javaColorSpace == JXL_CHANNELS_AUTO ? rgba
+                                                           : static_cast<JxlColorPixelType>(javaColorSpace);
+  if (rawColorspace != rgb && rawColorspace != rgba && rawColorspace != mono) {
+    throwInvalidColorSpaceException(env);
+    return;
+  }
+
+  auto token = cancellationTokenFromHandle(cancellationToken);
+  // Fires together with the caller's token, or when the callback has thrown
+  auto batchToken = std::make_shared<concurrency::CancellationToken>(token);
+  concurrency::CancellationScope cancellationScope(batchToken);
+
+  const JxlBatchEncodeOptions options = {
+      .rawColorspace = rawColorspace,
+      .compressionOption = compressionOption,
+      .effort = effort,
+      .quality = jQuality,
+      .decodingSpeed = decodingSpeed,
+      .profile = static_cast<JxlEncodingProfile>(javaProfile),
+  };
+
+  JxlBatchCompletion completion;
+  size_t inFlight = 0;
+  // Workers reference the completion queue and the source buffers, they must be done before returning
+  auto waitForWorkers = [&]() {
+    while (inFlight > 0) {
+      completion.take();
+      inFlight -= 1;
+    }
+  };
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+
+    jsize count = env->GetArrayLength(widths);
+    std::vector<jint> descriptors(count), itemWidths(count), itemHeights(count), itemStrides(count),
+        itemLayouts(count), itemDataSpaces(count);
+    std::vector<jlong> itemOffsets(count);
+    std::vector<jboolean> itemPremultiplied(count);
+    env->GetIntArrayRegion(fds, 0, count, descriptors.data());
+    env->GetLongArrayRegion(offsets, 0, count, itemOffsets.data());
+    env->GetIntArrayRegion(widths, 0, count, itemWidths.data());
+    env->GetIntArrayRegion(heights, 0, count, itemHeights.data());
+    env->GetIntArrayRegion(strides, 0, count, itemStrides.data());
+    env->GetIntArrayRegion(layouts, 0, count, itemLayouts.data());
+    env->GetBooleanArrayRegion(premultiplied, 0, count, itemPremultiplied.data());
+    env->GetIntArrayRegion(dataSpaces, 0, count, itemDataSpaces.data());
+
+    auto &pool = concurrency::sharedThreadPool();
+    // Waiting on the pool from one of its workers would deadlock, so encode inline there
+    const bool inlineEncoding = pool.isWorkerThread();
+    // Images share the cores, a small batch still keeps every core busy
+    const uint32_t threadsPerImage = inlineEncoding ? 0 : std::max(
+        1u, pool.size() / std::max(1u, std::min(static_cast<uint32_t>(count), pool.size())));
+    const uint64_t inFlightLimit = maxInFlightBytes > 0 ? static_cast<uint64_t>(maxInFlightBytes) : 0;
+
+    JxlBatchDelivery delivery(env, callback);
+    uint64_t inFlightBytes = 0;
+    bool callbackFailed = false;
+
+    auto deliverNext = [&]() {
+      auto item = completion.take();
+      inFlight -= 1;
+      inFlightBytes -= item->cost;
+      // After cancellation only finished images are delivered, the call itself reports it
+      if (callbackFailed || (item->error == BATCH_CANCELLED && batchToken->isCancelled())) {
+        return;
+      }
+      if (!delivery.deliver(*item)) {
+        callbackFailed = true;
+        batchToken->cancel();
+      }
+    };
+
+    for (jsize i = 0; i < count && !batchToken->isCancelled(); ++i) {
+      auto item = std::make_unique<JxlBatchEncodeItem>();
+      item->index = i;
+      item->fd = descriptors[i];
+      item->offset = itemOffsets[i];
+      item->width = static_cast<uint32_t>(std::max(itemWidths[i], 0));
+      item->height = static_cast<uint32_t>(std::max(itemHeights[i], 0));
+      item->stride = static_cast<uint32_t>(std::max(itemStrides[i], 0));
+      item->layout = static_cast<coder::JxlSourceLayout>(itemLayouts[i]);
+      item->premultiplied = itemPremultiplied[i];
+
+      jobject bitmap = env->GetObjectArrayElement(bitmaps, i);
+      jthrowable failure;
+      if (bitmap != nullptr) {
+        item->cost = bitmapCost(env, bitmap);
+        // Bitmaps are converted only once there is room for them, at least one is always admitted
+        while (inFlight > 0 && inFlightLimit > 0 && inFlightBytes + item->cost > inFlightLimit) {
+          deliverNext();
+        }
+        if (callbackFailed) {
+          env->DeleteLocalRef(bitmap);
+          break;
+        }
+        auto colorProfile = reinterpret_cast<jstring>(env->GetObjectArrayElement(colorProfiles, i));
+        failure = prepareBitmapItem(env, *item, bitmap, javaColorSpace, colorProfile,
+                                    itemDataSpaces[i]);
+        if (colorProfile != nullptr) {
+          env->DeleteLocalRef(colorProfile);
+        }
+        env->DeleteLocalRef(bitmap);
+        item->width = item->image.width;
+        item->height = item->image.height;
+      } else {
+        jobject buffer = env->GetObjectArrayElement(buffers, i);
+        failure = prepareRawItem(env, *item, buffer);
+        if (buffer != nullptr) {
+          env->DeleteLocalRef(buffer);
+        }
+        while (failure == nullptr && inFlight > 0 && inFlightLimit > 0
+            && inFlightBytes + item->cost > inFlightLimit) {
+          deliverNext();
+        }
+      }
+
+      if (callbackFailed) {
+        if (failure != nullptr) {
+          env->DeleteLocalRef(failure);
+        }
+        break;
+      }
+      if (failure != nullptr) {
+        if (!delivery.fail(i, failure)) {
+          callbackFailed = true;
+          batchToken->cancel();
+        }
+        continue;
+      }
+
+      if (inlineEncoding) {
+        encodeBatchItem(*item, options, threadsPerImage);
+        inFlight += 1;
+        inFlightBytes += item->cost;
+        completion.push(std::move(item));
+        deliverNext();
+        continue;
+      }
+
+      inFlight += 1;
+      inFlightBytes += item->cost;
+      auto *completionRef = &completion;
+      auto *pending = item.release();
+      pool.submit([completionRef, pending, batchToken, options, threadsPerImage]() {
+        std::unique_ptr<JxlBatchEncodeItem> owned(pending);
+        concurrency::CancellationScope workerScope(batchToken);
+        encodeBatchItem(*owned, options, threadsPerImage);
+        completionRef->push(std::move(owned));
+      });
+    }
+
+    jthrowable callbackError = nullptr;
+    if (callbackFailed) {
+      callbackError = env->ExceptionOccurred();
+      env->ExceptionClear();
+    }
+    while (inFlight > 0) {
+      deliverNext();
+    }
+    if (callbackError != nullptr) {
+      env->Throw(callbackError);
+      return;
+    }
+    if (token != nullptr) {
+      token->throwIfCancelled();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    jlong values[5] = {static_cast<jlong>(elapsed), delivery.encodedPixels, delivery.encodedBytes,
+                       delivery.succeeded, delivery.failed};
+    env->SetLongArrayRegion(stats, 0, 5, values);
+  } catch (std::bad_alloc &err) {
+    waitForWorkers();
+    std::string errorString = "Not enough memory to encode this batch";
+    throwException(env, errorString);
+  } catch (std::runtime_error &err) {
+    waitForWorkers();
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+  } catch (concurrency::OperationCancelledException &err) {
+    waitForWorkers();
+    throwCancellationException(env, err.what());
+  }
+}
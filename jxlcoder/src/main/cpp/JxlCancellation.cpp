@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlCancellation.h"
+#include <jni.h>
+#include <memory>
+
+std::shared_ptr<concurrency::CancellationToken> cancellationTokenFromHandle(jlong handle) {
+  if (handle == 0) {
+    return nullptr;
+  }
+  auto holder = reinterpret_cast<std::shared_ptr<concurrency::CancellationToken> *>(handle);
+  return *holder;
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCancellationToken_createTokenImpl(JNIEnv *env, jobject thiz,
+                                                              jlong timeoutMillis) {
+  auto token = std::make_shared<concurrency::CancellationToken>();
+  token->setTimeout(static_cast<int64_t>(timeoutMillis));
+  auto holder = new std::shared_ptr<concurrency::CancellationToken>(token);
+  return reinterpret_cast<jlong>(holder);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCancellationToken_cancelImpl(JNIEnv *env, jobject thiz, jlong handle) {
+  auto token = cancellationTokenFromHandle(handle);
+  if (token) {
+    token->cancel();
+  }
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_awxkee_jxlcoder_JxlCancellationToken_isCancelledImpl(JNIEnv *env, jobject thiz,
+                                                              jlong handle) {
+  auto token = cancellationTokenFromHandle(handle);
+  return token && token->isCancelled() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCancellationToken_releaseTokenImpl(JNIEnv *env, jobject thiz,
+                                                               jlong handle) {
+  auto holder = reinterpret_cast<std::shared_ptr<concurrency::CancellationToken> *>(handle);
+  delete holder;
+}
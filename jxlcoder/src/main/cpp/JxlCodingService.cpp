@@ -0,0 +1,539 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlCodingService.h"
+#include <jni.h>
+#include <string>
+#include <vector>
+#include <android/log.h>
+#include <android/bitmap.h>
+#include "JniExceptions.h"
+#include "JniDecoding.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlDecoding.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlResourceGovernor.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+
+/**
+ * Attaches a pool worker to the JVM once, it is detached when the thread exits.
+ */
+static JNIEnv *attachWorkerThread(JavaVM *vm) {
+  struct WorkerAttachment {
+    JavaVM *vm = nullptr;
+    ~WorkerAttachment() {
+      if (vm) {
+        vm->DetachCurrentThread();
+      }
+    }
+  };
+  static thread_local WorkerAttachment attachment;
+  JNIEnv *env = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) {
+    return env;
+  }
+  if (vm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
+    return nullptr;
+  }
+  attachment.vm = vm;
+  return env;
+}
+
+static jthrowable takePendingException(JNIEnv *env) {
+  if (!env->ExceptionCheck()) {
+    return nullptr;
+  }
+  jthrowable throwable = env->ExceptionOccurred();
+  env->ExceptionClear();
+  return throwable;
+}
+
+static void deliverError(JNIEnv *env, const std::shared_ptr<JxlServiceJob> &job, jthrowable error) {
+  jclass callbackClass = env->GetObjectClass(job->callback);
+  jmethodID onError = env->GetMethodID(callbackClass, "onError", "(JLjava/lang/Throwable;)V");
+  env->CallVoidMethod(job->callback, onError, job->id, error);
+  if (env->ExceptionCheck()) {
+    env->ExceptionClear();
+    __android_log_print(ANDROID_LOG_ERROR, "JXLCoder", "Job callback has thrown an exception");
+  }
+  env->DeleteLocalRef(callbackClass);
+}
+
+static void deliverCancelled(JNIEnv *env, const std::shared_ptr<JxlServiceJob> &job) {
+  concurrency::OperationCancelledException cancelled(false);
+  throwCancellationException(env, cancelled.what());
+  jthrowable error = takePendingException(env);
+  deliverError(env, job, error);
+  env->DeleteLocalRef(error);
+  job->release(env);
+  env->DeleteGlobalRef(job->callback);
+}
+
+jlong JxlCodingService::enqueue(JNIEnv *env, JxlJobPriority priority, uint64_t estimatedBytes,
+                                jobject callback,
+                                std::function<jobject(JNIEnv *)> work,
+                                std::function<void(JNIEnv *)> release) {
+  std::unique_lock<std::mutex> guard(mutex);
+  if (closed) {
+    guard.unlock();
+    release(env);
+    std::string msg = "Coding service is already closed";
+    throwException(env, msg);
+    return 0;
+  }
+  auto job = std::make_shared<JxlServiceJob>();
+  job->id = nextId++;
+  job->priority = priority;
+  job->sequence = nextSequence++;
+  job->estimatedBytes = estimatedBytes;
+  job->token = std::make_shared<concurrency::CancellationToken>();
+  job->callback = env->NewGlobalRef(callback);
+  job->work = std::move(work);
+  job->release = std::move(release);
+  pending[std::make_pair(static_cast<int>(job->priority), job->sequence)] = job;
+  jobs[job->id] = job;
+  dispatchLocked();
+  return job->id;
+}
+
+bool JxlCodingService::setPriority(jlong jobId, JxlJobPriority priority) {
+  std::lock_guard<std::mutex> guard(mutex);
+  auto it = jobs.find(jobId);
+  if (it == jobs.end()) {
+    return false;
+  }
+  auto job = it->second;
+  auto key = std::make_pair(static_cast<int>(job->priority), job->sequence);
+  auto pendingIt = pending.find(key);
+  if (pendingIt == pending.end()) {
+    // Already running
+    return false;
+  }
+  pending.erase(pendingIt);
+  job->priority = priority;
+  pending[std::make_pair(static_cast<int>(job->priority), job->sequence)] = job;
+  dispatchLocked();
+  return true;
+}
+
+bool JxlCodingService::cancel(JNIEnv *env, jlong jobId) {
+  std::unique_lock<std::mutex> guard(mutex);
+  auto it = jobs.find(jobId);
+  if (it == jobs.end()) {
+    return false;
+  }
+  auto job = it->second;
+  auto pendingIt = pending.find(std::make_pair(static_cast<int>(job->priority), job->sequence));
+  if (pendingIt == pending.end()) {
+    // Running job observes the token and reports cancellation through its callback
+    job->token->cancel();
+    return true;
+  }
+  pending.erase(pendingIt);
+  jobs.erase(it);
+  guard.unlock();
+  deliverCancelled(env, job);
+  return true;
+}
+
+void JxlCodingService::close(JNIEnv *env) {
+  std::vector<std::shared_ptr<JxlServiceJob>> dropped;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    closed = true;
+    for (auto &entry : pending) {
+      dropped.push_back(entry.second);
+      jobs.erase(entry.second->id);
+    }
+    pending.clear();
+    for (auto &entry : jobs) {
+      entry.second->token->cancel();
+    }
+  }
+  for (auto &job : dropped) {
+    deliverCancelled(env, job);
+  }
+}
+
+void JxlCodingService::dispatchLocked() {
+  while (!pending.empty() && runningJobs < maxConcurrentJobs) {
+    auto head = pending.begin();
+    auto job = head->second;
+    // Strict priority: a large head job waits for memory instead of being overtaken
+    if (runningJobs > 0 && inFlightBytes + job->estimatedBytes > maxInFlightBytes) {
+      break;
+    }
+    pending.erase(head);
+    runningJobs += 1;
+    inFlightBytes += job->estimatedBytes;
+    auto self = shared_from_this();
+    concurrency::sharedThreadPool().submit([self, job]() {
+      self->run(job);
+    });
+  }
+}
+
+void JxlCodingService::run(const std::shared_ptr<JxlServiceJob> &job) {
+  JNIEnv *env = attachWorkerThread(vm);
+  if (env != nullptr) {
+    env->PushLocalFrame(16);
+    jobject result = nullptr;
+    {
+      concurrency::CancellationScope cancellationScope(job->token);
+      try {
+        job->token->throwIfCancelled();
+        result = job->work(env);
+      } catch (coder::JxlMemoryBudgetExceededException &err) {
+        throwMemoryBudgetException(env, err.what());
+      } catch (coder::JxlResourceLimitException &err) {
+        throwResourceLimitException(env, err.what());
+      } catch (std::bad_alloc &err) {
+        std::string errorString = "Not enough memory to process this image";
+        throwException(env, errorString);
+      } catch (std::runtime_error &err) {
+        std::string m1 = err.what();
+        std::string errorString = "Error: " + m1;
+        throwException(env, errorString);
+      } catch (InvalidImageSizeException &err) {
+        throwImageSizeException(env, err.what());
+      } catch (concurrency::OperationCancelledException &err) {
+        throwCancellationException(env, err.what());
+      }
+    }
+    finish(env, job, result);
+    env->PopLocalFrame(nullptr);
+  } else {
+    __android_log_print(ANDROID_LOG_ERROR, "JXLCoder", "Cannot attach worker thread to JVM");
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  runningJobs -= 1;
+  inFlightBytes -= job->estimatedBytes;
+  jobs.erase(job->id);
+  dispatchLocked();
+}
+
+void JxlCodingService::finish(JNIEnv *env, const std::shared_ptr<JxlServiceJob> &job,
+                              jobject result) {
+  jthrowable error = takePendingException(env);
+  if (error == nullptr && result == nullptr) {
+    std::string errorString = "Job has finished without result";
+    throwException(env, errorString);
+    error = takePendingException(env);
+  }
+  if (error != nullptr) {
+    deliverError(env, job, error);
+  } else {
+    jclass callbackClass = env->GetObjectClass(job->callback);
+    jmethodID onComplete = env->GetMethodID(callbackClass, "onComplete", "(JLjava/lang/Object;)V");
+    env->CallVoidMethod(job->callback, onComplete, job->id, result);
+    if (env->ExceptionCheck()) {
+      env->ExceptionClear();
+      __android_log_print(ANDROID_LOG_ERROR, "JXLCoder", "Job callback has thrown an exception");
+    }
+    env->DeleteLocalRef(callbackClass);
+  }
+  job->release(env);
+  env->DeleteGlobalRef(job->callback);
+}
+
+static std::shared_ptr<JxlCodingService> *serviceFromHandle(jlong handle) {
+  return reinterpret_cast<std::shared_ptr<JxlCodingService> *>(handle);
+}
+
+static bool resolveJobPriority(JNIEnv *env, jint javaPriority, JxlJobPriority *priority) {
+  if (javaPriority < JOB_VISIBLE || javaPriority > JOB_BACKGROUND) {
+    std::string msg = "Invalid job priority was provided";
+    throwException(env, msg);
+    return false;
+  }
+  *priority = static_cast<JxlJobPriority>(javaPriority);
+  return true;
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_createServiceImpl(JNIEnv *env, jobject thiz,
+                                                            jint maxConcurrentJobs,
+                                                            jlong maxInFlightBytes) {
+  JavaVM *vm = nullptr;
+  if (env->GetJavaVM(&vm) != JNI_OK) {
+    std::string msg = "Cannot obtain Java VM";
+    throwException(env, msg);
+    return 0;
+  }
+  auto service = std::make_shared<JxlCodingService>(vm,
+                                                    static_cast<uint32_t>(std::max(maxConcurrentJobs, 1)),
+                                                    static_cast<uint64_t>(std::max(maxInFlightBytes,
+                                                                                   static_cast<jlong>(0))));
+  return reinterpret_cast<jlong>(new std::shared_ptr<JxlCodingService>(service));
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_enqueueDecodeImpl(JNIEnv *env, jobject thiz,
+                                                            jlong handle,
+                                                            jbyteArray byteArray,
+                                                            jobject byteBuffer,
+                                                            jint scaledWidth, jint scaledHeight,
+                                                            jint preferredColorConfig,
+                                                            jint scaleMode,
+                                                            jint resizeSampler,
+                                                            jint javaToneMapper,
+                                                            jint javaPriority,
+                                                            jobject callback) {
+  try {
+    JxlJobPriority priority;
+    if (!resolveJobPriority(env, javaPriority, &priority)) {
+      return 0;
+    }
+    auto srcBuffer = std::make_shared<std::vector<uint8_t>>();
+    if (byteArray != nullptr) {
+      auto totalLength = env->GetArrayLength(byteArray);
+      srcBuffer->resize(totalLength);
+      env->GetByteArrayRegion(byteArray, 0, totalLength,
+                              reinterpret_cast<jbyte *>(srcBuffer->data()));
+    } else {
+      auto bufferAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(byteBuffer));
+      int length = (int) env->GetDirectBufferCapacity(byteBuffer);
+      if (!bufferAddress || length <= 0) {
+        std::string errorString = "Only direct byte buffers are supported";
+        throwException(env, errorString);
+        return 0;
+      }
+      srcBuffer->assign(bufferAddress, bufferAddress + length);
+    }
+
+    // Decoded RGBA plus the reformatted copy, this is an estimate used only for admission
+    uint64_t estimatedBytes = 0;
+    size_t xsize = 0, ysize = 0;
+    if (DecodeBasicInfo(srcBuffer->data(), srcBuffer->size(), &xsize, &ysize)) {
+      estimatedBytes = static_cast<uint64_t>(xsize) * static_cast<uint64_t>(ysize) * 4 * 2;
+    }
+
+    auto work = [srcBuffer, scaledWidth, scaledHeight, preferredColorConfig, scaleMode,
+        resizeSampler, javaToneMapper](JNIEnv *workerEnv) -> jobject {
+      return decodeSampledImageImpl(workerEnv, *srcBuffer, scaledWidth, scaledHeight,
+                                    preferredColorConfig, scaleMode,
+                                    resizeSampler, javaToneMapper);
+    };
+    auto release = [](JNIEnv *workerEnv) {};
+    return (*serviceFromHandle(handle))->enqueue(env, priority, estimatedBytes, callback,
+                                                 work, release);
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to enqueue this image";
+    throwException(env, errorString);
+    return 0;
+  }
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_enqueueEncodeImpl(JNIEnv *env, jobject thiz,
+                                                            jlong handle,
+                                                            jobject bitmap,
+                                                            jint javaColorSpace,
+                                                            jint javaCompressionOption,
+                                                            jint effort,
+                                                            jstring bitmapColorProfile,
+                                                            jint dataSpace, jint jQuality,
+                                                            jint decodingSpeed,
+                                                            jint javaPriority,
+                                                            jobject callback) {
+  JxlJobPriority priority;
+  if (!resolveJobPriority(env, javaPriority, &priority)) {
+    return 0;
+  }
+  AndroidBitmapInfo info;
+  uint64_t estimatedBytes = 0;
+  // Bitmap copy, converted pixels and packed pixels
+  if (AndroidBitmap_getInfo(env, bitmap, &info) >= 0) {
+    estimatedBytes = static_cast<uint64_t>(info.stride) * static_cast<uint64_t>(info.height) * 3;
+  }
+
+  jobject bitmapRef = env->NewGlobalRef(bitmap);
+  jobject profileRef = bitmapColorProfile != nullptr ? env->NewGlobalRef(bitmapColorProfile) : nullptr;
+
+  auto work = [bitmapRef, profileRef, javaColorSpace, javaCompressionOption, effort,
+      dataSpace, jQuality, decodingSpeed](JNIEnv *workerEnv) -> jobject {
+    return encodeBitmapImpl(workerEnv, bitmapRef, javaColorSpace, javaCompressionOption, effort,
+                            reinterpret_cast<jstring>(profileRef), dataSpace, jQuality,
+                            decodingSpeed, PROFILE_DEFAULT);
+  };
+  auto release = [bitmapRef, profileRef](JNIEnv *workerEnv) {
+    workerEnv->DeleteGlobalRef(bitmapRef);
+    if (profileRef) {
+      workerEnv->DeleteGlobalRef(profileRef);
+    }
+  };
+  return (*serviceFromHandle(handle))->enqueue(env, priority, estimatedBytes, callback,
+                                               work, release);
+}
+
+static std::shared_ptr<JxlBitmapPixels> *pixelsFromHandle(jlong handle) {
+  return reinterpret_cast<std::shared_ptr<JxlBitmapPixels> *>(handle);
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_encodeInstantImpl(JNIEnv *env, jobject thiz,
+                                                            jobject bitmap,
+                                                            jint javaColorSpace,
+                                                            jint javaCompressionOption,
+                                                            jint effort,
+                                                            jstring bitmapColorProfile,
+                                                            jint dataSpace, jint jQuality,
+                                                            jint decodingSpeed,
+                                                            jlongArray pixelsHandle) {
+  try {
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (compressionOption != lossy && compressionOption != loseless) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    auto image = std::make_shared<JxlBitmapPixels>();
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace, *image)) {
+      return nullptr;
+    }
+    coder::JxlBlockOutputSink sink;
+    if (!EncodeBitmapPixels(*image, compressionOption, effort, jQuality, decodingSpeed,
+                            PROFILE_DEFAULT, sink, 0)) {
+      throwCantCompressImage(env);
+      return nullptr;
+    }
+    jbyteArray instant = NewByteArrayFromSink(env, sink);
+    if (instant == nullptr) {
+      return nullptr;
+    }
+    // Converted pixels are kept for the replacement job, ownership passes to enqueueEncodePixelsImpl
+    jlong handle = reinterpret_cast<jlong>(new std::shared_ptr<JxlBitmapPixels>(std::move(image)));
+    env->SetLongArrayRegion(pixelsHandle, 0, 1, &handle);
+    return instant;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_enqueueEncodePixelsImpl(JNIEnv *env, jobject thiz,
+                                                                  jlong handle,
+                                                                  jlong pixelsHandle,
+                                                                  jint javaCompressionOption,
+                                                                  jint effort, jint jQuality,
+                                                                  jint decodingSpeed,
+                                                                  jint javaPriority,
+                                                                  jobject callback) {
+  auto holder = pixelsFromHandle(pixelsHandle);
+  std::shared_ptr<JxlBitmapPixels> image = std::move(*holder);
+  delete holder;
+
+  JxlJobPriority priority;
+  if (!resolveJobPriority(env, javaPriority, &priority)) {
+    return 0;
+  }
+  if (effort < 0 || effort > 10) {
+    throwInvalidCompressionOptionException(env);
+    return 0;
+  }
+  auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+  // Converted pixels are held until the job is done, the encoder itself is not accounted
+  const uint64_t estimatedBytes = image->pixels.size();
+
+  auto work = [image, compressionOption, effort, jQuality,
+      decodingSpeed](JNIEnv *workerEnv) -> jobject {
+    coder::JxlBlockOutputSink sink;
+    if (!EncodeBitmapPixels(*image, compressionOption, effort, jQuality, decodingSpeed,
+                            PROFILE_DEFAULT, sink, 0)) {
+      throwCantCompressImage(workerEnv);
+      return nullptr;
+    }
+    return NewByteArrayFromSink(workerEnv, sink);
+  };
+  auto release = [](JNIEnv *workerEnv) {};
+  return (*serviceFromHandle(handle))->enqueue(env, priority, estimatedBytes, callback,
+                                               work, release);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_releasePixelsImpl(JNIEnv *env, jobject thiz,
+                                                            jlong pixelsHandle) {
+  delete pixelsFromHandle(pixelsHandle);
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_setPriorityImpl(JNIEnv *env, jobject thiz, jlong handle,
+                                                          jlong jobId, jint javaPriority) {
+  JxlJobPriority priority;
+  if (!resolveJobPriority(env, javaPriority, &priority)) {
+    return JNI_FALSE;
+  }
+  return (*serviceFromHandle(handle))->setPriority(jobId, priority) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_cancelImpl(JNIEnv *env, jobject thiz, jlong handle,
+                                                     jlong jobId) {
+  return (*serviceFromHandle(handle))->cancel(env, jobId) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlCodingService_closeAndReleaseServiceImpl(JNIEnv *env, jobject thiz,
+                                                                     jlong handle) {
+  auto service = serviceFromHandle(handle);
+  (*service)->close(env);
+  // Running jobs keep their own reference and release the service once they are done
+  delete service;
+}
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_JXLCODINGSERVICE_H
+#define JXLCODER_JXLCODINGSERVICE_H
+
+#include <jni.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "cancellation.hpp"
+
+enum JxlJobPriority {
+  JOB_VISIBLE = 0,
+  JOB_PREFETCH = 1,
+  JOB_BACKGROUND = 2,
+};
+
+struct JxlServiceJob {
+  jlong id;
+  JxlJobPriority priority;
+  uint64_t sequence;
+  uint64_t estimatedBytes;
+  std::shared_ptr<concurrency::CancellationToken> token;
+  // Global reference to JxlJobCallback
+  jobject callback;
+  // Produces a local reference result, or returns nullptr with a pending java exception
+  std::function<jobject(JNIEnv *)> work;
+  // Releases global references captured by the job, called exactly once
+  std::function<void(JNIEnv *)> release;
+};
+
+/**
+ * Schedules decode and encode jobs on the shared thread pool.
+ * Pending jobs are ordered by priority then by submission order, a job is started only when
+ * the concurrent jobs limit and the in-flight memory budget allow it.
+ * A job exceeding the budget alone is still started when nothing else runs, so it can't starve.
+ */
+class JxlCodingService : public std::enable_shared_from_this<JxlCodingService> {
+ public:
+  JxlCodingService(JavaVM *vm, uint32_t maxConcurrentJobs, uint64_t maxInFlightBytes)
+      : vm(vm), maxConcurrentJobs(std::max(maxConcurrentJobs, 1u)),
+        maxInFlightBytes(maxInFlightBytes), nextId(1), nextSequence(0),
+        runningJobs(0), inFlightBytes(0), closed(false) {
+
+  }
+
+  jlong enqueue(JNIEnv *env, JxlJobPriority priority, uint64_t estimatedBytes, jobject callback,
+                std::function<jobject(JNIEnv *)> work,
+                std::function<void(JNIEnv *)> release);
+
+  bool setPriority(jlong jobId, JxlJobPriority priority);
+
+  bool cancel(JNIEnv *env, jlong jobId);
+
+  void close(JNIEnv *env);
+
+ private:
+  void dispatchLocked();
+
+  void run(const std::shared_ptr<JxlServiceJob> &job);
+
+  void finish(JNIEnv *env, const std::shared_ptr<JxlServiceJob> &job, jobject result);
+
+  JavaVM *vm;
+  uint32_t maxConcurrentJobs;
+  uint64_t maxInFlightBytes;
+  jlong nextId;
+  uint64_t nextSequence;
+  uint32_t runningJobs;
+  uint64_t inFlightBytes;
+  bool closed;
+  std::mutex mutex;
+  std::map<std::pair<int, uint64_t>, std::shared_ptr<JxlServiceJob>> pending;
+  std::unordered_map<jlong, std::shared_ptr<JxlServiceJob>> jobs;
+};
+
+#endif //JXLCODER_JXLCODINGSERVICE_H
@@ -27,6 +27,7 @@
  */
 
 #include <jni.h>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <inttypes.h>
@@ -36,7 +37,10 @@
 #include "interop/JxlEncoding.h"
 #include <android/data_space.h>
 #include "interop/JxlDefinitions.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlThroughputModel.hpp"
 #include <jxl/encode.h>
+#include "thread_parallel_runner.h"
 #include "colorspaces/ColorSpaceProfile.h"
 #include "conversion/RgbChannels.h"
 #include "imagebit/RGBAlpha.h"
@@ -44,359 +48,502 @@
 #include "imagebit/Rgb565.h"
 #include "imagebit/RgbaToRgb.h"
 #include "imagebit/Rgb1010102.h"
-#include "imagebit/RgbaF16bitToNBitU16.h"
+#include "imagebit/RgbaPack.h"
+#include "imagebit/RgbaF16bitNBitU8.h"
+#include "imagebit/ScanAlpha.h"
+#include "JxlCancellation.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
 
 using namespace std;
 
-extern "C"
-JNIEXPORT jbyteArray JNICALL
-Java_com_awxkee_jxlcoder_JxlCoder_encodeImpl(JNIEnv *env, jobject thiz, jobject bitmap,
-                                             jint javaColorSpace, jint javaCompressionOption,
-                                             jint effort, jstring bitmapColorProfile,
-                                             jint dataSpace, jint jQuality, jint decodingSpeed) {
-  try {
-    auto colorspace = static_cast<JxlColorPixelType>(javaColorSpace);
-    if (!colorspace) {
-      throwInvalidColorSpaceException(env);
-      return static_cast<jbyteArray>(nullptr);
-    }
-    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
-    if (!compressionOption) {
-      throwInvalidCompressionOptionException(env);
-      return static_cast<jbyteArray>(nullptr);
-    }
+JxlColorEncoding ResolveBitmapColorEncoding(JNIEnv *env, jstring bitmapColorProfile,
+                                            jint dataSpace, bool isImageMono) {
+  JxlColorEncoding colorEncoding = {};
 
-    if (effort < 0 || effort > 10) {
-      throwInvalidCompressionOptionException(env);
-      return static_cast<jbyteArray>(nullptr);
-    }
+  if (bitmapColorProfile || dataSpace != -1) {
+    const char *utf8String = env->GetStringUTFChars(bitmapColorProfile, nullptr);
+    std::string stdString(utf8String);
+    env->ReleaseStringUTFChars(bitmapColorProfile, utf8String);
 
-    if (jQuality < 0 || jQuality > 100) {
-      std::string exc = "Quality must be in 0...100";
-      throwException(env, exc);
-      return static_cast<jbyteArray>(nullptr);
+    if (stdString == "Rec. ITU-R BT.709-5" || dataSpace == ADataSpace::ADATASPACE_BT709) {
+      auto matrix = getRec709Primaries();
+      auto illuminant = getIlluminantD65();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {illuminant.x(), illuminant.y()},
+          .primaries = JXL_PRIMARIES_SRGB,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_709,
+      };
+    } else if (stdString == "Rec. ITU-R BT.2020-1" ||
+        dataSpace == ADataSpace::ADATASPACE_BT2020) {
+      auto matrix = getRec2020Primaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_2100,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_709,
+      };
+    } else if (stdString == "Display P3" ||
+        dataSpace == ADataSpace::ADATASPACE_DISPLAY_P3) {
+      auto matrix = getDisplayP3Primaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_CUSTOM,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_SRGB,
+          .gamma = 1 / 2.2
+      };
+    } else if (stdString == "sRGB IEC61966-2.1 (Linear)" ||
+        dataSpace == ADataSpace::ADATASPACE_SCRGB_LINEAR) {
+      auto matrix = getRec709Primaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_SRGB,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_LINEAR
+      };
+    } else if (stdString == "Perceptual Quantizer encoding" ||
+        (dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_PQ ||
+            dataSpace == ADataSpace::ADATASPACE_BT2020_HLG ||
+            dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_HLG)) {
+      auto matrix = getRec2020Primaries();
+      JxlTransferFunction function = JXL_TRANSFER_FUNCTION_PQ;
+      if (dataSpace == ADataSpace::ADATASPACE_BT2020_HLG ||
+          dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_HLG) {
+        function = JXL_TRANSFER_FUNCTION_HLG;
+      }
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_2100,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = function,
+      };
+    } else if (stdString == "Adobe RGB (1998)" ||
+        dataSpace == ADataSpace::ADATASPACE_ADOBE_RGB) {
+      auto matrix = getAdobeRGBPrimaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_CUSTOM,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_GAMMA,
+          .gamma = 256.0 / 563.0
+      };
+    } else if (stdString == "SMPTE RP 431-2-2007 DCI (P3)" ||
+        dataSpace == ADataSpace::ADATASPACE_DCI_P3) {
+      auto matrix = getDCIP3Primaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantDCI().x(), getIlluminantDCI().y()},
+          .primaries = JXL_PRIMARIES_CUSTOM,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_SRGB,
+      };
+    } else if (dataSpace == ADataSpace::ADATASPACE_BT601_525 ||
+        dataSpace == ADataSpace::ADATASPACE_BT601_625 ||
+        dataSpace == ADataSpace::ADATASPACE_JFIF) {
+      auto matrix = getBT601_525Primaries();
+      if (dataSpace == ADataSpace::ADATASPACE_BT601_625 ||
+          dataSpace == ADataSpace::ADATASPACE_JFIF) {
+        matrix = getBT601_625Primaries();
+      }
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_D65,
+          .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
+          .primaries = JXL_PRIMARIES_CUSTOM,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_709
+      };
+    } else if (dataSpace == ADataSpace::STANDARD_BT470M) {
+      auto matrix = getBT470MPrimaries();
+      colorEncoding = {
+          .color_space = JXL_COLOR_SPACE_RGB,
+          .white_point = JXL_WHITE_POINT_CUSTOM,
+          .white_point_xy = {getIlluminantC().x(), getIlluminantC().y()},
+          .primaries = JXL_PRIMARIES_CUSTOM,
+          .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
+          .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
+          .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
+          .transfer_function = JXL_TRANSFER_FUNCTION_GAMMA,
+          .gamma = 0.45f
+      };
+    } else {
+      JxlColorEncodingSetToSRGB(&colorEncoding, isImageMono);
     }
+  } else {
+    JxlColorEncodingSetToSRGB(&colorEncoding, isImageMono);
+  }
+  return colorEncoding;
+}
 
-    AndroidBitmapInfo info;
-    if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
-      throwPixelsException(env);
-      return static_cast<jbyteArray>(nullptr);
-    }
+/**
+ * Smallest pixel type that keeps every analyzed property of the image
+ */
+static JxlColorPixelType ReducedPixelType(uint32_t content) {
+  if (content & coder::CONTENT_OPAQUE) {
+    return (content & coder::CONTENT_GRAYSCALE) ? mono : rgb;
+  }
+  return rgba;
+}
 
-    if (info.flags & ANDROID_BITMAP_FLAGS_IS_HARDWARE) {
-      std::string exc = "Hardware bitmap is not supported by JXL Coder";
-      throwException(env, exc);
-      return static_cast<jbyteArray>(nullptr);
-    }
+/**
+ * Keeps bitmap pixels locked until unlocked or the scope ends,
+ * so a conversion throwing on cancellation or allocation never leaves the bitmap locked
+ */
+class BitmapPixelsLock {
+ public:
+  BitmapPixelsLock(JNIEnv *env, jobject bitmap) : env(env), bitmap(bitmap) {}
 
-    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 &&
-        info.format != ANDROID_BITMAP_FORMAT_RGBA_F16 &&
-        info.format != ANDROID_BITMAP_FORMAT_RGBA_1010102 &&
-        info.format != ANDROID_BITMAP_FORMAT_RGB_565) {
-      string msg("Currently support encoding only RGBA_8888, RGBA_F16, RGBA_1010102, RGB_565 images pixel format");
-      throwException(env, msg);
-      return static_cast<jbyteArray>(nullptr);
+  ~BitmapPixelsLock() {
+    if (locked) {
+      AndroidBitmap_unlockPixels(env, bitmap);
     }
+  }
 
-    void *addr;
-    if (AndroidBitmap_lockPixels(env, bitmap, &addr) != 0) {
-      throwPixelsException(env);
-      return static_cast<jbyteArray>(nullptr);
-    }
+  BitmapPixelsLock(const BitmapPixelsLock &) = delete;
+  BitmapPixelsLock &operator=(const BitmapPixelsLock &) = delete;
+
+  bool lock(void **addr) {
+    locked = AndroidBitmap_lockPixels(env, bitmap, addr) == 0;
+    return locked;
+  }
+
+  bool unlock() {
+    locked = false;
+    return AndroidBitmap_unlockPixels(env, bitmap) == 0;
+  }
+
+ private:
+  JNIEnv *env;
+  jobject bitmap;
+  bool locked = false;
+};
+
+bool PrepareBitmapPixels(JNIEnv *env, jobject bitmap, jint javaColorSpace,
+                         jstring bitmapColorProfile, jint dataSpace, JxlBitmapPixels &out) {
+  const bool isAutoChannels = javaColorSpace == JXL_CHANNELS_AUTO;
+  auto colorspace = isAutoChannels ? rgba : static_cast<JxlColorPixelType>(javaColorSpace);
+  if (!colorspace) {
+    throwInvalidColorSpaceException(env);
+    return false;
+  }
+
+  AndroidBitmapInfo info;
+  if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+    throwPixelsException(env);
+    return false;
+  }
 
-    vector<uint8_t> rgbaPixels(info.stride * info.height);
-    memcpy(rgbaPixels.data(), addr, info.stride * info.height);
+  if (info.flags & ANDROID_BITMAP_FLAGS_IS_HARDWARE) {
+    std::string exc = "Hardware bitmap is not supported by JXL Coder";
+    throwException(env, exc);
+    return false;
+  }
+
+  if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 &&
+      info.format != ANDROID_BITMAP_FORMAT_RGBA_F16 &&
+      info.format != ANDROID_BITMAP_FORMAT_RGBA_1010102 &&
+      info.format != ANDROID_BITMAP_FORMAT_RGB_565) {
+    string msg("Currently support encoding only RGBA_8888, RGBA_F16, RGBA_1010102, RGB_565 images pixel format");
+    throwException(env, msg);
+    return false;
+  }
+
+  bool useFloat16 = info.format == ANDROID_BITMAP_FORMAT_RGBA_F16 ||
+      info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102;
+
+  pooled_uint8_vector &rgbPixels = out.pixels;
+  const bool isPackedFromBitmap = info.format == ANDROID_BITMAP_FORMAT_RGBA_8888;
+
+  void *addr;
+  BitmapPixelsLock pixelsLock(env, bitmap);
+  if (!pixelsLock.lock(&addr)) {
+    throwPixelsException(env);
+    return false;
+  }
 
-    if (AndroidBitmap_unlockPixels(env, bitmap) != 0) {
+  if (isPackedFromBitmap) {
+    if (isAutoChannels) {
+      // Premultiplied equal channels stay equal once unassociated
+      colorspace = ReducedPixelType(coder::AnalyzeRgba8(reinterpret_cast<const uint8_t *>(addr),
+                                                        info.stride, info.width, info.height,
+                                                        coder::CONTENT_OPAQUE
+                                                            | coder::CONTENT_GRAYSCALE));
+    }
+    const uint32_t packedChannels = colorspace == mono ? 1 : (colorspace == rgb ? 3 : 4);
+    rgbPixels.resize(static_cast<size_t>(info.width) * packedChannels * info.height);
+    // Unassociates alpha and drops channels in a single pass straight from the bitmap memory
+    coder::PackRgba8(reinterpret_cast<const uint8_t *>(addr), info.stride,
+                     rgbPixels.data(), info.width * packedChannels,
+                     info.width, info.height, packedChannels, true);
+    if (!pixelsLock.unlock()) {
       string exc = "Unlocking pixels has failed";
       throwException(env, exc);
-      return static_cast<jbyteArray>(nullptr);
+      return false;
     }
-
+  } else {
+    // Every conversion reads straight from the locked bitmap, F16 is handed to libjxl as is
+    pooled_uint8_vector rgbaPixels;
+    auto source = reinterpret_cast<const uint8_t *>(addr);
     uint32_t imageStride = info.stride;
 
     if (info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102) {
       imageStride = info.width * 4 * sizeof(uint16_t);
-      vector<uint8_t> halfFloatPixels(imageStride * info.height);
-      coder::RGBA1010102ToUnsigned(reinterpret_cast<const uint8_t *>(rgbaPixels.data()), info.stride,
-                                   reinterpret_cast<uint16_t *>(halfFloatPixels.data()), imageStride,
-                                   info.width, info.height, 16);
-      rgbaPixels = halfFloatPixels;
+      rgbaPixels.resize(static_cast<size_t>(imageStride) * info.height);
+      coder::RGBA1010102ToF16(source, info.stride,
+                              reinterpret_cast<uint16_t *>(rgbaPixels.data()), imageStride,
+                              info.width, info.height);
+      source = rgbaPixels.data();
     } else if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
-      uint32_t
-          newStride = info.width * 4 * (uint32_t)
-      sizeof(uint8_t);
-      std::vector<uint8_t> rgba8888Pixels(newStride * info.height);
-      coder::Rgb565ToUnsigned8(reinterpret_cast<uint16_t *>(rgbaPixels.data()),
+      imageStride = info.width * 4 * sizeof(uint8_t);
+      rgbaPixels.resize(static_cast<size_t>(imageStride) * info.height);
+      coder::Rgb565ToUnsigned8(reinterpret_cast<const uint16_t *>(source),
                                (uint32_t) info.stride,
-                               rgba8888Pixels.data(), newStride,
+                               rgbaPixels.data(), imageStride,
                                (uint32_t) info.width, (uint32_t) info.height, 255);
-      imageStride = newStride;
-      rgbaPixels = rgba8888Pixels;
-    } else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
-      coder::UnassociateRgba8(rgbaPixels.data(), imageStride,
-                              rgbaPixels.data(), imageStride,
-                              (uint32_t) info.width,
-                              (uint32_t) info.height);
-    } else if (info.format == ANDROID_BITMAP_FORMAT_RGBA_F16) {
-      uint32_t
-          newStride = info.width * 4 * (uint32_t)
-      sizeof(uint16_t);
-      std::vector<uint8_t> rgbau16Pixels(newStride * info.height);
-      coder::RGBAF16BitToNBitU16(reinterpret_cast<uint16_t *>(rgbaPixels.data()),
-                                 (uint32_t) info.stride,
-                                 reinterpret_cast<uint16_t *>(rgbau16Pixels.data()), newStride,
-                                 (uint32_t) info.width, (uint32_t) info.height, 16);
-      imageStride = newStride;
-      rgbaPixels = rgbau16Pixels;
+      source = rgbaPixels.data();
     }
 
-    bool useFloat16 = info.format == ANDROID_BITMAP_FORMAT_RGBA_F16 ||
-        info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102;
-
-    const bool isImageMono = colorspace == mono;
+    if (isAutoChannels) {
+      uint32_t content = useFloat16
+                         ? coder::AnalyzeRgbaF16(reinterpret_cast<const uint16_t *>(source),
+                                                 imageStride, info.width, info.height,
+                                                 coder::CONTENT_ALL)
+                         : coder::AnalyzeRgba8(source, imageStride, info.width, info.height,
+                                               coder::CONTENT_ALL);
+      colorspace = ReducedPixelType(content);
+      if (useFloat16 && (content & coder::CONTENT_8_BIT)) {
+        // Half floats holding only 8-bit levels are encoded as 8-bit
+        uint32_t u8Stride = info.width * 4 * sizeof(uint8_t);
+        pooled_uint8_vector u8Pixels(static_cast<size_t>(u8Stride) * info.height);
+        coder::RGBAF16BitToNBitU8(reinterpret_cast<const uint16_t *>(source), imageStride,
+                                  u8Pixels.data(), u8Stride, info.width, info.height, 8, false);
+        rgbaPixels = std::move(u8Pixels);
+        source = rgbaPixels.data();
+        imageStride = u8Stride;
+        useFloat16 = false;
+      }
+    }
 
-    std::vector<uint8_t> rgbPixels;
+    const uint32_t packedChannels = colorspace == mono ? 1 : (colorspace == rgb ? 3 : 4);
+    const uint32_t sampleSize = useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t);
+    const uint32_t requiredStride = info.width * packedChannels * sampleSize;
     switch (colorspace) {
       case mono: {
-        int requiredStride = (int) info.width * 1 *
-            (int) (useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t));
-        rgbPixels.resize(info.height * requiredStride);
+        rgbPixels.resize(static_cast<size_t>(requiredStride) * info.height);
         if (useFloat16) {
-          coder::RGBAPickChannel(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                                 (int) imageStride,
-                                 reinterpret_cast<uint16_t *>(rgbPixels.data()),
-                                 (int) requiredStride,
-                                 (int) info.width, (int) info.height, 0);
+          coder::RGBAPickChannel(reinterpret_cast<const uint16_t *>(source), imageStride,
+                                 reinterpret_cast<uint16_t *>(rgbPixels.data()), requiredStride,
+                                 info.width, info.height, 0);
         } else {
-          coder::RGBAPickChannel(reinterpret_cast<const uint8_t *>(rgbaPixels.data()), static_cast<int>(imageStride),
-                                 reinterpret_cast<uint8_t *>(rgbPixels.data()),
-                                 static_cast<int>(requiredStride),
-                                 static_cast<int>(info.width),
-                                 static_cast<int>(info.height), 0);
+          coder::RGBAPickChannel(source, imageStride, rgbPixels.data(), requiredStride,
+                                 info.width, info.height, 0);
         }
-        imageStride = requiredStride;
       }
         break;
       case rgb: {
-        uint32_t requiredStride = (uint32_t) info.width * 3 * (uint32_t)(useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t));
-        rgbPixels.resize(info.height * requiredStride);
+        rgbPixels.resize(static_cast<size_t>(requiredStride) * info.height);
         if (useFloat16) {
-          coder::Rgba16ToRgb16(reinterpret_cast<const uint16_t *>(rgbaPixels.data()),
-                               imageStride,
-                               reinterpret_cast<uint16_t *>(rgbPixels.data()),
-                               requiredStride,
+          coder::Rgba16ToRgb16(reinterpret_cast<const uint16_t *>(source), imageStride,
+                               reinterpret_cast<uint16_t *>(rgbPixels.data()), requiredStride,
                                info.width, info.height);
         } else {
-          coder::Rgba8ToRgb8(reinterpret_cast<const uint8_t *>(rgbaPixels.data()), static_cast<int>(imageStride),
-                             reinterpret_cast<uint8_t *>(rgbPixels.data()),
-                             static_cast<int>(requiredStride),
-                             static_cast<int>(info.width),
-                             static_cast<int>(info.height));
+          coder::Rgba8ToRgb8(source, imageStride, rgbPixels.data(), requiredStride,
+                             info.width, info.height);
         }
-        imageStride = requiredStride;
       }
         break;
       case rgba: {
-        int requiredStride = (int) info.width * 4 *
-            (int) (useFloat16 ? sizeof(uint16_t) : sizeof(uint8_t));
-        if (requiredStride == imageStride) {
-          rgbPixels = rgbaPixels;
+        if (requiredStride == imageStride && source == rgbaPixels.data()) {
+          rgbPixels = std::move(rgbaPixels);
         } else {
-          rgbPixels.resize(requiredStride * (int) info.height);
-          if (useFloat16) {
-            coder::CopyUnaligned(reinterpret_cast<uint16_t *>(rgbaPixels.data()), imageStride,
-                                 reinterpret_cast<uint16_t *>(rgbPixels.data()), requiredStride,
-                                 (uint32_t) info.width * 4,
-                                 (uint32_t) info.height);
-          } else {
-            coder::CopyUnaligned(rgbaPixels.data(), imageStride, rgbPixels.data(),
-                                 requiredStride,
-                                 (uint32_t) info.width * 4,
-                                 (uint32_t) info.height);
-          }
+          rgbPixels.resize(static_cast<size_t>(requiredStride) * info.height);
+          coder::CopyUnaligned(source, imageStride, rgbPixels.data(), requiredStride,
+                               info.width * 4 * sampleSize, info.height);
         }
-        imageStride = requiredStride;
       }
         break;
     }
 
     rgbaPixels.clear();
 
-    std::vector<uint8_t> compressedVector;
-
-    JxlColorEncoding colorEncoding = {};
-
-    if (bitmapColorProfile || dataSpace != -1) {
-      const char *utf8String = env->GetStringUTFChars(bitmapColorProfile, nullptr);
-      std::string stdString(utf8String);
-      env->ReleaseStringUTFChars(bitmapColorProfile, utf8String);
-
-      if (stdString == "Rec. ITU-R BT.709-5" || dataSpace == ADataSpace::ADATASPACE_BT709) {
-        auto matrix = getRec709Primaries();
-        auto illuminant = getIlluminantD65();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {illuminant.x(), illuminant.y()},
-            .primaries = JXL_PRIMARIES_SRGB,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_709,
-        };
-      } else if (stdString == "Rec. ITU-R BT.2020-1" ||
-          dataSpace == ADataSpace::ADATASPACE_BT2020) {
-        auto matrix = getRec2020Primaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_2100,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_709,
-        };
-      } else if (stdString == "Display P3" ||
-          dataSpace == ADataSpace::ADATASPACE_DISPLAY_P3) {
-        auto matrix = getDisplayP3Primaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_CUSTOM,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_SRGB,
-            .gamma = 1 / 2.2
-        };
-      } else if (stdString == "sRGB IEC61966-2.1 (Linear)" ||
-          dataSpace == ADataSpace::ADATASPACE_SCRGB_LINEAR) {
-        auto matrix = getRec709Primaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_SRGB,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_LINEAR
-        };
-      } else if (stdString == "Perceptual Quantizer encoding" ||
-          (dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_PQ ||
-              dataSpace == ADataSpace::ADATASPACE_BT2020_HLG ||
-              dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_HLG)) {
-        auto matrix = getRec2020Primaries();
-        JxlTransferFunction function = JXL_TRANSFER_FUNCTION_PQ;
-        if (dataSpace == ADataSpace::ADATASPACE_BT2020_HLG ||
-            dataSpace == ADataSpace::ADATASPACE_BT2020_ITU_HLG) {
-          function = JXL_TRANSFER_FUNCTION_HLG;
-        }
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_2100,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = function,
-        };
-      } else if (stdString == "Adobe RGB (1998)" ||
-          dataSpace == ADataSpace::ADATASPACE_ADOBE_RGB) {
-        auto matrix = getAdobeRGBPrimaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_CUSTOM,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_GAMMA,
-            .gamma = 256.0 / 563.0
-        };
-      } else if (stdString == "SMPTE RP 431-2-2007 DCI (P3)" ||
-          dataSpace == ADataSpace::ADATASPACE_DCI_P3) {
-        auto matrix = getDCIP3Primaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantDCI().x(), getIlluminantDCI().y()},
-            .primaries = JXL_PRIMARIES_CUSTOM,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_SRGB,
-        };
-      } else if (dataSpace == ADataSpace::ADATASPACE_BT601_525 ||
-          dataSpace == ADataSpace::ADATASPACE_BT601_625 ||
-          dataSpace == ADataSpace::ADATASPACE_JFIF) {
-        auto matrix = getBT601_525Primaries();
-        if (dataSpace == ADataSpace::ADATASPACE_BT601_625 ||
-            dataSpace == ADataSpace::ADATASPACE_JFIF) {
-          matrix = getBT601_625Primaries();
-        }
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_D65,
-            .white_point_xy = {getIlluminantD65().x(), getIlluminantD65().y()},
-            .primaries = JXL_PRIMARIES_CUSTOM,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_709
-        };
-      } else if (dataSpace == ADataSpace::STANDARD_BT470M) {
-        auto matrix = getBT470MPrimaries();
-        colorEncoding = {
-            .color_space = JXL_COLOR_SPACE_RGB,
-            .white_point = JXL_WHITE_POINT_CUSTOM,
-            .white_point_xy = {getIlluminantC().x(), getIlluminantC().y()},
-            .primaries = JXL_PRIMARIES_CUSTOM,
-            .primaries_red_xy = {matrix(0, 0), matrix(0, 1)},
-            .primaries_green_xy = {matrix(1, 0), matrix(1, 1)},
-            .primaries_blue_xy = {matrix(2, 0), matrix(2, 1)},
-            .transfer_function = JXL_TRANSFER_FUNCTION_GAMMA,
-            .gamma = 0.45f
-        };
-      } else {
-        JxlColorEncodingSetToSRGB(&colorEncoding, isImageMono);
-      }
-    } else {
-      JxlColorEncodingSetToSRGB(&colorEncoding, isImageMono);
+    if (!pixelsLock.unlock()) {
+      string exc = "Unlocking pixels has failed";
+      throwException(env, exc);
+      return false;
     }
+  }
 
-    JxlEncodingPixelDataFormat dataPixelFormat = useFloat16 ? BINARY_16 : UNSIGNED_8;
-    std::vector<uint8_t> iccProfile;
+  const bool isImageMono = colorspace == mono;
+  JxlColorEncoding colorEncoding = ResolveBitmapColorEncoding(env, bitmapColorProfile, dataSpace,
+                                                              isImageMono);
 
-    if (!EncodeJxlOneshot(rgbPixels, info.width, info.height,
-                          &compressedVector, colorspace,
-                          compressionOption, dataPixelFormat,
-                          ref(iccProfile),
-                          effort, (int) jQuality, (int) decodingSpeed,
-                          colorEncoding)) {
-      throwCantCompressImage(env);
-      return static_cast<jbyteArray>(nullptr);
+  out.width = info.width;
+  out.height = info.height;
+  out.colorspace = colorspace;
+  out.dataFormat = useFloat16 ? BINARY_16 : UNSIGNED_8;
+  out.colorEncoding = colorEncoding;
+  return true;
+}
+
+bool EncodeBitmapPixels(const JxlBitmapPixels &image, JxlCompressionOption compressionOption,
+                        int effort, int quality, int decodingSpeed, JxlEncodingProfile profile,
+                        coder::JxlOutputSink &sink, uint32_t maxThreads) {
+  std::vector<uint8_t> iccProfile;
+  JxlColorEncoding colorEncoding = image.colorEncoding;
+  const auto encodeStart = std::chrono::steady_clock::now();
+  if (!EncodeJxlOneshot(image.pixels, image.width, image.height, sink, image.colorspace,
+                        compressionOption, image.dataFormat, iccProfile, effort, quality,
+                        decodingSpeed, colorEncoding, profile,
+                        maxThreads == 0 ? JxlThreadParallelRunnerDefaultNumWorkerThreads() : maxThreads)) {
+    return false;
+  }
+  // Every finished encode calibrates the model used by time budgeted encoding
+  coder::JxlThroughputModel::shared().record(
+      compressionOption, effort, static_cast<uint64_t>(image.width) * image.height,
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - encodeStart).count());
+  return true;
+}
+
+bool encodeBitmapInto(JNIEnv *env, jobject bitmap,
+                      jint javaColorSpace, jint javaCompressionOption,
+                      jint effort, jstring bitmapColorProfile,
+                      jint dataSpace, jint jQuality, jint decodingSpeed,
+                      jint javaProfile, coder::JxlOutputSink &sink) {
+  try {
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (!compressionOption) {
+      throwInvalidCompressionOptionException(env);
+      return false;
+    }
+
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return false;
+    }
+
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return false;
     }
 
-    jbyteArray byteArray = env->NewByteArray((jsize) compressedVector.size());
-    char *memBuf = (char *) ((void *) compressedVector.data());
-    env->SetByteArrayRegion(byteArray, 0, (jint) compressedVector.size(),
-                            reinterpret_cast<const jbyte *>(memBuf));
-    compressedVector.clear();
-    return byteArray;
+    if (javaProfile != PROFILE_DEFAULT && javaProfile != PROFILE_PROGRESSIVE) {
+      throwInvalidCompressionOptionException(env);
+      return false;
+    }
+
+    JxlBitmapPixels image;
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace, image)) {
+      return false;
+    }
+
+    if (!EncodeBitmapPixels(image, compressionOption, effort, (int) jQuality, (int) decodingSpeed,
+                            static_cast<JxlEncodingProfile>(javaProfile), sink, 0)) {
+      throwCantCompressImage(env);
+      return false;
+    }
+    return true;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return false;
   } catch (std::bad_alloc &err) {
     std::string errorString = "Not enough memory to encode this image";
     throwException(env, errorString);
-    return nullptr;
+    return false;
   } catch (std::runtime_error &err) {
     std::string m1 = err.what();
     std::string errorString = "Error: " + m1;
     throwException(env, errorString);
+    return false;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return false;
+  }
+}
+
+jbyteArray encodeBitmapImpl(JNIEnv *env, jobject bitmap,
+                            jint javaColorSpace, jint javaCompressionOption,
+                            jint effort, jstring bitmapColorProfile,
+                            jint dataSpace, jint jQuality, jint decodingSpeed,
+                            jint javaProfile) {
+  coder::JxlBlockOutputSink sink;
+  if (!encodeBitmapInto(env, bitmap, javaColorSpace, javaCompressionOption, effort,
+                        bitmapColorProfile, dataSpace, jQuality, decodingSpeed, javaProfile,
+                        sink)) {
     return nullptr;
   }
-}
\ No newline at end of file
+  return NewByteArrayFromSink(env, sink);
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                             jint javaColorSpace, jint javaCompressionOption,
+                                             jint effort, jstring bitmapColorProfile,
+                                             jint dataSpace, jint jQuality, jint decodingSpeed,
+                                             jint javaProfile, jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  return encodeBitmapImpl(env, bitmap, javaColorSpace, javaCompressionOption, effort,
+                          bitmapColorProfile, dataSpace, jQuality, decodingSpeed, javaProfile);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeIntoImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                 jint javaColorSpace, jint javaCompressionOption,
+                                                 jint effort, jstring bitmapColorProfile,
+                                                 jint dataSpace, jint jQuality, jint decodingSpeed,
+                                                 jint javaProfile,
+                                                 jobject outputBuffer, jbyteArray outputArray,
+                                                 jint outputOffset, jint outputFd,
+                                                 jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    JniOutputTarget target(env, outputBuffer, outputArray, outputOffset, outputFd);
+    if (!encodeBitmapInto(env, bitmap, javaColorSpace, javaCompressionOption, effort,
+                          bitmapColorProfile, dataSpace, jQuality, decodingSpeed, javaProfile,
+                          target.sink())) {
+      return -1;
+    }
+    return target.complete(env);
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return -1;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return -1;
+  }
+}
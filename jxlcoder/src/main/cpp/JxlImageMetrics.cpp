@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <string>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "imagebit/ImageMetrics.h"
+#include "interop/JxlProgression.hpp"
+#include "interop/JxlMemoryManager.hpp"
+#include "cancellation.hpp"
+
+static coder::MetricImageView MetricViewOf(const JxlBitmapPixels &image) {
+  const uint32_t channels = image.colorspace == mono ? 1 : (image.colorspace == rgb ? 3 : 4);
+  const bool isF16 = image.dataFormat == BINARY_16;
+  return {
+      .data = image.pixels.data(),
+      .stride = image.width * channels * (isF16 ? 2u : 1u),
+      .width = image.width,
+      .height = image.height,
+      .channels = channels,
+      .isF16 = isF16,
+  };
+}
+
+extern "C"
+JNIEXPORT jdouble JNICALL
+Java_com_awxkee_jxlcoder_JxlMetrics_computeImpl(JNIEnv *env, jobject thiz, jobject referenceBitmap,
+                                                jobject distortedBitmap, jint javaMetric,
+                                                jboolean alphaAware) {
+  try {
+    auto metric = static_cast<coder::ImageMetric>(javaMetric);
+    if (metric != coder::METRIC_SSIMULACRA2 && metric != coder::METRIC_PSNR) {
+      std::string exc = "Unknown image metric";
+      throwException(env, exc);
+      return 0;
+    }
+    // Bitmaps are read the same way the encoder reads them, unpremultiplied
+    JxlBitmapPixels reference, distorted;
+    if (!PrepareBitmapPixels(env, referenceBitmap, rgba, nullptr, -1, reference)
+        || !PrepareBitmapPixels(env, distortedBitmap, rgba, nullptr, -1, distorted)) {
+      return 0;
+    }
+    return coder::ComputeImageMetric(metric, MetricViewOf(reference), MetricViewOf(distorted),
+                                     alphaAware);
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to compare images";
+    throwException(env, errorString);
+    return 0;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return 0;
+  }
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_awxkee_jxlcoder_JxlMetrics_measureProgressionImpl(JNIEnv *env, jobject thiz,
+                                                           jbyteArray byteArray,
+                                                           jfloat qualityScore,
+                                                           jlongArray report) {
+  try {
+    auto totalLength = env->GetArrayLength(byteArray);
+    std::vector<uint8_t> srcBuffer(totalLength);
+    env->GetByteArrayRegion(byteArray, 0, totalLength, reinterpret_cast<jbyte *>(srcBuffer.data()));
+
+    coder::JxlProgressionReport progression;
+    if (!coder::MeasureJxlProgression(srcBuffer.data(), srcBuffer.size(), qualityScore, progression)) {
+      throwInvalidJXLException(env);
+      return false;
+    }
+    jlong values[5] = {
+        static_cast<jlong>(progression.totalBytes),
+        static_cast<jlong>(progression.firstRenderBytes),
+        static_cast<jlong>(progression.dcBytes),
+        static_cast<jlong>(progression.qualityBytes),
+        static_cast<jlong>(progression.progressionSteps),
+    };
+    env->SetLongArrayRegion(report, 0, 5, values);
+    return true;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return false;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to measure progression";
+    throwException(env, errorString);
+    return false;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return false;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return false;
+  }
+}
@@ -0,0 +1,284 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+#include "JniDecoding.h"
+#include "JniExceptions.h"
+#include "JxlCancellation.h"
+#include "SizeScaler.h"
+#include "Support.h"
+#include "interop/JxlDecoding.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlResourceGovernor.hpp"
+
+using namespace std;
+
+// Source index of an output which is resampled directly from the decoded image
+static const int multiDecodeFromBase = -1;
+
+struct JxlOutputLevel {
+  int scaledWidth = 0;
+  int scaledHeight = 0;
+  ScaleMode scaleMode = Fit;
+  PreferredColorConfig preferredColorConfig = Default;
+  bool scaled = false;
+  RescaleGeometry geometry = {};
+  // Uncropped aspect preserving levels may feed smaller outputs
+  bool reusable = false;
+  int source = multiDecodeFromBase;
+  int pendingConsumers = 0;
+  bool produced = false;
+  JxlDecodedImage image;
+};
+
+static void copyImageProperties(const JxlDecodedImage &from, JxlDecodedImage &to) {
+  to.width = from.width;
+  to.height = from.height;
+  to.stride = from.stride;
+  to.useFloats = from.useFloats;
+  to.bitDepth = from.bitDepth;
+  to.alphaPremultiplied = from.alphaPremultiplied;
+  to.hasAlphaInOrigin = from.hasAlphaInOrigin;
+}
+
+/**
+ * Picks for every output the cheapest image to resample from: the smallest already produced
+ * level that still covers the target, or the decoded image itself.
+ * @return outputs in the order they have to be produced
+ */
+static std::vector<int> planOutputLevels(std::vector<JxlOutputLevel> &levels, uint32_t width, uint32_t height) {
+  std::vector<int> order(levels.size());
+  for (size_t i = 0; i < levels.size(); ++i) {
+    JxlOutputLevel &level = levels[i];
+    order[i] = static_cast<int>(i);
+    level.scaled = level.scaledWidth != 0 && level.scaledHeight != 0;
+    if (!level.scaled) {
+      level.geometry = {
+          .resampledWidth = static_cast<int>(width), .resampledHeight = static_cast<int>(height),
+          .canvasWidth = static_cast<int>(width), .canvasHeight = static_cast<int>(height),
+          .xTranslation = 0, .yTranslation = 0,
+      };
+      continue;
+    }
+    level.geometry = ResolveRescaleGeometry(width, height, level.scaledWidth, level.scaledHeight,
+                                            level.scaleMode);
+    level.reusable = level.scaleMode != Resize
+        && level.geometry.xTranslation == 0 && level.geometry.yTranslation == 0
+        && level.geometry.resampledWidth > 0 && level.geometry.resampledHeight > 0;
+  }
+
+  auto area = [&levels](int index) {
+    return static_cast<uint64_t>(std::abs(levels[index].geometry.resampledWidth))
+        * static_cast<uint64_t>(std::abs(levels[index].geometry.resampledHeight));
+  };
+  std::stable_sort(order.begin(), order.end(), [&area](int lhs, int rhs) {
+    return area(lhs) > area(rhs);
+  });
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    JxlOutputLevel &level = levels[order[i]];
+    if (!level.scaled) {
+      continue;
+    }
+    uint64_t bestArea = std::numeric_limits<uint64_t>::max();
+    for (size_t j = 0; j < i; ++j) {
+      JxlOutputLevel &candidate = levels[order[j]];
+      if (!candidate.reusable
+          || candidate.geometry.resampledWidth < level.geometry.resampledWidth
+          || candidate.geometry.resampledHeight < level.geometry.resampledHeight) {
+        continue;
+      }
+      uint64_t candidateArea = area(order[j]);
+      if (candidateArea < bestArea) {
+        bestArea = candidateArea;
+        level.source = order[j];
+      }
+    }
+    if (level.source != multiDecodeFromBase) {
+      levels[level.source].pendingConsumers += 1;
+    }
+  }
+  return order;
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_decodeMultipleImpl(JNIEnv *env, jobject thiz,
+                                                     jobject source,
+                                                     jintArray scaledWidths,
+                                                     jintArray scaledHeights,
+                                                     jintArray javaScaleModes,
+                                                     jintArray javaPreferredColorConfigs,
+                                                     jint javaResizeFilter,
+                                                     jint javaToneMapper,
+                                                     jlong cancellationToken) {
+  jsize count = env->GetArrayLength(scaledWidths);
+  std::vector<jint> widths(count), heights(count), scaleModes(count), colorConfigs(count);
+  env->GetIntArrayRegion(scaledWidths, 0, count, widths.data());
+  env->GetIntArrayRegion(scaledHeights, 0, count, heights.data());
+  env->GetIntArrayRegion(javaScaleModes, 0, count, scaleModes.data());
+  env->GetIntArrayRegion(javaPreferredColorConfigs, 0, count, colorConfigs.data());
+
+  XSampler sampler;
+  CurveToneMapper toneMapper;
+  std::vector<JxlOutputLevel> levels(count);
+  for (jsize i = 0; i < count; ++i) {
+    JxlOutputLevel &level = levels[i];
+    if (!checkDecodePreconditions(env, colorConfigs[i], &level.preferredColorConfig,
+                                  scaleModes[i], &level.scaleMode, javaResizeFilter, &sampler,
+                                  javaToneMapper, &toneMapper)) {
+      return nullptr;
+    }
+    level.scaledWidth = widths[i];
+    level.scaledHeight = heights[i];
+  }
+
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+
+  try {
+    std::vector<uint8_t> imageData;
+    auto bufferAddress = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(source));
+    if (bufferAddress != nullptr) {
+      auto length = static_cast<size_t>(env->GetDirectBufferCapacity(source));
+      imageData.assign(bufferAddress, bufferAddress + length);
+    } else {
+      auto byteArray = reinterpret_cast<jbyteArray>(source);
+      auto length = env->GetArrayLength(byteArray);
+      imageData.resize(length);
+      env->GetByteArrayRegion(byteArray, 0, length, reinterpret_cast<jbyte *>(imageData.data()));
+    }
+
+    // Decoding and color management are done once in the full resolution
+    JxlDecodedImage base;
+    if (!DecodeSampledPixels(imageData, 0, 0, Fit, sampler, toneMapper, 0, &base)) {
+      throwInvalidJXLException(env);
+      return nullptr;
+    }
+
+    std::vector<int> order = planOutputLevels(levels, base.width, base.height);
+    int baseConsumers = 0;
+    for (const JxlOutputLevel &level : levels) {
+      if (level.source == multiDecodeFromBase) {
+        baseConsumers += 1;
+      }
+    }
+
+    jclass bitmapClass = env->FindClass("android/graphics/Bitmap");
+    jobjectArray results = env->NewObjectArray(count, bitmapClass, nullptr);
+
+    // Level is converted into the bitmap as soon as nothing else is resampled from it
+    auto emitLevel = [&](int index) -> bool {
+      JxlOutputLevel &level = levels[index];
+      jobject bitmap = CreateBitmapFromDecoded(env, level.image, level.preferredColorConfig);
+      pooled_uint8_vector().swap(level.image.pixels);
+      if (env->ExceptionCheck() || bitmap == nullptr) {
+        return false;
+      }
+      env->SetObjectArrayElement(results, index, bitmap);
+      env->DeleteLocalRef(bitmap);
+      return true;
+    };
+
+    for (int index : order) {
+      JxlOutputLevel &level = levels[index];
+      bool fromBase = level.source == multiDecodeFromBase;
+      const JxlDecodedImage &sourceImage = fromBase ? base : levels[level.source].image;
+      copyImageProperties(sourceImage, level.image);
+
+      if (!level.scaled) {
+        if (baseConsumers == 1) {
+          level.image.pixels = std::move(base.pixels);
+        } else {
+          level.image.pixels = base.pixels;
+        }
+      } else {
+        // Geometry always resolves against the decoded size so outputs don't depend on the chosen source
+        uint32_t finalWidth = base.width;
+        uint32_t finalHeight = base.height;
+        if (!RescaleImageInto(sourceImage.pixels.data(), sourceImage.stride,
+                              sourceImage.width, sourceImage.height,
+                              level.image.pixels, &level.image.stride, sourceImage.useFloats,
+                              &finalWidth, &finalHeight,
+                              level.scaledWidth, level.scaledHeight,
+                              sourceImage.bitDepth, sourceImage.alphaPremultiplied,
+                              level.scaleMode, sampler, sourceImage.hasAlphaInOrigin)) {
+          throwInvalidJXLException(env);
+          return nullptr;
+        }
+        level.image.width = finalWidth;
+        level.image.height = finalHeight;
+      }
+      level.produced = true;
+
+      if (fromBase) {
+        baseConsumers -= 1;
+        if (baseConsumers == 0) {
+          pooled_uint8_vector().swap(base.pixels);
+        }
+      } else {
+        JxlOutputLevel &parent = levels[level.source];
+        parent.pendingConsumers -= 1;
+        if (parent.pendingConsumers == 0 && !emitLevel(level.source)) {
+          return nullptr;
+        }
+      }
+
+      if (level.pendingConsumers == 0 && !emitLevel(index)) {
+        return nullptr;
+      }
+    }
+
+    return results;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (coder::JxlResourceLimitException &err) {
+    throwResourceLimitException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to decode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (InvalidImageSizeException &err) {
+    throwImageSizeException(env, err.what());
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
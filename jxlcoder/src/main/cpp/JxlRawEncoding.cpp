@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlEncoding.h"
+#include "interop/JxlRawPixels.hpp"
+#include "interop/JxlOutputSink.hpp"
+#include "interop/JxlMemoryManager.hpp"
+#include "thread_parallel_runner.h"
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeRawImpl(JNIEnv *env, jobject thiz, jobject byteBuffer,
+                                                jint width, jint height, jint stride,
+                                                jint javaChannels, jint javaSampleType,
+                                                jboolean premultiplied,
+                                                jint javaCompressionOption, jint effort,
+                                                jstring colorSpaceName, jint dataSpace,
+                                                jint jQuality, jint decodingSpeed,
+                                                jint javaProfile, jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (compressionOption != lossy && compressionOption != loseless) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return nullptr;
+    }
+    if (javaProfile != PROFILE_DEFAULT && javaProfile != PROFILE_PROGRESSIVE) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (width <= 0 || height <= 0 || stride <= 0) {
+      std::string exc = "Invalid image dimensions or stride";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    coder::JxlRawPixels pixels = {
+        .data = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(byteBuffer)),
+        .size = static_cast<size_t>(std::max(env->GetDirectBufferCapacity(byteBuffer),
+                                             static_cast<jlong>(0))),
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .stride = static_cast<uint32_t>(stride),
+        .channels = static_cast<coder::JxlRawChannels>(javaChannels),
+        .sampleType = static_cast<coder::RgbaSampleType>(javaSampleType),
+        .premultiplied = static_cast<bool>(premultiplied),
+    };
+    std::string invalid = coder::ValidateJxlRawPixels(pixels);
+    if (!invalid.empty()) {
+      throwException(env, invalid);
+      return nullptr;
+    }
+
+    pooled_uint8_vector storage;
+    coder::JxlRawFrame frame = coder::PrepareJxlRawFrame(pixels, storage);
+
+    JxlColorEncoding colorEncoding = ResolveBitmapColorEncoding(env, colorSpaceName,
+                                                                colorSpaceName ? dataSpace : -1,
+                                                                frame.colorspace == mono);
+    if (frame.colorspace == mono) {
+      // Gray pixels keep the white point and transfer of the space, primaries don't apply
+      colorEncoding.color_space = JXL_COLOR_SPACE_GRAY;
+    }
+    std::vector<uint8_t> iccProfile;
+
+    coder::JxlBlockOutputSink sink;
+    if (!EncodeJxlRaw(frame.data, frame.size, frame.stride, pixels.width, pixels.height, sink,
+                      frame.colorspace, compressionOption, frame.dataFormat, iccProfile, effort,
+                      jQuality, decodingSpeed, colorEncoding,
+                      static_cast<JxlEncodingProfile>(javaProfile),
+                      JxlThreadParallelRunnerDefaultNumWorkerThreads())) {
+      throwCantCompressImage(env);
+      return nullptr;
+    }
+
+    return NewByteArrayFromSink(env, sink);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
@@ -0,0 +1,380 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "SizeScaler.h"
+#include "XScaler.h"
+#include "conversion/RgbChannels.h"
+#include "imagebit/CopyUnalignedRGBA.h"
+#include "imagebit/RgbaPack.h"
+#include "imagebit/RgbaToRgb.h"
+#include "imagebit/ScanAlpha.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct RenditionRequest {
+  uint32_t width;
+  uint32_t height;
+  int quality;
+  int effort;
+  JxlCompressionOption compressionOption;
+  JxlColorPixelType colorspace;
+  // Index of the downscaled level the rendition is encoded from
+  size_t level;
+};
+
+/**
+ * Unassociated RGBA of one size of the ladder, shared by every rendition of that size
+ */
+struct RenditionLevel {
+  pooled_uint8_vector pixels;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t stride = 0;
+};
+
+struct RenditionOutput {
+  std::unique_ptr<coder::JxlBlockOutputSink> sink;
+  float scaleMillis = 0;
+  float encodeMillis = 0;
+  bool failed = false;
+  std::exception_ptr error;
+};
+
+double MillisSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Rows of levels are aligned for the scaler, libjxl wants them packed into the channels of the rendition
+void PackRenditionPixels(const RenditionLevel &level, bool useFloats, JxlColorPixelType colorspace,
+                         pooled_uint8_vector &dst) {
+  const uint32_t channels = colorspace == mono ? 1 : (colorspace == rgb ? 3 : 4);
+  const uint32_t sampleSize = useFloats ? sizeof(uint16_t) : sizeof(uint8_t);
+  const uint32_t dstStride = level.width * channels * sampleSize;
+  dst.resize(static_cast<size_t>(dstStride) * level.height);
+  if (!useFloats) {
+    coder::PackRgba8(level.pixels.data(), level.stride, dst.data(), dstStride,
+                     level.width, level.height, channels, false);
+    return;
+  }
+  switch (colorspace) {
+    case mono:
+      coder::RGBAPickChannel(reinterpret_cast<const uint16_t *>(level.pixels.data()), level.stride,
+                             reinterpret_cast<uint16_t *>(dst.data()), dstStride,
+                             level.width, level.height, 0);
+      break;
+    case rgb:
+      coder::Rgba16ToRgb16(reinterpret_cast<const uint16_t *>(level.pixels.data()), level.stride,
+                           reinterpret_cast<uint16_t *>(dst.data()), dstStride,
+                           level.width, level.height);
+      break;
+    case rgba:
+      coder::CopyUnaligned(level.pixels.data(), level.stride, dst.data(), dstStride,
+                           level.width * 4 * sampleSize, level.height);
+      break;
+  }
+}
+
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeRenditionsImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                       jstring bitmapColorProfile, jint dataSpace,
+                                                       jintArray javaMaxDimensions,
+                                                       jintArray javaQualities,
+                                                       jintArray javaEfforts,
+                                                       jintArray javaChannels,
+                                                       jintArray javaCompressionOptions,
+                                                       jint decodingSpeed, jint javaResizeFilter,
+                                                       jintArray sizes, jfloatArray timings,
+                                                       jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    const jsize count = env->GetArrayLength(javaMaxDimensions);
+    if (count == 0 || env->GetArrayLength(javaQualities) != count
+        || env->GetArrayLength(javaEfforts) != count || env->GetArrayLength(javaChannels) != count
+        || env->GetArrayLength(javaCompressionOptions) != count) {
+      std::string exc = "Renditions must not be empty";
+      throwException(env, exc);
+      return nullptr;
+    }
+    std::vector<jint> maxDimensions(count), qualities(count), efforts(count), channels(count),
+        compressionOptions(count);
+    env->GetIntArrayRegion(javaMaxDimensions, 0, count, maxDimensions.data());
+    env->GetIntArrayRegion(javaQualities, 0, count, qualities.data());
+    env->GetIntArrayRegion(javaEfforts, 0, count, efforts.data());
+    env->GetIntArrayRegion(javaChannels, 0, count, channels.data());
+    env->GetIntArrayRegion(javaCompressionOptions, 0, count, compressionOptions.data());
+
+    for (jsize i = 0; i < count; ++i) {
+      auto compressionOption = static_cast<JxlCompressionOption>(compressionOptions[i]);
+      if ((compressionOption != lossy && compressionOption != loseless)
+          || efforts[i] < 0 || efforts[i] > 10) {
+        throwInvalidCompressionOptionException(env);
+        return nullptr;
+      }
+      if (qualities[i] < 0 || qualities[i] > 100) {
+        std::string exc = "Quality must be in 0...100";
+        throwException(env, exc);
+        return nullptr;
+      }
+      if (channels[i] != rgb && channels[i] != rgba && channels[i] != mono
+          && channels[i] != JXL_CHANNELS_AUTO) {
+        throwInvalidColorSpaceException(env);
+        return nullptr;
+      }
+    }
+    auto sampler = static_cast<XSampler>(javaResizeFilter);
+    if (!sampler) {
+      std::string exc = "Invalid Sampler: " + std::to_string(javaResizeFilter) + " was passed";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    // Converted once, every level is downscaled from the previous one
+    JxlBitmapPixels base;
+    if (!PrepareBitmapPixels(env, bitmap, rgba, bitmapColorProfile, dataSpace, base)) {
+      return nullptr;
+    }
+    const bool useFloats = base.dataFormat == BINARY_16;
+    const uint32_t sampleSize = useFloats ? sizeof(uint16_t) : sizeof(uint8_t);
+    const uint32_t content = useFloats
+                             ? coder::AnalyzeRgbaF16(reinterpret_cast<const uint16_t *>(base.pixels.data()),
+                                                     base.width * 4 * sampleSize, base.width,
+                                                     base.height,
+                                                     coder::CONTENT_OPAQUE | coder::CONTENT_GRAYSCALE)
+                             : coder::AnalyzeRgba8(base.pixels.data(), base.width * 4, base.width,
+                                                   base.height,
+                                                   coder::CONTENT_OPAQUE | coder::CONTENT_GRAYSCALE);
+    const bool hasAlpha = !(content & coder::CONTENT_OPAQUE);
+
+    std::vector<RenditionRequest> requests(count);
+    std::vector<std::pair<uint32_t, uint32_t>> levelSizes;
+    bool hasMono = false;
+    for (jsize i = 0; i < count; ++i) {
+      RenditionRequest &request = requests[i];
+      const uint32_t longSide = std::max(base.width, base.height);
+      // Renditions are never upscaled
+      const double scale = maxDimensions[i] > 0
+                           ? std::min(1.0, static_cast<double>(maxDimensions[i]) / longSide) : 1.0;
+      request.width = std::max<uint32_t>(static_cast<uint32_t>(std::lround(base.width * scale)), 1);
+      request.height = std::max<uint32_t>(static_cast<uint32_t>(std::lround(base.height * scale)), 1);
+      request.quality = qualities[i];
+      request.effort = efforts[i];
+      request.compressionOption = static_cast<JxlCompressionOption>(compressionOptions[i]);
+      if (channels[i] == JXL_CHANNELS_AUTO) {
+        // Resampling keeps opaque and gray images such, so the analysis of the base holds for every size
+        request.colorspace = (content & coder::CONTENT_OPAQUE)
+                             ? ((content & coder::CONTENT_GRAYSCALE) ? mono : rgb) : rgba;
+      } else {
+        request.colorspace = static_cast<JxlColorPixelType>(channels[i]);
+      }
+      hasMono |= request.colorspace == mono;
+      levelSizes.emplace_back(request.width, request.height);
+    }
+
+    std::sort(levelSizes.begin(), levelSizes.end(), [](const auto &a, const auto &b) {
+      return static_cast<uint64_t>(a.first) * a.second > static_cast<uint64_t>(b.first) * b.second;
+    });
+    levelSizes.erase(std::unique(levelSizes.begin(), levelSizes.end()), levelSizes.end());
+    for (RenditionRequest &request: requests) {
+      request.level = std::find(levelSizes.begin(), levelSizes.end(),
+                                std::make_pair(request.width, request.height)) - levelSizes.begin();
+    }
+
+    const JxlColorEncoding rgbEncoding = base.colorEncoding;
+    const JxlColorEncoding monoEncoding = hasMono
+                                          ? ResolveBitmapColorEncoding(env, bitmapColorProfile,
+                                                                       dataSpace, true)
+                                          : rgbEncoding;
+
+    std::shared_ptr<concurrency::CancellationToken> ladderToken =
+        std::make_shared<concurrency::CancellationToken>(concurrency::currentCancellationTokenRef());
+    std::vector<RenditionOutput> outputs(count);
+
+    auto encodeRendition = [&](const std::shared_ptr<RenditionLevel> &level, size_t index) {
+      const RenditionRequest &request = requests[index];
+      RenditionOutput &output = outputs[index];
+      concurrency::CancellationScope renditionScope(ladderToken);
+      try {
+        const auto start = std::chrono::steady_clock::now();
+        ladderToken->throwIfCancelled();
+        JxlBitmapPixels image;
+        image.width = level->width;
+        image.height = level->height;
+        image.colorspace = request.colorspace;
+        image.dataFormat = base.dataFormat;
+        image.colorEncoding = request.colorspace == mono ? monoEncoding : rgbEncoding;
+        PackRenditionPixels(*level, useFloats, request.colorspace, image.pixels);
+        auto sink = std::make_unique<coder::JxlBlockOutputSink>();
+        if (!EncodeBitmapPixels(image, request.compressionOption, request.effort, request.quality,
+                                (int) decodingSpeed, PROFILE_DEFAULT, *sink, 0)) {
+          output.failed = true;
+          ladderToken->cancel();
+          return;
+        }
+        output.sink = std::move(sink);
+        output.encodeMillis = static_cast<float>(MillisSince(start));
+      } catch (concurrency::OperationCancelledException &) {
+        // Either a sibling has failed or the whole ladder is cancelled, both are reported by the caller
+      } catch (...) {
+        output.error = std::current_exception();
+        ladderToken->cancel();
+      }
+    };
+
+    auto &pool = concurrency::sharedThreadPool();
+    // Waiting on the pool from one of its workers would deadlock, so renditions are encoded inline there
+    const bool runInline = pool.isWorkerThread();
+    std::vector<std::future<void>> pending;
+    auto waitPending = [&pending]() {
+      for (auto &future: pending) {
+        future.wait();
+      }
+    };
+
+    try {
+      auto level = std::make_shared<RenditionLevel>();
+      level->width = base.width;
+      level->height = base.height;
+      level->stride = base.width * 4 * sampleSize;
+      level->pixels = std::move(base.pixels);
+
+      for (size_t levelIndex = 0; levelIndex < levelSizes.size(); ++levelIndex) {
+        const auto [levelWidth, levelHeight] = levelSizes[levelIndex];
+        float scaleMillis = 0;
+        if (levelWidth != level->width || levelHeight != level->height) {
+          const auto start = std::chrono::steady_clock::now();
+          auto next = std::make_shared<RenditionLevel>();
+          uint32_t finalWidth = level->width;
+          uint32_t finalHeight = level->height;
+          RescaleImageInto(level->pixels.data(), level->stride, level->width, level->height,
+                           next->pixels, &next->stride, useFloats, &finalWidth, &finalHeight,
+                           static_cast<int>(levelWidth), static_cast<int>(levelHeight),
+                           useFloats ? 16 : 8, false, Resize, sampler, hasAlpha);
+          next->width = finalWidth;
+          next->height = finalHeight;
+          // The larger level is released as soon as its renditions are encoded
+          level = std::move(next);
+          scaleMillis = static_cast<float>(MillisSince(start));
+        }
+        if (ladderToken->isCancelled()) {
+          // A rendition has failed, the reason is reported once the running ones are done
+          break;
+        }
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+          if (requests[i].level != levelIndex) {
+            continue;
+          }
+          outputs[i].scaleMillis = scaleMillis;
+          if (runInline) {
+            encodeRendition(level, i);
+          } else {
+            pending.push_back(pool.enqueue([&encodeRendition, level, i]() {
+              encodeRendition(level, i);
+            }));
+          }
+        }
+      }
+    } catch (...) {
+      // Running renditions reference this frame, so they must be done before it unwinds
+      ladderToken->cancel();
+      waitPending();
+      throw;
+    }
+    waitPending();
+
+    concurrency::throwIfCurrentOperationCancelled();
+    for (const RenditionOutput &output: outputs) {
+      if (output.error) {
+        std::rethrow_exception(output.error);
+      }
+    }
+    for (const RenditionOutput &output: outputs) {
+      if (output.failed || !output.sink) {
+        throwCantCompressImage(env);
+        return nullptr;
+      }
+    }
+
+    jclass byteArrayClass = env->FindClass("[B");
+    jobjectArray results = env->NewObjectArray(count, byteArrayClass, nullptr);
+    if (results == nullptr) {
+      return nullptr;
+    }
+    std::vector<jint> outputSizes(static_cast<size_t>(count) * 2);
+    std::vector<jfloat> outputTimings(static_cast<size_t>(count) * 2);
+    for (jsize i = 0; i < count; ++i) {
+      jbyteArray data = NewByteArrayFromSink(env, *outputs[i].sink);
+      if (data == nullptr) {
+        return nullptr;
+      }
+      outputs[i].sink.reset();
+      env->SetObjectArrayElement(results, i, data);
+      env->DeleteLocalRef(data);
+      outputSizes[i * 2] = static_cast<jint>(requests[i].width);
+      outputSizes[i * 2 + 1] = static_cast<jint>(requests[i].height);
+      outputTimings[i * 2] = outputs[i].scaleMillis;
+      outputTimings[i * 2 + 1] = outputs[i].encodeMillis;
+    }
+    env->SetIntArrayRegion(sizes, 0, count * 2, outputSizes.data());
+    env->SetFloatArrayRegion(timings, 0, count * 2, outputTimings.data());
+    return results;
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
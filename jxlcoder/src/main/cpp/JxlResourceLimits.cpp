@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <algorithm>
+#include "interop/JxlResourceGovernor.hpp"
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlResourceGovernor_setLimitsImpl(JNIEnv *env, jobject thiz,
+                                                           jlong maxPixels, jlong maxFrames,
+                                                           jlong maxDecodedBytes,
+                                                           jlong maxWallTimeMillis) {
+  coder::JxlResourceLimits limits = {
+      .maxPixels = static_cast<uint64_t>(std::max(maxPixels, static_cast<jlong>(0))),
+      .maxFrames = static_cast<uint64_t>(std::max(maxFrames, static_cast<jlong>(0))),
+      .maxDecodedBytes = static_cast<uint64_t>(std::max(maxDecodedBytes, static_cast<jlong>(0))),
+      .maxWallTimeMillis = std::max(maxWallTimeMillis, static_cast<jlong>(0)),
+  };
+  coder::setJxlResourceLimits(limits);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlResourceGovernor_getLimitsImpl(JNIEnv *env, jobject thiz, jlongArray limits) {
+  auto resourceLimits = coder::jxlResourceLimits();
+  jlong values[4] = {
+      static_cast<jlong>(resourceLimits.maxPixels),
+      static_cast<jlong>(resourceLimits.maxFrames),
+      static_cast<jlong>(resourceLimits.maxDecodedBytes),
+      static_cast<jlong>(resourceLimits.maxWallTimeMillis),
+  };
+  env->SetLongArrayRegion(limits, 0, 4, values);
+}
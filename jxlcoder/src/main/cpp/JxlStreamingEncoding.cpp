@@ -0,0 +1,351 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "android/bitmap.h"
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlEncoding.h"
+#include "interop/JxlChunkedSource.hpp"
+#include "interop/JxlOutputSink.hpp"
+#include "interop/JxlMemoryManager.hpp"
+#include "thread_parallel_runner.h"
+
+namespace {
+
+/**
+ * Keeps bitmap pixels locked while libjxl pulls rectangles from them
+ */
+class BitmapPixelsLock {
+ public:
+  BitmapPixelsLock(JNIEnv *env, jobject bitmap) : env(env), bitmap(bitmap) {
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != 0) {
+      pixels = nullptr;
+    }
+  }
+
+  ~BitmapPixelsLock() {
+    if (pixels != nullptr) {
+      AndroidBitmap_unlockPixels(env, bitmap);
+    }
+  }
+
+  BitmapPixelsLock(const BitmapPixelsLock &) = delete;
+  BitmapPixelsLock &operator=(const BitmapPixelsLock &) = delete;
+
+  [[nodiscard]] const uint8_t *data() const {
+    return reinterpret_cast<const uint8_t *>(pixels);
+  }
+
+ private:
+  JNIEnv *env;
+  jobject bitmap;
+  void *pixels = nullptr;
+};
+
+bool bitmapSourceLayout(int32_t format, coder::JxlSourceLayout *layout) {
+  switch (format) {
+    case ANDROID_BITMAP_FORMAT_RGBA_8888:*layout = coder::SOURCE_RGBA_8888;
+      return true;
+    case ANDROID_BITMAP_FORMAT_RGBA_F16:*layout = coder::SOURCE_RGBA_F16;
+      return true;
+    case ANDROID_BITMAP_FORMAT_RGBA_1010102:*layout = coder::SOURCE_RGBA_1010102;
+      return true;
+    case ANDROID_BITMAP_FORMAT_RGB_565:*layout = coder::SOURCE_RGB_565;
+      return true;
+    default:return false;
+  }
+}
+
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeStreamingImpl(JNIEnv *env, jobject thiz,
+                                                      jobject bitmap, jobject byteBuffer,
+                                                      jint inputFd, jlong inputOffset,
+                                                      jint width, jint height, jint stride,
+                                                      jint javaLayout, jboolean premultiplied,
+                                                      jint javaColorSpace,
+                                                      jint javaCompressionOption,
+                                                      jint effort, jstring bitmapColorProfile,
+                                                      jint dataSpace, jint jQuality,
+                                                      jint decodingSpeed, jint outputFd,
+                                                      jlongArray written,
+                                                      jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    // Regions are pulled while encoding, there is no pass over the whole image to analyze it
+    auto colorspace = javaColorSpace == JXL_CHANNELS_AUTO ? rgba
+                                                          : static_cast<JxlColorPixelType>(javaColorSpace);
+    if (colorspace != rgb && colorspace != rgba && colorspace != mono) {
+      throwInvalidColorSpaceException(env);
+      return nullptr;
+    }
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (compressionOption != lossy && compressionOption != loseless) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    auto layout = static_cast<coder::JxlSourceLayout>(javaLayout);
+    bool isPremultiplied = premultiplied;
+    std::unique_ptr<BitmapPixelsLock> bitmapLock;
+    std::unique_ptr<coder::JxlPixelReader> reader;
+
+    if (bitmap != nullptr) {
+      AndroidBitmapInfo info;
+      if (AndroidBitmap_getInfo(env, bitmap, &info) < 0) {
+        throwPixelsException(env);
+        return nullptr;
+      }
+      if (info.flags & ANDROID_BITMAP_FLAGS_IS_HARDWARE) {
+        std::string exc = "Hardware bitmap is not supported by JXL Coder";
+        throwException(env, exc);
+        return nullptr;
+      }
+      if (!bitmapSourceLayout(info.format, &layout)) {
+        std::string msg("Currently support encoding only RGBA_8888, RGBA_F16, RGBA_1010102, RGB_565 images pixel format");
+        throwException(env, msg);
+        return nullptr;
+      }
+      width = static_cast<jint>(info.width);
+      height = static_cast<jint>(info.height);
+      stride = static_cast<jint>(info.stride);
+      // Same as one shot encoding, only 8 bit bitmaps are stored with associated alpha
+      isPremultiplied = layout == coder::SOURCE_RGBA_8888;
+      bitmapLock = std::make_unique<BitmapPixelsLock>(env, bitmap);
+      if (bitmapLock->data() == nullptr) {
+        throwPixelsException(env);
+        return nullptr;
+      }
+      reader = std::make_unique<coder::JxlMemoryPixelReader>(bitmapLock->data(), info.stride, layout);
+    } else {
+      if (layout != coder::SOURCE_RGBA_8888 && layout != coder::SOURCE_RGBA_F16 &&
+          layout != coder::SOURCE_RGBA_1010102 && layout != coder::SOURCE_RGB_565) {
+        std::string exc = "Unknown pixels layout";
+        throwException(env, exc);
+        return nullptr;
+      }
+      if (width <= 0 || height <= 0 ||
+          static_cast<int64_t>(stride) < static_cast<int64_t>(width) * coder::JxlSourcePixelSize(layout)) {
+        std::string exc = "Invalid image dimensions or stride";
+        throwException(env, exc);
+        return nullptr;
+      }
+      if (byteBuffer != nullptr) {
+        auto bufferAddress = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(byteBuffer));
+        int64_t bufferSize = env->GetDirectBufferCapacity(byteBuffer);
+        if (bufferAddress == nullptr || bufferSize < static_cast<int64_t>(stride) * (height - 1)
+            + static_cast<int64_t>(width) * coder::JxlSourcePixelSize(layout)) {
+          std::string exc = "Pixels must be provided in a direct byte buffer large enough to hold the image";
+          throwException(env, exc);
+          return nullptr;
+        }
+        reader = std::make_unique<coder::JxlMemoryPixelReader>(bufferAddress, stride, layout);
+      } else if (inputFd >= 0) {
+        reader = std::make_unique<coder::JxlFdPixelReader>(inputFd, inputOffset, stride, layout);
+      } else {
+        std::string exc = "Source of pixels is not provided";
+        throwException(env, exc);
+        return nullptr;
+      }
+    }
+
+    coder::JxlChunkedFrameSource source(*reader, layout, isPremultiplied, colorspace);
+
+    JxlColorEncoding colorEncoding = {};
+    if (bitmap != nullptr) {
+      colorEncoding = ResolveBitmapColorEncoding(env, bitmapColorProfile, dataSpace,
+                                                 colorspace == mono);
+    } else {
+      JxlColorEncodingSetToSRGB(&colorEncoding, colorspace == mono);
+    }
+    std::vector<uint8_t> iccProfile;
+
+    std::unique_ptr<coder::JxlOutputSink> sink;
+    if (outputFd >= 0) {
+      sink = std::make_unique<coder::JxlFdOutputSink>(outputFd);
+    } else {
+      sink = std::make_unique<coder::JxlBlockOutputSink>();
+    }
+
+    if (!EncodeJxlChunked(source, *sink, static_cast<uint32_t>(width),
+                          static_cast<uint32_t>(height), colorspace, compressionOption,
+                          iccProfile, effort, jQuality, decodingSpeed, colorEncoding,
+                          JxlThreadParallelRunnerDefaultNumWorkerThreads())) {
+      throwCantCompressImage(env);
+      return nullptr;
+    }
+
+    jlong writtenBytes = static_cast<jlong>(sink->size());
+    if (written != nullptr) {
+      env->SetLongArrayRegion(written, 0, 1, &writtenBytes);
+    }
+
+    if (outputFd >= 0) {
+      return nullptr;
+    }
+
+    return NewByteArrayFromSink(env, static_cast<coder::JxlBlockOutputSink &>(*sink));
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeYuvImpl(JNIEnv *env, jobject thiz,
+                                                jobject yBuffer, jobject uBuffer, jobject vBuffer,
+                                                jint width, jint height,
+                                                jint yStride, jint uvStride, jint uvPixelStride,
+                                                jint javaMatrix, jint javaRange,
+                                                jint javaCompressionOption, jint effort,
+                                                jint jQuality, jint decodingSpeed,
+                                                jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (compressionOption != lossy && compressionOption != loseless) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return nullptr;
+    }
+    auto matrix = static_cast<coder::YuvMatrix>(javaMatrix);
+    auto range = static_cast<coder::YuvRange>(javaRange);
+    if ((matrix != coder::YUV_MATRIX_BT601 && matrix != coder::YUV_MATRIX_BT709) ||
+        (range != coder::YUV_RANGE_FULL && range != coder::YUV_RANGE_LIMITED)) {
+      std::string exc = "Unknown YUV matrix or range";
+      throwException(env, exc);
+      return nullptr;
+    }
+    if (width <= 0 || height <= 0 || yStride < width || uvPixelStride <= 0 ||
+        static_cast<int64_t>(uvStride) < static_cast<int64_t>((width + 1) / 2 - 1) * uvPixelStride + 1) {
+      std::string exc = "Invalid image dimensions or stride";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    // Chroma planes of YUV_420_888 may end right at the last sample, e.g. U of NV21
+    int64_t chromaWidth = (width + 1) / 2;
+    int64_t chromaHeight = (height + 1) / 2;
+    int64_t lumaSize = static_cast<int64_t>(yStride) * (height - 1) + width;
+    int64_t chromaSize = static_cast<int64_t>(uvStride) * (chromaHeight - 1)
+        + (chromaWidth - 1) * uvPixelStride + 1;
+    auto yAddress = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(yBuffer));
+    auto uAddress = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(uBuffer));
+    auto vAddress = reinterpret_cast<const uint8_t *>(env->GetDirectBufferAddress(vBuffer));
+    if (yAddress == nullptr || uAddress == nullptr || vAddress == nullptr ||
+        env->GetDirectBufferCapacity(yBuffer) < lumaSize ||
+        env->GetDirectBufferCapacity(uBuffer) < chromaSize ||
+        env->GetDirectBufferCapacity(vBuffer) < chromaSize) {
+      std::string exc = "Planes must be provided in direct byte buffers large enough to hold the image";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    coder::YuvPlanes planes = {
+        .y = yAddress,
+        .u = uAddress,
+        .v = vAddress,
+        .yStride = static_cast<uint32_t>(yStride),
+        .uvStride = static_cast<uint32_t>(uvStride),
+        .uvPixelStride = static_cast<uint32_t>(uvPixelStride),
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+    };
+    coder::JxlYuvPixelReader reader(planes, matrix, range);
+    // Camera frames are always opaque
+    coder::JxlChunkedFrameSource source(reader, coder::SOURCE_RGBA_8888, false, rgb);
+
+    JxlColorEncoding colorEncoding = {};
+    JxlColorEncodingSetToSRGB(&colorEncoding, false);
+    std::vector<uint8_t> iccProfile;
+
+    coder::JxlBlockOutputSink sink;
+    if (!EncodeJxlChunked(source, sink, static_cast<uint32_t>(width),
+                          static_cast<uint32_t>(height), rgb, compressionOption,
+                          iccProfile, effort, jQuality, decodingSpeed, colorEncoding,
+                          JxlThreadParallelRunnerDefaultNumWorkerThreads())) {
+      throwCantCompressImage(env);
+      return nullptr;
+    }
+
+    return NewByteArrayFromSink(env, sink);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string m1 = err.what();
+    std::string errorString = "Error: " + m1;
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "imagebit/ImageMetrics.h"
+#include "interop/JxlEncoding.h"
+#include "interop/JxlDecoderSession.hpp"
+#include "interop/JxlDistanceSearch.hpp"
+#include "interop/JxlMemoryManager.hpp"
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeToTargetQualityImpl(JNIEnv *env, jobject thiz,
+                                                            jobject bitmap, jint javaColorSpace,
+                                                            jint effort, jstring bitmapColorProfile,
+                                                            jint dataSpace, jint decodingSpeed,
+                                                            jint javaMetric, jfloat targetScore,
+                                                            jfloat tolerance, jfloatArray chosen,
+                                                            jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    auto metric = static_cast<coder::ImageMetric>(javaMetric);
+    if (metric != coder::METRIC_SSIMULACRA2 && metric != coder::METRIC_PSNR) {
+      std::string exc = "Unknown image metric";
+      throwException(env, exc);
+      return nullptr;
+    }
+    if (!(tolerance >= 0.f)) {
+      std::string exc = "Tolerance must not be negative";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    // Converted once, it is the source of every candidate and the reference of the metric
+    JxlBitmapPixels image;
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace, image)) {
+      return nullptr;
+    }
+
+    const uint32_t channels = image.colorspace == mono ? 1 : (image.colorspace == rgb ? 3 : 4);
+    const bool isF16 = image.dataFormat == BINARY_16;
+    const uint32_t stride = image.width * channels * (isF16 ? sizeof(uint16_t) : sizeof(uint8_t));
+    const coder::MetricImageView reference = {
+        .data = image.pixels.data(),
+        .stride = stride,
+        .width = image.width,
+        .height = image.height,
+        .channels = channels,
+        .isF16 = isF16,
+    };
+    const JxlPixelFormat decodedFormat = {channels, isF16 ? JXL_TYPE_FLOAT16 : JXL_TYPE_UINT8,
+                                          JXL_NATIVE_ENDIAN, 0};
+    coder::JxlDecoderSessionPool decoders;
+    std::mutex scoresMutex;
+    std::map<float, double> scores;
+
+    auto encoder = [&image, effort, decodingSpeed](float distance, coder::JxlBlockOutputSink &sink,
+                                                   size_t numThreads) {
+      std::vector<uint8_t> iccProfile;
+      JxlColorEncoding colorEncoding = image.colorEncoding;
+      return EncodeJxlAtDistance(image.pixels, image.width, image.height, sink, image.colorspace,
+                                 image.dataFormat, iccProfile, effort, distance,
+                                 (int) decodingSpeed, colorEncoding, numThreads);
+    };
+    auto evaluator = [&](float distance, const coder::JxlBlockOutputSink &sink, size_t numThreads) {
+      pooled_uint8_vector decoded;
+      uint32_t xsize = 0, ysize = 0;
+      if (!decoders.decode(sink, decodedFormat, numThreads, decoded, &xsize, &ysize)
+          || xsize != image.width || ysize != image.height) {
+        throw std::runtime_error("Encoded candidate can't be decoded");
+      }
+      coder::MetricImageView distorted = reference;
+      distorted.data = decoded.data();
+      // Alpha is encoded too, so errors behind translucent pixels count
+      double score = coder::ComputeImageMetric(metric, reference, distorted, true,
+                                               static_cast<uint32_t>(numThreads));
+      {
+        std::lock_guard<std::mutex> guard(scoresMutex);
+        scores[distance] = score;
+      }
+      coder::JxlDistanceProbe probe = {
+          .meetsTarget = score >= targetScore,
+          .closeEnough = score >= targetScore && score <= targetScore + tolerance,
+      };
+      return probe;
+    };
+
+    auto result = coder::SearchJxlDistance(encoder, evaluator, false);
+    if (!result.output) {
+      std::string exc = "Image can't reach the target score " + std::to_string(targetScore);
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    jfloat distanceAndScore[2] = {result.distance, static_cast<jfloat>(scores[result.distance])};
+    env->SetFloatArrayRegion(chosen, 0, 2, distanceAndScore);
+    return NewByteArrayFromSink(env, *result.output);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <string>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlEncoding.h"
+#include "interop/JxlDistanceSearch.hpp"
+#include "interop/JxlMemoryManager.hpp"
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeToTargetSizeImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                         jint javaColorSpace, jint effort,
+                                                         jstring bitmapColorProfile,
+                                                         jint dataSpace, jint decodingSpeed,
+                                                         jlong maxBytes, jfloat tolerance,
+                                                         jfloatArray chosenDistance,
+                                                         jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    if (effort < 0 || effort > 10) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (maxBytes <= 0) {
+      std::string exc = "Target size must be positive";
+      throwException(env, exc);
+      return nullptr;
+    }
+    if (!(tolerance >= 0.f && tolerance < 1.f)) {
+      std::string exc = "Tolerance must be in [0, 1)";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    // Converted once, every candidate encodes the same pixels
+    JxlBitmapPixels image;
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace, image)) {
+      return nullptr;
+    }
+
+    auto encoder = [&image, effort, decodingSpeed](float distance, coder::JxlBlockOutputSink &sink,
+                                                   size_t numThreads) {
+      std::vector<uint8_t> iccProfile;
+      JxlColorEncoding colorEncoding = image.colorEncoding;
+      return EncodeJxlAtDistance(image.pixels, image.width, image.height, sink, image.colorspace,
+                                 image.dataFormat, iccProfile, effort, distance,
+                                 (int) decodingSpeed, colorEncoding, numThreads);
+    };
+    const auto budget = static_cast<uint64_t>(maxBytes);
+    const auto lowerBound = static_cast<uint64_t>(static_cast<double>(budget) * (1.0 - tolerance));
+    // Size alone decides, the distance and the share of workers are of no use here
+    auto evaluator = [budget, lowerBound](float, const coder::JxlBlockOutputSink &sink, size_t) {
+      coder::JxlDistanceProbe probe = {
+          .meetsTarget = sink.size() <= budget,
+          .closeEnough = sink.size() <= budget && sink.size() >= lowerBound,
+      };
+      return probe;
+    };
+
+    auto result = coder::SearchJxlDistance(encoder, evaluator, true);
+    if (!result.output) {
+      std::string exc = "Image can't be encoded into " + std::to_string(maxBytes) + " bytes";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    jfloat distance = result.distance;
+    env->SetFloatArrayRegion(chosenDistance, 0, 1, &distance);
+    return NewByteArrayFromSink(env, *result.output);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
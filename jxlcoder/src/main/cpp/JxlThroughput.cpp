@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <vector>
+#include "interop/JxlThroughputModel.hpp"
+
+extern "C"
+JNIEXPORT jfloatArray JNICALL
+Java_com_awxkee_jxlcoder_JxlThroughputModel_exportStateImpl(JNIEnv *env, jobject thiz) {
+  std::vector<float> state = coder::JxlThroughputModel::shared().exportState();
+  jfloatArray result = env->NewFloatArray(static_cast<jsize>(state.size()));
+  if (result == nullptr) {
+    return nullptr;
+  }
+  env->SetFloatArrayRegion(result, 0, static_cast<jsize>(state.size()), state.data());
+  return result;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_awxkee_jxlcoder_JxlThroughputModel_importStateImpl(JNIEnv *env, jobject thiz,
+                                                            jfloatArray state) {
+  std::vector<float> values(env->GetArrayLength(state));
+  env->GetFloatArrayRegion(state, 0, static_cast<jsize>(values.size()), values.data());
+  return coder::JxlThroughputModel::shared().importState(values.data(), values.size())
+         ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlThroughputModel_resetImpl(JNIEnv *env, jobject thiz) {
+  coder::JxlThroughputModel::shared().reset();
+}
+
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_com_awxkee_jxlcoder_JxlThroughputModel_predictMillisImpl(JNIEnv *env, jobject thiz,
+                                                              jint compressionOption, jint effort,
+                                                              jlong pixels) {
+  auto option = static_cast<JxlCompressionOption>(compressionOption);
+  return static_cast<jfloat>(coder::JxlThroughputModel::shared().predictMillis(
+      option, effort, static_cast<uint64_t>(pixels)));
+}
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <jni.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "JniExceptions.h"
+#include "JniEncoding.h"
+#include "JniOutputTarget.h"
+#include "JxlCancellation.h"
+#include "interop/JxlMemoryManager.hpp"
+#include "interop/JxlThroughputModel.hpp"
+
+// The lowest effort is expected to take up to this much more than predicted when it runs as a fallback
+static constexpr double fallbackMargin = 1.25;
+
+static double MillisSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_awxkee_jxlcoder_JxlCoder_encodeWithTimeBudgetImpl(JNIEnv *env, jobject thiz, jobject bitmap,
+                                                           jint javaColorSpace,
+                                                           jint javaCompressionOption,
+                                                           jstring bitmapColorProfile,
+                                                           jint dataSpace, jint jQuality,
+                                                           jint maxEffort, jint decodingSpeed,
+                                                           jlong budgetMillis, jboolean allowFallback,
+                                                           jfloatArray report,
+                                                           jlong cancellationToken) {
+  concurrency::CancellationScope cancellationScope(cancellationTokenFromHandle(cancellationToken));
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    auto compressionOption = static_cast<JxlCompressionOption>(javaCompressionOption);
+    if (compressionOption != lossy && compressionOption != loseless) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (maxEffort < coder::jxlModelMinEffort || maxEffort > coder::jxlModelMaxEffort) {
+      throwInvalidCompressionOptionException(env);
+      return nullptr;
+    }
+    if (jQuality < 0 || jQuality > 100) {
+      std::string exc = "Quality must be in 0...100";
+      throwException(env, exc);
+      return nullptr;
+    }
+    if (budgetMillis <= 0) {
+      std::string exc = "Time budget must be positive";
+      throwException(env, exc);
+      return nullptr;
+    }
+
+    JxlBitmapPixels image;
+    if (!PrepareBitmapPixels(env, bitmap, javaColorSpace, bitmapColorProfile, dataSpace, image)) {
+      return nullptr;
+    }
+
+    auto &model = coder::JxlThroughputModel::shared();
+    const uint64_t pixels = static_cast<uint64_t>(image.width) * image.height;
+    // Conversion already ate into the budget, only the rest is left for libjxl
+    const double conversionMillis = MillisSince(start);
+    const double remainingMillis = static_cast<double>(budgetMillis) - conversionMillis;
+    const coder::JxlEncodePlan plan = coder::PlanJxlEncode(model, compressionOption, pixels,
+                                                           remainingMillis, maxEffort, decodingSpeed);
+
+    auto encode = [&](int effort, coder::JxlOutputSink &sink) {
+      return EncodeBitmapPixels(image, compressionOption, effort, (int) jQuality,
+                                plan.decodingSpeed, PROFILE_DEFAULT, sink, 0);
+    };
+
+    int effort = plan.effort;
+    bool fellBack = false;
+    auto sink = std::make_unique<coder::JxlBlockOutputSink>();
+    const auto stageStart = std::chrono::steady_clock::now();
+    bool encoded = false;
+
+    if (allowFallback && plan.effort > coder::jxlModelMinEffort) {
+      // The planned effort is abandoned once there would be no time left to finish the lowest one
+      const double fallbackMillis =
+          model.predictMillis(compressionOption, coder::jxlModelMinEffort, pixels) * fallbackMargin;
+      const double deadlineMillis = std::max(remainingMillis - fallbackMillis, plan.predictedMillis);
+      std::shared_ptr<concurrency::CancellationToken> parentToken =
+          concurrency::currentCancellationTokenRef();
+      auto attemptToken = std::make_shared<concurrency::CancellationToken>(parentToken);
+      attemptToken->setTimeout(std::max<int64_t>(static_cast<int64_t>(std::ceil(deadlineMillis)), 1));
+      try {
+        concurrency::CancellationScope attemptScope(attemptToken);
+        encoded = encode(plan.effort, *sink);
+      } catch (concurrency::OperationCancelledException &err) {
+        if (parentToken != nullptr && parentToken->isCancelled()) {
+          throw;
+        }
+        model.record(compressionOption, plan.effort, pixels, MillisSince(stageStart));
+        fellBack = true;
+      }
+      if (fellBack) {
+        effort = coder::jxlModelMinEffort;
+        sink = std::make_unique<coder::JxlBlockOutputSink>();
+        encoded = encode(effort, *sink);
+      }
+    } else {
+      encoded = encode(effort, *sink);
+    }
+
+    if (!encoded) {
+      throwCantCompressImage(env);
+      return nullptr;
+    }
+
+    jfloat values[6] = {
+        static_cast<jfloat>(effort),
+        static_cast<jfloat>(plan.decodingSpeed),
+        fellBack ? 1.f : 0.f,
+        static_cast<jfloat>(plan.predictedMillis),
+        // Includes the abandoned attempt when the encoder has fallen back
+        static_cast<jfloat>(MillisSince(stageStart)),
+        static_cast<jfloat>(MillisSince(start)),
+    };
+    env->SetFloatArrayRegion(report, 0, 6, values);
+    return NewByteArrayFromSink(env, *sink);
+  } catch (coder::JxlMemoryBudgetExceededException &err) {
+    throwMemoryBudgetException(env, err.what());
+    return nullptr;
+  } catch (std::bad_alloc &err) {
+    std::string errorString = "Not enough memory to encode this image";
+    throwException(env, errorString);
+    return nullptr;
+  } catch (std::runtime_error &err) {
+    std::string errorString = "Error: " + std::string(err.what());
+    throwException(env, errorString);
+    return nullptr;
+  } catch (concurrency::OperationCancelledException &err) {
+    throwCancellationException(env, err.what());
+    return nullptr;
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "PixelBufferPool.h"
+#include <jni.h>
+#include <algorithm>
+#include "aligned_allocator.h"
+
+namespace coder {
+
+// aligned_allocator multiplies the alignment by 8, this gives 64 bytes aligned rows
+typedef aligned_allocator<uint8_t, 8> pool_backing_allocator;
+
+PixelBufferPool &PixelBufferPool::shared() {
+  // Intentionally leaked, buffers may be released during static destruction
+  static auto pool = new PixelBufferPool();
+  return *pool;
+}
+
+size_t PixelBufferPool::sizeClass(size_t bytes) {
+  size_t power = 1;
+  while (power <= bytes / 2) {
+    power <<= 1;
+  }
+  size_t step = std::max(power / 8, static_cast<size_t>(64));
+  return (bytes + step - 1) / step * step;
+}
+
+void *PixelBufferPool::acquire(size_t bytes) {
+  pool_backing_allocator allocator;
+  if (bytes < minPooledBytes) {
+    return allocator.allocate(bytes);
+  }
+  size_t classBytes = sizeClass(bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = freeBuffers.find(classBytes);
+    if (found != freeBuffers.end() && !found->second.empty()) {
+      void *buffer = found->second.back();
+      found->second.pop_back();
+      pooledBytes -= classBytes;
+      hits += 1;
+      return buffer;
+    }
+    misses += 1;
+  }
+  try {
+    return allocator.allocate(classBytes);
+  } catch (std::bad_alloc &err) {
+    // Cached buffers of other classes might be the reason, release them and try once again
+    trim(0);
+    return allocator.allocate(classBytes);
+  }
+}
+
+void PixelBufferPool::release(void *buffer, size_t bytes) {
+  pool_backing_allocator allocator;
+  if (bytes < minPooledBytes) {
+    allocator.deallocate(reinterpret_cast<uint8_t *>(buffer), bytes);
+    return;
+  }
+  size_t classBytes = sizeClass(bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pooledBytes + classBytes <= maxPooledBytes) {
+      freeBuffers[classBytes].push_back(buffer);
+      pooledBytes += classBytes;
+      return;
+    }
+  }
+  allocator.deallocate(reinterpret_cast<uint8_t *>(buffer), classBytes);
+}
+
+void PixelBufferPool::setMaxPooledBytes(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  maxPooledBytes = bytes;
+  trimLocked(bytes);
+}
+
+void PixelBufferPool::trim(size_t targetBytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  trimLocked(targetBytes);
+}
+
+void PixelBufferPool::trimLocked(size_t targetBytes) {
+  pool_backing_allocator allocator;
+  for (auto it = freeBuffers.rbegin(); it != freeBuffers.rend() && pooledBytes > targetBytes; ++it) {
+    auto &buffers = it->second;
+    while (!buffers.empty() && pooledBytes > targetBytes) {
+      allocator.deallocate(reinterpret_cast<uint8_t *>(buffers.back()), it->first);
+      buffers.pop_back();
+      pooledBytes -= it->first;
+    }
+  }
+}
+
+PixelBufferPoolStats PixelBufferPool::stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return {
+      .hits = hits,
+      .misses = misses,
+      .pooledBytes = pooledBytes,
+      .maxPooledBytes = maxPooledBytes,
+  };
+}
+
+}
+
+// android.content.ComponentCallbacks2 levels
+static const jint trimMemoryRunningModerate = 5;
+static const jint trimMemoryRunningLow = 10;
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlBufferPool_trimMemoryImpl(JNIEnv *env, jobject thiz, jint level) {
+  auto &pool = coder::PixelBufferPool::shared();
+  if (level >= trimMemoryRunningLow) {
+    pool.trim(0);
+  } else if (level >= trimMemoryRunningModerate) {
+    pool.trim(pool.stats().pooledBytes / 2);
+  }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlBufferPool_setMaxPooledBytesImpl(JNIEnv *env, jobject thiz, jlong bytes) {
+  coder::PixelBufferPool::shared().setMaxPooledBytes(static_cast<size_t>(std::max(bytes, static_cast<jlong>(0))));
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_awxkee_jxlcoder_JxlBufferPool_getStatsImpl(JNIEnv *env, jobject thiz, jlongArray stats) {
+  auto poolStats = coder::PixelBufferPool::shared().stats();
+  jlong values[4] = {
+      static_cast<jlong>(poolStats.hits),
+      static_cast<jlong>(poolStats.misses),
+      static_cast<jlong>(poolStats.pooledBytes),
+      static_cast<jlong>(poolStats.maxPooledBytes),
+  };
+  env->SetLongArrayRegion(stats, 0, 4, values);
+}
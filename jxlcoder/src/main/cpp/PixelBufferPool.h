@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_PIXELBUFFERPOOL_H
+#define JXLCODER_PIXELBUFFERPOOL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace coder {
+
+struct PixelBufferPoolStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t pooledBytes;
+  uint64_t maxPooledBytes;
+};
+
+/**
+ * Process wide cache of large 64 bytes aligned pixel buffers.
+ * Requests are rounded up to size classes ( 8 per power of two ) so buffers of images with
+ * close dimensions are interchangeable. Released buffers are kept while the total amount of
+ * cached bytes fits into the cap, otherwise they are returned to the system immediately.
+ */
+class PixelBufferPool {
+ public:
+  static PixelBufferPool &shared();
+
+  void *acquire(size_t bytes);
+  void release(void *buffer, size_t bytes);
+
+  void setMaxPooledBytes(size_t bytes);
+  // Frees cached buffers, largest first, until no more than targetBytes are cached
+  void trim(size_t targetBytes);
+  PixelBufferPoolStats stats();
+
+  // Smaller buffers are cheap for malloc and bypass the pool
+  static constexpr size_t minPooledBytes = 64 * 1024;
+
+ private:
+  PixelBufferPool() = default;
+
+  static size_t sizeClass(size_t bytes);
+  void trimLocked(size_t targetBytes);
+
+  std::mutex mutex;
+  std::map<size_t, std::vector<void *>> freeBuffers;
+  size_t pooledBytes = 0;
+  size_t maxPooledBytes = 64 * 1024 * 1024;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+/**
+ * Allocator backed by PixelBufferPool. Default construction of elements is a no-op,
+ * so resize() does not zero fill and pages are not touched before the actual write.
+ */
+template<typename T>
+class pooled_allocator {
+ public:
+  typedef T value_type;
+
+  pooled_allocator() = default;
+
+  template<typename U>
+  pooled_allocator(const pooled_allocator<U> &) {}
+
+  T *allocate(const std::size_t n) const {
+    if (n == 0) {
+      return nullptr;
+    }
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::length_error("pooled_allocator<T>::allocate() - Integer overflow.");
+    }
+    return static_cast<T *>(PixelBufferPool::shared().acquire(n * sizeof(T)));
+  }
+
+  void deallocate(T *const p, const std::size_t n) const {
+    if (p != nullptr) {
+      PixelBufferPool::shared().release(p, n * sizeof(T));
+    }
+  }
+
+  template<typename U>
+  void construct(U *p) const {
+    ::new(static_cast<void *>(p)) U;
+  }
+
+  template<typename U, typename... Args>
+  void construct(U *p, Args &&... args) const {
+    ::new(static_cast<void *>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template<typename U>
+  bool operator==(const pooled_allocator<U> &) const {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=(const pooled_allocator<U> &) const {
+    return false;
+  }
+};
+
+}
+
+#endif //JXLCODER_PIXELBUFFERPOOL_H
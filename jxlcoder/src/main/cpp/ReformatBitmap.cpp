@@ -42,13 +42,75 @@
 #include "imagebit/CopyUnalignedRGBA.h"
 #include "imagebit/Rgba16.h"
 #include "imagebit/RgbaU16toHF.h"
+#include "cancellation.hpp"
+
+ReformatPlan
+PlanReformatStorage(const pooled_uint8_vector &imageData, uint32_t srcStride, uint32_t srcPixelSize,
+                    uint32_t dstPixelSize, uint32_t imageWidth, uint32_t imageHeight) {
+  uint32_t lineWidth = imageWidth * dstPixelSize;
+  uint32_t alignment = 64;
+  uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
+  uint32_t alignedStride = lineWidth + padding;
+
+  if (dstPixelSize <= srcPixelSize) {
+    // Rows may only move towards the start of the buffer, drop the padding when it doesn't fit
+    uint32_t dstStride = alignedStride <= srcStride ? alignedStride : lineWidth;
+    return {.storage = REFORMAT_IN_PLACE_FORWARD, .dstStride = dstStride};
+  }
+
+  size_t requiredSize = static_cast<size_t>(alignedStride) * imageHeight;
+  if (alignedStride >= srcStride && imageData.capacity() >= requiredSize) {
+    return {.storage = REFORMAT_IN_PLACE_BACKWARD, .dstStride = alignedStride};
+  }
+  return {.storage = REFORMAT_NEW_BUFFER, .dstStride = alignedStride};
+}
+
+namespace {
+
+/**
+ * Destination storage of a single conversion according to its plan
+ */
+class ReformatTarget {
+ public:
+  ReformatTarget(pooled_uint8_vector &imageData, const ReformatPlan &plan, uint32_t imageHeight)
+      : imageData(imageData), plan(plan),
+        size(static_cast<size_t>(plan.dstStride) * imageHeight) {
+    if (plan.storage == REFORMAT_NEW_BUFFER) {
+      buffer.resize(size);
+    } else if (plan.storage == REFORMAT_IN_PLACE_BACKWARD) {
+      // Within capacity, therefore the storage is not moved
+      imageData.resize(size);
+    }
+  }
+
+  uint8_t *data() {
+    return plan.storage == REFORMAT_NEW_BUFFER ? buffer.data() : imageData.data();
+  }
+
+  void commit() {
+    if (plan.storage == REFORMAT_NEW_BUFFER) {
+      imageData = std::move(buffer);
+    } else {
+      imageData.resize(size);
+    }
+  }
+
+ private:
+  pooled_uint8_vector &imageData;
+  const ReformatPlan plan;
+  const size_t size;
+  pooled_uint8_vector buffer;
+};
+
+}
 
 void
-ReformatColorConfig(JNIEnv *env, std::vector<uint8_t> &imageData, std::string &imageConfig,
+ReformatColorConfig(JNIEnv *env, pooled_uint8_vector &imageData, std::string &imageConfig,
                     PreferredColorConfig preferredColorConfig, uint32_t depth,
                     uint32_t imageWidth, uint32_t imageHeight, uint32_t *stride, bool *useFloats,
                     jobject *hwBuffer, bool alphaPremultiplied, const bool hasAlphaInOrigin) {
   *hwBuffer = nullptr;
+  concurrency::throwIfCurrentOperationCancelled();
   if (preferredColorConfig == Default) {
     int osVersion = androidOSVersion();
     if (depth > 8 && osVersion >= 26) {
@@ -76,18 +138,21 @@ ReformatColorConfig(JNIEnv *env, std::vector<uint8_t> &imageData, std::string &i
     }
   }
 
+  concurrency::throwIfCurrentOperationCancelled();
+
   switch (preferredColorConfig) {
     case Rgba_8888:
       if (*useFloats) {
-        uint32_t lineWidth = imageWidth * 4 * (uint32_t)sizeof(uint8_t);
-        std::vector<uint8_t> rgba8888Data(lineWidth * imageHeight);
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint16_t),
+                                                4 * sizeof(uint8_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
         coder::Rgba16ToRgba8(reinterpret_cast<const uint16_t *>(imageData.data()),
-                             *stride, rgba8888Data.data(), lineWidth, imageWidth,
+                             *stride, target.data(), plan.dstStride, imageWidth,
                              imageHeight, depth);
-        *stride = lineWidth;
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = false;
         imageConfig = "ARGB_8888";
-        imageData = rgba8888Data;
       }
       break;
     case Rgba_F16:
@@ -99,95 +164,80 @@ ReformatColorConfig(JNIEnv *env, std::vector<uint8_t> &imageData, std::string &i
                           imageWidth, imageHeight,
                           depth);
       } else {
-        uint32_t
-            lineWidth = imageWidth * 4 * (uint32_t)
-        sizeof(uint16_t);
-        uint32_t alignment = 64;
-        uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
-        uint32_t dstStride = lineWidth + padding;
-        std::vector<uint8_t> rgbaF16Data(dstStride * imageHeight);
-        coder::Rgba8ToF16(imageData.data(), *stride,
-                          reinterpret_cast<uint16_t *>(rgbaF16Data.data()), dstStride,
-                          imageWidth, imageHeight, !alphaPremultiplied);
-        *stride = dstStride;
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint8_t),
+                                                4 * sizeof(uint16_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
+        if (plan.storage == REFORMAT_IN_PLACE_BACKWARD) {
+          coder::Rgba8ToF16InPlace(imageData.data(), *stride, plan.dstStride,
+                                   imageWidth, imageHeight, !alphaPremultiplied);
+        } else {
+          coder::Rgba8ToF16(imageData.data(), *stride,
+                            reinterpret_cast<uint16_t *>(target.data()), plan.dstStride,
+                            imageWidth, imageHeight, !alphaPremultiplied);
+        }
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = true;
         imageConfig = "RGBA_F16";
-        imageData = rgbaF16Data;
       }
       break;
     case Rgb_565:
       if (*useFloats) {
-        uint32_t
-            lineWidth = imageWidth * (uint32_t)
-        sizeof(uint16_t);
-        uint32_t alignment = 64;
-        uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
-        uint32_t dstStride = lineWidth + padding;
-        std::vector<uint8_t> rgb565Data(dstStride * imageHeight);
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint16_t),
+                                                sizeof(uint16_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
         coder::Rgba16To565(reinterpret_cast<const uint16_t *>(imageData.data()),
                            *stride,
-                           reinterpret_cast<uint16_t *>(rgb565Data.data()), dstStride,
+                           reinterpret_cast<uint16_t *>(target.data()), plan.dstStride,
                            imageWidth, imageHeight, depth);
-        *stride = dstStride;
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = false;
         imageConfig = "RGB_565";
-        imageData = rgb565Data;
         break;
       } else {
-        uint32_t
-            lineWidth = imageWidth * (uint32_t)
-        sizeof(uint16_t);
-        uint32_t alignment = 64;
-        uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
-        uint32_t dstStride = lineWidth + padding;
-        std::vector<uint8_t> rgb565Data(dstStride * imageHeight);
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint8_t),
+                                                sizeof(uint16_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
         coder::Rgba8To565(imageData.data(), *stride,
-                          reinterpret_cast<uint16_t *>(rgb565Data.data()), dstStride,
+                          reinterpret_cast<uint16_t *>(target.data()), plan.dstStride,
                           imageWidth, imageHeight,
                           !alphaPremultiplied);
-        *stride = dstStride;
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = false;
         imageConfig = "RGB_565";
-        imageData = rgb565Data;
       }
       break;
     case Rgba_1010102:
       if (*useFloats) {
-        uint32_t
-            lineWidth = imageWidth * (uint32_t)
-        sizeof(uint32_t);
-        uint32_t alignment = 64;
-        uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
-        uint32_t dstStride = lineWidth + padding;
-        std::vector<uint8_t> rgba1010102Data(dstStride * imageHeight);
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint16_t),
+                                                sizeof(uint32_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
         coder::Rgba16ToRGBA1010102(reinterpret_cast<const uint16_t *>(imageData.data()),
                                    *stride,
-                                   reinterpret_cast<uint8_t *>(rgba1010102Data.data()),
-                                   dstStride,
+                                   target.data(),
+                                   plan.dstStride,
                                    imageWidth, imageHeight, depth);
-        *stride = dstStride;
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = false;
         imageConfig = "RGBA_1010102";
-        imageData = rgba1010102Data;
         break;
       } else {
-        uint32_t
-            lineWidth = imageWidth * (uint32_t)
-        sizeof(uint32_t);
-        uint32_t alignment = 64;
-        uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
-        uint32_t dstStride = lineWidth + padding;
-        std::vector<uint8_t> rgba1010102Data(dstStride * imageHeight);
+        ReformatPlan plan = PlanReformatStorage(imageData, *stride, 4 * sizeof(uint8_t),
+                                                sizeof(uint32_t), imageWidth, imageHeight);
+        ReformatTarget target(imageData, plan, imageHeight);
         coder::Rgba8ToRGBA1010102(reinterpret_cast<const uint8_t *>(imageData.data()),
                                   *stride,
-                                  reinterpret_cast<uint8_t *>(rgba1010102Data.data()),
-                                  dstStride,
+                                  target.data(),
+                                  plan.dstStride,
                                   imageWidth, imageHeight,
                                   !alphaPremultiplied);
-        *stride = dstStride;
+        target.commit();
+        *stride = plan.dstStride;
         *useFloats = false;
         imageConfig = "RGBA_1010102";
-        imageData = rgba1010102Data;
         break;
       }
       break;
@@ -30,10 +30,32 @@
 
 #include <jni.h>
 #include <vector>
+#include "definitions.h"
 #include "Support.h"
 
+enum ReformatStorage {
+  REFORMAT_NEW_BUFFER = 0,
+  // Destination pixels are not larger than source ones, converted front to back over the same buffer
+  REFORMAT_IN_PLACE_FORWARD = 1,
+  // Destination pixels are larger and the buffer has enough capacity, converted back to front
+  REFORMAT_IN_PLACE_BACKWARD = 2,
+};
+
+struct ReformatPlan {
+  ReformatStorage storage;
+  uint32_t dstStride;
+};
+
+/**
+ * Decides whether converting imageData from srcPixelSize to dstPixelSize bytes per pixel
+ * can reuse its storage instead of allocating a second frame.
+ */
+ReformatPlan
+PlanReformatStorage(const pooled_uint8_vector &imageData, uint32_t srcStride, uint32_t srcPixelSize,
+                    uint32_t dstPixelSize, uint32_t imageWidth, uint32_t imageHeight);
+
 void
-ReformatColorConfig(JNIEnv *env, std::vector<uint8_t> &imageData, std::string &imageConfig,
+ReformatColorConfig(JNIEnv *env, pooled_uint8_vector &imageData, std::string &imageConfig,
                     PreferredColorConfig preferredColorConfig, uint32_t depth,
                     uint32_t imageWidth, uint32_t imageHeight, uint32_t *stride, bool *useFloats,
                     jobject *hwBuffer, bool alphaPremultiplied, const bool hasAlphaInOrigin);
@@ -34,8 +34,9 @@
 #include "XScaler.h"
 #include "Eigen/Eigen"
 #include "weaver.h"
+#include "cancellation.hpp"
 
-bool RescaleImage(std::vector<uint8_t> &rgbaData,
+bool RescaleImage(pooled_uint8_vector &rgbaData,
                   JNIEnv *env,
                   uint32_t *stride,
                   bool useFloats,
@@ -46,49 +47,44 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
                   ScaleMode scaleMode,
                   XSampler sampler,
                   bool doesOriginHasAlpha) {
+  return RescaleImageInto(rgbaData.data(), *stride, *imageWidthPtr, *imageHeightPtr,
+                          rgbaData, stride, useFloats,
+                          imageWidthPtr, imageHeightPtr, scaledWidth, scaledHeight,
+                          bitDepth, alphaPremultiplied, scaleMode, sampler, doesOriginHasAlpha);
+}
+
+bool RescaleImageInto(const uint8_t *source,
+                      uint32_t sourceStride,
+                      uint32_t sourceWidth,
+                      uint32_t sourceHeight,
+                      pooled_uint8_vector &rgbaData,
+                      uint32_t *stride,
+                      bool useFloats,
+                      uint32_t *imageWidthPtr, uint32_t *imageHeightPtr,
+                      int scaledWidth, int scaledHeight,
+                      uint32_t bitDepth,
+                      bool alphaPremultiplied,
+                      ScaleMode scaleMode,
+                      XSampler sampler,
+                      bool doesOriginHasAlpha) {
   uint32_t imageWidth = *imageWidthPtr;
   uint32_t imageHeight = *imageHeightPtr;
   if ((scaledHeight != 0 || scaledWidth != 0) && (scaledWidth != 0 && scaledHeight != 0)) {
 
-    int xTranslation = 0, yTranslation = 0;
-    int canvasWidth = scaledWidth;
-    int canvasHeight = scaledHeight;
-
-    if (scaleMode == Fit || scaleMode == Fill) {
-      std::pair<int, int> currentSize(imageWidth, imageHeight);
-      if (scaledHeight > 0 && scaledWidth < 0) {
-        auto newBounds = ResizeAspectHeight(currentSize, scaledHeight, scaledHeight == -2);
-        scaledWidth = newBounds.first;
-        scaledHeight = newBounds.second;
-      } else if (scaledHeight < 0) {
-        auto newBounds = ResizeAspectWidth(currentSize, scaledWidth, scaledWidth == -2);
-        scaledWidth = newBounds.first;
-        scaledHeight = newBounds.second;
-      } else {
-        std::pair<int, int> dstSize;
-        float scale = 1;
-        if (scaleMode == Fill) {
-          std::pair<int, int> canvasSize(scaledWidth, scaledHeight);
-          dstSize = ResizeAspectFill(currentSize, canvasSize, &scale);
-        } else {
-          std::pair<int, int> canvasSize(scaledWidth, scaledHeight);
-          dstSize = ResizeAspectFit(currentSize, canvasSize, &scale);
-        }
-
-        xTranslation = std::max((int) (((float) dstSize.first - (float) canvasWidth) / 2.0f), 0);
-        yTranslation = std::max((int) (((float) dstSize.second - (float) canvasHeight) / 2.0f), 0);
-
-        scaledWidth = dstSize.first;
-        scaledHeight = dstSize.second;
-      }
-    }
+    RescaleGeometry geometry = ResolveRescaleGeometry(imageWidth, imageHeight,
+                                                      scaledWidth, scaledHeight, scaleMode);
+    int xTranslation = geometry.xTranslation, yTranslation = geometry.yTranslation;
+    int canvasWidth = geometry.canvasWidth;
+    int canvasHeight = geometry.canvasHeight;
+    scaledWidth = geometry.resampledWidth;
+    scaledHeight = geometry.resampledHeight;
 
     uint32_t lineWidth = scaledWidth * static_cast<int>(useFloats ? sizeof(uint16_t) : sizeof(uint8_t)) * 4;
     uint32_t alignment = 64;
     uint32_t padding = (alignment - (lineWidth % alignment)) % alignment;
     uint32_t imdStride = lineWidth + padding;
 
-    std::vector<uint8_t> newImageData(imdStride * scaledHeight);
+    pooled_uint8_vector newImageData(imdStride * scaledHeight);
 
     ScalingFunction sparkSampler = ScalingFunction::Bilinear;
     switch (sampler) {
@@ -134,18 +130,21 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
         break;
     }
 
+    // Weaver scaler can't be interrupted, so cancellation is observed around it
+    concurrency::throwIfCurrentOperationCancelled();
+
     if (useFloats) {
-      weave_scale_u16(reinterpret_cast<const uint16_t *>(rgbaData.data()),
-                      imageWidth * 4 * (int) sizeof(uint16_t),
-                      imageWidth, imageHeight,
+      weave_scale_u16(reinterpret_cast<const uint16_t *>(source),
+                      sourceStride,
+                      sourceWidth, sourceHeight,
                       reinterpret_cast<uint16_t *>(newImageData.data()),
                       imdStride,
                       scaledWidth, scaledHeight, bitDepth, static_cast<ScalingFunction>(sparkSampler),
                       doesOriginHasAlpha);
     } else {
-      weave_scale_u8(reinterpret_cast<const uint8_t *>(rgbaData.data()),
-                     (int) imageWidth * 4 * (int) sizeof(uint8_t),
-                     imageWidth, imageHeight,
+      weave_scale_u8(reinterpret_cast<const uint8_t *>(source),
+                     sourceStride,
+                     sourceWidth, sourceHeight,
                      reinterpret_cast<uint8_t *>(newImageData.data()),
                      imdStride,
                      scaledWidth, scaledHeight, static_cast<ScalingFunction>(sparkSampler),
@@ -153,6 +152,8 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
 
     }
 
+    concurrency::throwIfCurrentOperationCancelled();
+
     imageWidth = scaledWidth;
     imageHeight = scaledHeight;
 
@@ -168,12 +169,15 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
           croppedWidth * 4 * (int) (useFloats ? sizeof(uint16_t) : sizeof(uint8_t));
       int srcStride = imdStride;
 
-      std::vector<uint8_t> croppedImage(newStride * croppedHeight);
+      pooled_uint8_vector croppedImage(newStride * croppedHeight);
 
       uint8_t *dstData = croppedImage.data();
       auto srcData = reinterpret_cast<const uint8_t *>(newImageData.data());
 
       for (int y = top, yc = 0; y < bottom; ++y, ++yc) {
+        if (yc % concurrency::cancellationCheckInterval == 0) {
+          concurrency::throwIfCurrentOperationCancelled();
+        }
         int x = 0;
         int xc = 0;
         auto srcRow = reinterpret_cast<const uint8_t *>(srcData + srcStride * y);
@@ -198,11 +202,11 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
       imageWidth = croppedWidth;
       imageHeight = croppedHeight;
 
-      rgbaData = croppedImage;
+      rgbaData = std::move(croppedImage);
       *stride = newStride;
 
     } else {
-      rgbaData = newImageData;
+      rgbaData = std::move(newImageData);
       *stride = imdStride;
     }
 
@@ -213,6 +217,49 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
   return true;
 }
 
+RescaleGeometry ResolveRescaleGeometry(uint32_t imageWidth, uint32_t imageHeight,
+                                       int scaledWidth, int scaledHeight,
+                                       ScaleMode scaleMode) {
+  RescaleGeometry geometry = {
+      .resampledWidth = scaledWidth,
+      .resampledHeight = scaledHeight,
+      .canvasWidth = scaledWidth,
+      .canvasHeight = scaledHeight,
+      .xTranslation = 0,
+      .yTranslation = 0,
+  };
+
+  if (scaleMode == Fit || scaleMode == Fill) {
+    std::pair<int, int> currentSize(imageWidth, imageHeight);
+    if (scaledHeight > 0 && scaledWidth < 0) {
+      auto newBounds = ResizeAspectHeight(currentSize, scaledHeight, scaledHeight == -2);
+      geometry.resampledWidth = newBounds.first;
+      geometry.resampledHeight = newBounds.second;
+    } else if (scaledHeight < 0) {
+      auto newBounds = ResizeAspectWidth(currentSize, scaledWidth, scaledWidth == -2);
+      geometry.resampledWidth = newBounds.first;
+      geometry.resampledHeight = newBounds.second;
+    } else {
+      std::pair<int, int> dstSize;
+      float scale = 1;
+      if (scaleMode == Fill) {
+        std::pair<int, int> canvasSize(scaledWidth, scaledHeight);
+        dstSize = ResizeAspectFill(currentSize, canvasSize, &scale);
+      } else {
+        std::pair<int, int> canvasSize(scaledWidth, scaledHeight);
+        dstSize = ResizeAspectFit(currentSize, canvasSize, &scale);
+      }
+
+      geometry.xTranslation = std::max((int) (((float) dstSize.first - (float) scaledWidth) / 2.0f), 0);
+      geometry.yTranslation = std::max((int) (((float) dstSize.second - (float) scaledHeight) / 2.0f), 0);
+
+      geometry.resampledWidth = dstSize.first;
+      geometry.resampledHeight = dstSize.second;
+    }
+  }
+  return geometry;
+}
+
 std::pair<int, int>
 ResizeAspectFit(std::pair<int, int> sourceSize, std::pair<int, int> dstSize, float *scale) {
   int sourceWidth = sourceSize.first;
@@ -234,8 +281,9 @@ ResizeAspectFill(std::pair<int, int> sourceSize, std::pair<int, int> dstSize, fl
   float yFactor = (float) dstSize.second / (float) sourceSize.second;
   float resizeFactor = std::max(xFactor, yFactor);
   *scale = resizeFactor;
-  std::pair<int, int> resultSize((int) ((float) sourceWidth * resizeFactor),
-                                 (int) ((float) sourceHeight * resizeFactor));
+  // Truncation may leave the covering side one pixel short of the canvas that is cropped afterwards
+  std::pair<int, int> resultSize(std::max((int) ((float) sourceWidth * resizeFactor), dstSize.first),
+                                 std::max((int) ((float) sourceHeight * resizeFactor), dstSize.second));
   return resultSize;
 }
 
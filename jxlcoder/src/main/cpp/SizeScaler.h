@@ -30,6 +30,7 @@
 #define AVIF_SIZESCALER_H
 
 #include <vector>
+#include "definitions.h"
 #include <jni.h>
 #include "XScaler.h"
 
@@ -39,7 +40,7 @@ enum ScaleMode {
   Resize = 3,
 };
 
-bool RescaleImage(std::vector<uint8_t> &rgbaData,
+bool RescaleImage(pooled_uint8_vector &rgbaData,
                   JNIEnv *env,
                   uint32_t *stride,
                   bool useFloats,
@@ -51,6 +52,42 @@ bool RescaleImage(std::vector<uint8_t> &rgbaData,
                   XSampler sampler,
                   bool doesOriginHasAlpha);
 
+/**
+ * Same as RescaleImage but reads from an arbitrary strided source, result is written into rgbaData
+ * which may alias the source storage. Target geometry is resolved against imageWidthPtr x imageHeightPtr,
+ * while the source might be an already downscaled copy of that image with the same aspect.
+ * When no scaling is requested rgbaData is left untouched.
+ */
+bool RescaleImageInto(const uint8_t *source,
+                      uint32_t sourceStride,
+                      uint32_t sourceWidth,
+                      uint32_t sourceHeight,
+                      pooled_uint8_vector &rgbaData,
+                      uint32_t *stride,
+                      bool useFloats,
+                      uint32_t *imageWidthPtr, uint32_t *imageHeightPtr,
+                      int scaledWidth, int scaledHeight,
+                      uint32_t bit_depth,
+                      bool alphaPremultiplied,
+                      ScaleMode scaleMode,
+                      XSampler sampler,
+                      bool doesOriginHasAlpha);
+
+struct RescaleGeometry {
+  // Size the image is resampled into
+  int resampledWidth;
+  int resampledHeight;
+  // Requested size, the resampled image is cropped to it when translations are non zero
+  int canvasWidth;
+  int canvasHeight;
+  int xTranslation;
+  int yTranslation;
+};
+
+RescaleGeometry ResolveRescaleGeometry(uint32_t imageWidth, uint32_t imageHeight,
+                                       int scaledWidth, int scaledHeight,
+                                       ScaleMode scaleMode);
+
 std::pair<int, int>
 ResizeAspectFit(std::pair<int, int> sourceSize, std::pair<int, int> dstSize, float *scale);
 
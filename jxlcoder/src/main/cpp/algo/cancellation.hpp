@@ -0,0 +1,170 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+
+namespace concurrency {
+
+// Number of iterations ( usually rows ) processed between cancellation checks
+static constexpr int cancellationCheckInterval = 16;
+
+class OperationCancelledException : public std::exception {
+ public:
+  explicit OperationCancelledException(bool deadlineExceeded) : deadlineExceeded(deadlineExceeded) {}
+
+  [[nodiscard]] const char *what() const noexcept override {
+    return deadlineExceeded ? "Operation deadline exceeded" : "Operation was cancelled";
+  }
+
+  [[nodiscard]] bool isDeadlineExceeded() const {
+    return deadlineExceeded;
+  }
+
+ private:
+  bool deadlineExceeded;
+};
+
+/**
+ * Cooperative cancellation flag with an optional deadline.
+ * Long-running stages poll it between units of work and bail out by throwing
+ * OperationCancelledException, so every buffer owned by the stage is released on unwind.
+ */
+class CancellationToken {
+ public:
+  CancellationToken() : cancelled(false), deadlineNanos(0) {}
+
+  /**
+   * Token that additionally fires together with the parent, used to narrow the deadline of a nested stage
+   */
+  explicit CancellationToken(std::shared_ptr<CancellationToken> parent)
+      : cancelled(false), deadlineNanos(0), parent(std::move(parent)) {}
+
+  void cancel() {
+    cancelled.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @param timeoutMillis deadline relative to now, values <= 0 remove the deadline
+   */
+  void setTimeout(int64_t timeoutMillis) {
+    if (timeoutMillis <= 0) {
+      deadlineNanos.store(0, std::memory_order_release);
+      return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis);
+    deadlineNanos.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline.time_since_epoch()).count(), std::memory_order_release);
+  }
+
+  [[nodiscard]] bool isDeadlineExceeded() const {
+    int64_t deadline = deadlineNanos.load(std::memory_order_acquire);
+    if (deadline == 0) {
+      return false;
+    }
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return now >= deadline;
+  }
+
+  [[nodiscard]] bool isCancelled() const {
+    return cancelled.load(std::memory_order_acquire) || isDeadlineExceeded()
+        || (parent != nullptr && parent->isCancelled());
+  }
+
+  void throwIfCancelled() const {
+    if (parent != nullptr) {
+      parent->throwIfCancelled();
+    }
+    if (cancelled.load(std::memory_order_acquire)) {
+      throw OperationCancelledException(false);
+    }
+    if (isDeadlineExceeded()) {
+      throw OperationCancelledException(true);
+    }
+  }
+
+ private:
+  std::atomic<bool> cancelled;
+  std::atomic<int64_t> deadlineNanos;
+  const std::shared_ptr<CancellationToken> parent;
+};
+
+// Must keep external linkage so every translation unit shares the same thread local slot
+inline std::shared_ptr<CancellationToken> &currentCancellationTokenRef() {
+  static thread_local std::shared_ptr<CancellationToken> token;
+  return token;
+}
+
+/**
+ * Token of the operation running on the current thread, or nullptr when it can't be cancelled.
+ */
+inline CancellationToken *currentCancellationToken() {
+  return currentCancellationTokenRef().get();
+}
+
+inline bool isCurrentOperationCancelled() {
+  auto token = currentCancellationToken();
+  return token != nullptr && token->isCancelled();
+}
+
+inline void throwIfCurrentOperationCancelled() {
+  auto token = currentCancellationToken();
+  if (token != nullptr) {
+    token->throwIfCancelled();
+  }
+}
+
+/**
+ * Installs a token for the current thread for the lifetime of the scope.
+ */
+class CancellationScope {
+ public:
+  explicit CancellationScope(std::shared_ptr<CancellationToken> token)
+      : previous(std::move(currentCancellationTokenRef())) {
+    currentCancellationTokenRef() = std::move(token);
+  }
+
+  ~CancellationScope() {
+    currentCancellationTokenRef() = std::move(previous);
+  }
+
+  CancellationScope(const CancellationScope &) = delete;
+  CancellationScope &operator=(const CancellationScope &) = delete;
+
+ private:
+  std::shared_ptr<CancellationToken> previous;
+};
+
+}
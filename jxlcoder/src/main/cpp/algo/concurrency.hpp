@@ -6,6 +6,7 @@
 #include <thread>
 #include <vector>
 #include <type_traits>
+#include "cancellation.hpp"
 
 namespace concurrency {
 
@@ -25,8 +26,14 @@ void parallel_for(const uint32_t numThreads, const uint32_t numIterations, Funct
 
   uint32_t segmentHeight = numIterations / numThreads;
 
+  // Workers don't inherit the thread local token, so it is polled through a captured copy
+  std::shared_ptr<CancellationToken> token = currentCancellationTokenRef();
+
   auto parallelWorker = [&](int start, int end) {
     for (int y = start; y < end; ++y) {
+      if (token && ((y - start) % cancellationCheckInterval) == 0 && token->isCancelled()) {
+        break;
+      }
       {
         std::invoke(func, y, std::forward<Args>(args)...);
       }
@@ -58,6 +65,10 @@ void parallel_for(const uint32_t numThreads, const uint32_t numIterations, Funct
       thread.join();
     }
   }
+
+  if (token) {
+    token->throwIfCancelled();
+  }
 }
 
 template<typename Function, typename... Args>
@@ -68,8 +79,13 @@ void parallel_for_with_thread_id(const int numThreads, const int numIterations,
 
   int segmentHeight = numIterations / numThreads;
 
+  std::shared_ptr<CancellationToken> token = currentCancellationTokenRef();
+
   auto parallel_worker = [&](int threadId, int start, int end) {
     for (int y = start; y < end; ++y) {
+      if (token && ((y - start) % cancellationCheckInterval) == 0 && token->isCancelled()) {
+        break;
+      }
       {
         std::invoke(func, threadId, y, std::forward<Args>(args)...);
       }
@@ -101,5 +117,9 @@ void parallel_for_with_thread_id(const int numThreads, const int numIterations,
       thread.join();
     }
   }
+
+  if (token) {
+    token->throwIfCancelled();
+  }
 }
 }
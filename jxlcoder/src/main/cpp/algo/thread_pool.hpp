@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace concurrency {
+
+/**
+ * Fixed size pool of long-living workers.
+ * Unlike parallel_for it doesn't spawn threads per call, so it's used for job level scheduling
+ * where many small tasks are submitted over time.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(uint32_t numThreads) : stopping(false) {
+    numThreads = std::max(numThreads, 1u);
+    for (uint32_t i = 0; i < numThreads; ++i) {
+      workers.emplace_back([this]() { this->work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> guard(mutex);
+      stopping = true;
+    }
+    condition.notify_all();
+    for (auto &worker : workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void submit(std::function<void()> task) {
+    {
+      std::unique_lock<std::mutex> guard(mutex);
+      tasks.emplace_back(std::move(task));
+    }
+    condition.notify_one();
+  }
+
+  template<typename Function>
+  std::future<std::invoke_result_t<Function>> enqueue(Function &&func) {
+    using Result = std::invoke_result_t<Function>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(func));
+    std::future<Result> future = task->get_future();
+    submit([task]() { (*task)(); });
+    return future;
+  }
+
+  [[nodiscard]] uint32_t size() const {
+    return static_cast<uint32_t>(workers.size());
+  }
+
+  /**
+   * @return true when called from one of the pool's workers,
+   * blocking on pool futures from there may deadlock
+   */
+  [[nodiscard]] bool isWorkerThread() const {
+    auto id = std::this_thread::get_id();
+    for (const auto &worker : workers) {
+      if (worker.get_id() == id) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  void work() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> guard(mutex);
+        condition.wait(guard, [this]() { return stopping || !tasks.empty(); });
+        if (stopping && tasks.empty()) {
+          return;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping;
+};
+
+/**
+ * Process wide pool shared by every asynchronous and batched operation of the library.
+ * It is intentionally never destroyed, workers may be attached to the JVM at process exit.
+ */
+inline ThreadPool &sharedThreadPool() {
+  static ThreadPool *pool = new ThreadPool(std::max(std::thread::hardware_concurrency(), 2u));
+  return *pool;
+}
+
+}
@@ -35,7 +35,7 @@
 
 using namespace std;
 
-void convertUseDefinedColorSpace(std::vector<uint8_t> &vector, uint32_t stride, uint32_t width, uint32_t height,
+void convertUseDefinedColorSpace(pooled_uint8_vector &vector, uint32_t stride, uint32_t width, uint32_t height,
                                  const unsigned char *colorSpace, size_t colorSpaceSize,
                                  bool image16Bits) {
   cmsContext context = cmsCreateContext(nullptr, nullptr);
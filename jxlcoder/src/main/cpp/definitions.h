@@ -31,9 +31,12 @@
 
 #include <aligned_allocator.h>
 #include <vector>
+#include "PixelBufferPool.h"
 
 typedef std::vector<float, aligned_allocator<float, sizeof(float)>> aligned_float_vector;
 typedef std::vector<uint8_t, aligned_allocator<uint8_t, sizeof(uint32_t)>> aligned_uint8_vector;
 typedef std::vector<uint16_t, aligned_allocator<uint16_t, sizeof(uint32_t)>> aligned_uint16_vector;
+// Pixel planes passed between pipeline stages, resize() leaves contents uninitialized
+typedef std::vector<uint8_t, coder::pooled_allocator<uint8_t>> pooled_uint8_vector;
 
 #endif //AVIF_DEFINITIONS_H
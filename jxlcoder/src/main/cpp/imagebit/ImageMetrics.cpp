@@ -0,0 +1,748 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "ImageMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "concurrency.hpp"
+#include "conversion/HalfFloats.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/ImageMetrics.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+// Radius of the gaussian blur of SSIMULACRA 2, sigma 1.5 is negligible past it
+static constexpr int kMetricBlurRadius = 5;
+
+template<class D, class V>
+HWY_INLINE V CubeRoot(D d, V x) {
+  const Rebind<int32_t, D> di;
+  // A third of the exponent is the first guess, refined by Newton steps y = (2y + x / y^2) / 3
+  auto bits = ConvertTo(d, BitCast(di, x));
+  V y = BitCast(d, Add(ConvertTo(di, Mul(bits, Set(d, 1.f / 3.f))), Set(di, 709921077)));
+  const V third = Set(d, 1.f / 3.f);
+  const V two = Set(d, 2.f);
+  for (int i = 0; i < 3; ++i) {
+    y = Mul(MulAdd(two, y, Div(x, Mul(y, y))), third);
+  }
+  return y;
+}
+
+template<class D>
+HWY_INLINE void LinearToXybPixels(D d, const float *HWY_RESTRICT r, const float *HWY_RESTRICT g,
+                                  const float *HWY_RESTRICT b, float *HWY_RESTRICT outX,
+                                  float *HWY_RESTRICT outY, float *HWY_RESTRICT outB) {
+  // Opsin absorbance of libjxl XYB
+  const float kM02 = 0.078f, kM00 = 0.30f, kM01 = 1.0f - kM02 - kM00;
+  const float kM12 = 0.078f, kM10 = 0.23f, kM11 = 1.0f - kM12 - kM10;
+  const float kM20 = 0.24342268924547819f, kM21 = 0.20476744424496821f, kM22 = 1.0f - kM20 - kM21;
+  const float kBias = 0.0037930732552754493f;
+  const auto bias = Set(d, kBias);
+  const auto biasCbrt = Set(d, std::cbrt(kBias));
+  const auto zero = Zero(d);
+  const auto half = Set(d, 0.5f);
+
+  auto vr = LoadU(d, r);
+  auto vg = LoadU(d, g);
+  auto vb = LoadU(d, b);
+  auto mixed0 = MulAdd(Set(d, kM00), vr, MulAdd(Set(d, kM01), vg, MulAdd(Set(d, kM02), vb, bias)));
+  auto mixed1 = MulAdd(Set(d, kM10), vr, MulAdd(Set(d, kM11), vg, MulAdd(Set(d, kM12), vb, bias)));
+  auto mixed2 = MulAdd(Set(d, kM20), vr, MulAdd(Set(d, kM21), vg, MulAdd(Set(d, kM22), vb, bias)));
+  mixed0 = Sub(CubeRoot(d, Max(mixed0, zero)), biasCbrt);
+  mixed1 = Sub(CubeRoot(d, Max(mixed1, zero)), biasCbrt);
+  mixed2 = Sub(CubeRoot(d, Max(mixed2, zero)), biasCbrt);
+
+  auto x = Mul(Sub(mixed0, mixed1), half);
+  auto y = Mul(Add(mixed0, mixed1), half);
+  // Shifted and scaled into positive ranges of comparable magnitude as SSIMULACRA 2 does
+  StoreU(Add(Sub(mixed2, y), Set(d, 0.55f)), d, outB);
+  StoreU(MulAdd(x, Set(d, 14.f), Set(d, 0.42f)), d, outX);
+  StoreU(Add(y, Set(d, 0.01f)), d, outY);
+}
+
+void LinearToXybRowHWY(const float *r, const float *g, const float *b,
+                       float *outX, float *outY, float *outB, const uint32_t width) {
+  const ScalableTag<float> d;
+  const CappedTag<float, 1> d1;
+  const uint32_t lanes = Lanes(d);
+  uint32_t x = 0;
+  for (; x + lanes <= width; x += lanes) {
+    LinearToXybPixels(d, r + x, g + x, b + x, outX + x, outY + x, outB + x);
+  }
+  for (; x < width; ++x) {
+    LinearToXybPixels(d1, r + x, g + x, b + x, outX + x, outY + x, outB + x);
+  }
+}
+
+template<class D>
+HWY_INLINE void BlurPixelsH(D d, const float *HWY_RESTRICT src, float *HWY_RESTRICT dst,
+                            const float *HWY_RESTRICT weights) {
+  auto sum = Mul(LoadU(d, src), Set(d, weights[0]));
+  for (int k = 1; k <= kMetricBlurRadius; ++k) {
+    sum = MulAdd(Add(LoadU(d, src - k), LoadU(d, src + k)), Set(d, weights[k]), sum);
+  }
+  StoreU(sum, d, dst);
+}
+
+/**
+ * @param padded row extended by the blur radius on both sides
+ */
+void BlurRowHWY(const float *padded, float *dst, const uint32_t width, const float *weights) {
+  const ScalableTag<float> d;
+  const CappedTag<float, 1> d1;
+  const uint32_t lanes = Lanes(d);
+  const float *src = padded + kMetricBlurRadius;
+  uint32_t x = 0;
+  for (; x + lanes <= width; x += lanes) {
+    BlurPixelsH(d, src + x, dst + x, weights);
+  }
+  for (; x < width; ++x) {
+    BlurPixelsH(d1, src + x, dst + x, weights);
+  }
+}
+
+template<class D>
+HWY_INLINE void MultiplyPixels(D d, const float *HWY_RESTRICT a, const float *HWY_RESTRICT b,
+                               float *HWY_RESTRICT dst) {
+  StoreU(Mul(LoadU(d, a), LoadU(d, b)), d, dst);
+}
+
+void MultiplyRowHWY(const float *a, const float *b, float *dst, const uint32_t width) {
+  const ScalableTag<float> d;
+  const CappedTag<float, 1> d1;
+  const uint32_t lanes = Lanes(d);
+  uint32_t x = 0;
+  for (; x + lanes <= width; x += lanes) {
+    MultiplyPixels(d, a + x, b + x, dst + x);
+  }
+  for (; x < width; ++x) {
+    MultiplyPixels(d1, a + x, b + x, dst + x);
+  }
+}
+
+template<class D, class V>
+HWY_INLINE V BlurPixelsV(D d, const float *const *HWY_RESTRICT rows, const uint32_t x,
+                         const float *HWY_RESTRICT weights) {
+  auto sum = Mul(LoadU(d, rows[kMetricBlurRadius] + x), Set(d, weights[0]));
+  for (int k = 1; k <= kMetricBlurRadius; ++k) {
+    sum = MulAdd(Add(LoadU(d, rows[kMetricBlurRadius - k] + x),
+                     LoadU(d, rows[kMetricBlurRadius + k] + x)), Set(d, weights[k]), sum);
+  }
+  return sum;
+}
+
+template<class D, class V = Vec<D>>
+HWY_INLINE void AccumulateScalePixels(D d, const float *const *HWY_RESTRICT rows,
+                                      const float *HWY_RESTRICT a, const float *HWY_RESTRICT b,
+                                      const uint32_t x, const float *HWY_RESTRICT weights,
+                                      V &ssim, V &ssim4, V &artifact, V &artifact4,
+                                      V &detail, V &detail4) {
+  constexpr int taps = 2 * kMetricBlurRadius + 1;
+  // Vertical pass over rows blurred horizontally, the blurred planes are never stored
+  const V mu1 = BlurPixelsV<D, V>(d, rows, x, weights);
+  const V mu2 = BlurPixelsV<D, V>(d, rows + taps, x, weights);
+  const V sigma11 = BlurPixelsV<D, V>(d, rows + 2 * taps, x, weights);
+  const V sigma22 = BlurPixelsV<D, V>(d, rows + 3 * taps, x, weights);
+  const V sigma12 = BlurPixelsV<D, V>(d, rows + 4 * taps, x, weights);
+
+  const V one = Set(d, 1.f);
+  const V zero = Zero(d);
+  const V c2 = Set(d, 0.0009f);
+  const V muDiff = Sub(mu1, mu2);
+  // SSIM without the luminance denominator, errors in darks shouldn't weigh more than in brights
+  const V numM = NegMulAdd(muDiff, muDiff, one);
+  // Covariances are rounded the same way, so identical images give exactly zero
+  const V numS = MulAdd(Set(d, 2.f), NegMulAdd(mu1, mu2, sigma12), c2);
+  const V denomS = Add(Add(NegMulAdd(mu1, mu1, sigma11), NegMulAdd(mu2, mu2, sigma22)), c2);
+  const V dssim = Max(Sub(one, Div(Mul(numM, numS), denomS)), zero);
+  const V dssim2 = Mul(dssim, dssim);
+  ssim = Add(ssim, dssim);
+  ssim4 = MulAdd(dssim2, dssim2, ssim4);
+
+  // Positive where the distorted image has edges the reference hasn't, negative where it lost them
+  const V edge = Sub(Div(Add(one, Abs(Sub(LoadU(d, b + x), mu2))),
+                         Add(one, Abs(Sub(LoadU(d, a + x), mu1)))), one);
+  const V artifactValue = Max(edge, zero);
+  const V detailValue = Max(Neg(edge), zero);
+  const V artifact2 = Mul(artifactValue, artifactValue);
+  const V detail2 = Mul(detailValue, detailValue);
+  artifact = Add(artifact, artifactValue);
+  artifact4 = MulAdd(artifact2, artifact2, artifact4);
+  detail = Add(detail, detailValue);
+  detail4 = MulAdd(detail2, detail2, detail4);
+}
+
+/**
+ * @param rows 5 groups of taps rows: blurred reference, blurred distorted and their products
+ * @param sums receives d, d^4 of SSIM, artifact, artifact^4, detail, detail^4 of edges
+ */
+void AccumulateScaleRowHWY(const float *const *rows, const float *a, const float *b,
+                           const uint32_t width, const float *weights, double *sums) {
+  const ScalableTag<float> d;
+  const CappedTag<float, 1> d1;
+  const uint32_t lanes = Lanes(d);
+  auto ssim = Zero(d), ssim4 = Zero(d), artifact = Zero(d), artifact4 = Zero(d);
+  auto detail = Zero(d), detail4 = Zero(d);
+  uint32_t x = 0;
+  for (; x + lanes <= width; x += lanes) {
+    AccumulateScalePixels(d, rows, a, b, x, weights, ssim, ssim4, artifact, artifact4, detail, detail4);
+  }
+  auto ssimTail = Zero(d1), ssim4Tail = Zero(d1), artifactTail = Zero(d1);
+  auto artifact4Tail = Zero(d1), detailTail = Zero(d1), detail4Tail = Zero(d1);
+  for (; x < width; ++x) {
+    AccumulateScalePixels(d1, rows, a, b, x, weights, ssimTail, ssim4Tail, artifactTail,
+                          artifact4Tail, detailTail, detail4Tail);
+  }
+  sums[0] += static_cast<double>(ReduceSum(d, ssim)) + GetLane(ssimTail);
+  sums[1] += static_cast<double>(ReduceSum(d, ssim4)) + GetLane(ssim4Tail);
+  sums[2] += static_cast<double>(ReduceSum(d, artifact)) + GetLane(artifactTail);
+  sums[3] += static_cast<double>(ReduceSum(d, artifact4)) + GetLane(artifact4Tail);
+  sums[4] += static_cast<double>(ReduceSum(d, detail)) + GetLane(detailTail);
+  sums[5] += static_cast<double>(ReduceSum(d, detail4)) + GetLane(detail4Tail);
+}
+
+double SquaredErrorRowHWY(const float *a, const float *b, const uint32_t width) {
+  const ScalableTag<float> d;
+  const uint32_t lanes = Lanes(d);
+  auto sum = Zero(d);
+  uint32_t x = 0;
+  for (; x + lanes <= width; x += lanes) {
+    auto diff = Sub(LoadU(d, a + x), LoadU(d, b + x));
+    sum = MulAdd(diff, diff, sum);
+  }
+  double result = ReduceSum(d, sum);
+  for (; x < width; ++x) {
+    double diff = a[x] - b[x];
+    result += diff * diff;
+  }
+  return result;
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(LinearToXybRowHWY);
+HWY_EXPORT(BlurRowHWY);
+HWY_EXPORT(MultiplyRowHWY);
+HWY_EXPORT(AccumulateScaleRowHWY);
+HWY_EXPORT(SquaredErrorRowHWY);
+
+static constexpr int metricBlurRadius = 5;
+static constexpr int metricBlurTaps = 2 * metricBlurRadius + 1;
+static constexpr int ssimulacra2Scales = 6;
+// Rows of a band processed by a single worker, blur halos are recomputed per band
+static constexpr uint32_t metricBandHeight = 128;
+// Backgrounds translucent pixels are blended over by the alpha aware metrics
+static constexpr float metricDarkBackground = 0.1f;
+static constexpr float metricLightBackground = 0.9f;
+
+static float SrgbToLinear(float v) {
+  float magnitude = std::abs(v);
+  float linear = magnitude <= 0.04045f ? magnitude / 12.92f
+                                       : std::pow((magnitude + 0.055f) / 1.055f, 2.4f);
+  return std::copysign(linear, v);
+}
+
+static const std::vector<float> &SrgbU8ToLinearTable() {
+  static const std::vector<float> table = []() {
+    std::vector<float> values(256);
+    for (int i = 0; i < 256; ++i) {
+      values[i] = SrgbToLinear(static_cast<float>(i) / 255.f);
+    }
+    return values;
+  }();
+  return table;
+}
+
+// Every half float has an entry, so extended range values are decoded as they are
+static const std::vector<float> &HalfToFloatTable() {
+  static const std::vector<float> table = []() {
+    std::vector<float> values(65536);
+    for (uint32_t i = 0; i < 65536; ++i) {
+      values[i] = half_to_float(static_cast<uint16_t>(i));
+    }
+    return values;
+  }();
+  return table;
+}
+
+static const std::vector<float> &HalfToLinearTable() {
+  static const std::vector<float> table = []() {
+    const auto &halfs = HalfToFloatTable();
+    std::vector<float> values(65536);
+    for (uint32_t i = 0; i < 65536; ++i) {
+      values[i] = std::isfinite(halfs[i]) ? SrgbToLinear(halfs[i]) : 0.f;
+    }
+    return values;
+  }();
+  return table;
+}
+
+/**
+ * Reads a row into planar RGB, sRGB encoded or linear.
+ * When the background is not negative pixels are blended over it in the same domain.
+ */
+static void ReadMetricRow(const MetricImageView &view, const uint32_t y, const bool linear,
+                          const float background, float *r, float *g, float *b) {
+  const uint8_t *row = view.data + static_cast<size_t>(y) * view.stride;
+  const uint32_t channels = view.channels;
+  const bool blend = background >= 0.f && channels == 4;
+  const float *table;
+  const float *alphaTable;
+  if (view.isF16) {
+    table = linear ? HalfToLinearTable().data() : HalfToFloatTable().data();
+    alphaTable = HalfToFloatTable().data();
+  } else {
+    table = linear ? SrgbU8ToLinearTable().data() : nullptr;
+    alphaTable = nullptr;
+  }
+  for (uint32_t x = 0; x < view.width; ++x) {
+    float values[4];
+    for (uint32_t c = 0; c < channels; ++c) {
+      if (view.isF16) {
+        uint16_t sample = reinterpret_cast<const uint16_t *>(row)[x * channels + c];
+        values[c] = (c == 3 ? alphaTable : table)[sample];
+      } else {
+        uint8_t sample = row[x * channels + c];
+        values[c] = (c == 3 || table == nullptr) ? static_cast<float>(sample) * (1.f / 255.f)
+                                                 : table[sample];
+      }
+    }
+    if (channels == 1) {
+      values[1] = values[0];
+      values[2] = values[0];
+    }
+    if (blend) {
+      float alpha = std::clamp(values[3], 0.f, 1.f);
+      for (int c = 0; c < 3; ++c) {
+        values[c] = values[c] * alpha + background * (1.f - alpha);
+      }
+    }
+    r[x] = values[0];
+    g[x] = values[1];
+    b[x] = values[2];
+  }
+}
+
+namespace {
+
+struct LinearPlanes {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<float> planes[3];
+
+  void reset(uint32_t newWidth, uint32_t newHeight) {
+    width = newWidth;
+    height = newHeight;
+    for (auto &plane : planes) {
+      plane.assign(static_cast<size_t>(width) * height, 0.f);
+    }
+  }
+
+  float *row(int plane, uint32_t y) {
+    return planes[plane].data() + static_cast<size_t>(y) * width;
+  }
+};
+
+// Sums of a scale per XYB plane: d and d^4 of SSIM, then artifact, artifact^4, detail, detail^4
+struct ScaleSums {
+  double values[3][6] = {};
+};
+
+using LinearRowSource = std::function<void(uint32_t y, float *r, float *g, float *b)>;
+
+// Quantities kept for every row of the ring, per plane
+enum RingRow {
+  RING_REFERENCE = 0,
+  RING_DISTORTED,
+  RING_MU1,
+  RING_MU2,
+  RING_SIGMA11,
+  RING_SIGMA22,
+  RING_SIGMA12,
+  RING_ROWS
+};
+
+struct BandScratch {
+  std::vector<float> ring;
+  std::vector<float> linear;
+  std::vector<float> padded;
+  std::vector<float> product;
+};
+
+/**
+ * Streams both images of a scale through a ring of blurred rows, so no blurred plane of the
+ * whole image is ever allocated. When next planes are given the 2x2 box downsampled images of
+ * the next scale are accumulated in the same pass.
+ */
+ScaleSums ProcessScale(const LinearRowSource &reference, const LinearRowSource &distorted,
+                       const uint32_t width, const uint32_t height, const uint32_t threads,
+                       const float *weights, LinearPlanes *nextReference,
+                       LinearPlanes *nextDistorted) {
+  const uint32_t bands = (height + metricBandHeight - 1) / metricBandHeight;
+  const uint32_t workers = std::clamp(threads, 1u, std::max(bands, 1u));
+  std::vector<BandScratch> scratches(workers);
+  std::vector<ScaleSums> bandSums(bands);
+
+  concurrency::parallel_for_with_thread_id(workers, bands, [&](int threadId, int band) {
+    BandScratch &scratch = scratches[threadId];
+    const size_t ringSize = static_cast<size_t>(metricBlurTaps) * 3 * RING_ROWS * width;
+    if (scratch.ring.size() != ringSize) {
+      scratch.ring.resize(ringSize);
+      scratch.linear.resize(static_cast<size_t>(6) * width);
+      scratch.padded.resize(width + 2 * metricBlurRadius);
+      scratch.product.resize(width);
+    }
+    auto ringRow = [&](uint32_t y, int plane, int quantity) {
+      size_t slot = y % metricBlurTaps;
+      return scratch.ring.data() + ((slot * 3 + plane) * RING_ROWS + quantity) * width;
+    };
+    auto blurRow = [&](const float *src, float *dst) {
+      float *padded = scratch.padded.data();
+      std::copy(src, src + width, padded + metricBlurRadius);
+      // Borders are clamped
+      std::fill(padded, padded + metricBlurRadius, src[0]);
+      std::fill(padded + metricBlurRadius + width, padded + 2 * metricBlurRadius + width, src[width - 1]);
+      HWY_DYNAMIC_DISPATCH(BlurRowHWY)(padded, dst, width, weights);
+    };
+
+    const uint32_t start = static_cast<uint32_t>(band) * metricBandHeight;
+    const uint32_t end = std::min(start + metricBandHeight, height);
+
+    auto computeRow = [&](uint32_t y) {
+      float *linear = scratch.linear.data();
+      reference(y, linear, linear + width, linear + 2 * width);
+      distorted(y, linear + 3 * width, linear + 4 * width, linear + 5 * width);
+      // Bands start at even rows, so each of them owns the downsampled rows it writes
+      if (nextReference != nullptr && y >= start && y < end) {
+        LinearPlanes *next[2] = {nextReference, nextDistorted};
+        for (int image = 0; image < 2; ++image) {
+          for (int plane = 0; plane < 3; ++plane) {
+            const float *src = linear + (image * 3 + plane) * width;
+            float *dst = next[image]->row(plane, y / 2);
+            for (uint32_t x = 0; x < width; ++x) {
+              dst[x / 2] += src[x] * 0.25f;
+            }
+          }
+        }
+      }
+      for (int image = 0; image < 2; ++image) {
+        const float *src = linear + image * 3 * width;
+        HWY_DYNAMIC_DISPATCH(LinearToXybRowHWY)(src, src + width, src + 2 * width,
+                                                ringRow(y, 0, image), ringRow(y, 1, image),
+                                                ringRow(y, 2, image), width);
+      }
+      for (int plane = 0; plane < 3; ++plane) {
+        const float *a = ringRow(y, plane, RING_REFERENCE);
+        const float *b = ringRow(y, plane, RING_DISTORTED);
+        float *product = scratch.product.data();
+        blurRow(a, ringRow(y, plane, RING_MU1));
+        blurRow(b, ringRow(y, plane, RING_MU2));
+        HWY_DYNAMIC_DISPATCH(MultiplyRowHWY)(a, a, product, width);
+        blurRow(product, ringRow(y, plane, RING_SIGMA11));
+        HWY_DYNAMIC_DISPATCH(MultiplyRowHWY)(b, b, product, width);
+        blurRow(product, ringRow(y, plane, RING_SIGMA22));
+        HWY_DYNAMIC_DISPATCH(MultiplyRowHWY)(a, b, product, width);
+        blurRow(product, ringRow(y, plane, RING_SIGMA12));
+      }
+    };
+
+    ScaleSums &sums = bandSums[band];
+    uint32_t nextRow = start > metricBlurRadius ? start - metricBlurRadius : 0;
+    for (uint32_t y = start; y < end; ++y) {
+      const uint32_t lastNeeded = std::min(height - 1, y + metricBlurRadius);
+      while (nextRow <= lastNeeded) {
+        computeRow(nextRow++);
+      }
+      for (int plane = 0; plane < 3; ++plane) {
+        const float *rows[5 * metricBlurTaps];
+        for (int quantity = 0; quantity < 5; ++quantity) {
+          for (int k = 0; k < metricBlurTaps; ++k) {
+            int64_t row = std::clamp<int64_t>(static_cast<int64_t>(y) + k - metricBlurRadius,
+                                              0, height - 1);
+            rows[quantity * metricBlurTaps + k] = ringRow(static_cast<uint32_t>(row), plane,
+                                                          RING_MU1 + quantity);
+          }
+        }
+        HWY_DYNAMIC_DISPATCH(AccumulateScaleRowHWY)(rows, ringRow(y, plane, RING_REFERENCE),
+                                                    ringRow(y, plane, RING_DISTORTED), width,
+                                                    weights, sums.values[plane]);
+      }
+    }
+  });
+
+  ScaleSums total;
+  for (const auto &sums : bandSums) {
+    for (int plane = 0; plane < 3; ++plane) {
+      for (int i = 0; i < 6; ++i) {
+        total.values[plane][i] += sums.values[plane][i];
+      }
+    }
+  }
+  return total;
+}
+
+}
+
+static uint32_t MetricThreads(uint32_t threads) {
+  return threads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : threads;
+}
+
+static void ValidateMetricImages(const MetricImageView &reference, const MetricImageView &distorted) {
+  if (reference.width != distorted.width || reference.height != distorted.height) {
+    throw std::runtime_error("Compared images must have the same size");
+  }
+  for (const auto *view : {&reference, &distorted}) {
+    if (view->channels != 1 && view->channels != 3 && view->channels != 4) {
+      throw std::runtime_error("Compared images must have 1, 3 or 4 channels");
+    }
+    if (view->data == nullptr || view->width == 0 || view->height == 0) {
+      throw std::runtime_error("Compared image is empty");
+    }
+  }
+}
+
+static double Ssimulacra2Score(const MetricImageView &reference, const MetricImageView &distorted,
+                               float background, uint32_t threads) {
+  // Normalized gaussian of sigma 1.5, only the center and one side are kept
+  float weights[metricBlurRadius + 1];
+  {
+    float sum = 0;
+    for (int k = 0; k <= metricBlurRadius; ++k) {
+      weights[k] = std::exp(-static_cast<float>(k * k) / (2.f * 1.5f * 1.5f));
+      sum += k == 0 ? weights[k] : 2 * weights[k];
+    }
+    for (float &weight : weights) {
+      weight /= sum;
+    }
+  }
+
+  double averageSsim[ssimulacra2Scales][6] = {};
+  double averageEdge[ssimulacra2Scales][12] = {};
+
+  LinearPlanes current[2];
+  LinearPlanes next[2];
+  uint32_t width = reference.width;
+  uint32_t height = reference.height;
+  uint32_t previousWidth = width;
+  uint32_t previousHeight = height;
+
+  for (int scale = 0; scale < ssimulacra2Scales; ++scale) {
+    // Scales are added while the previous one is at least 8x8 as in the reference tool
+    if (previousWidth < 8 || previousHeight < 8) {
+      break;
+    }
+    const bool downsample = scale + 1 < ssimulacra2Scales && width >= 8 && height >= 8;
+    if (downsample) {
+      next[0].reset((width + 1) / 2, (height + 1) / 2);
+      next[1].reset((width + 1) / 2, (height + 1) / 2);
+    }
+
+    LinearRowSource sources[2];
+    if (scale == 0) {
+      sources[0] = [&reference, background](uint32_t y, float *r, float *g, float *b) {
+        ReadMetricRow(reference, y, true, background, r, g, b);
+      };
+      sources[1] = [&distorted, background](uint32_t y, float *r, float *g, float *b) {
+        ReadMetricRow(distorted, y, true, background, r, g, b);
+      };
+    } else {
+      for (int image = 0; image < 2; ++image) {
+        LinearPlanes *planes = &current[image];
+        sources[image] = [planes](uint32_t y, float *r, float *g, float *b) {
+          std::memcpy(r, planes->row(0, y), planes->width * sizeof(float));
+          std::memcpy(g, planes->row(1, y), planes->width * sizeof(float));
+          std::memcpy(b, planes->row(2, y), planes->width * sizeof(float));
+        };
+      }
+    }
+
+    ScaleSums sums = ProcessScale(sources[0], sources[1], width, height, threads, weights,
+                                  downsample ? &next[0] : nullptr,
+                                  downsample ? &next[1] : nullptr);
+    const double onePerPixels = 1.0 / (static_cast<double>(width) * height);
+    for (int plane = 0; plane < 3; ++plane) {
+      const double *values = sums.values[plane];
+      averageSsim[scale][plane * 2] = values[0] * onePerPixels;
+      averageSsim[scale][plane * 2 + 1] = std::sqrt(std::sqrt(values[1] * onePerPixels));
+      averageEdge[scale][plane * 4] = values[2] * onePerPixels;
+      averageEdge[scale][plane * 4 + 1] = std::sqrt(std::sqrt(values[3] * onePerPixels));
+      averageEdge[scale][plane * 4 + 2] = values[4] * onePerPixels;
+      averageEdge[scale][plane * 4 + 3] = std::sqrt(std::sqrt(values[5] * onePerPixels));
+    }
+
+    previousWidth = width;
+    previousHeight = height;
+    if (!downsample) {
+      break;
+    }
+    std::swap(current[0], next[0]);
+    std::swap(current[1], next[1]);
+    width = current[0].width;
+    height = current[0].height;
+  }
+
+  static constexpr double weight[108] = {
+      0.0, 0.0007376606707406586, 0.0, 0.0, 0.0007793481682867309, 0.0, 0.0,
+      0.0004371155730107379, 0.0, 1.1041726426657346, 0.00066284834129271,
+      0.00015231632783718752, 0.0, 0.0016406437456599754, 0.0, 1.8422455520539298,
+      11.441172603757666, 0.0, 0.0007989109436015163, 0.000176816438078653, 0.0,
+      1.8787594979546387, 10.94906990605142, 0.0, 0.0007289346991508072, 0.9677937080626833,
+      0.0, 0.00014003424285435884, 0.9981766977854967, 0.00031949755934435053,
+      0.0004550992113792063, 0.0, 0.0, 0.0013648766163243398, 0.0, 0.0, 0.0, 0.0, 0.0,
+      7.466890328078848, 0.0, 17.445833984131262, 0.0006235601634041466, 0.0, 0.0,
+      6.683678146179332, 0.00037724407979611296, 1.027889937768264, 225.20515300849274, 0.0,
+      0.0, 19.213238186143016, 0.0011401524586618361, 0.001237755635509985, 176.39317598450694,
+      0.0, 0.0, 24.43300999870476, 0.28520802612117757, 0.0004485436923833408, 0.0, 0.0, 0.0,
+      34.77906344483772, 44.835625328877896, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+      0.0008680556573291698, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0005313191874358747, 0.0,
+      0.00016533814161379112, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0004179171803251336,
+      0.0017290828234722833, 0.0, 0.0020827005846636437, 0.0, 0.0, 8.826982764996862,
+      23.19243343998926, 0.0, 95.1080498811086, 0.9863978034400682, 0.9834382792465353,
+      0.0012286405048278493, 171.2667255897307, 0.9807858872435379, 0.0, 0.0, 0.0,
+      0.0005130064588990679, 0.0, 0.00010854057858411537,
+  };
+
+  double ssim = 0.0;
+  size_t i = 0;
+  for (int plane = 0; plane < 3; ++plane) {
+    for (int scale = 0; scale < ssimulacra2Scales; ++scale) {
+      for (int n = 0; n < 2; ++n) {
+        ssim += weight[i++] * std::abs(averageSsim[scale][plane * 2 + n]);
+        ssim += weight[i++] * std::abs(averageEdge[scale][plane * 4 + n]);
+        ssim += weight[i++] * std::abs(averageEdge[scale][plane * 4 + n + 2]);
+      }
+    }
+  }
+
+  ssim *= 0.9562382616834844;
+  ssim = 2.326765642916932 * ssim - 0.020884521182843837 * ssim * ssim
+      + 6.248496625763138e-05 * ssim * ssim * ssim;
+  if (ssim > 0) {
+    ssim = 100.0 - 10.0 * std::pow(ssim, 0.6276336467831387);
+  } else {
+    ssim = 100.0;
+  }
+  return ssim;
+}
+
+static double PsnrScore(const MetricImageView &reference, const MetricImageView &distorted,
+                        float background, uint32_t threads) {
+  const uint32_t width = reference.width;
+  const uint32_t height = reference.height;
+  const uint32_t bands = (height + metricBandHeight - 1) / metricBandHeight;
+  const uint32_t workers = std::clamp(threads, 1u, bands);
+  std::vector<std::vector<float>> scratches(workers);
+  std::vector<double> bandErrors(bands, 0.0);
+
+  concurrency::parallel_for_with_thread_id(workers, bands, [&](int threadId, int band) {
+    auto &scratch = scratches[threadId];
+    scratch.resize(static_cast<size_t>(6) * width);
+    float *rows = scratch.data();
+    const uint32_t start = static_cast<uint32_t>(band) * metricBandHeight;
+    const uint32_t end = std::min(start + metricBandHeight, height);
+    double error = 0;
+    for (uint32_t y = start; y < end; ++y) {
+      ReadMetricRow(reference, y, false, background, rows, rows + width, rows + 2 * width);
+      ReadMetricRow(distorted, y, false, background, rows + 3 * width, rows + 4 * width,
+                    rows + 5 * width);
+      for (int plane = 0; plane < 3; ++plane) {
+        error += HWY_DYNAMIC_DISPATCH(SquaredErrorRowHWY)(rows + plane * width,
+                                                          rows + (3 + plane) * width, width);
+      }
+    }
+    bandErrors[band] = error;
+  });
+
+  double error = 0;
+  for (double bandError : bandErrors) {
+    error += bandError;
+  }
+  const double mse = error / (3.0 * static_cast<double>(width) * height);
+  if (mse <= 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return 10.0 * std::log10(1.0 / mse);
+}
+
+static bool HasMetricAlpha(const MetricImageView &reference, const MetricImageView &distorted) {
+  return reference.channels == 4 || distorted.channels == 4;
+}
+
+double Ssimulacra2(const MetricImageView &reference, const MetricImageView &distorted,
+                   bool alphaAware, uint32_t threads) {
+  ValidateMetricImages(reference, distorted);
+  threads = MetricThreads(threads);
+  if (alphaAware && HasMetricAlpha(reference, distorted)) {
+    return std::min(Ssimulacra2Score(reference, distorted, metricDarkBackground, threads),
+                    Ssimulacra2Score(reference, distorted, metricLightBackground, threads));
+  }
+  return Ssimulacra2Score(reference, distorted, -1.f, threads);
+}
+
+double Psnr(const MetricImageView &reference, const MetricImageView &distorted,
+            bool alphaAware, uint32_t threads) {
+  ValidateMetricImages(reference, distorted);
+  threads = MetricThreads(threads);
+  if (alphaAware && HasMetricAlpha(reference, distorted)) {
+    return std::min(PsnrScore(reference, distorted, metricDarkBackground, threads),
+                    PsnrScore(reference, distorted, metricLightBackground, threads));
+  }
+  return PsnrScore(reference, distorted, -1.f, threads);
+}
+
+double ComputeImageMetric(ImageMetric metric, const MetricImageView &reference,
+                          const MetricImageView &distorted, bool alphaAware, uint32_t threads) {
+  switch (metric) {
+    case METRIC_SSIMULACRA2: {
+      return Ssimulacra2(reference, distorted, alphaAware, threads);
+    }
+    case METRIC_PSNR: {
+      return Psnr(reference, distorted, alphaAware, threads);
+    }
+  }
+  throw std::runtime_error("Unknown image metric");
+}
+
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_IMAGEBIT_IMAGEMETRICS_H
+#define JXLCODER_IMAGEBIT_IMAGEMETRICS_H
+
+#include <cstdint>
+
+namespace coder {
+
+enum ImageMetric {
+  METRIC_SSIMULACRA2 = 0,
+  METRIC_PSNR = 1
+};
+
+/**
+ * Interleaved image read by the metrics, samples are unassociated and sRGB encoded.
+ * Channels are 1 (gray), 3 (RGB) or 4 (RGBA) of u8 or IEEE half floats.
+ */
+struct MetricImageView {
+  const uint8_t *data;
+  uint32_t stride;
+  uint32_t width;
+  uint32_t height;
+  uint32_t channels;
+  bool isF16;
+};
+
+/**
+ * SSIMULACRA 2 score of the distorted image against the reference,
+ * 100 for identical images, about 90 is visually lossless and 70 is high quality.
+ * Without alphaAware alpha is ignored, otherwise both images are blended over a dark and a light
+ * background and the worse score is returned.
+ *
+ * Blurs are a separable gaussian instead of the recursive approximation of the reference tool,
+ * so scores may differ from it slightly.
+ *
+ * @param threads workers used for the row bands, 0 picks the hardware concurrency
+ * @throws std::runtime_error when the images differ in size or layout
+ */
+double Ssimulacra2(const MetricImageView &reference, const MetricImageView &distorted,
+                   bool alphaAware, uint32_t threads = 0);
+
+/**
+ * PSNR of the color channels in dB over samples in [0, 1], +infinity for identical images.
+ * With alphaAware the images are blended over the same backgrounds as in Ssimulacra2.
+ */
+double Psnr(const MetricImageView &reference, const MetricImageView &distorted,
+            bool alphaAware, uint32_t threads = 0);
+
+// Greater is better for every metric
+double ComputeImageMetric(ImageMetric metric, const MetricImageView &reference,
+                          const MetricImageView &distorted, bool alphaAware, uint32_t threads = 0);
+
+}
+
+#endif //JXLCODER_IMAGEBIT_IMAGEMETRICS_H
@@ -30,6 +30,7 @@
 #include <vector>
 #include <thread>
 #include <algorithm>
+#include <cstring>
 #include "half.hpp"
 #include "concurrency.hpp"
 #include "conversion/HalfFloats.h"
@@ -139,6 +140,50 @@ template void RGBA1010102ToUnsigned(const uint8_t *__restrict__ src,
                                     const uint32_t height,
                                     const uint32_t bitDepth);
 
+namespace {
+
+struct Rgba1010102HalfTable {
+  uint16_t color[1024];
+  uint16_t alpha[4];
+
+  Rgba1010102HalfTable() {
+    for (uint32_t i = 0; i < 1024; ++i) {
+      color[i] = float_to_half(static_cast<float>(i) / 1023.f);
+    }
+    for (uint32_t i = 0; i < 4; ++i) {
+      alpha[i] = float_to_half(static_cast<float>(i) / 3.f);
+    }
+  }
+};
+
+}
+
+void RGBA1010102ToF16(const uint8_t *__restrict__ src, const uint32_t srcStride,
+                      uint16_t *__restrict__ dst, const uint32_t dstStride,
+                      const uint32_t width, const uint32_t height) {
+  static const Rgba1010102HalfTable table;
+  const uint32_t mask = (1u << 10u) - 1u;
+
+  for (uint32_t y = 0; y < height; ++y) {
+    auto srcPointer = src + static_cast<size_t>(y) * srcStride;
+    auto dstPointer = reinterpret_cast<uint16_t *>(reinterpret_cast<uint8_t *>(dst)
+        + static_cast<size_t>(y) * dstStride);
+
+    for (uint32_t x = 0; x < width; ++x) {
+      uint32_t rgba1010102;
+      std::memcpy(&rgba1010102, srcPointer, sizeof(uint32_t));
+
+      dstPointer[0] = table.color[rgba1010102 & mask];
+      dstPointer[1] = table.color[(rgba1010102 >> 10) & mask];
+      dstPointer[2] = table.color[(rgba1010102 >> 20) & mask];
+      dstPointer[3] = table.alpha[rgba1010102 >> 30];
+
+      srcPointer += 4;
+      dstPointer += 4;
+    }
+  }
+}
+
 void
 F16ToRGBA1010102(const uint16_t *source,
                  uint32_t srcStride,
@@ -205,7 +250,9 @@ Rgba8ToRGBA1010102(const uint8_t *source,
       auto G16 = (uint32_t) g << 2;
       auto B16 = (uint32_t) b << 2;
 
-      dst32[0] = (A16 << 30) | (B16 << 20) | (G16 << 10) | R16;
+      // Stored bytewise, the destination may alias the source
+      uint32_t packed = (A16 << 30) | (B16 << 20) | (G16 << 10) | R16;
+      std::memcpy(dst32, &packed, sizeof(uint32_t));
       data += 4;
       dst32 += 1;
     }
@@ -240,7 +287,8 @@ Rgba16ToRGBA1010102(const uint16_t *source,
       auto G16 = (uint32_t) g >> diff;
       auto B16 = (uint32_t) b >> diff;
 
-      dst32[0] = (A16 & 0x3) << 30 | (B16 & 0x3ff) << 20 | (G16 & 0x3ff) << 10 | (R16 & 0x3ff);
+      uint32_t packed = (A16 & 0x3) << 30 | (B16 & 0x3ff) << 20 | (G16 & 0x3ff) << 10 | (R16 & 0x3ff);
+      std::memcpy(dst32, &packed, sizeof(uint32_t));
       data += 4;
       dst32 += 1;
     }
@@ -38,11 +38,23 @@ void RGBA1010102ToUnsigned(const uint8_t *__restrict__ src, uint32_t srcStride,
                            V *__restrict__ dst, uint32_t dstStride,
                            uint32_t width, uint32_t height, uint32_t bitDepth);
 
+/**
+ * Expands to interleaved half floats, every 10-bit level maps to a distinct half
+ * so the conversion is lossless. Alpha is kept unassociated.
+ */
+void RGBA1010102ToF16(const uint8_t *__restrict__ src, uint32_t srcStride,
+                      uint16_t *__restrict__ dst, uint32_t dstStride,
+                      uint32_t width, uint32_t height);
+
 void
 F16ToRGBA1010102(const uint16_t *source, uint32_t srcStride, uint8_t *destination, uint32_t dstStride,
                  uint32_t width,
                  uint32_t height);
 
+/**
+ * Rgba8ToRGBA1010102 and Rgba16ToRGBA1010102 may write into the source buffer when dstStride <= srcStride,
+ * rows are converted front to back
+ */
 void
 Rgba8ToRGBA1010102(const uint8_t *source,
                    uint32_t srcStride,
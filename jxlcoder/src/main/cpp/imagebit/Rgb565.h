@@ -42,6 +42,10 @@ void Rgb565ToUnsigned8(const uint16_t *sourceData, uint32_t srcStride,
                        uint8_t *dst, uint32_t dstStride, uint32_t width,
                        uint32_t height, uint8_t bgColor);
 
+/**
+ * Rgba8To565 and Rgba16To565 may write into the source buffer when dstStride <= srcStride,
+ * rows are converted front to back
+ */
 void Rgba8To565(const uint8_t *sourceData, uint32_t srcStride,
                 uint16_t *dst, uint32_t dstStride, uint32_t width,
                 uint32_t height, bool attenuateAlpha);
@@ -32,6 +32,9 @@
 #include <cstdint>
 
 namespace coder {
+/**
+ * Destination may be the source buffer itself when dstStride <= srcStride, rows are converted front to back
+ */
 void
 Rgba16ToRgba8(const uint16_t *source,
               uint32_t srcStride,
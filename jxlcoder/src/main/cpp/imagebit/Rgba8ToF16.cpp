@@ -136,4 +136,43 @@ void Rgba8ToF16(const uint8_t *sourceData, uint32_t srcStride,
     }
   }
 }
+
+void Rgba8ToF16InPlace(uint8_t *data, uint32_t srcStride, uint32_t dstStride,
+                       uint32_t width, uint32_t height, const bool attenuateAlpha) {
+  const float scale = 1.0f / float((1 << 8) - 1);
+
+  // Output pixels are twice as large, walking from the end keeps every source pixel intact until it's read
+  for (uint32_t y = height; y > 0; --y) {
+    auto vSrc = reinterpret_cast<const uint8_t *>(data + (y - 1) * srcStride) + (width - 1) * 4;
+    auto vDst = reinterpret_cast<uint16_t *>(data + (y - 1) * dstStride) + (width - 1) * 4;
+
+    for (uint32_t x = width; x > 0; --x) {
+      uint8_t alpha = vSrc[3];
+      uint8_t r = vSrc[0];
+      uint8_t g = vSrc[1];
+      uint8_t b = vSrc[2];
+
+      if (attenuateAlpha) {
+        r = (static_cast<uint16_t>(r) * static_cast<uint16_t>(alpha)) / static_cast<uint16_t >(255);
+        g = (static_cast<uint16_t>(g) * static_cast<uint16_t>(alpha)) / static_cast<uint16_t >(255);
+        b = (static_cast<uint16_t>(b) * static_cast<uint16_t>(alpha)) / static_cast<uint16_t >(255);
+      }
+
+      uint16_t clr[4] = {
+          (uint16_t) half(static_cast<float>(r) * scale).data_,
+          (uint16_t) half(static_cast<float>(g) * scale).data_,
+          (uint16_t) half(static_cast<float>(b) * scale).data_,
+          (uint16_t) half(static_cast<float>(alpha) * scale).data_,
+      };
+
+      vDst[0] = clr[0];
+      vDst[1] = clr[1];
+      vDst[2] = clr[2];
+      vDst[3] = clr[3];
+
+      vSrc -= 4;
+      vDst -= 4;
+    }
+  }
+}
 }
\ No newline at end of file
@@ -35,6 +35,13 @@ namespace coder {
 void Rgba8ToF16(const uint8_t *sourceData, uint32_t srcStride,
                 uint16_t *dst, uint32_t dstStride, uint32_t width,
                 uint32_t height, bool attenuateAlpha);
+
+/**
+ * Same as Rgba8ToF16 over a single buffer, converted back to front.
+ * Requires dstStride >= srcStride and the buffer to hold dstStride * height bytes.
+ */
+void Rgba8ToF16InPlace(uint8_t *data, uint32_t srcStride, uint32_t dstStride,
+                       uint32_t width, uint32_t height, bool attenuateAlpha);
 }
 
 #endif //AVIF_RGBA8TOF16_H
@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "RgbaAdapt.h"
+#include <algorithm>
+#include <cstring>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/RgbaAdapt.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+template<class V>
+HWY_INLINE void OrderToRgba(RgbaChannelOrder order, V c0, V c1, V c2, V c3,
+                            V &r, V &g, V &b, V &a) {
+  switch (order) {
+    case ORDER_BGRA:r = c2;
+      g = c1;
+      b = c0;
+      a = c3;
+      break;
+    case ORDER_ARGB:r = c1;
+      g = c2;
+      b = c3;
+      a = c0;
+      break;
+    default:r = c0;
+      g = c1;
+      b = c2;
+      a = c3;
+      break;
+  }
+}
+
+/**
+ * Swizzle only, samples are moved as raw bits of their size
+ */
+template<typename T>
+void SwizzleRowHWY(const uint8_t *HWY_RESTRICT src, uint8_t *HWY_RESTRICT dst,
+                   const uint32_t width, RgbaChannelOrder order) {
+  const ScalableTag<T> d;
+  using V = Vec<decltype(d)>;
+  const uint32_t pixels = Lanes(d);
+  auto s = reinterpret_cast<const T *>(src);
+  auto o = reinterpret_cast<T *>(dst);
+
+  uint32_t x = 0;
+  for (; x + pixels <= width; x += pixels) {
+    V c0, c1, c2, c3, r, g, b, a;
+    LoadInterleaved4(d, s, c0, c1, c2, c3);
+    OrderToRgba(order, c0, c1, c2, c3, r, g, b, a);
+    StoreInterleaved4(r, g, b, a, d, o);
+    s += 4 * pixels;
+    o += 4 * pixels;
+  }
+
+  for (; x < width; ++x) {
+    T r, g, b, a;
+    OrderToRgba(order, s[0], s[1], s[2], s[3], r, g, b, a);
+    o[0] = r;
+    o[1] = g;
+    o[2] = b;
+    o[3] = a;
+    s += 4;
+    o += 4;
+  }
+}
+
+template<class D>
+HWY_INLINE void LoadRgbaAsFloat(D d, RgbaSampleType sampleType, const uint8_t *HWY_RESTRICT src,
+                                VFromD<D> &c0, VFromD<D> &c1, VFromD<D> &c2, VFromD<D> &c3) {
+  const Rebind<uint32_t, D> du32;
+  switch (sampleType) {
+    case SAMPLE_U8: {
+      const Rebind<uint8_t, D> du8;
+      VFromD<decltype(du8)> v0, v1, v2, v3;
+      LoadInterleaved4(du8, src, v0, v1, v2, v3);
+      c0 = ConvertTo(d, PromoteTo(du32, v0));
+      c1 = ConvertTo(d, PromoteTo(du32, v1));
+      c2 = ConvertTo(d, PromoteTo(du32, v2));
+      c3 = ConvertTo(d, PromoteTo(du32, v3));
+    }
+      break;
+    case SAMPLE_U16: {
+      const Rebind<uint16_t, D> du16;
+      VFromD<decltype(du16)> v0, v1, v2, v3;
+      LoadInterleaved4(du16, reinterpret_cast<const uint16_t *>(src), v0, v1, v2, v3);
+      c0 = ConvertTo(d, PromoteTo(du32, v0));
+      c1 = ConvertTo(d, PromoteTo(du32, v1));
+      c2 = ConvertTo(d, PromoteTo(du32, v2));
+      c3 = ConvertTo(d, PromoteTo(du32, v3));
+    }
+      break;
+    case SAMPLE_F16: {
+      const Rebind<uint16_t, D> du16;
+      const Rebind<hwy::float16_t, D> df16;
+      VFromD<decltype(du16)> v0, v1, v2, v3;
+      LoadInterleaved4(du16, reinterpret_cast<const uint16_t *>(src), v0, v1, v2, v3);
+      c0 = PromoteTo(d, BitCast(df16, v0));
+      c1 = PromoteTo(d, BitCast(df16, v1));
+      c2 = PromoteTo(d, BitCast(df16, v2));
+      c3 = PromoteTo(d, BitCast(df16, v3));
+    }
+      break;
+    case SAMPLE_F32:LoadInterleaved4(d, reinterpret_cast<const float *>(src), c0, c1, c2, c3);
+      break;
+  }
+}
+
+template<class D>
+HWY_INLINE void StoreRgbaFromFloat(D d, RgbaSampleType sampleType, VFromD<D> r, VFromD<D> g,
+                                   VFromD<D> b, VFromD<D> a, uint8_t *HWY_RESTRICT dst) {
+  switch (sampleType) {
+    case SAMPLE_U8: {
+      const Rebind<uint8_t, D> du8;
+      StoreInterleaved4(DemoteTo(du8, NearestInt(r)), DemoteTo(du8, NearestInt(g)),
+                        DemoteTo(du8, NearestInt(b)), DemoteTo(du8, NearestInt(a)),
+                        du8, dst);
+    }
+      break;
+    case SAMPLE_U16: {
+      const Rebind<uint16_t, D> du16;
+      StoreInterleaved4(DemoteTo(du16, NearestInt(r)), DemoteTo(du16, NearestInt(g)),
+                        DemoteTo(du16, NearestInt(b)), DemoteTo(du16, NearestInt(a)),
+                        du16, reinterpret_cast<uint16_t *>(dst));
+    }
+      break;
+    case SAMPLE_F16: {
+      const Rebind<uint16_t, D> du16;
+      const Rebind<hwy::float16_t, D> df16;
+      StoreInterleaved4(BitCast(du16, DemoteTo(df16, r)), BitCast(du16, DemoteTo(df16, g)),
+                        BitCast(du16, DemoteTo(df16, b)), BitCast(du16, DemoteTo(df16, a)),
+                        du16, reinterpret_cast<uint16_t *>(dst));
+    }
+      break;
+    case SAMPLE_F32:StoreInterleaved4(r, g, b, a, d, reinterpret_cast<float *>(dst));
+      break;
+  }
+}
+
+/**
+ * Swizzle and unassociation through float lanes, the tail goes through a padded block
+ * so it takes exactly the same path as full vectors
+ */
+void UnpremultiplyRowHWY(const uint8_t *HWY_RESTRICT src, uint8_t *HWY_RESTRICT dst,
+                         const uint32_t width, RgbaSampleType sampleType, RgbaChannelOrder order,
+                         const uint32_t pixelSize) {
+  const ScalableTag<float> d;
+  using V = Vec<decltype(d)>;
+  const uint32_t pixels = Lanes(d);
+  const bool isFloat = sampleType == SAMPLE_F16 || sampleType == SAMPLE_F32;
+  const float maxValue = sampleType == SAMPLE_U8 ? 255.0f : (sampleType == SAMPLE_U16 ? 65535.0f : 1.0f);
+  const V vMax = Set(d, maxValue);
+  const V zeros = Zero(d);
+
+  auto convert = [&](const uint8_t *s, uint8_t *o) {
+    V c0, c1, c2, c3, r, g, b, a;
+    LoadRgbaAsFloat(d, sampleType, s, c0, c1, c2, c3);
+    OrderToRgba(order, c0, c1, c2, c3, r, g, b, a);
+    const auto transparent = Le(a, zeros);
+    const V divisor = IfThenElse(transparent, vMax, a);
+    // Integer samples are rounded to the nearest level when stored
+    r = IfThenZeroElse(transparent, Div(Mul(r, vMax), divisor));
+    g = IfThenZeroElse(transparent, Div(Mul(g, vMax), divisor));
+    b = IfThenZeroElse(transparent, Div(Mul(b, vMax), divisor));
+    if (!isFloat) {
+      r = Min(r, vMax);
+      g = Min(g, vMax);
+      b = Min(b, vMax);
+    }
+    StoreRgbaFromFloat(d, sampleType, r, g, b, a, o);
+  };
+
+  uint32_t x = 0;
+  for (; x + pixels <= width; x += pixels) {
+    convert(src, dst);
+    src += static_cast<size_t>(pixels) * pixelSize;
+    dst += static_cast<size_t>(pixels) * pixelSize;
+  }
+
+  if (x < width) {
+    HWY_ALIGN uint8_t srcBlock[HWY_MAX_LANES_D(ScalableTag<float>) * 4 * sizeof(float)] = {};
+    HWY_ALIGN uint8_t dstBlock[HWY_MAX_LANES_D(ScalableTag<float>) * 4 * sizeof(float)];
+    const size_t tail = static_cast<size_t>(width - x) * pixelSize;
+    memcpy(srcBlock, src, tail);
+    convert(srcBlock, dstBlock);
+    memcpy(dst, dstBlock, tail);
+  }
+}
+
+void AdaptToRgbaHWY(const uint8_t *src, const uint32_t srcStride,
+                    uint8_t *dst, const uint32_t dstStride,
+                    const uint32_t width, const uint32_t height,
+                    RgbaSampleType sampleType, RgbaChannelOrder order, const bool unpremultiply) {
+  const uint32_t pixelSize = RgbaSampleSize(sampleType) * 4;
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t *s = src + static_cast<size_t>(y) * srcStride;
+    uint8_t *o = dst + static_cast<size_t>(y) * dstStride;
+    if (unpremultiply) {
+      UnpremultiplyRowHWY(s, o, width, sampleType, order, pixelSize);
+      continue;
+    }
+    switch (sampleType) {
+      case SAMPLE_U8:SwizzleRowHWY<uint8_t>(s, o, width, order);
+        break;
+      case SAMPLE_U16:
+      case SAMPLE_F16:SwizzleRowHWY<uint16_t>(s, o, width, order);
+        break;
+      case SAMPLE_F32:SwizzleRowHWY<uint32_t>(s, o, width, order);
+        break;
+    }
+  }
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(AdaptToRgbaHWY);
+
+uint32_t RgbaSampleSize(RgbaSampleType sampleType) {
+  switch (sampleType) {
+    case SAMPLE_U16:
+    case SAMPLE_F16:return sizeof(uint16_t);
+    case SAMPLE_F32:return sizeof(float);
+    case SAMPLE_U8:
+    default:return sizeof(uint8_t);
+  }
+}
+
+void AdaptToRgba(const uint8_t *src, uint32_t srcStride,
+                 uint8_t *dst, uint32_t dstStride,
+                 uint32_t width, uint32_t height,
+                 RgbaSampleType sampleType, RgbaChannelOrder order, bool unpremultiply) {
+  HWY_DYNAMIC_DISPATCH(AdaptToRgbaHWY)(src, srcStride, dst, dstStride, width, height,
+                                       sampleType, order, unpremultiply);
+}
+}
+#endif
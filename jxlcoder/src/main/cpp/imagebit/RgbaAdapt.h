@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_RGBAADAPT_H
+#define JXLCODER_RGBAADAPT_H
+
+#include <cstdint>
+
+namespace coder {
+
+enum RgbaSampleType {
+  SAMPLE_U8 = 1,
+  SAMPLE_U16 = 2,
+  SAMPLE_F16 = 3,
+  SAMPLE_F32 = 4,
+};
+
+// Order of 4 channel pixels in memory
+enum RgbaChannelOrder {
+  ORDER_RGBA = 1,
+  ORDER_BGRA = 2,
+  ORDER_ARGB = 3,
+};
+
+uint32_t RgbaSampleSize(RgbaSampleType sampleType);
+
+/**
+ * Single pass conversion of any 4 channel layout into straight alpha RGBA of the same sample type,
+ * the one adapter every raw layout libjxl can't take as is goes through.
+ * Integer samples are unassociated against their maximum, float samples against 1.0 without clamping.
+ */
+void AdaptToRgba(const uint8_t *src, uint32_t srcStride,
+                 uint8_t *dst, uint32_t dstStride,
+                 uint32_t width, uint32_t height,
+                 RgbaSampleType sampleType, RgbaChannelOrder order, bool unpremultiply);
+}
+
+#endif //JXLCODER_RGBAADAPT_H
@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "RgbaPack.h"
+#include <algorithm>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/RgbaPack.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+template<class D, class DU8, typename VU8 = VFromD<DU8>>
+HWY_INLINE VU8 UnassociateChannel(D d, DU8 du8, VU8 channel, VFromD<D> alpha,
+                                  MFromD<D> transparent) {
+  const Rebind<uint32_t, D> du32;
+  const Rebind<int32_t, D> di32;
+  const auto maxColors = Set(d, 255.0f);
+  const auto value = ConvertTo(d, PromoteTo(du32, channel));
+  // Numerator and denominator are exact integers, so true division truncates same as the scalar path
+  auto unassociated = Min(Div(Mul(value, maxColors), alpha), maxColors);
+  unassociated = IfThenZeroElse(transparent, unassociated);
+  return DemoteTo(du8, ConvertTo(di32, unassociated));
+}
+
+void PackRgba8RowHWY(const uint8_t *HWY_RESTRICT src, uint8_t *HWY_RESTRICT dst,
+                     const uint32_t width, const uint32_t channels, const bool unpremultiply) {
+  const ScalableTag<float> d;
+  const Rebind<uint8_t, decltype(d)> du8;
+  const Rebind<uint32_t, decltype(d)> du32;
+  using VU8 = Vec<decltype(du8)>;
+  const uint32_t pixels = Lanes(d);
+  const auto opaque = Set(du8, 255);
+
+  uint32_t x = 0;
+  for (; x + pixels <= width; x += pixels) {
+    VU8 r, g, b, a;
+    LoadInterleaved4(du8, src, r, g, b, a);
+
+    if (unpremultiply && !AllTrue(du8, Eq(a, opaque))) {
+      const auto alpha = ConvertTo(d, PromoteTo(du32, a));
+      const auto transparent = Eq(alpha, Zero(d));
+      r = UnassociateChannel(d, du8, r, alpha, transparent);
+      g = UnassociateChannel(d, du8, g, alpha, transparent);
+      b = UnassociateChannel(d, du8, b, alpha, transparent);
+    }
+
+    if (channels == 4) {
+      StoreInterleaved4(r, g, b, a, du8, dst);
+    } else if (channels == 3) {
+      StoreInterleaved3(r, g, b, du8, dst);
+    } else {
+      StoreU(r, du8, dst);
+    }
+
+    src += 4 * pixels;
+    dst += channels * pixels;
+  }
+
+  for (; x < width; ++x) {
+    uint8_t alpha = src[3];
+    uint8_t color[3] = {src[0], src[1], src[2]};
+    if (unpremultiply && alpha != 255) {
+      for (uint8_t &c : color) {
+        c = alpha == 0 ? 0 : static_cast<uint8_t>(std::min(
+            (static_cast<uint32_t>(c) * 255u) / static_cast<uint32_t>(alpha), 255u));
+      }
+    }
+    dst[0] = color[0];
+    if (channels >= 3) {
+      dst[1] = color[1];
+      dst[2] = color[2];
+    }
+    if (channels == 4) {
+      dst[3] = alpha;
+    }
+    src += 4;
+    dst += channels;
+  }
+}
+
+void PackRgba8HWY(const uint8_t *src, const uint32_t srcStride,
+                  uint8_t *dst, const uint32_t dstStride,
+                  const uint32_t width, const uint32_t height,
+                  const uint32_t channels, const bool unpremultiply) {
+  for (uint32_t y = 0; y < height; ++y) {
+    PackRgba8RowHWY(src + static_cast<size_t>(y) * srcStride,
+                    dst + static_cast<size_t>(y) * dstStride,
+                    width, channels, unpremultiply);
+  }
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(PackRgba8HWY);
+
+void PackRgba8(const uint8_t *src, uint32_t srcStride,
+               uint8_t *dst, uint32_t dstStride,
+               uint32_t width, uint32_t height,
+               uint32_t channels, bool unpremultiply) {
+  HWY_DYNAMIC_DISPATCH(PackRgba8HWY)(src, srcStride, dst, dstStride, width, height,
+                                     channels, unpremultiply);
+}
+}
+#endif
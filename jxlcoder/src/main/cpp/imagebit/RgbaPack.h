@@ -0,0 +1,46 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_RGBAPACK_H
+#define JXLCODER_RGBAPACK_H
+
+#include <cstdint>
+
+namespace coder {
+/**
+ * Single pass conversion of RGBA8 rows into the interleaved layout consumed by libjxl:
+ * alpha is unassociated when requested, channels are reduced to 1 ( R ), 3 ( RGB ) or 4 ( RGBA )
+ * and rows are written with dstStride, so it may read straight from locked bitmap memory.
+ */
+void PackRgba8(const uint8_t *src, uint32_t srcStride,
+               uint8_t *dst, uint32_t dstStride,
+               uint32_t width, uint32_t height,
+               uint32_t channels, bool unpremultiply);
+}
+
+#endif //JXLCODER_RGBAPACK_H
@@ -0,0 +1,246 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "RgbaToTensor.h"
+#include <algorithm>
+#include <cmath>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/RgbaToTensor.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+#ifndef JXLCODER_RGBATOTENSOR_SCALAR
+#define JXLCODER_RGBATOTENSOR_SCALAR
+
+namespace coder {
+
+static constexpr float kLumaR = 0.2126f;
+static constexpr float kLumaG = 0.7152f;
+static constexpr float kLumaB = 0.0722f;
+
+static inline void StoreTensorSample(uint8_t *dst, size_t index, TensorSampleType sampleType,
+                                     float value) {
+  switch (sampleType) {
+    case TENSOR_U8:
+      dst[index] = static_cast<uint8_t>(std::clamp(std::lrintf(value * 255.f), 0l, 255l));
+      break;
+    case TENSOR_F16:
+      reinterpret_cast<hwy::float16_t *>(dst)[index] = hwy::F16FromF32(value);
+      break;
+    case TENSOR_F32:reinterpret_cast<float *>(dst)[index] = value;
+      break;
+  }
+}
+
+}
+
+#endif
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+template<class D>
+HWY_INLINE void LoadTensorRgba(D d, bool srcF16, const uint8_t *HWY_RESTRICT src,
+                               VFromD<D> &r, VFromD<D> &g, VFromD<D> &b, VFromD<D> &a) {
+  if (srcF16) {
+    const Rebind<uint16_t, D> du16;
+    const Rebind<hwy::float16_t, D> df16;
+    VFromD<decltype(du16)> v0, v1, v2, v3;
+    LoadInterleaved4(du16, reinterpret_cast<const uint16_t *>(src), v0, v1, v2, v3);
+    r = PromoteTo(d, BitCast(df16, v0));
+    g = PromoteTo(d, BitCast(df16, v1));
+    b = PromoteTo(d, BitCast(df16, v2));
+    a = PromoteTo(d, BitCast(df16, v3));
+    return;
+  }
+  const Rebind<uint8_t, D> du8;
+  const Rebind<uint32_t, D> du32;
+  const auto scale = Set(d, 1.f / 255.f);
+  VFromD<decltype(du8)> v0, v1, v2, v3;
+  LoadInterleaved4(du8, src, v0, v1, v2, v3);
+  r = Mul(ConvertTo(d, PromoteTo(du32, v0)), scale);
+  g = Mul(ConvertTo(d, PromoteTo(du32, v1)), scale);
+  b = Mul(ConvertTo(d, PromoteTo(du32, v2)), scale);
+  a = Mul(ConvertTo(d, PromoteTo(du32, v3)), scale);
+}
+
+void RgbaToTensorHWY(const uint8_t *src, const uint32_t srcStride, const bool srcF16,
+                     const uint32_t width, const uint32_t height, const uint32_t channels,
+                     TensorLayout layout, TensorSampleType sampleType,
+                     const float *mean, const float *std, uint8_t *dst) {
+  const ScalableTag<float> df;
+  const Rebind<uint8_t, decltype(df)> du8;
+  const Rebind<uint16_t, decltype(df)> du16;
+  const Rebind<hwy::float16_t, decltype(df)> df16;
+  using V = VFromD<decltype(df)>;
+  const size_t lanes = Lanes(df);
+
+  // (value - mean) / std is applied as value * scale + offset
+  float scales[4], offsets[4];
+  for (uint32_t c = 0; c < 4; ++c) {
+    const float m = mean != nullptr ? mean[c] : 0.f;
+    const float s = std != nullptr ? std[c] : 1.f;
+    scales[c] = 1.f / s;
+    offsets[c] = -m / s;
+  }
+  V vScales[4], vOffsets[4];
+  for (uint32_t c = 0; c < 4; ++c) {
+    vScales[c] = Set(df, scales[c]);
+    vOffsets[c] = Set(df, offsets[c]);
+  }
+  const V zeros = Zero(df);
+  const V maxValue = Set(df, 255.f);
+
+  const size_t sampleSize = TensorSampleSize(sampleType);
+  const size_t planeSamples = static_cast<size_t>(width) * height;
+  const uint32_t pixelSize = srcF16 ? 4 * sizeof(uint16_t) : 4 * sizeof(uint8_t);
+
+  auto toU8 = [&](V v) {
+    return DemoteTo(du8, NearestInt(Min(Max(Mul(v, maxValue), zeros), maxValue)));
+  };
+  auto toF16 = [&](V v) {
+    return BitCast(du16, DemoteTo(df16, v));
+  };
+
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t *row = src + static_cast<size_t>(y) * srcStride;
+    const size_t rowSample = static_cast<size_t>(y) * width;
+    uint32_t x = 0;
+
+    for (; x + lanes <= width; x += lanes) {
+      V r, g, b, a;
+      LoadTensorRgba(df, srcF16, row + static_cast<size_t>(x) * pixelSize, r, g, b, a);
+      V values[4];
+      if (channels == 1) {
+        values[0] = MulAdd(r, Set(df, kLumaR), MulAdd(g, Set(df, kLumaG), Mul(b, Set(df, kLumaB))));
+      } else {
+        values[0] = r;
+        values[1] = g;
+        values[2] = b;
+        values[3] = a;
+      }
+      for (uint32_t c = 0; c < channels; ++c) {
+        values[c] = MulAdd(values[c], vScales[c], vOffsets[c]);
+      }
+
+      if (layout == TENSOR_NCHW || channels == 1) {
+        for (uint32_t c = 0; c < channels; ++c) {
+          uint8_t *plane = dst + (static_cast<size_t>(c) * planeSamples + rowSample + x) * sampleSize;
+          switch (sampleType) {
+            case TENSOR_U8:StoreU(toU8(values[c]), du8, plane);
+              break;
+            case TENSOR_F16:StoreU(toF16(values[c]), du16, reinterpret_cast<uint16_t *>(plane));
+              break;
+            case TENSOR_F32:StoreU(values[c], df, reinterpret_cast<float *>(plane));
+              break;
+          }
+        }
+        continue;
+      }
+
+      uint8_t *pixels = dst + (rowSample + x) * channels * sampleSize;
+      switch (sampleType) {
+        case TENSOR_U8:
+          if (channels == 3) {
+            StoreInterleaved3(toU8(values[0]), toU8(values[1]), toU8(values[2]), du8, pixels);
+          } else {
+            StoreInterleaved4(toU8(values[0]), toU8(values[1]), toU8(values[2]), toU8(values[3]),
+                              du8, pixels);
+          }
+          break;
+        case TENSOR_F16: {
+          auto out = reinterpret_cast<uint16_t *>(pixels);
+          if (channels == 3) {
+            StoreInterleaved3(toF16(values[0]), toF16(values[1]), toF16(values[2]), du16, out);
+          } else {
+            StoreInterleaved4(toF16(values[0]), toF16(values[1]), toF16(values[2]),
+                              toF16(values[3]), du16, out);
+          }
+        }
+          break;
+        case TENSOR_F32: {
+          auto out = reinterpret_cast<float *>(pixels);
+          if (channels == 3) {
+            StoreInterleaved3(values[0], values[1], values[2], df, out);
+          } else {
+            StoreInterleaved4(values[0], values[1], values[2], values[3], df, out);
+          }
+        }
+          break;
+      }
+    }
+
+    for (; x < width; ++x) {
+      const uint8_t *pixel = row + static_cast<size_t>(x) * pixelSize;
+      float rgba[4];
+      for (uint32_t c = 0; c < 4; ++c) {
+        rgba[c] = srcF16 ? hwy::F32FromF16(reinterpret_cast<const hwy::float16_t *>(pixel)[c])
+                         : static_cast<float>(pixel[c]) * (1.f / 255.f);
+      }
+      if (channels == 1) {
+        rgba[0] = rgba[0] * kLumaR + rgba[1] * kLumaG + rgba[2] * kLumaB;
+      }
+      for (uint32_t c = 0; c < channels; ++c) {
+        const float value = rgba[c] * scales[c] + offsets[c];
+        const size_t index = layout == TENSOR_NCHW ? static_cast<size_t>(c) * planeSamples + rowSample + x
+                                                   : (rowSample + x) * channels + c;
+        StoreTensorSample(dst, index, sampleType, value);
+      }
+    }
+  }
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(RgbaToTensorHWY);
+
+size_t TensorSampleSize(TensorSampleType sampleType) {
+  switch (sampleType) {
+    case TENSOR_F16:return sizeof(uint16_t);
+    case TENSOR_F32:return sizeof(float);
+    case TENSOR_U8:
+    default:return sizeof(uint8_t);
+  }
+}
+
+void RgbaToTensor(const uint8_t *src, uint32_t srcStride, bool srcF16,
+                  uint32_t width, uint32_t height, uint32_t channels,
+                  TensorLayout layout, TensorSampleType sampleType,
+                  const float *mean, const float *std, uint8_t *dst) {
+  HWY_DYNAMIC_DISPATCH(RgbaToTensorHWY)(src, srcStride, srcF16, width, height, channels, layout,
+                                        sampleType, mean, std, dst);
+}
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_RGBATOTENSOR_H
+#define JXLCODER_RGBATOTENSOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace coder {
+
+// Values are shared with java side
+enum TensorLayout {
+  // Channels interleaved per pixel
+  TENSOR_NHWC = 1,
+  // Every channel stored as a separate plane
+  TENSOR_NCHW = 2,
+};
+
+enum TensorSampleType {
+  TENSOR_U8 = 1,
+  TENSOR_F16 = 2,
+  TENSOR_F32 = 3,
+};
+
+size_t TensorSampleSize(TensorSampleType sampleType);
+
+/**
+ * Writes straight alpha RGBA as a single image tensor, samples are mapped into 0...1 and then
+ * normalized as (value - mean[c]) / std[c].
+ * Unsigned tensors hold the samples in 0...255 and must not be normalized.
+ *
+ * @param srcF16 source holds half floats instead of 8 bit samples
+ * @param channels 1 stores BT.709 luma, 3 stores RGB, 4 stores RGBA
+ * @param mean per channel mean of the normalization, nullptr for 0
+ * @param std per channel standard deviation of the normalization, nullptr for 1
+ */
+void RgbaToTensor(const uint8_t *src, uint32_t srcStride, bool srcF16,
+                  uint32_t width, uint32_t height, uint32_t channels,
+                  TensorLayout layout, TensorSampleType sampleType,
+                  const float *mean, const float *std, uint8_t *dst);
+
+}
+
+#endif //JXLCODER_RGBATOTENSOR_H
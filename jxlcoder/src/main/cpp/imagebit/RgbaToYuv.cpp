@@ -0,0 +1,256 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "RgbaToYuv.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/RgbaToYuv.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+#ifndef JXLCODER_RGBATOYUV_COEFFICIENTS
+#define JXLCODER_RGBATOYUV_COEFFICIENTS
+
+namespace coder {
+
+struct RgbToYuvCoefficients {
+  float yR, yG, yB, yOffset;
+  float uR, uG, uB;
+  float vR, vG, vB;
+};
+
+/**
+ * Coefficients take samples in 0...255 and give samples of the requested range
+ */
+static RgbToYuvCoefficients MakeRgbToYuvCoefficients(YuvMatrix matrix, YuvRange range) {
+  const float kr = matrix == YUV_MATRIX_BT709 ? 0.2126f : 0.299f;
+  const float kb = matrix == YUV_MATRIX_BT709 ? 0.0722f : 0.114f;
+  const float kg = 1.f - kr - kb;
+  const bool limited = range == YUV_RANGE_LIMITED;
+  const float yScale = limited ? 219.f / 255.f : 1.f;
+  const float uvScale = limited ? 224.f / 255.f : 1.f;
+  return {
+      .yR = kr * yScale,
+      .yG = kg * yScale,
+      .yB = kb * yScale,
+      .yOffset = limited ? 16.f : 0.f,
+      .uR = -kr / (2.f * (1.f - kb)) * uvScale,
+      .uG = -kg / (2.f * (1.f - kb)) * uvScale,
+      .uB = 0.5f * uvScale,
+      .vR = 0.5f * uvScale,
+      .vG = -kg / (2.f * (1.f - kr)) * uvScale,
+      .vB = -kb / (2.f * (1.f - kr)) * uvScale,
+  };
+}
+
+static inline uint8_t YuvSampleToU8(float value) {
+  return static_cast<uint8_t>(std::clamp(std::lrintf(value), 0l, 255l));
+}
+
+}
+
+#endif
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+template<class D>
+HWY_INLINE void LoadRgbAs255(D d, bool srcF16, const uint8_t *HWY_RESTRICT src,
+                             VFromD<D> &r, VFromD<D> &g, VFromD<D> &b) {
+  VFromD<D> a;
+  if (srcF16) {
+    const Rebind<uint16_t, D> du16;
+    const Rebind<hwy::float16_t, D> df16;
+    const auto scale = Set(d, 255.f);
+    VFromD<decltype(du16)> v0, v1, v2, v3;
+    LoadInterleaved4(du16, reinterpret_cast<const uint16_t *>(src), v0, v1, v2, v3);
+    r = Mul(PromoteTo(d, BitCast(df16, v0)), scale);
+    g = Mul(PromoteTo(d, BitCast(df16, v1)), scale);
+    b = Mul(PromoteTo(d, BitCast(df16, v2)), scale);
+    return;
+  }
+  const Rebind<uint8_t, D> du8;
+  const Rebind<uint32_t, D> du32;
+  VFromD<decltype(du8)> v0, v1, v2, v3;
+  LoadInterleaved4(du8, src, v0, v1, v2, v3);
+  r = ConvertTo(d, PromoteTo(du32, v0));
+  g = ConvertTo(d, PromoteTo(du32, v1));
+  b = ConvertTo(d, PromoteTo(du32, v2));
+}
+
+static inline void LoadRgbPixelAs255(bool srcF16, const uint8_t *pixel, float &r, float &g, float &b) {
+  if (srcF16) {
+    auto samples = reinterpret_cast<const hwy::float16_t *>(pixel);
+    r = hwy::F32FromF16(samples[0]) * 255.f;
+    g = hwy::F32FromF16(samples[1]) * 255.f;
+    b = hwy::F32FromF16(samples[2]) * 255.f;
+    return;
+  }
+  r = static_cast<float>(pixel[0]);
+  g = static_cast<float>(pixel[1]);
+  b = static_cast<float>(pixel[2]);
+}
+
+void RgbaToYuv420HWY(const uint8_t *src, const uint32_t srcStride, const bool srcF16,
+                     const uint32_t width, const uint32_t height, const YuvOutputPlanes &planes,
+                     YuvMatrix matrix, YuvRange range) {
+  const ScalableTag<float> df;
+  const Rebind<uint8_t, decltype(df)> du8;
+  using V = VFromD<decltype(df)>;
+  const size_t lanes = Lanes(df);
+  const RgbToYuvCoefficients k = MakeRgbToYuvCoefficients(matrix, range);
+  const uint32_t pixelSize = srcF16 ? 4 * sizeof(uint16_t) : 4 * sizeof(uint8_t);
+  const uint32_t chromaWidth = (width + 1) / 2;
+
+  const V yR = Set(df, k.yR), yG = Set(df, k.yG), yB = Set(df, k.yB);
+  const V yOffset = Set(df, k.yOffset);
+  const V uR = Set(df, k.uR), uG = Set(df, k.uG), uB = Set(df, k.uB);
+  const V vR = Set(df, k.vR), vG = Set(df, k.vG), vB = Set(df, k.vB);
+  const V chromaOffset = Set(df, 128.f);
+  const V zeros = Zero(df);
+  const V maxValue = Set(df, 255.f);
+  const V two = Set(df, 2.f);
+  // [1 2 1] taps over two rows sum up to 8
+  const V chromaNorm = Set(df, 1.f / 8.f);
+
+  auto toU8 = [&](V v) {
+    return DemoteTo(du8, NearestInt(Min(Max(v, zeros), maxValue)));
+  };
+
+  // Vertical sums of the row pair, one leading and one trailing pixel replicate the row edges
+  std::vector<float> sums(static_cast<size_t>(width + 2) * 3);
+  float *sumR = sums.data();
+  float *sumG = sumR + width + 2;
+  float *sumB = sumG + width + 2;
+
+  for (uint32_t y = 0; y < height; y += 2) {
+    const uint32_t pairRows = std::min(2u, height - y);
+    const uint8_t *row0 = src + static_cast<size_t>(y) * srcStride;
+    const uint8_t *row1 = pairRows == 2 ? row0 + srcStride : row0;
+    uint8_t *luma0 = planes.y + static_cast<size_t>(y) * planes.yStride;
+    uint8_t *luma1 = luma0 + planes.yStride;
+
+    uint32_t x = 0;
+    for (; x + lanes <= width; x += lanes) {
+      V r0, g0, b0, r1, g1, b1;
+      LoadRgbAs255(df, srcF16, row0 + static_cast<size_t>(x) * pixelSize, r0, g0, b0);
+      LoadRgbAs255(df, srcF16, row1 + static_cast<size_t>(x) * pixelSize, r1, g1, b1);
+      StoreU(toU8(MulAdd(r0, yR, MulAdd(g0, yG, MulAdd(b0, yB, yOffset)))), du8, luma0 + x);
+      if (pairRows == 2) {
+        StoreU(toU8(MulAdd(r1, yR, MulAdd(g1, yG, MulAdd(b1, yB, yOffset)))), du8, luma1 + x);
+      }
+      StoreU(Add(r0, r1), df, sumR + x + 1);
+      StoreU(Add(g0, g1), df, sumG + x + 1);
+      StoreU(Add(b0, b1), df, sumB + x + 1);
+    }
+    for (; x < width; ++x) {
+      float r0, g0, b0, r1, g1, b1;
+      LoadRgbPixelAs255(srcF16, row0 + static_cast<size_t>(x) * pixelSize, r0, g0, b0);
+      LoadRgbPixelAs255(srcF16, row1 + static_cast<size_t>(x) * pixelSize, r1, g1, b1);
+      luma0[x] = YuvSampleToU8(r0 * k.yR + g0 * k.yG + b0 * k.yB + k.yOffset);
+      if (pairRows == 2) {
+        luma1[x] = YuvSampleToU8(r1 * k.yR + g1 * k.yG + b1 * k.yB + k.yOffset);
+      }
+      sumR[x + 1] = r0 + r1;
+      sumG[x + 1] = g0 + g1;
+      sumB[x + 1] = b0 + b1;
+    }
+    sumR[0] = sumR[1];
+    sumG[0] = sumG[1];
+    sumB[0] = sumB[1];
+    sumR[width + 1] = sumR[width];
+    sumG[width + 1] = sumG[width];
+    sumB[width + 1] = sumB[width];
+
+    uint8_t *uRow = planes.u + static_cast<size_t>(y / 2) * planes.uvStride;
+    uint8_t *vRow = planes.v + static_cast<size_t>(y / 2) * planes.uvStride;
+
+    // Chroma k takes pixels 2k - 1, 2k and 2k + 1, that are sums[2k], sums[2k + 1] and sums[2k + 2]
+    auto filtered = [&](const float *sum, size_t c) {
+      V left, center, centerCopy, right;
+      LoadInterleaved2(df, sum + 2 * c, left, center);
+      LoadInterleaved2(df, sum + 2 * c + 1, centerCopy, right);
+      return Mul(MulAdd(center, two, Add(left, right)), chromaNorm);
+    };
+
+    uint32_t c = 0;
+    for (; c + lanes <= chromaWidth; c += lanes) {
+      const V r = filtered(sumR, c);
+      const V g = filtered(sumG, c);
+      const V b = filtered(sumB, c);
+      const auto u = toU8(MulAdd(r, uR, MulAdd(g, uG, MulAdd(b, uB, chromaOffset))));
+      const auto v = toU8(MulAdd(r, vR, MulAdd(g, vG, MulAdd(b, vB, chromaOffset))));
+      if (planes.uvPixelStride == 1) {
+        StoreU(u, du8, uRow + c);
+        StoreU(v, du8, vRow + c);
+      } else if (planes.uvPixelStride == 2 && vRow == uRow + 1) {
+        StoreInterleaved2(u, v, du8, uRow + static_cast<size_t>(c) * 2);
+      } else {
+        HWY_ALIGN uint8_t uBlock[HWY_MAX_LANES_D(ScalableTag<float>)];
+        HWY_ALIGN uint8_t vBlock[HWY_MAX_LANES_D(ScalableTag<float>)];
+        Store(u, du8, uBlock);
+        Store(v, du8, vBlock);
+        for (size_t i = 0; i < lanes; ++i) {
+          uRow[(c + i) * planes.uvPixelStride] = uBlock[i];
+          vRow[(c + i) * planes.uvPixelStride] = vBlock[i];
+        }
+      }
+    }
+    for (; c < chromaWidth; ++c) {
+      const float r = (sumR[2 * c] + 2.f * sumR[2 * c + 1] + sumR[2 * c + 2]) * (1.f / 8.f);
+      const float g = (sumG[2 * c] + 2.f * sumG[2 * c + 1] + sumG[2 * c + 2]) * (1.f / 8.f);
+      const float b = (sumB[2 * c] + 2.f * sumB[2 * c + 1] + sumB[2 * c + 2]) * (1.f / 8.f);
+      uRow[static_cast<size_t>(c) * planes.uvPixelStride] =
+          YuvSampleToU8(r * k.uR + g * k.uG + b * k.uB + 128.f);
+      vRow[static_cast<size_t>(c) * planes.uvPixelStride] =
+          YuvSampleToU8(r * k.vR + g * k.vG + b * k.vB + 128.f);
+    }
+  }
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(RgbaToYuv420HWY);
+
+void RgbaToYuv420(const uint8_t *src, uint32_t srcStride, bool srcF16,
+                  uint32_t width, uint32_t height, const YuvOutputPlanes &planes,
+                  YuvMatrix matrix, YuvRange range) {
+  HWY_DYNAMIC_DISPATCH(RgbaToYuv420HWY)(src, srcStride, srcF16, width, height, planes,
+                                        matrix, range);
+}
+}
+#endif
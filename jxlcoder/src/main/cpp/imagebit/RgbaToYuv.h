@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_RGBATOYUV_H
+#define JXLCODER_RGBATOYUV_H
+
+#include <cstdint>
+#include "YuvToRgba.h"
+
+namespace coder {
+
+/**
+ * Caller owned 4:2:0 planes, chroma samples of a row are uvPixelStride bytes apart,
+ * so I420 uses 1 and NV12 uses 2 with v = u + 1
+ */
+struct YuvOutputPlanes {
+  uint8_t *y;
+  uint8_t *u;
+  uint8_t *v;
+  uint32_t yStride;
+  uint32_t uvStride;
+  uint32_t uvPixelStride;
+};
+
+/**
+ * Converts RGBA rows into 4:2:0 planes in a single pass over pairs of rows, alpha is dropped.
+ * Chroma is sited at even columns between rows as MPEG-2 and H.264 expect,
+ * it is filtered by [1 2 1] horizontally and averaged over the row pair.
+ *
+ * @param srcF16 source holds half floats in 0...1 instead of 8 bit samples
+ */
+void RgbaToYuv420(const uint8_t *src, uint32_t srcStride, bool srcF16,
+                  uint32_t width, uint32_t height, const YuvOutputPlanes &planes,
+                  YuvMatrix matrix, YuvRange range);
+
+}
+
+#endif //JXLCODER_RGBATOYUV_H
@@ -27,10 +27,201 @@
  */
 
 #include "ScanAlpha.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <thread>
+#include <type_traits>
+#include "concurrency.hpp"
+#include "conversion/HalfFloats.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/ScanAlpha.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+uint32_t ScanRgba8RowHWY(const uint8_t *HWY_RESTRICT src, const uint32_t width,
+                         const uint32_t checks) {
+  const ScalableTag<uint8_t> du8;
+  using VU8 = Vec<decltype(du8)>;
+  const uint32_t pixels = Lanes(du8);
+  const auto opaque = Set(du8, 255);
+  // Any non zero lane disproves the property
+  auto alphaDiff = Zero(du8);
+  auto grayDiff = Zero(du8);
+
+  uint32_t x = 0;
+  for (; x + pixels <= width; x += pixels) {
+    VU8 r, g, b, a;
+    LoadInterleaved4(du8, src, r, g, b, a);
+    alphaDiff = Or(alphaDiff, Xor(a, opaque));
+    grayDiff = Or(grayDiff, Or(Xor(r, g), Xor(g, b)));
+    src += 4 * pixels;
+  }
+
+  uint32_t holds = checks;
+  if (!AllTrue(du8, Eq(alphaDiff, Zero(du8)))) {
+    holds &= ~static_cast<uint32_t>(CONTENT_OPAQUE);
+  }
+  if (!AllTrue(du8, Eq(grayDiff, Zero(du8)))) {
+    holds &= ~static_cast<uint32_t>(CONTENT_GRAYSCALE);
+  }
+
+  for (; x < width; ++x) {
+    if (src[3] != 255) {
+      holds &= ~static_cast<uint32_t>(CONTENT_OPAQUE);
+    }
+    if (src[0] != src[1] || src[1] != src[2]) {
+      holds &= ~static_cast<uint32_t>(CONTENT_GRAYSCALE);
+    }
+    src += 4;
+  }
+  return holds;
+}
+
+template<class D>
+HWY_INLINE MFromD<D> Is8BitLevel(D df, VFromD<Rebind<uint16_t, D>> bits) {
+  const Rebind<hwy::float16_t, D> df16;
+  const auto scaled = Mul(PromoteTo(df, BitCast(df16, bits)), Set(df, 255.0f));
+  // A half keeps an 8-bit level within 0.0625 of the integer, so requantizing an accepted sample
+  // moves it by less than 0.07 of an 8-bit step. NaN fails every comparison
+  const auto nearLevel = Le(Abs(Sub(scaled, Round(scaled))), Set(df, 0.07f));
+  const auto inRange = And(Ge(scaled, Zero(df)), Le(scaled, Set(df, 255.0f)));
+  return And(nearLevel, inRange);
+}
+
+static inline bool Is8BitLevel(const uint16_t bits) {
+  float scaled = half_to_float(bits) * 255.0f;
+  return scaled >= 0.0f && scaled <= 255.0f && std::fabs(scaled - std::roundf(scaled)) <= 0.07f;
+}
+
+uint32_t ScanRgbaF16RowHWY(const uint16_t *HWY_RESTRICT src, const uint32_t width,
+                           const uint32_t checks) {
+  const ScalableTag<float> df;
+  const Rebind<uint16_t, decltype(df)> du16;
+  using VU16 = Vec<decltype(du16)>;
+  const uint32_t pixels = Lanes(df);
+  const auto opaque = Set(du16, 0x3C00);
+  auto alphaDiff = Zero(du16);
+  auto grayDiff = Zero(du16);
+  bool is8Bit = (checks & CONTENT_8_BIT) != 0;
+
+  uint32_t x = 0;
+  for (; x + pixels <= width; x += pixels) {
+    VU16 r, g, b, a;
+    LoadInterleaved4(du16, src, r, g, b, a);
+    alphaDiff = Or(alphaDiff, Xor(a, opaque));
+    grayDiff = Or(grayDiff, Or(Xor(r, g), Xor(g, b)));
+    if (is8Bit) {
+      const auto levels = And(And(Is8BitLevel(df, r), Is8BitLevel(df, g)),
+                              And(Is8BitLevel(df, b), Is8BitLevel(df, a)));
+      is8Bit = AllTrue(df, levels);
+    }
+    src += 4 * pixels;
+  }
+
+  uint32_t holds = checks;
+  if (!AllTrue(du16, Eq(alphaDiff, Zero(du16)))) {
+    holds &= ~static_cast<uint32_t>(CONTENT_OPAQUE);
+  }
+  if (!AllTrue(du16, Eq(grayDiff, Zero(du16)))) {
+    holds &= ~static_cast<uint32_t>(CONTENT_GRAYSCALE);
+  }
+
+  for (; x < width; ++x) {
+    if (src[3] != 0x3C00) {
+      holds &= ~static_cast<uint32_t>(CONTENT_OPAQUE);
+    }
+    if (src[0] != src[1] || src[1] != src[2]) {
+      holds &= ~static_cast<uint32_t>(CONTENT_GRAYSCALE);
+    }
+    if (is8Bit) {
+      is8Bit = Is8BitLevel(src[0]) && Is8BitLevel(src[1]) && Is8BitLevel(src[2])
+          && Is8BitLevel(src[3]);
+    }
+    src += 4;
+  }
+  if (!is8Bit) {
+    holds &= ~static_cast<uint32_t>(CONTENT_8_BIT);
+  }
+  return holds;
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(ScanRgba8RowHWY);
+HWY_EXPORT(ScanRgbaF16RowHWY);
+
+// Rows handed to a single worker at once
+static constexpr uint32_t contentScanBandHeight = 32;
+// Smaller images aren't worth spawning workers for
+static constexpr uint64_t contentScanParallelPixels = 512 * 512;
+
+template<typename T, typename ScanRow>
+static uint32_t AnalyzeRows(const T *src, uint32_t stride, uint32_t width, uint32_t height,
+                            uint32_t checks, ScanRow scanRow) {
+  std::atomic<uint32_t> holds(checks);
+  const uint32_t bands = (height + contentScanBandHeight - 1) / contentScanBandHeight;
+  uint32_t threads = 1;
+  if (static_cast<uint64_t>(width) * height >= contentScanParallelPixels) {
+    threads = std::clamp(std::thread::hardware_concurrency(), 1u, std::max(bands, 1u));
+  }
+  concurrency::parallel_for(threads, bands, [&](int band) {
+    const uint32_t start = static_cast<uint32_t>(band) * contentScanBandHeight;
+    const uint32_t end = std::min(start + contentScanBandHeight, height);
+    for (uint32_t y = start; y < end; ++y) {
+      uint32_t remaining = holds.load(std::memory_order_relaxed);
+      if (remaining == 0) {
+        return;
+      }
+      auto row = reinterpret_cast<const T *>(reinterpret_cast<const uint8_t *>(src)
+          + static_cast<size_t>(y) * stride);
+      uint32_t rowHolds = scanRow(row, width, remaining);
+      if (rowHolds != remaining) {
+        holds.fetch_and(rowHolds, std::memory_order_relaxed);
+      }
+    }
+  });
+  return holds.load(std::memory_order_relaxed);
+}
+
+uint32_t AnalyzeRgba8(const uint8_t *src, uint32_t stride, uint32_t width, uint32_t height,
+                      uint32_t checks) {
+  // Every sample of an 8-bit image is an 8-bit level
+  uint32_t levels = checks & CONTENT_8_BIT;
+  checks &= ~static_cast<uint32_t>(CONTENT_8_BIT);
+  return levels | AnalyzeRows(src, stride, width, height, checks,
+                              [](const uint8_t *row, uint32_t w, uint32_t remaining) {
+                                return HWY_DYNAMIC_DISPATCH(ScanRgba8RowHWY)(row, w, remaining);
+                              });
+}
+
+uint32_t AnalyzeRgbaF16(const uint16_t *src, uint32_t stride, uint32_t width, uint32_t height,
+                        uint32_t checks) {
+  return AnalyzeRows(src, stride, width, height, checks,
+                     [](const uint16_t *row, uint32_t w, uint32_t remaining) {
+                       return HWY_DYNAMIC_DISPATCH(ScanRgbaF16RowHWY)(row, w, remaining);
+                     });
+}
+
+}
 
 template<typename T>
 bool isImageHasAlpha(T *image, uint32_t stride, uint32_t width, uint32_t height) {
+  if constexpr (std::is_same_v<T, uint8_t>) {
+    return (coder::AnalyzeRgba8(image, stride, width, height, coder::CONTENT_OPAQUE)
+        & coder::CONTENT_OPAQUE) == 0;
+  }
   T firstItem = image[3];
   if (firstItem != std::numeric_limits<T>::max()) {
     return true;
@@ -51,4 +242,5 @@ bool isImageHasAlpha(T *image, uint32_t stride, uint32_t width, uint32_t height)
 }
 
 template bool isImageHasAlpha(uint8_t *image, uint32_t stride, uint32_t width, uint32_t height);
-template bool isImageHasAlpha(uint16_t *image, uint32_t stride, uint32_t width, uint32_t height);
\ No newline at end of file
+template bool isImageHasAlpha(uint16_t *image, uint32_t stride, uint32_t width, uint32_t height);
+#endif
@@ -34,4 +34,29 @@
 template<typename T>
 bool isImageHasAlpha(T* image, uint32_t stride, uint32_t width, uint32_t height);
 
+namespace coder {
+
+enum ImageContentCheck {
+  // Every alpha sample is the maximum
+  CONTENT_OPAQUE = 1,
+  // R == G == B for every pixel
+  CONTENT_GRAYSCALE = 2,
+  // Every sample of a half float image is an 8-bit level k / 255 within [0, 1]
+  CONTENT_8_BIT = 4,
+  CONTENT_ALL = CONTENT_OPAQUE | CONTENT_GRAYSCALE | CONTENT_8_BIT
+};
+
+/**
+ * Runs the requested checks over interleaved RGBA in one pass, rows are scanned in parallel
+ * and the scan stops as soon as every requested property is disproved.
+ * @return mask of ImageContentCheck that hold for the whole image, unrequested checks are never set
+ */
+uint32_t AnalyzeRgba8(const uint8_t *src, uint32_t stride, uint32_t width, uint32_t height,
+                      uint32_t checks);
+
+uint32_t AnalyzeRgbaF16(const uint16_t *src, uint32_t stride, uint32_t width, uint32_t height,
+                        uint32_t checks);
+
+}
+
 #endif //AVIF_AVIF_CODER_SRC_MAIN_CPP_IMAGEBITS_SCANALPHA_H_
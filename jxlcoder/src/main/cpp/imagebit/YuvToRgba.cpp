@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "YuvToRgba.h"
+#include <algorithm>
+#include <cmath>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "imagebit/YuvToRgba.cpp"
+
+#include "hwy/foreach_target.h"  // IWYU pragma: keep
+#include "hwy/highway.h"
+
+#ifndef JXLCODER_YUVTORGBA_COEFFICIENTS
+#define JXLCODER_YUVTORGBA_COEFFICIENTS
+
+namespace coder {
+
+struct YuvCoefficients {
+  float yOffset;
+  float yScale;
+  float uvScale;
+  float crToR;
+  float cbToG;
+  float crToG;
+  float cbToB;
+};
+
+static YuvCoefficients MakeYuvCoefficients(YuvMatrix matrix, YuvRange range) {
+  const float kr = matrix == YUV_MATRIX_BT709 ? 0.2126f : 0.299f;
+  const float kb = matrix == YUV_MATRIX_BT709 ? 0.0722f : 0.114f;
+  const float kg = 1.f - kr - kb;
+  const bool limited = range == YUV_RANGE_LIMITED;
+  return {
+      .yOffset = limited ? 16.f : 0.f,
+      .yScale = limited ? 255.f / 219.f : 1.f,
+      .uvScale = limited ? 255.f / 224.f : 1.f,
+      .crToR = 2.f * (1.f - kr),
+      .cbToG = -2.f * kb * (1.f - kb) / kg,
+      .crToG = -2.f * kr * (1.f - kr) / kg,
+      .cbToB = 2.f * (1.f - kb),
+  };
+}
+
+static inline uint8_t YuvClampToU8(float value) {
+  return static_cast<uint8_t>(std::clamp(std::lrintf(value), 0l, 255l));
+}
+
+static inline void YuvPixelToRgba8(const YuvCoefficients &k, uint8_t y, uint8_t u, uint8_t v,
+                                   uint8_t *dst) {
+  const float luma = (static_cast<float>(y) - k.yOffset) * k.yScale;
+  const float cb = (static_cast<float>(u) - 128.f) * k.uvScale;
+  const float cr = (static_cast<float>(v) - 128.f) * k.uvScale;
+  dst[0] = YuvClampToU8(luma + k.crToR * cr);
+  dst[1] = YuvClampToU8(luma + k.cbToG * cb + k.crToG * cr);
+  dst[2] = YuvClampToU8(luma + k.cbToB * cb);
+  dst[3] = 255;
+}
+
+}
+
+#endif
+
+HWY_BEFORE_NAMESPACE();
+namespace coder::HWY_NAMESPACE {
+
+using namespace hwy::HWY_NAMESPACE;
+
+/**
+ * Converts pixels [fromX, toX) of a single row into dst, fromX must be even
+ * @param imageWidth used to keep interleaved chroma loads inside of the plane
+ */
+void YuvRowToRgba8HWY(const uint8_t *HWY_RESTRICT yRow, const uint8_t *HWY_RESTRICT uRow,
+                      const uint8_t *HWY_RESTRICT vRow, const uint32_t uvPixelStride,
+                      uint8_t *HWY_RESTRICT dst, uint32_t fromX, const uint32_t toX,
+                      const uint32_t imageWidth, const YuvCoefficients &k) {
+  const uint32_t startX = fromX;
+#if HWY_TARGET != HWY_SCALAR
+  if (uvPixelStride == 1 || uvPixelStride == 2) {
+    const ScalableTag<float> df;
+    const Rebind<int32_t, decltype(df)> di32;
+    const Rebind<uint8_t, decltype(df)> du8;
+    const size_t lanes = Lanes(df);
+
+    const auto yOffset = Set(df, k.yOffset);
+    const auto yScale = Set(df, k.yScale);
+    const auto uvScale = Set(df, k.uvScale);
+    const auto uvBias = Set(df, 128.f);
+    const auto crToR = Set(df, k.crToR);
+    const auto cbToG = Set(df, k.cbToG);
+    const auto crToG = Set(df, k.crToG);
+    const auto cbToB = Set(df, k.cbToB);
+    const auto zeros = Zero(df);
+    const auto maxValue = Set(df, 255.f);
+    const auto alpha = Set(du8, 255);
+
+    auto toU8 = [&](decltype(zeros) value) {
+      return DemoteTo(du8, NearestInt(Min(Max(value, zeros), maxValue)));
+    };
+
+    auto storePixels = [&](const uint8_t *yPixels, decltype(zeros) rAdd, decltype(zeros) gAdd,
+                           decltype(zeros) bAdd, uint8_t *out) {
+      const auto luma = Mul(Sub(ConvertTo(df, PromoteTo(di32, LoadU(du8, yPixels))), yOffset),
+                            yScale);
+      StoreInterleaved4(toU8(Add(luma, rAdd)), toU8(Add(luma, gAdd)), toU8(Add(luma, bAdd)),
+                        alpha, du8, out);
+    };
+
+    // Every step takes lanes chroma samples for twice as many pixels, the strict bound keeps
+    // one more chroma sample after the loaded ones, so interleaved loads never pass the plane end
+    for (; fromX + 2 * lanes <= toX && fromX + 2 * lanes < imageWidth; fromX += 2 * lanes) {
+      const size_t c = fromX / 2;
+      VFromD<decltype(du8)> uRaw, vRaw;
+      if (uvPixelStride == 1) {
+        uRaw = LoadU(du8, uRow + c);
+        vRaw = LoadU(du8, vRow + c);
+      } else {
+        VFromD<decltype(du8)> skip;
+        LoadInterleaved2(du8, uRow + c * 2, uRaw, skip);
+        LoadInterleaved2(du8, vRow + c * 2, vRaw, skip);
+      }
+      const auto cb = Mul(Sub(ConvertTo(df, PromoteTo(di32, uRaw)), uvBias), uvScale);
+      const auto cr = Mul(Sub(ConvertTo(df, PromoteTo(di32, vRaw)), uvBias), uvScale);
+      const auto rAdd = Mul(cr, crToR);
+      const auto gAdd = MulAdd(cb, cbToG, Mul(cr, crToG));
+      const auto bAdd = Mul(cb, cbToB);
+
+      storePixels(yRow + fromX,
+                  InterleaveWholeLower(df, rAdd, rAdd),
+                  InterleaveWholeLower(df, gAdd, gAdd),
+                  InterleaveWholeLower(df, bAdd, bAdd),
+                  dst + static_cast<size_t>(fromX - startX) * 4);
+      storePixels(yRow + fromX + lanes,
+                  InterleaveWholeUpper(df, rAdd, rAdd),
+                  InterleaveWholeUpper(df, gAdd, gAdd),
+                  InterleaveWholeUpper(df, bAdd, bAdd),
+                  dst + (static_cast<size_t>(fromX - startX) + lanes) * 4);
+    }
+  }
+#endif
+
+  for (; fromX < toX; ++fromX) {
+    const size_t c = static_cast<size_t>(fromX / 2) * uvPixelStride;
+    YuvPixelToRgba8(k, yRow[fromX], uRow[c], vRow[c],
+                    dst + static_cast<size_t>(fromX - startX) * 4);
+  }
+}
+
+void YuvToRgba8HWY(const YuvPlanes &planes, const uint32_t x, const uint32_t y,
+                   const uint32_t width, const uint32_t height,
+                   uint8_t *dst, const uint32_t dstStride, YuvMatrix matrix, YuvRange range) {
+  const YuvCoefficients k = MakeYuvCoefficients(matrix, range);
+  for (uint32_t row = 0; row < height; ++row) {
+    const uint32_t sourceRow = y + row;
+    const uint8_t *yRow = planes.y + static_cast<size_t>(sourceRow) * planes.yStride;
+    const uint8_t *uRow = planes.u + static_cast<size_t>(sourceRow / 2) * planes.uvStride;
+    const uint8_t *vRow = planes.v + static_cast<size_t>(sourceRow / 2) * planes.uvStride;
+    uint8_t *out = dst + static_cast<size_t>(row) * dstStride;
+    uint32_t fromX = x;
+    // The row kernel must start on a chroma pair
+    if ((fromX & 1) && width > 0) {
+      const size_t c = static_cast<size_t>(fromX / 2) * planes.uvPixelStride;
+      YuvPixelToRgba8(k, yRow[fromX], uRow[c], vRow[c], out);
+      fromX += 1;
+      out += 4;
+    }
+    YuvRowToRgba8HWY(yRow, uRow, vRow, planes.uvPixelStride, out, fromX, x + width,
+                     planes.width, k);
+  }
+}
+
+}
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace coder {
+HWY_EXPORT(YuvToRgba8HWY);
+
+void YuvToRgba8(const YuvPlanes &planes, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                uint8_t *dst, uint32_t dstStride, YuvMatrix matrix, YuvRange range) {
+  HWY_DYNAMIC_DISPATCH(YuvToRgba8HWY)(planes, x, y, width, height, dst, dstStride, matrix, range);
+}
+}
+#endif
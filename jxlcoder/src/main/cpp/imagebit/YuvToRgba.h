@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef JXLCODER_YUVTORGBA_H
+#define JXLCODER_YUVTORGBA_H
+
+#include <cstdint>
+
+namespace coder {
+
+// Values are shared with java side
+enum YuvMatrix {
+  YUV_MATRIX_BT601 = 1,
+  YUV_MATRIX_BT709 = 2,
+};
+
+enum YuvRange {
+  // Y and chroma use all of 0...255
+  YUV_RANGE_FULL = 1,
+  // Y in 16...235 and chroma in 16...240
+  YUV_RANGE_LIMITED = 2,
+};
+
+/**
+ * 4:2:0 planes as they are exposed by YUV_420_888 images.
+ * Chroma samples of a row are uvPixelStride bytes apart, so the same description covers
+ * planar I420 (1) and interleaved NV21/NV12 (2) chroma.
+ */
+struct YuvPlanes {
+  const uint8_t *y;
+  const uint8_t *u;
+  const uint8_t *v;
+  uint32_t yStride;
+  uint32_t uvStride;
+  uint32_t uvPixelStride;
+  uint32_t width;
+  uint32_t height;
+};
+
+/**
+ * Converts a rectangle of the planes into opaque RGBA 8888, chroma is upsampled by replication.
+ */
+void YuvToRgba8(const YuvPlanes &planes, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                uint8_t *dst, uint32_t dstStride, YuvMatrix matrix, YuvRange range);
+
+}
+
+#endif //JXLCODER_YUVTORGBA_H
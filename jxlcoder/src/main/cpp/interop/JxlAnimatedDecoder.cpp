@@ -26,13 +26,34 @@
 #include "JxlAnimatedDecoder.hpp"
 
 JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
+  JxlFrame result;
+  decodeFrames(framePosition, 1, [&result](JxlFrame &frame) {
+    result = std::move(frame);
+  });
+  return result;
+}
+
+void JxlAnimatedDecoder::decodeFrames(int from, int count,
+                                      const std::function<void(JxlFrame &)> &onFrame) {
   std::lock_guard guard(lock);
-  if (framePosition < 0) {
+  try {
+    CallScope callScope(*this);
+    decodeGovernedFrames(from, count, onFrame);
+  } catch (concurrency::OperationCancelledException &err) {
+    // Time limit is delivered through the cancellation token, report it as the limit it is
+    governor.checkTime();
+    throw;
+  }
+}
+
+void JxlAnimatedDecoder::decodeGovernedFrames(int from, int count,
+                                              const std::function<void(JxlFrame &)> &onFrame) {
+  if (from < 0) {
     std::string str = "Frame position must be positive";
     throw AnimatedDecoderError(str);
   }
 
-  if (framePosition >= this->frameInfo.size()) {
+  if (count < 1 || from >= this->frameInfo.size() || count > this->frameInfo.size() - from) {
     std::string str = "Requested frame index more than frames in the container";
     throw AnimatedDecoderError(str);
   }
@@ -49,7 +70,7 @@ JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
     throw AnimatedDecoderError(str);
   }
   JxlDecoderCloseInput(dec.get());
-  JxlDecoderSkipFrames(dec.get(), framePosition);
+  JxlDecoderSkipFrames(dec.get(), from);
 
   if (JXL_DEC_SUCCESS != JxlDecoderSetCoalescing(dec.get(), JXL_TRUE)) {
     std::string str = "Cannot coalesce frames";
@@ -62,7 +83,9 @@ JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
   bool useColorEncoding = false;
   JxlPixelFormat format = {4, JXL_TYPE_UINT8, JXL_NATIVE_ENDIAN, 0};
   bool isFrameReceived = false;
+  int framesDelivered = 0;
   for (;;) {
+    governor.checkTime();
     JxlDecoderStatus status = JxlDecoderProcessInput(dec.get());
     if (status == JXL_DEC_FRAME) {
       JxlFrameHeader header;
@@ -88,6 +111,7 @@ JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
         std::string str = "Buffer size are not valid";
         throw AnimatedDecoderError(str);
       }
+      governor.onFrame(allocationSize);
       pixels.resize(allocationSize);
       void *pixelsBuffer = (void *) pixels.data();
 
@@ -113,30 +137,43 @@ JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
         }
       }
     } else if (status == JXL_DEC_FULL_IMAGE || status == JXL_DEC_SUCCESS) {
-      // All decoding successfully finished, we are at the end of the file.
-      // We must rewind the decoder to get a new frame.
-      JxlDecoderRewind(dec.get());
-      JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE);
-      JxlDecoderSetInput(dec.get(), data.data(), data.size());
-      JxlDecoderCloseInput(dec.get());
-
       if (!isFrameReceived) {
-        std::string str = "Cannot decode frame. Possible frame " + std::to_string(framePosition)
+        // All decoding successfully finished, we are at the end of the file.
+        // We must rewind the decoder to get a new frame.
+        JxlDecoderRewind(dec.get());
+        JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE);
+        JxlDecoderSetInput(dec.get(), data.data(), data.size());
+        JxlDecoderCloseInput(dec.get());
+
+        std::string str = "Cannot decode frame. Possible frame " + std::to_string(from + framesDelivered)
             + " position is more than frames available. Also possible case is previous frame have an infinity duration.";
         throw AnimatedDecoderError(str);
       }
 
-      std::vector<uint8_t> iccCopy;
-      iccCopy = iccProfile;
-
-      JxlFrame frame = {.pixels = pixels,
-          .iccProfile = iccCopy,
+      JxlFrame frame = {.pixels = std::move(pixels),
+          .iccProfile = iccProfile,
           .colorEncoding = clr,
           .hasAlphaInOrigin = info.num_extra_channels > 0 && info.alpha_bits > 0,
           .preferColorEncoding = useColorEncoding,
           .duration = frameTime};
-      return frame;
+      pixels = std::vector<uint8_t>();
+      isFrameReceived = false;
+      onFrame(frame);
+
+      if (++framesDelivered == count || status == JXL_DEC_SUCCESS) {
+        // All requested frames are delivered, rewind the decoder for the next request
+        JxlDecoderRewind(dec.get());
+        JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE);
+        JxlDecoderSetInput(dec.get(), data.data(), data.size());
+        JxlDecoderCloseInput(dec.get());
+        if (framesDelivered != count) {
+          std::string str = "Container ended before all requested frames were decoded";
+          throw AnimatedDecoderError(str);
+        }
+        return;
+      }
     } else {
+      throwIfInterrupted();
       std::string str = "Error event has received";
       throw AnimatedDecoderError(str);
     }
@@ -145,8 +182,20 @@ JxlFrame JxlAnimatedDecoder::getFrame(int framePosition) {
 
 JxlFrame JxlAnimatedDecoder::nextFrame() {
   std::lock_guard guard(lock);
+  try {
+    CallScope callScope(*this);
+    return nextGovernedFrame();
+  } catch (concurrency::OperationCancelledException &err) {
+    // Time limit is delivered through the cancellation token, report it as the limit it is
+    governor.checkTime();
+    throw;
+  }
+}
+
+JxlFrame JxlAnimatedDecoder::nextGovernedFrame() {
   int frameTime = 0;
   for (;;) {
+    governor.checkTime();
     JxlDecoderStatus status = JxlDecoderProcessInput(dec.get());
     if (status == JXL_DEC_FULL_IMAGE || status == JXL_DEC_SUCCESS) {
       // All decoding successfully finished, we are at the end of the file.
@@ -181,6 +230,7 @@ JxlFrame JxlAnimatedDecoder::nextFrame() {
         throw AnimatedDecoderError(str);
       }
       std::vector<uint8_t> pixels;
+      governor.onFrame(bufferSize);
       pixels.resize(info.xsize * info.ysize * (components) * sizeof(uint8_t));
       void *pixelsBuffer = (void *) pixels.data();
 
@@ -196,6 +246,7 @@ JxlFrame JxlAnimatedDecoder::nextFrame() {
       JxlFrame frame = {.pixels = pixels, .iccProfile = iccCopy, .duration = frameTime};
       return frame;
     } else {
+      throwIfInterrupted();
       std::string str = "Error event has received";
       throw AnimatedDecoderError(str);
     }
@@ -36,7 +36,11 @@
 #include "resizable_parallel_runner.h"
 #include "resizable_parallel_runner_cxx.h"
 #include <thread>
+#include <functional>
 #include "conversion/HalfFloats.h"
+#include "JxlMemoryManager.hpp"
+#include "JxlResourceGovernor.hpp"
+#include "JxlCancellableRunner.hpp"
 
 class AnimatedDecoderError : public std::exception {
  public:
@@ -73,10 +77,16 @@ class JxlAnimatedDecoder {
       throw AnimatedDecoderError(str);
     }
 
-    runner = JxlResizableParallelRunnerMake(nullptr);
+    runner = JxlResizableParallelRunnerMake(memoryTracker.manager());
+    cancellableRunner = {
+        .runner = JxlResizableParallelRunner,
+        .runnerOpaque = runner.get(),
+        .token = nullptr,
+    };
 
-    dec = JxlDecoderMake(nullptr);
+    dec = JxlDecoderMake(memoryTracker.manager());
     if (!dec) {
+      memoryTracker.throwIfBudgetExceeded();
       std::string str = "Cannot create decoder";
       throw AnimatedDecoderError(str);
     }
@@ -90,8 +100,8 @@ class JxlAnimatedDecoder {
     }
 
     if (JXL_DEC_SUCCESS != JxlDecoderSetParallelRunner(dec.get(),
-                                                       JxlResizableParallelRunner,
-                                                       runner.get())) {
+                                                       coder::JxlCancellableParallelRunner,
+                                                       &cancellableRunner)) {
       std::string str = "Cannot attach parallel runner to decoder";
       throw AnimatedDecoderError(str);
     }
@@ -104,9 +114,92 @@ class JxlAnimatedDecoder {
     JxlDecoderSetInput(dec.get(), data.data(), data.size());
     JxlDecoderCloseInput(dec.get());
 
+    try {
+      CallScope callScope(*this);
+      readAnimationInfo();
+    } catch (concurrency::OperationCancelledException &err) {
+      // Time limit is delivered through the cancellation token, report it as the limit it is
+      governor.checkTime();
+      throw;
+    }
+  }
+
+  JxlFrame nextFrame();
+
+  JxlFrame getFrame(int at);
+
+  /**
+   * Decodes count consecutive coalesced frames starting from the given one in a single pass,
+   * every frame is handed to onFrame before the next one is decoded
+   */
+  void decodeFrames(int from, int count, const std::function<void(JxlFrame &)> &onFrame);
+
+  [[nodiscard]] uint32_t getLoopCount() {
+    return loopCount;
+  }
+
+  [[nodiscard]] uint32_t getWidth() const {
+    return info.xsize;
+  }
+
+  [[nodiscard]] uint32_t getHeight() const {
+    return info.ysize;
+  }
+
+  int getNumberOfFrames() {
+    return static_cast<int>(frameInfo.size());
+  }
+
+  [[nodiscard]] bool isAlphaAttenuated() const {
+    return alphaPremultiplied;
+  }
+
+  int getFrameDuration(int frame) {
+    std::lock_guard guard(lock);
+    if (frame < 0) {
+      return 0;
+    }
+
+    if (frame >= this->frameInfo.size()) {
+      return 0;
+    }
+    JxlFrameInfo fInfo = this->frameInfo[frame];
+    return fInfo.duration;
+  }
+
+ private:
+  /**
+   * Installs the decoder governor for a single call and points the runner at its deadline,
+   * so frames and decoded bytes add up and the time limit spans the whole decoder lifetime
+   */
+  class CallScope {
+   public:
+    explicit CallScope(JxlAnimatedDecoder &decoder)
+        : governorScope(decoder.governor), runner(decoder.cancellableRunner) {
+      runner.token = concurrency::currentCancellationToken();
+    }
+
+    ~CallScope() {
+      runner.token = nullptr;
+    }
+
+   private:
+    coder::JxlGovernorScope governorScope;
+    coder::JxlCancellableRunner &runner;
+  };
+
+  // Runner skips jobs once cancelled, therefore a failed call must be checked for it first
+  void throwIfInterrupted() {
+    memoryTracker.throwIfBudgetExceeded();
+    concurrency::throwIfCurrentOperationCancelled();
+  }
+
+  void readAnimationInfo() {
     for (;;) {
+      governor.checkTime();
       JxlDecoderStatus status = JxlDecoderProcessInput(dec.get());
       if (status == JXL_DEC_ERROR) {
+        throwIfInterrupted();
         std::string str = "Cannot retreive basic info";
         throw AnimatedDecoderError(str);
       } else if (status == JXL_DEC_BASIC_INFO) {
@@ -128,6 +221,8 @@ class JxlAnimatedDecoder {
           throw AnimatedDecoderError(strdup(errorMessage.c_str()));
         }
 
+        governor.checkImageSize(info.xsize, info.ysize);
+
         JxlResizableParallelRunnerSetThreads(
             runner.get(),
             JxlResizableParallelRunnerSuggestThreads(info.xsize, info.ysize));
@@ -154,6 +249,7 @@ class JxlAnimatedDecoder {
           frameTime = 0;
         JxlFrameInfo fInfo = {.duration = frameTime};
         this->frameInfo.push_back(fInfo);
+        governor.checkFrameCount(this->frameInfo.size());
       } else if (status == JXL_DEC_NEED_IMAGE_OUT_BUFFER) {
         if (JXL_DEC_SUCCESS != JxlDecoderSkipCurrentFrame(dec.get())) {
           std::string str = "Cannot properly resolve animation info";
@@ -184,44 +280,12 @@ class JxlAnimatedDecoder {
     }
   }
 
-  JxlFrame nextFrame();
-
-  JxlFrame getFrame(int at);
-
-  [[nodiscard]] uint32_t getLoopCount() {
-    return loopCount;
-  }
-
-  [[nodiscard]] uint32_t getWidth() const {
-    return info.xsize;
-  }
+  JxlFrame nextGovernedFrame();
 
-  [[nodiscard]] uint32_t getHeight() const {
-    return info.ysize;
-  }
+  void decodeGovernedFrames(int from, int count, const std::function<void(JxlFrame &)> &onFrame);
 
-  int getNumberOfFrames() {
-    return static_cast<int>(frameInfo.size());
-  }
-
-  [[nodiscard]] bool isAlphaAttenuated() const {
-    return alphaPremultiplied;
-  }
-
-  int getFrameDuration(int frame) {
-    std::lock_guard guard(lock);
-    if (frame < 0) {
-      return 0;
-    }
-
-    if (frame >= this->frameInfo.size()) {
-      return 0;
-    }
-    JxlFrameInfo fInfo = this->frameInfo[frame];
-    return fInfo.duration;
-  }
-
- private:
+  // Declared first, libjxl objects below are released through it
+  coder::JxlMemoryTracker memoryTracker;
   std::vector<uint8_t> data;
   std::vector<uint8_t> iccProfile;
   std::vector<JxlFrameInfo> frameInfo;
@@ -232,6 +296,9 @@ class JxlAnimatedDecoder {
   int denom;
   int numer;
   JxlResizableParallelRunnerPtr runner;
+  coder::JxlCancellableRunner cancellableRunner;
+  // Limits add up over every call to the decoder
+  coder::JxlResourceGovernor governor{coder::JxlResourceGovernor::Detached{}};
   std::mutex lock;
 };
 
@@ -26,6 +26,11 @@
 #include "JxlAnimatedEncoder.hpp"
 
 void JxlAnimatedEncoder::addFrame(std::vector<uint8_t> &data, int frameTime) {
+  addFrame(data.data(), data.size(), pixelFormat, frameTime);
+}
+
+void JxlAnimatedEncoder::addFrame(const void *data, size_t size, const JxlPixelFormat &format,
+                                  int frameTime) {
   std::lock_guard guard(lock);
 
   if (!isColorEncodingSet) {
@@ -49,15 +54,14 @@ void JxlAnimatedEncoder::addFrame(std::vector<uint8_t> &data, int frameTime) {
   }
 
   if (JXL_ENC_SUCCESS !=
-      JxlEncoderAddImageFrame(frameSettings, &pixelFormat,
-                              (void *) data.data(),
-                              sizeof(uint8_t) * data.size())) {
+      JxlEncoderAddImageFrame(frameSettings, &format, data, size)) {
+    memoryTracker.throwIfBudgetExceeded();
     std::string str = "Encoding frame has failed";
     throw AnimatedEncoderError(str);
   }
 }
 
-void JxlAnimatedEncoder::encode(std::vector<uint8_t> &dst) {
+const coder::JxlBlockOutputSink &JxlAnimatedEncoder::encode() {
   std::lock_guard guard(lock);
   if (!isColorEncodingSet) {
     setColorEncoding();
@@ -66,26 +70,16 @@ void JxlAnimatedEncoder::encode(std::vector<uint8_t> &dst) {
     std::string str = "Cannot compress empty animation";
     throw AnimatedEncoderError(str);
   }
-  JxlEncoderCloseFrames(enc.get());
+  JxlEncoderCloseInput(enc.get());
 
-  dst.resize(64);
-  uint8_t *nextOut = dst.data();
-  size_t availOut = dst.size() - (nextOut - dst.data());
-  JxlEncoderStatus processResult = JXL_ENC_NEED_MORE_OUTPUT;
-  while (processResult == JXL_ENC_NEED_MORE_OUTPUT) {
-    processResult = JxlEncoderProcessOutput(enc.get(), &nextOut, &availOut);
-    if (processResult == JXL_ENC_NEED_MORE_OUTPUT) {
-      size_t offset = nextOut - dst.data();
-      dst.resize(dst.size() * 2);
-      nextOut = dst.data() + offset;
-      availOut = dst.size() - offset;
-    }
-  }
-  dst.resize(nextOut - dst.data());
+  JxlEncoderStatus processResult = JxlEncoderFlushInput(enc.get());
   if (JXL_ENC_SUCCESS != processResult) {
+    memoryTracker.throwIfBudgetExceeded();
     std::string str = "Encoding image has failed";
     throw AnimatedEncoderError(str);
   }
+  output.finish();
+  return output;
 }
 
 JxlAnimatedEncoder::~JxlAnimatedEncoder() {
@@ -34,6 +34,9 @@
 #include "thread_parallel_runner_cxx.h"
 #include <string>
 #include "JxlDefinitions.h"
+#include "JxlEncodingProfile.hpp"
+#include "JxlMemoryManager.hpp"
+#include "JxlOutputSink.hpp"
 #include <vector>
 #include <thread>
 
@@ -54,7 +57,8 @@ class JxlAnimatedEncoder {
   JxlAnimatedEncoder(int width, int height, JxlColorPixelType pixelType,
                      JxlEncodingPixelDataFormat encodingPixelFormat,
                      JxlCompressionOption compressionOption,
-                     int numLoops, int quality, int effort, int decodingSpeed) : width(width),
+                     int numLoops, int quality, int effort, int decodingSpeed,
+                     JxlEncodingProfile profile) : width(width),
                                                                                  height(height),
                                                                                  pixelType(
                                                                                      pixelType),
@@ -65,6 +69,7 @@ class JxlAnimatedEncoder {
                                                                                  quality(quality),
                                                                                  effort(effort) {
     if (!enc || !runner) {
+      memoryTracker.throwIfBudgetExceeded();
       std::string str = "Cannot initialize encoder";
       throw AnimatedEncoderError(str);
     }
@@ -74,6 +79,11 @@ class JxlAnimatedEncoder {
       std::string str = "Cannot initialize parallel runner";
       throw AnimatedEncoderError(str);
     }
+    // Frames are written out as they are added instead of being kept until the end
+    if (JXL_ENC_SUCCESS != JxlEncoderSetOutputProcessor(enc.get(), output.processor())) {
+      std::string str = "Cannot set encoder output";
+      throw AnimatedEncoderError(str);
+    }
 
     uint32_t channelsCount = 3;
 
@@ -107,7 +117,8 @@ class JxlAnimatedEncoder {
     JxlEncoderInitBasicInfo(&basicInfo);
     basicInfo.xsize = width;
     basicInfo.ysize = height;
-    basicInfo.bits_per_sample = 8;
+    basicInfo.bits_per_sample = encodingPixelFormat == BINARY_16 ? 16 : 8;
+    basicInfo.exponent_bits_per_sample = encodingPixelFormat == BINARY_16 ? 5 : 0;
     basicInfo.uses_original_profile = compressionOption == lossy ? JXL_FALSE : JXL_TRUE;
     basicInfo.num_color_channels = baseChannelsCount;
 
@@ -124,7 +135,8 @@ class JxlAnimatedEncoder {
 
     if (pixelType == rgba) {
       basicInfo.num_extra_channels = 1;
-      basicInfo.alpha_bits = 8;
+      basicInfo.alpha_bits = encodingPixelFormat == BINARY_16 ? 16 : 8;
+      basicInfo.alpha_exponent_bits = encodingPixelFormat == BINARY_16 ? 5 : 0;
     }
 
     if (JXL_ENC_SUCCESS != JxlEncoderSetBasicInfo(enc.get(), &basicInfo)) {
@@ -135,7 +147,8 @@ class JxlAnimatedEncoder {
     if (pixelType == rgba) {
       JxlExtraChannelInfo channelInfo;
       JxlEncoderInitExtraChannelInfo(JXL_CHANNEL_ALPHA, &channelInfo);
-      channelInfo.bits_per_sample = 8;
+      channelInfo.bits_per_sample = encodingPixelFormat == BINARY_16 ? 16 : 8;
+      channelInfo.exponent_bits_per_sample = encodingPixelFormat == BINARY_16 ? 5 : 0;
       channelInfo.alpha_premultiplied = false;
       if (JXL_ENC_SUCCESS != JxlEncoderSetExtraChannelInfo(enc.get(), 0, &channelInfo)) {
         std::string str = "Cannot set extra channel to encoder";
@@ -195,11 +208,25 @@ class JxlAnimatedEncoder {
       throw AnimatedEncoderError(str);
     }
 
+    if (!ApplyJxlEncodingProfile(frameSettings, profile)) {
+      std::string str = "Set encoding profile has failed";
+      throw AnimatedEncoderError(str);
+    }
+
   }
 
   void addFrame(std::vector<uint8_t> &data, int frameTime);
 
-  void encode(std::vector<uint8_t> &dst);
+  /**
+   * Adds a frame in any format libjxl accepts, the number of channels must match the encoder.
+   * Bit depth of the frame is taken from the format, so samples are scaled into the stored depth.
+   */
+  void addFrame(const void *data, size_t size, const JxlPixelFormat &format, int frameTime);
+
+  /**
+   * Closes the animation, the returned stream stays owned by the encoder
+   */
+  const coder::JxlBlockOutputSink &encode();
 
   int getWidth() {
     return width;
@@ -262,8 +289,11 @@ class JxlAnimatedEncoder {
     }
   }
 
-  JxlEncoderPtr enc = JxlEncoderMake(nullptr);
-  JxlThreadParallelRunnerPtr runner = JxlThreadParallelRunnerMake(nullptr,
+  // Declared first, libjxl objects below are released through it
+  coder::JxlMemoryTracker memoryTracker;
+  coder::JxlBlockOutputSink output;
+  JxlEncoderPtr enc = JxlEncoderMake(memoryTracker.manager());
+  JxlThreadParallelRunnerPtr runner = JxlThreadParallelRunnerMake(memoryTracker.manager(),
                                                                   JxlThreadParallelRunnerDefaultNumWorkerThreads());
 
   JxlBasicInfo basicInfo;
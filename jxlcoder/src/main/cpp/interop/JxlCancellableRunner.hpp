@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "jxl/parallel_runner.h"
+#include "cancellation.hpp"
+
+namespace coder {
+
+/**
+ * Wraps any libjxl parallel runner and polls a cancellation token on each job dispatch.
+ * Once the token fires the remaining jobs are skipped and the runner reports a failure,
+ * so libjxl unwinds the current ProcessInput/ProcessOutput call with an error.
+ */
+struct JxlCancellableRunner {
+  JxlParallelRunner runner;
+  void *runnerOpaque;
+  concurrency::CancellationToken *token;
+};
+
+namespace {
+
+struct JxlCancellableDispatch {
+  void *jpegxlOpaque;
+  JxlParallelRunInit init;
+  JxlParallelRunFunction func;
+  concurrency::CancellationToken *token;
+};
+
+JxlParallelRetCode JxlCancellableDispatchInit(void *opaque, size_t numThreads) {
+  auto dispatch = reinterpret_cast<JxlCancellableDispatch *>(opaque);
+  if (dispatch->token->isCancelled()) {
+    return -1;
+  }
+  return dispatch->init(dispatch->jpegxlOpaque, numThreads);
+}
+
+void JxlCancellableDispatchRun(void *opaque, uint32_t value, size_t threadId) {
+  auto dispatch = reinterpret_cast<JxlCancellableDispatch *>(opaque);
+  if (dispatch->token->isCancelled()) {
+    return;
+  }
+  dispatch->func(dispatch->jpegxlOpaque, value, threadId);
+}
+
+}
+
+static inline JxlParallelRetCode JxlCancellableParallelRunner(void *runnerOpaque,
+                                                              void *jpegxlOpaque,
+                                                              JxlParallelRunInit init,
+                                                              JxlParallelRunFunction func,
+                                                              uint32_t startRange,
+                                                              uint32_t endRange) {
+  auto cancellable = reinterpret_cast<JxlCancellableRunner *>(runnerOpaque);
+  if (cancellable->token == nullptr) {
+    return cancellable->runner(cancellable->runnerOpaque, jpegxlOpaque, init, func,
+                               startRange, endRange);
+  }
+  if (cancellable->token->isCancelled()) {
+    return -1;
+  }
+  JxlCancellableDispatch dispatch = {
+      .jpegxlOpaque = jpegxlOpaque,
+      .init = init,
+      .func = func,
+      .token = cancellable->token,
+  };
+  JxlParallelRetCode code = cancellable->runner(cancellable->runnerOpaque, &dispatch,
+                                                JxlCancellableDispatchInit,
+                                                JxlCancellableDispatchRun,
+                                                startRange, endRange);
+  // Skipped jobs leave the output incomplete, therefore this must be reported as a failure
+  if (code == 0 && cancellable->token->isCancelled()) {
+    return -1;
+  }
+  return code;
+}
+
+}
@@ -0,0 +1,298 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlChunkedSource.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "cancellation.hpp"
+#include "conversion/RgbChannels.h"
+#include "imagebit/CopyUnalignedRGBA.h"
+#include "imagebit/RGBAlpha.h"
+#include "imagebit/Rgb565.h"
+#include "imagebit/Rgb1010102.h"
+#include "imagebit/RgbaToRgb.h"
+
+namespace coder {
+
+uint32_t JxlSourcePixelSize(JxlSourceLayout layout) {
+  switch (layout) {
+    case SOURCE_RGBA_F16:return 4 * sizeof(uint16_t);
+    case SOURCE_RGB_565:return sizeof(uint16_t);
+    case SOURCE_RGBA_8888:
+    case SOURCE_RGBA_1010102:
+    default:return 4 * sizeof(uint8_t);
+  }
+}
+
+const uint8_t *JxlMemoryPixelReader::region(uint32_t x, uint32_t y, uint32_t, uint32_t,
+                                            uint32_t *rowStride, pooled_uint8_vector &) {
+  *rowStride = stride;
+  return data + static_cast<size_t>(y) * stride + static_cast<size_t>(x) * pixelSize;
+}
+
+const uint8_t *JxlFdPixelReader::region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                        uint32_t *rowStride, pooled_uint8_vector &scratch) {
+  uint32_t lineWidth = width * pixelSize;
+  scratch.resize(static_cast<size_t>(lineWidth) * height);
+  for (uint32_t row = 0; row < height; ++row) {
+    int64_t position = offset + static_cast<int64_t>(y + row) * stride
+        + static_cast<int64_t>(x) * pixelSize;
+    uint8_t *dst = scratch.data() + static_cast<size_t>(row) * lineWidth;
+    size_t done = 0;
+    while (done < lineWidth) {
+      ssize_t result = pread64(fd, dst + done, lineWidth - done, position + static_cast<int64_t>(done));
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        std::string reason = result == 0 ? "unexpected end of file" : strerror(errno);
+        throw std::runtime_error("Cannot read source pixels: " + reason);
+      }
+      done += static_cast<size_t>(result);
+    }
+  }
+  *rowStride = lineWidth;
+  return scratch.data();
+}
+
+const uint8_t *JxlYuvPixelReader::region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                         uint32_t *rowStride, pooled_uint8_vector &scratch) {
+  uint32_t lineWidth = width * 4 * sizeof(uint8_t);
+  scratch.resize(static_cast<size_t>(lineWidth) * height);
+  YuvToRgba8(planes, x, y, width, height, scratch.data(), lineWidth, matrix, range);
+  *rowStride = lineWidth;
+  return scratch.data();
+}
+
+JxlChunkedFrameSource::JxlChunkedFrameSource(JxlPixelReader &reader, JxlSourceLayout layout,
+                                             bool premultiplied, JxlColorPixelType colorspace)
+    : reader(reader), layout(layout), premultiplied(premultiplied), colorspace(colorspace) {}
+
+JxlPixelFormat JxlChunkedFrameSource::colorFormat() const {
+  uint32_t channels = colorspace == mono ? 1 : (colorspace == rgb ? 3 : 4);
+  return {channels, dataFormat() == BINARY_16 ? JXL_TYPE_FLOAT16 : JXL_TYPE_UINT8,
+          JXL_NATIVE_ENDIAN, 0};
+}
+
+JxlChunkedFrameInputSource JxlChunkedFrameSource::inputSource() {
+  return {
+      .opaque = this,
+      .get_color_channels_pixel_format = colorChannelsFormatCallback,
+      .get_color_channel_data_at = colorChannelsDataCallback,
+      .get_extra_channel_pixel_format = extraChannelFormatCallback,
+      .get_extra_channel_data_at = extraChannelDataCallback,
+      .release_buffer = releaseCallback,
+  };
+}
+
+void JxlChunkedFrameSource::convertToRgba(Region &region, size_t x, size_t y,
+                                          size_t width, size_t height, uint32_t *rgbaStride) {
+  uint32_t srcStride = 0;
+  auto w = static_cast<uint32_t>(width);
+  auto h = static_cast<uint32_t>(height);
+  const uint8_t *src = reader.region(static_cast<uint32_t>(x), static_cast<uint32_t>(y), w, h,
+                                     &srcStride, region.scratch);
+  bool wide = dataFormat() == BINARY_16;
+  uint32_t dstStride = w * 4 * (wide ? sizeof(uint16_t) : sizeof(uint8_t));
+  region.rgba.resize(static_cast<size_t>(dstStride) * h);
+  switch (layout) {
+    case SOURCE_RGBA_8888:
+      if (premultiplied) {
+        UnassociateRgba8(src, srcStride, region.rgba.data(), dstStride, w, h);
+      } else {
+        CopyUnaligned(src, srcStride, region.rgba.data(), dstStride, w * 4, h);
+      }
+      break;
+    case SOURCE_RGB_565:
+      Rgb565ToUnsigned8(reinterpret_cast<const uint16_t *>(src), srcStride,
+                        region.rgba.data(), dstStride, w, h, 255);
+      break;
+    case SOURCE_RGBA_1010102:
+      RGBA1010102ToF16(src, srcStride,
+                       reinterpret_cast<uint16_t *>(region.rgba.data()), dstStride, w, h);
+      break;
+    case SOURCE_RGBA_F16:
+      CopyUnaligned(reinterpret_cast<const uint16_t *>(src), srcStride,
+                    reinterpret_cast<uint16_t *>(region.rgba.data()), dstStride, w * 4, h);
+      break;
+  }
+  *rgbaStride = dstStride;
+}
+
+void JxlChunkedFrameSource::rethrowIfFailed() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+const void *JxlChunkedFrameSource::failedRegion(std::exception_ptr error, size_t width,
+                                                size_t height, uint32_t channels,
+                                                size_t *rowOffset) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (!failure) {
+    failure = error;
+  }
+  uint32_t sampleSize = dataFormat() == BINARY_16 ? sizeof(uint16_t) : sizeof(uint8_t);
+  auto dstStride = static_cast<uint32_t>(width) * channels * sampleSize;
+  Region &region = regions.emplace_back();
+  region.output.assign(static_cast<size_t>(dstStride) * height, 0);
+  *rowOffset = dstStride;
+  return region.output.data();
+}
+
+const void *JxlChunkedFrameSource::colorChannelsAt(size_t x, size_t y, size_t width, size_t height,
+                                                   size_t *rowOffset) {
+  concurrency::throwIfCurrentOperationCancelled();
+  // Readers are safe to call concurrently, so conversion runs without the lock
+  // and chunks requested by the parallel runner are prepared in parallel
+  Region region;
+  uint32_t rgbaStride = 0;
+  convertToRgba(region, x, y, width, height, &rgbaStride);
+  region.scratch.clear();
+  auto w = static_cast<uint32_t>(width);
+  auto h = static_cast<uint32_t>(height);
+  bool wide = dataFormat() == BINARY_16;
+  uint32_t sampleSize = wide ? sizeof(uint16_t) : sizeof(uint8_t);
+  switch (colorspace) {
+    case rgba: {
+      region.output = std::move(region.rgba);
+      *rowOffset = rgbaStride;
+      break;
+    }
+    case rgb: {
+      uint32_t dstStride = w * 3 * sampleSize;
+      region.output.resize(static_cast<size_t>(dstStride) * h);
+      if (wide) {
+        Rgba16ToRgb16(reinterpret_cast<const uint16_t *>(region.rgba.data()), rgbaStride,
+                      reinterpret_cast<uint16_t *>(region.output.data()), dstStride, w, h);
+      } else {
+        Rgba8ToRgb8(region.rgba.data(), rgbaStride, region.output.data(), dstStride, w, h);
+      }
+      region.rgba.clear();
+      *rowOffset = dstStride;
+      break;
+    }
+    case mono: {
+      uint32_t dstStride = w * sampleSize;
+      region.output.resize(static_cast<size_t>(dstStride) * h);
+      if (wide) {
+        RGBAPickChannel(reinterpret_cast<const uint16_t *>(region.rgba.data()), rgbaStride,
+                        reinterpret_cast<uint16_t *>(region.output.data()), dstStride, w, h, 0);
+      } else {
+        RGBAPickChannel(region.rgba.data(), rgbaStride, region.output.data(), dstStride, w, h, 0);
+      }
+      region.rgba.clear();
+      *rowOffset = dstStride;
+      break;
+    }
+  }
+  return keepRegion(std::move(region));
+}
+
+const void *JxlChunkedFrameSource::extraChannelAt([[maybe_unused]] size_t index, size_t x, size_t y,
+                                                  size_t width, size_t height, size_t *rowOffset) {
+  // Alpha is the only extra channel, it's used only when libjxl doesn't take it interleaved
+  concurrency::throwIfCurrentOperationCancelled();
+  Region region;
+  uint32_t rgbaStride = 0;
+  convertToRgba(region, x, y, width, height, &rgbaStride);
+  auto w = static_cast<uint32_t>(width);
+  auto h = static_cast<uint32_t>(height);
+  bool wide = dataFormat() == BINARY_16;
+  uint32_t dstStride = w * (wide ? sizeof(uint16_t) : sizeof(uint8_t));
+  region.output.resize(static_cast<size_t>(dstStride) * h);
+  if (wide) {
+    RGBAPickChannel(reinterpret_cast<const uint16_t *>(region.rgba.data()), rgbaStride,
+                    reinterpret_cast<uint16_t *>(region.output.data()), dstStride, w, h, 3);
+  } else {
+    RGBAPickChannel(region.rgba.data(), rgbaStride, region.output.data(), dstStride, w, h, 3);
+  }
+  region.scratch.clear();
+  region.rgba.clear();
+  *rowOffset = dstStride;
+  return keepRegion(std::move(region));
+}
+
+const void *JxlChunkedFrameSource::keepRegion(Region &&region) {
+  std::lock_guard<std::mutex> guard(lock);
+  return regions.emplace_back(std::move(region)).output.data();
+}
+
+void JxlChunkedFrameSource::release(const void *buffer) {
+  std::lock_guard<std::mutex> guard(lock);
+  for (auto it = regions.begin(); it != regions.end(); ++it) {
+    if (it->output.data() == buffer) {
+      regions.erase(it);
+      return;
+    }
+  }
+}
+
+void JxlChunkedFrameSource::colorChannelsFormatCallback(void *opaque, JxlPixelFormat *pixelFormat) {
+  *pixelFormat = reinterpret_cast<JxlChunkedFrameSource *>(opaque)->colorFormat();
+}
+
+const void *JxlChunkedFrameSource::colorChannelsDataCallback(void *opaque, size_t x, size_t y,
+                                                             size_t width, size_t height,
+                                                             size_t *rowOffset) {
+  auto source = reinterpret_cast<JxlChunkedFrameSource *>(opaque);
+  try {
+    return source->colorChannelsAt(x, y, width, height, rowOffset);
+  } catch (...) {
+    return source->failedRegion(std::current_exception(), width, height,
+                                source->colorFormat().num_channels, rowOffset);
+  }
+}
+
+void JxlChunkedFrameSource::extraChannelFormatCallback(void *opaque, [[maybe_unused]] size_t index,
+                                                       JxlPixelFormat *pixelFormat) {
+  auto source = reinterpret_cast<JxlChunkedFrameSource *>(opaque);
+  *pixelFormat = {1, source->dataFormat() == BINARY_16 ? JXL_TYPE_FLOAT16 : JXL_TYPE_UINT8,
+                  JXL_NATIVE_ENDIAN, 0};
+}
+
+const void *JxlChunkedFrameSource::extraChannelDataCallback(void *opaque, size_t index,
+                                                            size_t x, size_t y, size_t width,
+                                                            size_t height, size_t *rowOffset) {
+  auto source = reinterpret_cast<JxlChunkedFrameSource *>(opaque);
+  try {
+    return source->extraChannelAt(index, x, y, width, height, rowOffset);
+  } catch (...) {
+    return source->failedRegion(std::current_exception(), width, height, 1, rowOffset);
+  }
+}
+
+void JxlChunkedFrameSource::releaseCallback(void *opaque, const void *buffer) {
+  reinterpret_cast<JxlChunkedFrameSource *>(opaque)->release(buffer);
+}
+
+}
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <list>
+#include <mutex>
+#include "encode.h"
+#include "definitions.h"
+#include "JxlDefinitions.h"
+#include "imagebit/YuvToRgba.h"
+
+namespace coder {
+
+/**
+ * Memory layout of source pixels, values are shared with java side
+ */
+enum JxlSourceLayout {
+  SOURCE_RGBA_8888 = 1,
+  SOURCE_RGBA_F16 = 2,
+  SOURCE_RGBA_1010102 = 3,
+  SOURCE_RGB_565 = 4,
+};
+
+uint32_t JxlSourcePixelSize(JxlSourceLayout layout);
+
+/**
+ * Provides rectangles of source pixels in their original layout
+ */
+class JxlPixelReader {
+ public:
+  virtual ~JxlPixelReader() = default;
+
+  /**
+   * @param scratch storage that may be used to hold the rows, it stays alive until the region is released
+   * @return pointer to the first pixel of the rectangle, rows are separated by *stride bytes
+   */
+  virtual const uint8_t *region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                uint32_t *stride, pooled_uint8_vector &scratch) = 0;
+};
+
+/**
+ * Pixels already in memory, e.g. a locked bitmap or a direct buffer
+ */
+class JxlMemoryPixelReader : public JxlPixelReader {
+ public:
+  JxlMemoryPixelReader(const uint8_t *data, uint32_t stride, JxlSourceLayout layout)
+      : data(data), stride(stride), pixelSize(JxlSourcePixelSize(layout)) {}
+
+  const uint8_t *region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                        uint32_t *rowStride, pooled_uint8_vector &scratch) override;
+
+ private:
+  const uint8_t *data;
+  const uint32_t stride;
+  const uint32_t pixelSize;
+};
+
+/**
+ * Pixels stored in a file, rows are read on demand
+ */
+class JxlFdPixelReader : public JxlPixelReader {
+ public:
+  JxlFdPixelReader(int fd, int64_t offset, uint32_t stride, JxlSourceLayout layout)
+      : fd(fd), offset(offset), stride(stride), pixelSize(JxlSourcePixelSize(layout)) {}
+
+  const uint8_t *region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                        uint32_t *rowStride, pooled_uint8_vector &scratch) override;
+
+ private:
+  const int fd;
+  const int64_t offset;
+  const uint32_t stride;
+  const uint32_t pixelSize;
+};
+
+/**
+ * Camera 4:2:0 planes, every requested rectangle is converted into opaque RGBA 8888 on its own,
+ * so a full resolution RGBA frame never exists
+ */
+class JxlYuvPixelReader : public JxlPixelReader {
+ public:
+  JxlYuvPixelReader(const YuvPlanes &planes, YuvMatrix matrix, YuvRange range)
+      : planes(planes), matrix(matrix), range(range) {}
+
+  const uint8_t *region(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                        uint32_t *rowStride, pooled_uint8_vector &scratch) override;
+
+ private:
+  const YuvPlanes planes;
+  const YuvMatrix matrix;
+  const YuvRange range;
+};
+
+/**
+ * Feeds libjxl through JxlEncoderAddChunkedFrame, every requested rectangle is converted
+ * into the encoder format only when asked for, so the whole frame never exists in the encoder layout.
+ */
+class JxlChunkedFrameSource {
+ public:
+  JxlChunkedFrameSource(JxlPixelReader &reader, JxlSourceLayout layout, bool premultiplied,
+                        JxlColorPixelType colorspace);
+
+  JxlChunkedFrameInputSource inputSource();
+
+  [[nodiscard]] JxlEncodingPixelDataFormat dataFormat() const {
+    return layout == SOURCE_RGBA_F16 || layout == SOURCE_RGBA_1010102 ? BINARY_16 : UNSIGNED_8;
+  }
+
+  /**
+   * Format of interleaved color channels, alpha is included for rgba
+   */
+  [[nodiscard]] JxlPixelFormat colorFormat() const;
+
+  /**
+   * Exceptions can't unwind through libjxl, a failure inside a callback is kept
+   * and must be rethrown once libjxl has returned
+   */
+  void rethrowIfFailed();
+
+ private:
+  // Buffers of one requested rectangle, output is the one handed to libjxl
+  struct Region {
+    pooled_uint8_vector scratch;
+    pooled_uint8_vector rgba;
+    pooled_uint8_vector output;
+  };
+
+  const void *colorChannelsAt(size_t x, size_t y, size_t width, size_t height, size_t *rowOffset);
+  const void *extraChannelAt(size_t index, size_t x, size_t y, size_t width, size_t height,
+                             size_t *rowOffset);
+  // Converts a rectangle into interleaved RGBA of the encoding sample type
+  void convertToRgba(Region &region, size_t x, size_t y, size_t width, size_t height,
+                     uint32_t *rgbaStride);
+  // Hands the converted output of a region to libjxl, it's kept until libjxl releases it
+  const void *keepRegion(Region &&region);
+  void release(const void *buffer);
+  // Placeholder handed to libjxl after a failure, the encoder result is discarded anyway
+  const void *failedRegion(std::exception_ptr error, size_t width, size_t height,
+                           uint32_t channels, size_t *rowOffset);
+
+  static void colorChannelsFormatCallback(void *opaque, JxlPixelFormat *pixelFormat);
+  static const void *colorChannelsDataCallback(void *opaque, size_t x, size_t y, size_t width,
+                                               size_t height, size_t *rowOffset);
+  static void extraChannelFormatCallback(void *opaque, size_t index, JxlPixelFormat *pixelFormat);
+  static const void *extraChannelDataCallback(void *opaque, size_t index, size_t x, size_t y,
+                                              size_t width, size_t height, size_t *rowOffset);
+  static void releaseCallback(void *opaque, const void *buffer);
+
+  JxlPixelReader &reader;
+  const JxlSourceLayout layout;
+  const bool premultiplied;
+  const JxlColorPixelType colorspace;
+  std::mutex lock;
+  // Regions handed out to libjxl and not released yet
+  std::list<Region> regions;
+  std::exception_ptr failure;
+};
+
+}
@@ -32,6 +32,8 @@
 #include "encode_cxx.h"
 #include "thread_parallel_runner.h"
 #include "thread_parallel_runner_cxx.h"
+#include "JxlMemoryManager.hpp"
+#include "JxlOutputSink.hpp"
 #include <vector>
 
 namespace coder {
@@ -43,8 +45,9 @@ class JxlConstruction {
   }
 
   bool construct() {
-    auto enc = JxlEncoderMake(nullptr);
-    auto runner = JxlThreadParallelRunnerMake(nullptr,
+    JxlMemoryTracker memoryTracker;
+    auto enc = JxlEncoderMake(memoryTracker.manager());
+    auto runner = JxlThreadParallelRunnerMake(memoryTracker.manager(),
                                               JxlThreadParallelRunnerDefaultNumWorkerThreads());
     if (JXL_ENC_SUCCESS != JxlEncoderSetParallelRunner(enc.get(),
                                                        JxlThreadParallelRunner,
@@ -52,6 +55,10 @@ class JxlConstruction {
       return false;
     }
 
+    if (JXL_ENC_SUCCESS != JxlEncoderSetOutputProcessor(enc.get(), compressed.processor())) {
+      return false;
+    }
+
     if (JXL_ENC_SUCCESS != JxlEncoderStoreJPEGMetadata(enc.get(), JXL_TRUE)) {
       return false;
     }
@@ -75,39 +82,28 @@ class JxlConstruction {
 
     if (JXL_ENC_SUCCESS !=
         JxlEncoderAddJPEGFrame(frameSettings, jpegData.data(), jpegData.size())) {
+      memoryTracker.throwIfBudgetExceeded();
       return false;
     }
 
     JxlEncoderCloseInput(enc.get());
 
-    compressed.resize(64);
-    uint8_t *next_out = compressed.data();
-    size_t avail_out = compressed.size() - (next_out - compressed.data());
-    JxlEncoderStatus process_result = JXL_ENC_NEED_MORE_OUTPUT;
-    while (process_result == JXL_ENC_NEED_MORE_OUTPUT) {
-      process_result = JxlEncoderProcessOutput(enc.get(), &next_out, &avail_out);
-      if (process_result == JXL_ENC_NEED_MORE_OUTPUT) {
-        size_t offset = next_out - compressed.data();
-        compressed.resize(compressed.size() * 2);
-        next_out = compressed.data() + offset;
-        avail_out = compressed.size() - offset;
-      }
-    }
-    compressed.resize(next_out - compressed.data());
-    if (JXL_ENC_SUCCESS != process_result) {
+    if (JXL_ENC_SUCCESS != JxlEncoderFlushInput(enc.get())) {
+      memoryTracker.throwIfBudgetExceeded();
       return false;
     }
 
+    compressed.finish();
     return true;
   }
 
-  std::vector<uint8_t> &getCompressedData() {
+  const JxlBlockOutputSink &getCompressedData() {
     return compressed;
   }
 
  private:
   const std::vector<uint8_t> jpegData;
-  std::vector<uint8_t> compressed;
+  JxlBlockOutputSink compressed;
 };
 
 } // coder
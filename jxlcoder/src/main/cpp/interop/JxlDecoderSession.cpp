@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlDecoderSession.hpp"
+#include <algorithm>
+#include "jxl/resizable_parallel_runner.h"
+#include "JxlCancellableRunner.hpp"
+
+namespace coder {
+
+JxlDecoderSession::JxlDecoderSession()
+    : decoder(JxlDecoderMake(memoryTracker.manager())),
+      runner(JxlResizableParallelRunnerMake(memoryTracker.manager())) {}
+
+bool JxlDecoderSession::decode(const JxlBlockOutputSink &stream, const JxlPixelFormat &format,
+                               size_t numThreads, pooled_uint8_vector &pixels,
+                               uint32_t *xsize, uint32_t *ysize) {
+  concurrency::throwIfCurrentOperationCancelled();
+  if (!decoder || !runner) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
+
+  JxlDecoder *dec = decoder.get();
+  JxlDecoderReset(dec);
+  coder::JxlCancellableRunner cancellableRunner = {
+      .runner = JxlResizableParallelRunner,
+      .runnerOpaque = runner.get(),
+      .token = concurrency::currentCancellationToken(),
+  };
+  if (JXL_DEC_SUCCESS != JxlDecoderSubscribeEvents(dec, JXL_DEC_BASIC_INFO | JXL_DEC_FULL_IMAGE)) {
+    return false;
+  }
+  if (JXL_DEC_SUCCESS != JxlDecoderSetParallelRunner(dec, coder::JxlCancellableParallelRunner,
+                                                     &cancellableRunner)) {
+    return false;
+  }
+
+  input.resize(stream.size());
+  stream.copyTo(input.data());
+  JxlDecoderSetInput(dec, input.data(), input.size());
+  JxlDecoderCloseInput(dec);
+
+  bool decoded = false;
+  for (;;) {
+    JxlDecoderStatus status = JxlDecoderProcessInput(dec);
+
+    // Cancelled runner jobs surface as JXL_DEC_ERROR, so the token has to be checked first
+    concurrency::throwIfCurrentOperationCancelled();
+
+    if (status == JXL_DEC_BASIC_INFO) {
+      JxlBasicInfo info;
+      if (JXL_DEC_SUCCESS != JxlDecoderGetBasicInfo(dec, &info)) {
+        break;
+      }
+      *xsize = info.xsize;
+      *ysize = info.ysize;
+      uint32_t threads = JxlResizableParallelRunnerSuggestThreads(info.xsize, info.ysize);
+      JxlResizableParallelRunnerSetThreads(runner.get(),
+                                           std::clamp<size_t>(threads, 1, std::max<size_t>(numThreads, 1)));
+    } else if (status == JXL_DEC_NEED_IMAGE_OUT_BUFFER) {
+      size_t bufferSize;
+      if (JXL_DEC_SUCCESS != JxlDecoderImageOutBufferSize(dec, &format, &bufferSize)) {
+        break;
+      }
+      pixels.resize(bufferSize);
+      if (JXL_DEC_SUCCESS != JxlDecoderSetImageOutBuffer(dec, &format, pixels.data(), pixels.size())) {
+        break;
+      }
+    } else if (status == JXL_DEC_FULL_IMAGE) {
+      // Only the first frame is needed
+      decoded = true;
+      break;
+    } else {
+      // Refused allocations surface as a decoding error
+      if (status == JXL_DEC_ERROR) {
+        memoryTracker.throwIfBudgetExceeded();
+      }
+      break;
+    }
+  }
+
+  JxlDecoderReleaseInput(dec);
+  JxlDecoderReset(dec);
+  return decoded;
+}
+
+bool JxlDecoderSessionPool::decode(const JxlBlockOutputSink &stream, const JxlPixelFormat &format,
+                                   size_t numThreads, pooled_uint8_vector &pixels,
+                                   uint32_t *xsize, uint32_t *ysize) {
+  std::unique_ptr<JxlDecoderSession> session;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!idle.empty()) {
+      session = std::move(idle.back());
+      idle.pop_back();
+    }
+  }
+  if (!session) {
+    session = std::make_unique<JxlDecoderSession>();
+  }
+  bool decoded = session->decode(stream, format, numThreads, pixels, xsize, ysize);
+  std::lock_guard<std::mutex> guard(mutex);
+  idle.push_back(std::move(session));
+  return decoded;
+}
+
+}
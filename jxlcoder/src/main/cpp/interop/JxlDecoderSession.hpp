@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "definitions.h"
+#include "jxl/decode.h"
+#include "jxl/decode_cxx.h"
+#include "jxl/resizable_parallel_runner_cxx.h"
+#include "JxlMemoryManager.hpp"
+#include "JxlOutputSink.hpp"
+
+namespace coder {
+
+/**
+ * Decoder kept between decodes of many small streams, e.g. candidates of an encoder search,
+ * the decoder and the runner are reset instead of being created for every stream.
+ */
+class JxlDecoderSession {
+ public:
+  JxlDecoderSession();
+
+  JxlDecoderSession(const JxlDecoderSession &) = delete;
+  JxlDecoderSession &operator=(const JxlDecoderSession &) = delete;
+
+  /**
+   * Decodes the first frame of the stream into interleaved pixels of the format
+   * @return false when the stream can't be decoded
+   */
+  bool decode(const JxlBlockOutputSink &stream, const JxlPixelFormat &format, size_t numThreads,
+              pooled_uint8_vector &pixels, uint32_t *xsize, uint32_t *ysize);
+
+ private:
+  // Must outlive the decoder and the runner
+  JxlMemoryTracker memoryTracker;
+  JxlDecoderPtr decoder;
+  JxlResizableParallelRunnerPtr runner;
+  // Blocks of the stream are joined here, the decoder wants contiguous input
+  std::vector<uint8_t> input;
+};
+
+/**
+ * Sessions shared by the concurrent decodes of one operation,
+ * every decode borrows an idle session or makes a new one.
+ */
+class JxlDecoderSessionPool {
+ public:
+  bool decode(const JxlBlockOutputSink &stream, const JxlPixelFormat &format, size_t numThreads,
+              pooled_uint8_vector &pixels, uint32_t *xsize, uint32_t *ysize);
+
+ private:
+  std::mutex mutex;
+  std::vector<std::unique_ptr<JxlDecoderSession>> idle;
+};
+
+}
@@ -32,9 +32,12 @@
 #include "jxl/resizable_parallel_runner.h"
 #include "jxl/resizable_parallel_runner_cxx.h"
 #include "conversion/HalfFloats.h"
+#include "JxlCancellableRunner.hpp"
+#include "JxlMemoryManager.hpp"
+#include "JxlResourceGovernor.hpp"
 
 bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
-                         std::vector<uint8_t> *pixels, size_t *xsize,
+                         pooled_uint8_vector *pixels, size_t *xsize,
                          size_t *ysize, std::vector<uint8_t> *iccProfile,
                          bool *useFloats, uint32_t *bitDepth,
                          bool *alphaPremultiplied, bool allowedFloats,
@@ -42,10 +45,24 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
                          bool *preferEncoding,
                          JxlColorEncoding *colorEncoding,
                          bool *hasAlphaInOrigin,
-                         float* intensityTarget) {
-  auto runner = JxlResizableParallelRunnerMake(nullptr);
+                         float* intensityTarget,
+                         uint32_t maxThreads) {
+  concurrency::throwIfCurrentOperationCancelled();
 
-  auto dec = JxlDecoderMake(nullptr);
+  auto governor = coder::JxlResourceGovernor::current();
+  coder::JxlMemoryTracker memoryTracker;
+  auto runner = JxlResizableParallelRunnerMake(memoryTracker.manager());
+  coder::JxlCancellableRunner cancellableRunner = {
+      .runner = JxlResizableParallelRunner,
+      .runnerOpaque = runner.get(),
+      .token = concurrency::currentCancellationToken(),
+  };
+
+  auto dec = JxlDecoderMake(memoryTracker.manager());
+  if (!dec) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
   if (JXL_DEC_SUCCESS !=
       JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_BASIC_INFO |
           JXL_DEC_COLOR_ENCODING |
@@ -54,8 +71,8 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
   }
 
   if (JXL_DEC_SUCCESS != JxlDecoderSetParallelRunner(dec.get(),
-                                                     JxlResizableParallelRunner,
-                                                     runner.get())) {
+                                                     coder::JxlCancellableParallelRunner,
+                                                     &cancellableRunner)) {
     return false;
   }
 
@@ -74,7 +91,12 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
   for (;;) {
     JxlDecoderStatus status = JxlDecoderProcessInput(dec.get());
 
+    // Cancelled runner jobs surface as JXL_DEC_ERROR, so the token has to be checked first
+    concurrency::throwIfCurrentOperationCancelled();
+
     if (status == JXL_DEC_ERROR) {
+      // Refused allocations surface as a decoding error as well
+      memoryTracker.throwIfBudgetExceeded();
       return false;
     } else if (status == JXL_DEC_NEED_MORE_INPUT) {
       return false;
@@ -85,6 +107,10 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
       *xsize = info.xsize;
       *ysize = info.ysize;
 
+      if (governor != nullptr) {
+        governor->checkImageSize(info.xsize, info.ysize);
+      }
+
       *alphaPremultiplied = info.alpha_premultiplied;
       *bitDepth = (int) info.bits_per_sample;
       *jxlOrientation = info.orientation;
@@ -109,9 +135,11 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
       }
 
       *hasAlphaInOrigin = info.num_extra_channels > 0 && info.alpha_bits > 0;
-      JxlResizableParallelRunnerSetThreads(
-          runner.get(),
-          JxlResizableParallelRunnerSuggestThreads(info.xsize, info.ysize));
+      uint32_t threads = JxlResizableParallelRunnerSuggestThreads(info.xsize, info.ysize);
+      if (maxThreads > 0) {
+        threads = std::min(threads, maxThreads);
+      }
+      JxlResizableParallelRunnerSetThreads(runner.get(), threads);
     } else if (status == JXL_DEC_COLOR_ENCODING) {
       // Get the ICC color profile of the pixel data
       size_t iccSize;
@@ -153,7 +181,14 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
       if (bufferSize != stride * (*ysize)) {
         return false;
       }
-      pixels->resize(stride * (*ysize));
+      // Each frame of an animation asks for the output buffer again
+      if (governor != nullptr) {
+        governor->onFrame(stride * (*ysize));
+      }
+      if (pixels->size() != stride * (*ysize)) {
+        memoryTracker.reserve(stride * (*ysize));
+        pixels->resize(stride * (*ysize));
+      }
       void *pixelsBuffer = (void *) pixels->data();
       size_t pixelsBufferSize = pixels->size();
       if (JXL_DEC_SUCCESS != JxlDecoderSetImageOutBuffer(dec.get(), &format,
@@ -177,10 +212,11 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
 
 bool DecodeBasicInfo(const uint8_t *jxl, size_t size, size_t *xsize,
                      size_t *ysize) {
+  coder::JxlMemoryTracker memoryTracker;
   // Multi-threaded parallel runner.
-  auto runner = JxlResizableParallelRunnerMake(nullptr);
+  auto runner = JxlResizableParallelRunnerMake(memoryTracker.manager());
 
-  auto dec = JxlDecoderMake(nullptr);
+  auto dec = JxlDecoderMake(memoryTracker.manager());
   if (JXL_DEC_SUCCESS !=
       JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_BASIC_INFO |
           JXL_DEC_COLOR_ENCODING |
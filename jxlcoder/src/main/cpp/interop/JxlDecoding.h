@@ -29,6 +29,7 @@
 #pragma once
 
 #include <vector>
+#include "definitions.h"
 #include "codestream_header.h"
 #include "color_encoding.h"
 #include <string>
@@ -52,7 +53,7 @@ class InvalidImageSizeException : public std::exception {
 };
 
 bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
-                         std::vector<uint8_t> *pixels, size_t *xsize,
+                         pooled_uint8_vector *pixels, size_t *xsize,
                          size_t *ysize, std::vector<uint8_t> *iccProfile,
                          bool *useFloats, uint32_t *bitDepth,
                          bool *alphaPremultiplied, bool allowedFloats,
@@ -60,6 +61,7 @@ bool DecodeJpegXlOneShot(const uint8_t *jxl, size_t size,
                          bool *preferEncoding,
                          JxlColorEncoding *colorEncoding,
                          bool *hasAlphaInOrigin,
-                         float* intensityTarget);
+                         float* intensityTarget,
+                         uint32_t maxThreads = 0);
 
 bool DecodeBasicInfo(const uint8_t *jxl, size_t size, size_t *xsize, size_t *ysize);
@@ -46,6 +46,9 @@ enum JxlColorPixelType {
   mono = 3
 };
 
+// Channels configuration picked by the content analysis, resolved into JxlColorPixelType before encoding
+static constexpr int JXL_CHANNELS_AUTO = 4;
+
 enum JxlCompressionOption {
   loseless = 1,
   lossy = 2
@@ -53,7 +56,11 @@ enum JxlCompressionOption {
 
 enum JxlEncodingPixelDataFormat {
   UNSIGNED_8 = 1,
-  BINARY_16 = 2
+  // IEEE half floats, values outside of [0, 1] are passed to libjxl as they are
+  BINARY_16 = 2,
+  UNSIGNED_16 = 3,
+  // IEEE single precision floats, passed to libjxl as they are
+  BINARY_32 = 4
 };
 
 #endif //JXLCODER_JXLDEFINITIONS_H
@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlDistanceSearch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "cancellation.hpp"
+#include "thread_pool.hpp"
+
+namespace coder {
+
+// Candidates encoded at once in each round, every one of them gets a share of the cores
+static constexpr uint32_t distanceSearchCandidates = 3;
+static constexpr uint32_t distanceSearchMaxRounds = 6;
+// The search stops once the bracket is narrower than this ratio
+static constexpr float distanceSearchPrecision = 1.03f;
+
+namespace {
+
+struct DistanceCandidate {
+  float distance = 0;
+  std::shared_ptr<concurrency::CancellationToken> token;
+  std::unique_ptr<JxlBlockOutputSink> output;
+  JxlDistanceProbe probe = {false, false};
+  bool finished = false;
+  bool failed = false;
+  std::exception_ptr error;
+};
+
+/**
+ * Encodes and evaluates all the distances concurrently,
+ * a finished candidate cancels the running ones that can't do better than it.
+ */
+std::vector<DistanceCandidate> RunDistanceCandidates(const std::vector<float> &distances,
+                                                     const JxlDistanceEncoder &encoder,
+                                                     const JxlDistanceEvaluator &evaluator,
+                                                     bool metAtGreaterDistance) {
+  auto &pool = concurrency::sharedThreadPool();
+  // Waiting on the pool from one of its workers would deadlock, so candidates run inline there
+  const bool runInline = pool.isWorkerThread() || distances.size() == 1;
+  const size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  const size_t threadsPerCandidate = runInline ? hardwareThreads
+                                               : std::max<size_t>(hardwareThreads / distances.size(), 1);
+
+  std::shared_ptr<concurrency::CancellationToken> parentToken = concurrency::currentCancellationTokenRef();
+  std::vector<DistanceCandidate> candidates(distances.size());
+  for (size_t i = 0; i < distances.size(); ++i) {
+    candidates[i].distance = distances[i];
+    candidates[i].token = std::make_shared<concurrency::CancellationToken>(parentToken);
+  }
+
+  std::mutex mutex;
+  auto cancelOthers = [&candidates](const DistanceCandidate &except) {
+    for (auto &other : candidates) {
+      if (&other != &except) {
+        other.token->cancel();
+      }
+    }
+  };
+
+  auto runCandidate = [&](size_t index) {
+    DistanceCandidate &candidate = candidates[index];
+    concurrency::CancellationScope cancellationScope(candidate.token);
+    try {
+      candidate.token->throwIfCancelled();
+      auto output = std::make_unique<JxlBlockOutputSink>();
+      if (!encoder(candidate.distance, *output, threadsPerCandidate)) {
+        std::lock_guard<std::mutex> guard(mutex);
+        candidate.failed = true;
+        cancelOthers(candidate);
+        return;
+      }
+      JxlDistanceProbe probe = evaluator(candidate.distance, *output, threadsPerCandidate);
+
+      std::lock_guard<std::mutex> guard(mutex);
+      candidate.probe = probe;
+      candidate.output = std::move(output);
+      candidate.finished = true;
+      for (auto &other : candidates) {
+        if (&other == &candidate || other.finished) {
+          continue;
+        }
+        bool isBeyond = metAtGreaterDistance ? other.distance > candidate.distance
+                                             : other.distance < candidate.distance;
+        // Beyond a met candidate everything is further from the threshold,
+        // on the other side of a missed one everything misses as well
+        if ((probe.meetsTarget && probe.closeEnough) || probe.meetsTarget == isBeyond) {
+          other.token->cancel();
+        }
+      }
+    } catch (concurrency::OperationCancelledException &) {
+      // Either a loser or the whole search is cancelled, the latter is rethrown by the caller
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(mutex);
+      candidate.error = std::current_exception();
+      cancelOthers(candidate);
+    }
+  };
+
+  if (runInline) {
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      runCandidate(i);
+    }
+  } else {
+    std::vector<std::future<void>> pending;
+    pending.reserve(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      pending.push_back(pool.enqueue([&runCandidate, i]() { runCandidate(i); }));
+    }
+    for (auto &future : pending) {
+      future.wait();
+    }
+  }
+
+  concurrency::throwIfCurrentOperationCancelled();
+  for (auto &candidate : candidates) {
+    if (candidate.error) {
+      std::rethrow_exception(candidate.error);
+    }
+    if (candidate.failed) {
+      throw std::runtime_error("Encoding a candidate of the distance search has failed");
+    }
+  }
+  return candidates;
+}
+
+}
+
+JxlDistanceSearchResult SearchJxlDistance(const JxlDistanceEncoder &encoder,
+                                          const JxlDistanceEvaluator &evaluator,
+                                          bool metAtGreaterDistance) {
+  // Whether the first distance is nearer to the threshold than the second one
+  auto isNearer = [metAtGreaterDistance](float distance, float other) {
+    return metAtGreaterDistance ? distance < other : distance > other;
+  };
+
+  JxlDistanceSearchResult result;
+  // Nearest distances to the threshold known to meet and to miss the target, zero while unknown
+  float metBound = 0;
+  float missedBound = 0;
+  bool accepted = false;
+
+  auto collect = [&](std::vector<DistanceCandidate> &candidates) {
+    for (auto &candidate : candidates) {
+      if (!candidate.finished) {
+        continue;
+      }
+      result.encodedCandidates += 1;
+      if (candidate.probe.meetsTarget) {
+        if (metBound == 0 || isNearer(candidate.distance, metBound)) {
+          metBound = candidate.distance;
+        }
+        if (!result.output || isNearer(candidate.distance, result.distance)) {
+          result.distance = candidate.distance;
+          result.output = std::move(candidate.output);
+        }
+        accepted |= candidate.probe.closeEnough;
+      } else if (missedBound == 0 || isNearer(missedBound, candidate.distance)) {
+        missedBound = candidate.distance;
+      }
+    }
+  };
+
+  for (uint32_t round = 0; round < distanceSearchMaxRounds && !accepted; ++round) {
+    float metEnd = metBound != 0 ? metBound
+                                 : (metAtGreaterDistance ? jxlMaxSearchDistance : jxlMinSearchDistance);
+    float missedEnd = missedBound != 0 ? missedBound
+                                       : (metAtGreaterDistance ? jxlMinSearchDistance : jxlMaxSearchDistance);
+    float low = std::min(metEnd, missedEnd);
+    float high = std::max(metEnd, missedEnd);
+    if (high / low < distanceSearchPrecision) {
+      break;
+    }
+
+    // Candidates split the bracket evenly in log space, where the size changes about uniformly
+    std::vector<float> distances(distanceSearchCandidates);
+    for (uint32_t i = 0; i < distanceSearchCandidates; ++i) {
+      float t = static_cast<float>(i + 1) / static_cast<float>(distanceSearchCandidates + 1);
+      distances[i] = low * std::pow(high / low, t);
+    }
+    auto candidates = RunDistanceCandidates(distances, encoder, evaluator, metAtGreaterDistance);
+    collect(candidates);
+  }
+
+  // Ends of the range aren't probed by the rounds, the one where the target is easiest to meet is the last resort
+  if (!result.output) {
+    std::vector<float> distances = {metAtGreaterDistance ? jxlMaxSearchDistance : jxlMinSearchDistance};
+    auto candidates = RunDistanceCandidates(distances, encoder, evaluator, metAtGreaterDistance);
+    collect(candidates);
+  }
+
+  return result;
+}
+
+}
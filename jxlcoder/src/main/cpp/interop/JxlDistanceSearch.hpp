@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "JxlOutputSink.hpp"
+
+namespace coder {
+
+/**
+ * How a candidate encoded at some distance relates to the search target
+ */
+struct JxlDistanceProbe {
+  bool meetsTarget;
+  // Meets the target closely enough to stop searching
+  bool closeEnough;
+};
+
+struct JxlDistanceSearchResult {
+  float distance = 0;
+  // nullptr when no distance in the range meets the target
+  std::unique_ptr<JxlBlockOutputSink> output;
+  uint32_t encodedCandidates = 0;
+};
+
+// Encodes a candidate into the sink using numThreads workers, false when libjxl has failed
+using JxlDistanceEncoder = std::function<bool(float distance, JxlBlockOutputSink &sink,
+                                              size_t numThreads)>;
+// Runs on the thread of the candidate with the same share of workers
+using JxlDistanceEvaluator = std::function<JxlDistanceProbe(float distance,
+                                                            const JxlBlockOutputSink &sink,
+                                                            size_t numThreads)>;
+
+static constexpr float jxlMinSearchDistance = 0.05f;
+static constexpr float jxlMaxSearchDistance = 25.0f;
+
+/**
+ * Bracketed search of the butteraugli distance for a target that holds on one side of a threshold,
+ * e.g. a byte budget holds for every distance above some value and a quality floor below it.
+ *
+ * Each round encodes several distances of the current bracket concurrently on the shared pool,
+ * every finished candidate cancels the running ones it has proven useless
+ * and the bracket is narrowed in log space around the threshold.
+ *
+ * @param metAtGreaterDistance true when the target holds above the threshold
+ * @return candidate nearest to the threshold that meets the target
+ * @throws std::runtime_error when libjxl fails to encode a candidate
+ */
+JxlDistanceSearchResult SearchJxlDistance(const JxlDistanceEncoder &encoder,
+                                          const JxlDistanceEvaluator &evaluator,
+                                          bool metAtGreaterDistance);
+
+}
@@ -31,6 +31,8 @@
 #include "encode_cxx.h"
 #include "thread_parallel_runner.h"
 #include "thread_parallel_runner_cxx.h"
+#include "JxlCancellableRunner.hpp"
+#include "JxlMemoryManager.hpp"
 #include <vector>
 
 using namespace std;
@@ -45,59 +47,63 @@ static inline float JXLGetDistance(int quality) {
                15.0f);
 }
 
-bool EncodeJxlOneshot(const std::vector<uint8_t> &pixels, const uint32_t xsize,
-                      const uint32_t ysize, std::vector<uint8_t> *compressed,
-                      JxlColorPixelType colorspace, JxlCompressionOption compression_option,
-                      JxlEncodingPixelDataFormat encodingDataFormat,
-                      std::vector<uint8_t> &iccProfile, int effort, int quality,
-                      int decodingSpeed, JxlColorEncoding &colorEncoding) {
-  auto enc = JxlEncoderMake(nullptr);
-  auto runner = JxlThreadParallelRunnerMake(nullptr,
-                                            JxlThreadParallelRunnerDefaultNumWorkerThreads());
-  if (JXL_ENC_SUCCESS != JxlEncoderSetParallelRunner(enc.get(),
-                                                     JxlThreadParallelRunner,
-                                                     runner.get())) {
-    return false;
+static inline uint32_t JxlDataFormatBits(JxlEncodingPixelDataFormat format) {
+  switch (format) {
+    case BINARY_16:
+    case UNSIGNED_16:return 16;
+    case BINARY_32:return 32;
+    default:return 8;
   }
+}
 
-  JxlPixelFormat pixelFormat = {1, encodingDataFormat == BINARY_16 ? JXL_TYPE_UINT16 : JXL_TYPE_UINT8, JXL_NATIVE_ENDIAN, 0};
-  uint32_t channelsCount = 1;
-  uint32_t baseChannelsCount = 1;
-  switch (colorspace) {
-    case mono: {
-      channelsCount = 1;
-      baseChannelsCount = 1;
-    }
-      break;
-    case rgb: {
-      channelsCount = 3;
-      baseChannelsCount = 3;
-    }
-      break;
-    case rgba: {
-      channelsCount = 4;
-      baseChannelsCount = 3;
-    }
-      break;
+static inline uint32_t JxlDataFormatExponentBits(JxlEncodingPixelDataFormat format) {
+  switch (format) {
+    case BINARY_16:return 5;
+    case BINARY_32:return 8;
+    default:return 0;
   }
-  pixelFormat.num_channels = channelsCount;
+}
+
+static inline JxlDataType JxlDataFormatType(JxlEncodingPixelDataFormat format) {
+  switch (format) {
+    case BINARY_16:return JXL_TYPE_FLOAT16;
+    case UNSIGNED_16:return JXL_TYPE_UINT16;
+    case BINARY_32:return JXL_TYPE_FLOAT;
+    default:return JXL_TYPE_UINT8;
+  }
+}
+
+/**
+ * Applies image info, color and frame settings shared by all encoding paths
+ * @return frame settings or nullptr when libjxl rejects any of the options
+ */
+static JxlEncoderFrameSettings *
+ConfigureJxlEncoder(JxlEncoder *enc, const uint32_t xsize, const uint32_t ysize,
+                    JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                    JxlEncodingPixelDataFormat encodingDataFormat,
+                    std::vector<uint8_t> &iccProfile, int effort, float distance,
+                    int decodingSpeed, JxlColorEncoding &colorEncoding,
+                    JxlEncodingProfile profile) {
+  uint32_t baseChannelsCount = colorspace == mono ? 1 : 3;
 
   JxlBasicInfo basicInfo;
   JxlEncoderInitBasicInfo(&basicInfo);
   basicInfo.xsize = xsize;
   basicInfo.ysize = ysize;
-  basicInfo.bits_per_sample = encodingDataFormat == BINARY_16 ? 16 : 8;
+  basicInfo.bits_per_sample = JxlDataFormatBits(encodingDataFormat);
+  basicInfo.exponent_bits_per_sample = JxlDataFormatExponentBits(encodingDataFormat);
   basicInfo.uses_original_profile = compression_option == lossy ? JXL_FALSE : JXL_TRUE;
   basicInfo.num_color_channels = baseChannelsCount;
   basicInfo.alpha_premultiplied = false;
 
   if (colorspace == rgba) {
     basicInfo.num_extra_channels = 1;
-    basicInfo.alpha_bits = encodingDataFormat == BINARY_16 ? 16 : 8;
+    basicInfo.alpha_bits = JxlDataFormatBits(encodingDataFormat);
+    basicInfo.alpha_exponent_bits = JxlDataFormatExponentBits(encodingDataFormat);
   }
 
-  if (JXL_ENC_SUCCESS != JxlEncoderSetBasicInfo(enc.get(), &basicInfo)) {
-    return false;
+  if (JXL_ENC_SUCCESS != JxlEncoderSetBasicInfo(enc, &basicInfo)) {
+    return nullptr;
   }
 
   switch (colorspace) {
@@ -113,10 +119,11 @@ bool EncodeJxlOneshot(const std::vector<uint8_t> &pixels, const uint32_t xsize,
       basicInfo.num_color_channels = 4;
       JxlExtraChannelInfo channelInfo;
       JxlEncoderInitExtraChannelInfo(JXL_CHANNEL_ALPHA, &channelInfo);
-      channelInfo.bits_per_sample = encodingDataFormat == BINARY_16 ? 16 : 8;
+      channelInfo.bits_per_sample = JxlDataFormatBits(encodingDataFormat);
+      channelInfo.exponent_bits_per_sample = JxlDataFormatExponentBits(encodingDataFormat);
       channelInfo.alpha_premultiplied = false;
-      if (JXL_ENC_SUCCESS != JxlEncoderSetExtraChannelInfo(enc.get(), 0, &channelInfo)) {
-        return false;
+      if (JXL_ENC_SUCCESS != JxlEncoderSetExtraChannelInfo(enc, 0, &channelInfo)) {
+        return nullptr;
       }
     }
       break;
@@ -124,70 +131,212 @@ bool EncodeJxlOneshot(const std::vector<uint8_t> &pixels, const uint32_t xsize,
 
   if (!iccProfile.empty()) {
     if (JXL_ENC_SUCCESS !=
-        JxlEncoderSetICCProfile(enc.get(), iccProfile.data(), iccProfile.size())) {
-      return false;
+        JxlEncoderSetICCProfile(enc, iccProfile.data(), iccProfile.size())) {
+      return nullptr;
     }
   } else {
     JxlColorEncoding encoding;
     memcpy(&encoding, &colorEncoding, sizeof(JxlColorEncoding));
     if (JXL_ENC_SUCCESS !=
-        JxlEncoderSetColorEncoding(enc.get(), &colorEncoding)) {
-      return false;
+        JxlEncoderSetColorEncoding(enc, &colorEncoding)) {
+      return nullptr;
     }
   }
 
   JxlEncoderFrameSettings *frameSettings =
-      JxlEncoderFrameSettingsCreate(enc.get(), nullptr);
-
-  float distance = JXLGetDistance(quality);
+      JxlEncoderFrameSettingsCreate(enc, nullptr);
 
   if (compression_option == lossy &&
       JXL_ENC_SUCCESS != JxlEncoderSetFrameDistance(frameSettings, distance)) {
-    return false;
+    return nullptr;
   }
 
   if (JxlEncoderFrameSettingsSetOption(frameSettings,
                                        JXL_ENC_FRAME_SETTING_EFFORT, effort) != JXL_ENC_SUCCESS) {
-    return false;
+    return nullptr;
   }
 
   if (compression_option == loseless &&
       JXL_ENC_SUCCESS != JxlEncoderSetFrameLossless(frameSettings, JXL_TRUE)) {
-    return false;
+    return nullptr;
   }
 
   if (JXL_ENC_SUCCESS !=
       JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_DECODING_SPEED,
                                        decodingSpeed)) {
+    return nullptr;
+  }
+
+  if (!ApplyJxlEncodingProfile(frameSettings, profile)) {
+    return nullptr;
+  }
+
+  return frameSettings;
+}
+
+/**
+ * @param stride bytes between rows, 0 for tightly packed rows
+ */
+static bool EncodeJxlPixels(const uint8_t *pixels, size_t size, uint32_t stride,
+                            const uint32_t xsize, const uint32_t ysize, coder::JxlOutputSink &sink,
+                            JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                            JxlEncodingPixelDataFormat encodingDataFormat,
+                            std::vector<uint8_t> &iccProfile, int effort, float distance,
+                            int decodingSpeed, JxlColorEncoding &colorEncoding,
+                            JxlEncodingProfile profile, size_t numThreads) {
+  concurrency::throwIfCurrentOperationCancelled();
+
+  coder::JxlMemoryTracker memoryTracker;
+  memoryTracker.reserve(size);
+  auto enc = JxlEncoderMake(memoryTracker.manager());
+  auto runner = JxlThreadParallelRunnerMake(memoryTracker.manager(), numThreads);
+  if (!enc || !runner) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
+  coder::JxlCancellableRunner cancellableRunner = {
+      .runner = JxlThreadParallelRunner,
+      .runnerOpaque = runner.get(),
+      .token = concurrency::currentCancellationToken(),
+  };
+  if (JXL_ENC_SUCCESS != JxlEncoderSetParallelRunner(enc.get(),
+                                                     coder::JxlCancellableParallelRunner,
+                                                     &cancellableRunner)) {
+    return false;
+  }
+
+  JxlEncoderFrameSettings *frameSettings =
+      ConfigureJxlEncoder(enc.get(), xsize, ysize, colorspace, compression_option,
+                          encodingDataFormat, iccProfile, effort, distance, decodingSpeed,
+                          colorEncoding, profile);
+  if (frameSettings == nullptr) {
+    return false;
+  }
+
+  if (JXL_ENC_SUCCESS != JxlEncoderSetOutputProcessor(enc.get(), sink.processor())) {
     return false;
   }
 
+  // Rows are rounded up to the alignment, so any stride not less than a row is taken without a copy
+  JxlPixelFormat pixelFormat = {colorspace == mono ? 1u : (colorspace == rgb ? 3u : 4u),
+                                JxlDataFormatType(encodingDataFormat),
+                                JXL_NATIVE_ENDIAN, stride};
+
   if (JXL_ENC_SUCCESS !=
-      JxlEncoderAddImageFrame(frameSettings, &pixelFormat,
-                              (void *) pixels.data(),
-                              sizeof(uint8_t) * pixels.size())) {
+      JxlEncoderAddImageFrame(frameSettings, &pixelFormat, pixels, size)) {
+    sink.throwIfFailed();
+    concurrency::throwIfCurrentOperationCancelled();
+    memoryTracker.throwIfBudgetExceeded();
     return false;
   }
 
   JxlEncoderCloseInput(enc.get());
 
-  compressed->resize(64);
-  uint8_t *next_out = compressed->data();
-  size_t avail_out = compressed->size() - (next_out - compressed->data());
-  JxlEncoderStatus process_result = JXL_ENC_NEED_MORE_OUTPUT;
-  while (process_result == JXL_ENC_NEED_MORE_OUTPUT) {
-    process_result = JxlEncoderProcessOutput(enc.get(), &next_out, &avail_out);
-    if (process_result == JXL_ENC_NEED_MORE_OUTPUT) {
-      size_t offset = next_out - compressed->data();
-      compressed->resize(compressed->size() * 2);
-      next_out = compressed->data() + offset;
-      avail_out = compressed->size() - offset;
-    }
+  JxlEncoderStatus status = JxlEncoderFlushInput(enc.get());
+  sink.throwIfFailed();
+  concurrency::throwIfCurrentOperationCancelled();
+  if (JXL_ENC_SUCCESS != status) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
+
+  sink.finish();
+  return true;
+}
+
+bool EncodeJxlOneshot(const pooled_uint8_vector &pixels, const uint32_t xsize,
+                      const uint32_t ysize, coder::JxlOutputSink &sink,
+                      JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                      JxlEncodingPixelDataFormat encodingDataFormat,
+                      std::vector<uint8_t> &iccProfile, int effort, int quality,
+                      int decodingSpeed, JxlColorEncoding &colorEncoding,
+                      JxlEncodingProfile profile, size_t numThreads) {
+  return EncodeJxlPixels(pixels.data(), pixels.size(), 0, xsize, ysize, sink, colorspace,
+                         compression_option, encodingDataFormat, iccProfile, effort,
+                         JXLGetDistance(quality), decodingSpeed, colorEncoding, profile, numThreads);
+}
+
+bool EncodeJxlRaw(const uint8_t *pixels, size_t size, uint32_t stride,
+                  const uint32_t xsize, const uint32_t ysize, coder::JxlOutputSink &sink,
+                  JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                  JxlEncodingPixelDataFormat encodingDataFormat,
+                  std::vector<uint8_t> &iccProfile, int effort, int quality,
+                  int decodingSpeed, JxlColorEncoding &colorEncoding,
+                  JxlEncodingProfile profile, size_t numThreads) {
+  return EncodeJxlPixels(pixels, size, stride, xsize, ysize, sink, colorspace,
+                         compression_option, encodingDataFormat, iccProfile, effort,
+                         JXLGetDistance(quality), decodingSpeed, colorEncoding, profile, numThreads);
+}
+
+bool EncodeJxlAtDistance(const pooled_uint8_vector &pixels, const uint32_t xsize,
+                         const uint32_t ysize, coder::JxlOutputSink &sink,
+                         JxlColorPixelType colorspace,
+                         JxlEncodingPixelDataFormat encodingDataFormat,
+                         std::vector<uint8_t> &iccProfile, int effort, float distance,
+                         int decodingSpeed, JxlColorEncoding &colorEncoding,
+                         size_t numThreads) {
+  return EncodeJxlPixels(pixels.data(), pixels.size(), 0, xsize, ysize, sink, colorspace, lossy,
+                         encodingDataFormat, iccProfile, effort, distance,
+                         decodingSpeed, colorEncoding, PROFILE_DEFAULT, numThreads);
+}
+
+bool EncodeJxlChunked(coder::JxlChunkedFrameSource &source, coder::JxlOutputSink &sink,
+                      const uint32_t xsize, const uint32_t ysize,
+                      JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                      std::vector<uint8_t> &iccProfile, int effort, int quality,
+                      int decodingSpeed, JxlColorEncoding &colorEncoding, size_t numThreads) {
+  concurrency::throwIfCurrentOperationCancelled();
+
+  coder::JxlMemoryTracker memoryTracker;
+  auto enc = JxlEncoderMake(memoryTracker.manager());
+  auto runner = JxlThreadParallelRunnerMake(memoryTracker.manager(), numThreads);
+  if (!enc || !runner) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
+  coder::JxlCancellableRunner cancellableRunner = {
+      .runner = JxlThreadParallelRunner,
+      .runnerOpaque = runner.get(),
+      .token = concurrency::currentCancellationToken(),
+  };
+  if (JXL_ENC_SUCCESS != JxlEncoderSetParallelRunner(enc.get(),
+                                                     coder::JxlCancellableParallelRunner,
+                                                     &cancellableRunner)) {
+    return false;
+  }
+
+  JxlEncoderFrameSettings *frameSettings =
+      ConfigureJxlEncoder(enc.get(), xsize, ysize, colorspace, compression_option,
+                          source.dataFormat(), iccProfile, effort, JXLGetDistance(quality),
+                          decodingSpeed,
+                          colorEncoding, PROFILE_DEFAULT);
+  if (frameSettings == nullptr) {
+    return false;
+  }
+
+  // Streams input and output for every image larger than a single group
+  if (JXL_ENC_SUCCESS !=
+      JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_BUFFERING, 2)) {
+    return false;
+  }
+
+  if (JXL_ENC_SUCCESS != JxlEncoderSetOutputProcessor(enc.get(), sink.processor())) {
+    return false;
+  }
+
+  JxlEncoderStatus status = JxlEncoderAddChunkedFrame(frameSettings, JXL_TRUE,
+                                                      source.inputSource());
+  if (JXL_ENC_SUCCESS == status) {
+    status = JxlEncoderFlushInput(enc.get());
   }
-  compressed->resize(next_out - compressed->data());
-  if (JXL_ENC_SUCCESS != process_result) {
+  source.rethrowIfFailed();
+  sink.throwIfFailed();
+  concurrency::throwIfCurrentOperationCancelled();
+  if (JXL_ENC_SUCCESS != status) {
+    memoryTracker.throwIfBudgetExceeded();
     return false;
   }
 
+  sink.finish();
   return true;
 }
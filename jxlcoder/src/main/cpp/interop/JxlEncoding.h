@@ -29,8 +29,12 @@
 #pragma once
 
 #include <vector>
+#include "definitions.h"
 #include "JxlDefinitions.h"
+#include "JxlEncodingProfile.hpp"
 #include "encode.h"
+#include "JxlChunkedSource.hpp"
+#include "JxlOutputSink.hpp"
 
 /**
  * Compresses the provided pixels.
@@ -38,12 +42,56 @@
  * @param pixels input pixels
  * @param xsize width of the input image
  * @param ysize height of the input image
- * @param compressed will be populated with the compressed bytes
+ * @param sink receives the compressed stream as libjxl produces it
+ * @param profile layout of the stream on top of effort and distance
+ * @param numThreads workers of the libjxl runner
  */
-bool EncodeJxlOneshot(const std::vector<uint8_t> &pixels, const uint32_t xsize,
-                      const uint32_t ysize, std::vector<uint8_t> *compressed,
+bool EncodeJxlOneshot(const pooled_uint8_vector &pixels, const uint32_t xsize,
+                      const uint32_t ysize, coder::JxlOutputSink &sink,
                       JxlColorPixelType colorspace, JxlCompressionOption compression_option,
                       JxlEncodingPixelDataFormat encodingPixelDataFormat,
                       std::vector<uint8_t> &iccProfile,
                       int effort, int quality, int decodingSpeed,
-                      JxlColorEncoding &colorEncoding);
+                      JxlColorEncoding &colorEncoding, JxlEncodingProfile profile,
+                      size_t numThreads);
+
+/**
+ * Compresses pixels that are already in a layout libjxl accepts, rows aren't repacked.
+ *
+ * @param size bytes available at pixels, at least (ysize - 1) * stride + one row
+ * @param stride bytes between starts of consecutive rows, 0 when rows are tightly packed
+ * @param encodingPixelDataFormat sample type of the pixels and of the stored image
+ */
+bool EncodeJxlRaw(const uint8_t *pixels, size_t size, uint32_t stride,
+                  const uint32_t xsize, const uint32_t ysize, coder::JxlOutputSink &sink,
+                  JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                  JxlEncodingPixelDataFormat encodingPixelDataFormat,
+                  std::vector<uint8_t> &iccProfile,
+                  int effort, int quality, int decodingSpeed,
+                  JxlColorEncoding &colorEncoding, JxlEncodingProfile profile,
+                  size_t numThreads);
+
+/**
+ * Lossy compression at the butteraugli distance given as is instead of mapping it from quality.
+ *
+ * @param distance in 0...25, greater is smaller and worse
+ * @param numThreads workers of the libjxl runner, lowered when several images are encoded at once
+ */
+bool EncodeJxlAtDistance(const pooled_uint8_vector &pixels, const uint32_t xsize,
+                         const uint32_t ysize, coder::JxlOutputSink &sink,
+                         JxlColorPixelType colorspace,
+                         JxlEncodingPixelDataFormat encodingPixelDataFormat,
+                         std::vector<uint8_t> &iccProfile,
+                         int effort, float distance, int decodingSpeed,
+                         JxlColorEncoding &colorEncoding, size_t numThreads);
+
+/**
+ * Compresses a frame pulled in rectangles from the source while the output is streamed into the sink,
+ * only a few groups of the image are held in memory at once.
+ * Always uses the default profile, progressive frames would make libjxl buffer the whole image.
+ */
+bool EncodeJxlChunked(coder::JxlChunkedFrameSource &source, coder::JxlOutputSink &sink,
+                      uint32_t xsize, uint32_t ysize,
+                      JxlColorPixelType colorspace, JxlCompressionOption compression_option,
+                      std::vector<uint8_t> &iccProfile, int effort, int quality,
+                      int decodingSpeed, JxlColorEncoding &colorEncoding, size_t numThreads);
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include "encode.h"
+
+enum JxlEncodingProfile {
+  PROFILE_DEFAULT = 0,
+  // Lays the stream out for incremental rendering: coarse DC first, AC in quality passes, centre groups first
+  PROFILE_PROGRESSIVE = 1,
+};
+
+/**
+ * Frame options of the profile, same as cjxl --progressive:
+ * progressive DC and quantized AC passes for lossy frames, squeeze for the modular ones.
+ * @return false when libjxl rejects any of the options
+ */
+static inline bool ApplyJxlEncodingProfile(JxlEncoderFrameSettings *frameSettings,
+                                           JxlEncodingProfile profile) {
+  if (profile != PROFILE_PROGRESSIVE) {
+    return true;
+  }
+  return JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_PROGRESSIVE_DC, 1)
+      == JXL_ENC_SUCCESS
+      && JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_QPROGRESSIVE_AC, 1)
+          == JXL_ENC_SUCCESS
+      && JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_RESPONSIVE, 1)
+          == JXL_ENC_SUCCESS
+      // Groups are sent in a spiral from the centre, where the subject usually is
+      && JxlEncoderFrameSettingsSetOption(frameSettings, JXL_ENC_FRAME_SETTING_GROUP_ORDER, 1)
+          == JXL_ENC_SUCCESS;
+}
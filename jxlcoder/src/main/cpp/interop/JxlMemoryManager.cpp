@@ -0,0 +1,224 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlMemoryManager.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+namespace coder {
+
+namespace {
+
+std::atomic<size_t> budgetBytes(0);
+std::atomic<uint64_t> totalCurrentBytes(0);
+std::atomic<uint64_t> lastPeakBytes(0);
+std::atomic<uint64_t> maxPeakBytes(0);
+
+// Block header keeps the size, so libjxl free callback which has no size can account it back
+constexpr size_t blockHeaderSize = 16;
+constexpr size_t minArenaClassShift = 6;
+constexpr size_t maxArenaClassShift = 20;
+constexpr size_t arenaClassesCount = maxArenaClassShift - minArenaClassShift + 1;
+// Upper bound of blocks cached by a single thread between operations
+constexpr size_t maxArenaCachedBytes = 8 * 1024 * 1024;
+
+size_t arenaClassIndex(size_t bytes) {
+  size_t index = 0;
+  while ((static_cast<size_t>(1) << (index + minArenaClassShift)) < bytes) {
+    index += 1;
+  }
+  return index;
+}
+
+/**
+ * Blocks freed on this thread, reused by the next allocations of the same class.
+ * libjxl workers allocate and free plenty of small group buffers,
+ * this keeps them out of the global allocator lock.
+ */
+class JxlThreadArena {
+ public:
+  ~JxlThreadArena() {
+    for (auto &blocks : freeBlocks) {
+      for (void *block : blocks) {
+        free(block);
+      }
+    }
+  }
+
+  void *take(size_t classIndex) {
+    auto &blocks = freeBlocks[classIndex];
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    void *block = blocks.back();
+    blocks.pop_back();
+    cachedBytes -= classBytes(classIndex);
+    return block;
+  }
+
+  bool give(size_t classIndex, void *block) {
+    size_t bytes = classBytes(classIndex);
+    if (cachedBytes + bytes > maxArenaCachedBytes) {
+      return false;
+    }
+    freeBlocks[classIndex].push_back(block);
+    cachedBytes += bytes;
+    return true;
+  }
+
+  static size_t classBytes(size_t classIndex) {
+    return static_cast<size_t>(1) << (classIndex + minArenaClassShift);
+  }
+
+ private:
+  std::array<std::vector<void *>, arenaClassesCount> freeBlocks;
+  size_t cachedBytes = 0;
+};
+
+JxlThreadArena &threadArena() {
+  static thread_local JxlThreadArena arena;
+  return arena;
+}
+
+void updateMax(std::atomic<uint64_t> &target, uint64_t value) {
+  uint64_t previous = target.load(std::memory_order_relaxed);
+  while (previous < value && !target.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+  }
+}
+
+}
+
+void setJxlMemoryBudget(size_t bytes) {
+  budgetBytes.store(bytes, std::memory_order_relaxed);
+}
+
+size_t jxlMemoryBudget() {
+  return budgetBytes.load(std::memory_order_relaxed);
+}
+
+JxlMemoryStats jxlMemoryStats() {
+  return {
+      .currentBytes = totalCurrentBytes.load(std::memory_order_relaxed),
+      .lastPeakBytes = lastPeakBytes.load(std::memory_order_relaxed),
+      .maxPeakBytes = maxPeakBytes.load(std::memory_order_relaxed),
+      .budgetBytes = budgetBytes.load(std::memory_order_relaxed),
+  };
+}
+
+JxlMemoryTracker::JxlMemoryTracker(size_t budgetBytes)
+    : budget(budgetBytes), current(0), peak(0), refusedBytes(0) {
+  memoryManager = {
+      .opaque = this,
+      .alloc = JxlMemoryTracker::allocate,
+      .free = JxlMemoryTracker::release,
+  };
+}
+
+JxlMemoryTracker::~JxlMemoryTracker() {
+  unaccount(reserved);
+  uint64_t operationPeak = peak.load(std::memory_order_relaxed);
+  lastPeakBytes.store(operationPeak, std::memory_order_relaxed);
+  updateMax(maxPeakBytes, operationPeak);
+}
+
+bool JxlMemoryTracker::tryAccount(size_t bytes) {
+  size_t updated = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (budget != 0 && updated > budget) {
+    current.fetch_sub(bytes, std::memory_order_relaxed);
+    size_t expected = 0;
+    refusedBytes.compare_exchange_strong(expected, updated, std::memory_order_relaxed);
+    return false;
+  }
+  size_t previous = peak.load(std::memory_order_relaxed);
+  while (previous < updated && !peak.compare_exchange_weak(previous, updated, std::memory_order_relaxed)) {
+  }
+  totalCurrentBytes.fetch_add(bytes, std::memory_order_relaxed);
+  return true;
+}
+
+void JxlMemoryTracker::unaccount(size_t bytes) {
+  current.fetch_sub(bytes, std::memory_order_relaxed);
+  totalCurrentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void JxlMemoryTracker::reserve(size_t bytes) {
+  if (!tryAccount(bytes)) {
+    throw JxlMemoryBudgetExceededException(refusedBytes.load(std::memory_order_relaxed), budget);
+  }
+  reserved += bytes;
+}
+
+void JxlMemoryTracker::throwIfBudgetExceeded() const {
+  size_t refused = refusedBytes.load(std::memory_order_relaxed);
+  if (refused != 0) {
+    throw JxlMemoryBudgetExceededException(refused, budget);
+  }
+}
+
+void *JxlMemoryTracker::allocate(void *opaque, size_t size) {
+  auto tracker = reinterpret_cast<JxlMemoryTracker *>(opaque);
+  size_t blockBytes = size + blockHeaderSize;
+  bool useArena = blockBytes <= JxlThreadArena::classBytes(arenaClassesCount - 1);
+  size_t classIndex = 0;
+  if (useArena) {
+    classIndex = arenaClassIndex(blockBytes);
+    blockBytes = JxlThreadArena::classBytes(classIndex);
+  }
+  if (!tracker->tryAccount(blockBytes)) {
+    return nullptr;
+  }
+  void *block = useArena ? threadArena().take(classIndex) : nullptr;
+  if (block == nullptr) {
+    block = malloc(blockBytes);
+  }
+  if (block == nullptr) {
+    tracker->unaccount(blockBytes);
+    return nullptr;
+  }
+  *reinterpret_cast<size_t *>(block) = blockBytes;
+  return reinterpret_cast<uint8_t *>(block) + blockHeaderSize;
+}
+
+void JxlMemoryTracker::release(void *opaque, void *address) {
+  if (address == nullptr) {
+    return;
+  }
+  auto tracker = reinterpret_cast<JxlMemoryTracker *>(opaque);
+  void *block = reinterpret_cast<uint8_t *>(address) - blockHeaderSize;
+  size_t blockBytes = *reinterpret_cast<size_t *>(block);
+  tracker->unaccount(blockBytes);
+  if (blockBytes <= JxlThreadArena::classBytes(arenaClassesCount - 1)
+      && threadArena().give(arenaClassIndex(blockBytes), block)) {
+    return;
+  }
+  free(block);
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include "jxl/memory_manager.h"
+
+namespace coder {
+
+/**
+ * Thrown when libjxl allocations of a single operation exceed the configured budget.
+ * It is a bad_alloc, so every handler that is prepared for OOM handles it as well.
+ */
+class JxlMemoryBudgetExceededException : public std::bad_alloc {
+ public:
+  JxlMemoryBudgetExceededException(size_t requestedBytes, size_t budgetBytes)
+      : errorMessage("JPEG XL memory budget exceeded: required at least "
+                         + std::to_string(requestedBytes) + " bytes, budget is "
+                         + std::to_string(budgetBytes) + " bytes") {}
+
+  [[nodiscard]] const char *what() const noexcept override {
+    return errorMessage.c_str();
+  }
+
+ private:
+  std::string errorMessage;
+};
+
+struct JxlMemoryStats {
+  // Bytes held by all running operations
+  uint64_t currentBytes;
+  // Peak of the most recently finished operation
+  uint64_t lastPeakBytes;
+  // Largest peak seen since the process start
+  uint64_t maxPeakBytes;
+  uint64_t budgetBytes;
+};
+
+// Budget applied to operations started afterwards, 0 means unlimited
+void setJxlMemoryBudget(size_t bytes);
+size_t jxlMemoryBudget();
+JxlMemoryStats jxlMemoryStats();
+
+/**
+ * Memory manager of a single decode or encode operation, must outlive every libjxl object made with it.
+ * Small blocks are served from per thread arenas that survive between operations,
+ * large ones go straight to the system. Once an allocation would exceed the budget it is refused,
+ * libjxl then fails and the caller reports it by throwIfBudgetExceeded().
+ */
+class JxlMemoryTracker {
+ public:
+  explicit JxlMemoryTracker(size_t budgetBytes = jxlMemoryBudget());
+  ~JxlMemoryTracker();
+
+  JxlMemoryTracker(const JxlMemoryTracker &) = delete;
+  JxlMemoryTracker &operator=(const JxlMemoryTracker &) = delete;
+
+  JxlMemoryManager *manager() {
+    return &memoryManager;
+  }
+
+  /**
+   * Accounts memory of the operation allocated outside of libjxl, e.g. the output image
+   * @throws JxlMemoryBudgetExceededException
+   */
+  void reserve(size_t bytes);
+
+  void throwIfBudgetExceeded() const;
+
+  [[nodiscard]] size_t currentBytes() const {
+    return current.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] size_t peakBytes() const {
+    return peak.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static void *allocate(void *opaque, size_t size);
+  static void release(void *opaque, void *address);
+
+  bool tryAccount(size_t bytes);
+  void unaccount(size_t bytes);
+
+  JxlMemoryManager memoryManager;
+  size_t budget;
+  size_t reserved = 0;
+  std::atomic<size_t> current;
+  std::atomic<size_t> peak;
+  std::atomic<size_t> refusedBytes;
+};
+
+}
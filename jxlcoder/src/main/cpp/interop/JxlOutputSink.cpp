@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlOutputSink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace coder {
+
+// Upper bound of a single chunk written into a file descriptor
+static constexpr size_t fdSinkChunkSize = 1 << 20;
+// Blocks of the block sink start small for small images and double up to the upper bound
+static constexpr size_t blockSinkFirstBlockSize = 64 * 1024;
+static constexpr size_t blockSinkMaxBlockSize = 4 << 20;
+
+JxlEncoderOutputProcessor JxlOutputSink::processor() {
+  return {
+      .opaque = this,
+      .get_buffer = getBufferCallback,
+      .release_buffer = releaseBufferCallback,
+      .seek = canSeek() ? seekCallback : nullptr,
+      .set_finalized_position = setFinalizedPositionCallback,
+  };
+}
+
+void JxlOutputSink::throwIfFailed() const {
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
+
+void JxlOutputSink::seek(uint64_t newPosition) {
+  position = newPosition;
+}
+
+void *JxlOutputSink::getBufferCallback(void *opaque, size_t *size) {
+  auto sink = reinterpret_cast<JxlOutputSink *>(opaque);
+  if (!sink->error.empty()) {
+    *size = 0;
+    return nullptr;
+  }
+  void *buffer = sink->acquire(size);
+  if (buffer == nullptr) {
+    *size = 0;
+  }
+  return buffer;
+}
+
+void JxlOutputSink::releaseBufferCallback(void *opaque, size_t writtenBytes) {
+  auto sink = reinterpret_cast<JxlOutputSink *>(opaque);
+  sink->commit(writtenBytes);
+  sink->position += writtenBytes;
+  sink->end = std::max(sink->end, sink->position);
+}
+
+void JxlOutputSink::seekCallback(void *opaque, uint64_t position) {
+  reinterpret_cast<JxlOutputSink *>(opaque)->seek(position);
+}
+
+void JxlOutputSink::setFinalizedPositionCallback(void *opaque, uint64_t finalizedPosition) {
+  reinterpret_cast<JxlOutputSink *>(opaque)->finalize(finalizedPosition);
+}
+
+void *JxlVectorOutputSink::acquire(size_t *size) {
+  size_t required = static_cast<size_t>(position) + *size;
+  try {
+    if (output.size() < required) {
+      // Grows geometrically through the vector capacity
+      output.resize(required);
+    }
+  } catch (std::bad_alloc &err) {
+    error = "Not enough memory to store encoded image";
+    return nullptr;
+  }
+  return output.data() + position;
+}
+
+void JxlVectorOutputSink::commit(size_t writtenBytes) {}
+
+void JxlVectorOutputSink::finish() {
+  output.resize(end);
+}
+
+void *JxlBlockOutputSink::acquire(size_t *size) {
+  if (position >= capacity) {
+    size_t blockSize = blocks.empty() ? blockSinkFirstBlockSize
+                                      : std::min(blocks.back().size * 2, blockSinkMaxBlockSize);
+    try {
+      // Default initialized, libjxl overwrites everything that is committed
+      blocks.push_back({std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]), blockSize});
+    } catch (std::bad_alloc &err) {
+      error = "Not enough memory to store encoded image";
+      return nullptr;
+    }
+    capacity += blockSize;
+  }
+  uint64_t blockStart = 0;
+  for (auto &block : blocks) {
+    if (position < blockStart + block.size) {
+      auto offset = static_cast<size_t>(position - blockStart);
+      *size = block.size - offset;
+      return block.data.get() + offset;
+    }
+    blockStart += block.size;
+  }
+  return nullptr;
+}
+
+void JxlBlockOutputSink::forEachBlock(const std::function<void(const uint8_t *, size_t)> &visitor) const {
+  uint64_t remaining = end;
+  for (auto &block : blocks) {
+    if (remaining == 0) {
+      break;
+    }
+    auto blockSize = static_cast<size_t>(std::min(remaining, static_cast<uint64_t>(block.size)));
+    visitor(block.data.get(), blockSize);
+    remaining -= blockSize;
+  }
+}
+
+void JxlBlockOutputSink::copyTo(uint8_t *dst) const {
+  forEachBlock([&dst](const uint8_t *data, size_t size) {
+    std::memcpy(dst, data, size);
+    dst += size;
+  });
+}
+
+void *JxlMemoryOutputSink::acquire(size_t *size) {
+  if (position >= capacity) {
+    error = "Output buffer is too small for the encoded image";
+    return nullptr;
+  }
+  *size = capacity - static_cast<size_t>(position);
+  return data + position;
+}
+
+JxlFdOutputSink::JxlFdOutputSink(int fd) : fd(fd) {
+  origin = lseek64(fd, 0, SEEK_CUR);
+  seekable = origin >= 0;
+}
+
+void JxlFdOutputSink::finish() {
+  if (seekable) {
+    lseek64(fd, origin + static_cast<int64_t>(end), SEEK_SET);
+  }
+}
+
+void *JxlFdOutputSink::acquire(size_t *size) {
+  size_t chunkSize = std::clamp(*size, static_cast<size_t>(1), fdSinkChunkSize);
+  try {
+    if (buffer.size() < chunkSize) {
+      buffer.resize(chunkSize);
+    }
+  } catch (std::bad_alloc &err) {
+    error = "Not enough memory to store encoded image";
+    return nullptr;
+  }
+  *size = chunkSize;
+  return buffer.data();
+}
+
+void JxlFdOutputSink::commit(size_t writtenBytes) {
+  size_t offset = 0;
+  while (offset < writtenBytes) {
+    ssize_t result;
+    if (seekable) {
+      result = pwrite64(fd, buffer.data() + offset, writtenBytes - offset,
+                        origin + static_cast<int64_t>(position + offset));
+    } else {
+      result = write(fd, buffer.data() + offset, writtenBytes - offset);
+    }
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      error = "Cannot write encoded image: " + std::string(strerror(errno));
+      return;
+    }
+    offset += static_cast<size_t>(result);
+  }
+}
+
+}
@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "encode.h"
+
+namespace coder {
+
+/**
+ * Destination of an encoded stream, handed to libjxl through JxlEncoderSetOutputProcessor
+ * so the output is written as it is produced instead of being grown in one buffer.
+ */
+class JxlOutputSink {
+ public:
+  virtual ~JxlOutputSink() = default;
+
+  JxlEncoderOutputProcessor processor();
+
+  // Throws std::runtime_error when the sink has failed while encoding
+  virtual void throwIfFailed() const;
+
+  // Completes the stream once the encoder has finished
+  virtual void finish() {}
+
+  [[nodiscard]] uint64_t size() const {
+    return end;
+  }
+
+ protected:
+  // Returns a buffer at the current position, nullptr stops the encoder
+  virtual void *acquire(size_t *size) = 0;
+  virtual void commit(size_t writtenBytes) = 0;
+  virtual bool canSeek() const = 0;
+  virtual void seek(uint64_t newPosition);
+  virtual void finalize([[maybe_unused]] uint64_t finalizedPosition) {}
+
+  uint64_t position = 0;
+  // Furthest position ever written, the size of the stream
+  uint64_t end = 0;
+  std::string error;
+
+ private:
+  static void *getBufferCallback(void *opaque, size_t *size);
+  static void releaseBufferCallback(void *opaque, size_t writtenBytes);
+  static void seekCallback(void *opaque, uint64_t position);
+  static void setFinalizedPositionCallback(void *opaque, uint64_t finalizedPosition);
+};
+
+/**
+ * Collects the stream into a vector
+ */
+class JxlVectorOutputSink : public JxlOutputSink {
+ public:
+  explicit JxlVectorOutputSink(std::vector<uint8_t> &output) : output(output) {}
+
+  // Trims the vector to the written size
+  void finish() override;
+
+ protected:
+  void *acquire(size_t *size) override;
+  void commit(size_t writtenBytes) override;
+  bool canSeek() const override {
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> &output;
+};
+
+/**
+ * Keeps the stream in a list of blocks that are never moved once allocated,
+ * so the output grows without reallocating and copying what was already written.
+ */
+class JxlBlockOutputSink : public JxlOutputSink {
+ public:
+  JxlBlockOutputSink() = default;
+
+  // Visits the written stream block by block in order
+  void forEachBlock(const std::function<void(const uint8_t *data, size_t size)> &visitor) const;
+
+  // Copies the written stream into dst, it must hold at least size() bytes
+  void copyTo(uint8_t *dst) const;
+
+ protected:
+  void *acquire(size_t *size) override;
+  void commit([[maybe_unused]] size_t writtenBytes) override {}
+  bool canSeek() const override {
+    return true;
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+  };
+  std::vector<Block> blocks;
+  uint64_t capacity = 0;
+};
+
+/**
+ * Writes the stream into caller owned memory of a fixed capacity, e.g. a direct ByteBuffer.
+ * The encoder is stopped with an error when the stream doesn't fit.
+ */
+class JxlMemoryOutputSink : public JxlOutputSink {
+ public:
+  JxlMemoryOutputSink(uint8_t *data, size_t capacity) : data(data), capacity(capacity) {}
+
+ protected:
+  void *acquire(size_t *size) override;
+  void commit([[maybe_unused]] size_t writtenBytes) override {}
+  bool canSeek() const override {
+    return true;
+  }
+
+ private:
+  uint8_t *const data;
+  const size_t capacity;
+};
+
+/**
+ * Writes the stream into a file descriptor starting at its current offset.
+ * Seeking is offered to libjxl only when the descriptor supports it, e.g. pipes and sockets are written sequentially.
+ */
+class JxlFdOutputSink : public JxlOutputSink {
+ public:
+  explicit JxlFdOutputSink(int fd);
+
+  // Moves the descriptor offset past the written stream
+  void finish() override;
+
+ protected:
+  void *acquire(size_t *size) override;
+  void commit(size_t writtenBytes) override;
+  bool canSeek() const override {
+    return seekable;
+  }
+
+ private:
+  const int fd;
+  bool seekable;
+  int64_t origin;
+  std::vector<uint8_t> buffer;
+};
+
+}
@@ -0,0 +1,191 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlProgression.hpp"
+#include <algorithm>
+#include "definitions.h"
+#include "jxl/decode.h"
+#include "jxl/decode_cxx.h"
+#include "jxl/resizable_parallel_runner.h"
+#include "jxl/resizable_parallel_runner_cxx.h"
+#include "JxlCancellableRunner.hpp"
+#include "JxlMemoryManager.hpp"
+#include "imagebit/ImageMetrics.h"
+
+namespace coder {
+
+// Prefix grows by this fraction of the stream, but never by less than minProgressionStep
+static constexpr size_t progressionStepsPerStream = 256;
+static constexpr size_t minProgressionStep = 256;
+
+namespace {
+
+const JxlPixelFormat progressionFormat = {4, JXL_TYPE_UINT8, JXL_NATIVE_ENDIAN, 0};
+
+MetricImageView ViewOf(const pooled_uint8_vector &pixels, uint32_t width, uint32_t height) {
+  return {
+      .data = pixels.data(),
+      .stride = width * 4,
+      .width = width,
+      .height = height,
+      .channels = 4,
+      .isF16 = false,
+  };
+}
+
+/**
+ * Decodes the stream either at once, or in growing prefixes calling onProgression at every step
+ */
+template<class OnProgression>
+bool DecodeFirstFrame(const uint8_t *data, size_t size, bool incremental,
+                      pooled_uint8_vector &pixels, JxlBasicInfo &info,
+                      OnProgression &&onProgression) {
+  JxlMemoryTracker memoryTracker;
+  auto decoder = JxlDecoderMake(memoryTracker.manager());
+  auto runner = JxlResizableParallelRunnerMake(memoryTracker.manager());
+  if (!decoder || !runner) {
+    memoryTracker.throwIfBudgetExceeded();
+    return false;
+  }
+  JxlDecoder *dec = decoder.get();
+  coder::JxlCancellableRunner cancellableRunner = {
+      .runner = JxlResizableParallelRunner,
+      .runnerOpaque = runner.get(),
+      .token = concurrency::currentCancellationToken(),
+  };
+  int events = JXL_DEC_BASIC_INFO | JXL_DEC_FULL_IMAGE;
+  if (incremental) {
+    events |= JXL_DEC_FRAME_PROGRESSION;
+  }
+  if (JXL_DEC_SUCCESS != JxlDecoderSubscribeEvents(dec, events)
+      || JXL_DEC_SUCCESS != JxlDecoderSetParallelRunner(dec, coder::JxlCancellableParallelRunner,
+                                                        &cancellableRunner)) {
+    return false;
+  }
+  if (incremental && JXL_DEC_SUCCESS != JxlDecoderSetProgressiveDetail(dec, kPasses)) {
+    return false;
+  }
+
+  const size_t step = incremental ? std::max(size / progressionStepsPerStream, minProgressionStep)
+                                  : size;
+  size_t available = std::min(step, size);
+  JxlDecoderSetInput(dec, data, available);
+  if (available == size) {
+    JxlDecoderCloseInput(dec);
+  }
+
+  for (;;) {
+    JxlDecoderStatus status = JxlDecoderProcessInput(dec);
+    concurrency::throwIfCurrentOperationCancelled();
+
+    if (status == JXL_DEC_NEED_MORE_INPUT) {
+      if (available == size) {
+        return false;
+      }
+      const size_t consumed = available - JxlDecoderReleaseInput(dec);
+      available = std::min(available + step, size);
+      JxlDecoderSetInput(dec, data + consumed, available - consumed);
+      if (available == size) {
+        JxlDecoderCloseInput(dec);
+      }
+    } else if (status == JXL_DEC_BASIC_INFO) {
+      if (JXL_DEC_SUCCESS != JxlDecoderGetBasicInfo(dec, &info)) {
+        return false;
+      }
+      JxlResizableParallelRunnerSetThreads(
+          runner.get(), JxlResizableParallelRunnerSuggestThreads(info.xsize, info.ysize));
+    } else if (status == JXL_DEC_NEED_IMAGE_OUT_BUFFER) {
+      size_t bufferSize;
+      if (JXL_DEC_SUCCESS != JxlDecoderImageOutBufferSize(dec, &progressionFormat, &bufferSize)) {
+        return false;
+      }
+      pixels.resize(bufferSize);
+      if (JXL_DEC_SUCCESS != JxlDecoderSetImageOutBuffer(dec, &progressionFormat, pixels.data(),
+                                                         pixels.size())) {
+        return false;
+      }
+    } else if (status == JXL_DEC_FRAME_PROGRESSION) {
+      // Steps that can't be rendered yet are skipped
+      if (JXL_DEC_SUCCESS == JxlDecoderFlushImage(dec)) {
+        onProgression(available, JxlDecoderGetIntendedDownsamplingRatio(dec));
+      }
+    } else if (status == JXL_DEC_FULL_IMAGE) {
+      // Only the first frame is measured
+      return true;
+    } else {
+      if (status == JXL_DEC_ERROR) {
+        memoryTracker.throwIfBudgetExceeded();
+      }
+      return false;
+    }
+  }
+}
+
+}
+
+bool MeasureJxlProgression(const uint8_t *data, size_t size, float qualityScore,
+                           JxlProgressionReport &report) {
+  report = {};
+  JxlBasicInfo info = {};
+  pooled_uint8_vector complete;
+  if (!DecodeFirstFrame(data, size, false, complete, info, [](size_t, size_t) {})) {
+    return false;
+  }
+  const bool hasAlpha = info.alpha_bits > 0;
+  const MetricImageView reference = ViewOf(complete, info.xsize, info.ysize);
+
+  pooled_uint8_vector partial;
+  JxlProgressionReport measured;
+  measured.totalBytes = size;
+  auto onProgression = [&](size_t available, size_t downsamplingRatio) {
+    measured.progressionSteps += 1;
+    if (measured.firstRenderBytes == 0) {
+      measured.firstRenderBytes = available;
+    }
+    if (measured.dcBytes == 0 && downsamplingRatio <= 8) {
+      measured.dcBytes = available;
+    }
+    if (measured.qualityBytes == 0
+        && Ssimulacra2(reference, ViewOf(partial, info.xsize, info.ysize), hasAlpha) >= qualityScore) {
+      measured.qualityBytes = available;
+    }
+  };
+  if (!DecodeFirstFrame(data, size, true, partial, info, onProgression)) {
+    return false;
+  }
+  // Whatever wasn't reached by a partial render needs the whole stream
+  for (uint64_t *bytes: {&measured.firstRenderBytes, &measured.dcBytes, &measured.qualityBytes}) {
+    if (*bytes == 0) {
+      *bytes = size;
+    }
+  }
+  report = measured;
+  return true;
+}
+
+}
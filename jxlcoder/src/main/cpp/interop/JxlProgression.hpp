@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coder {
+
+/**
+ * Prefix lengths of a stream needed for renders of increasing quality,
+ * every length is 0 when the stream can't be decoded.
+ */
+struct JxlProgressionReport {
+  uint64_t totalBytes = 0;
+  // First render of any resolution
+  uint64_t firstRenderBytes = 0;
+  // First render at 1:8 or finer, the DC of lossy frames
+  uint64_t dcBytes = 0;
+  // First render scoring at least the requested SSIMULACRA2 against the complete image
+  uint64_t qualityBytes = 0;
+  uint32_t progressionSteps = 0;
+};
+
+/**
+ * Feeds the stream to a progressive decoder in small increments and renders the first frame at every
+ * progression step libjxl reports, lengths are accurate to about 1/256 of the stream.
+ * A stream not laid out for progression still renders its DC before the rest of the frame.
+ * @return false when the stream can't be decoded
+ */
+bool MeasureJxlProgression(const uint8_t *data, size_t size, float qualityScore,
+                           JxlProgressionReport &report);
+
+}
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlRawPixels.hpp"
+
+namespace coder {
+
+uint32_t JxlRawChannelsCount(JxlRawChannels channels) {
+  switch (channels) {
+    case RAW_GRAY:return 1;
+    case RAW_RGB:return 3;
+    default:return 4;
+  }
+}
+
+static JxlEncodingPixelDataFormat JxlRawDataFormat(RgbaSampleType sampleType) {
+  switch (sampleType) {
+    case SAMPLE_U16:return UNSIGNED_16;
+    case SAMPLE_F16:return BINARY_16;
+    case SAMPLE_F32:return BINARY_32;
+    default:return UNSIGNED_8;
+  }
+}
+
+static JxlDataType JxlRawDataType(RgbaSampleType sampleType) {
+  switch (sampleType) {
+    case SAMPLE_U16:return JXL_TYPE_UINT16;
+    case SAMPLE_F16:return JXL_TYPE_FLOAT16;
+    case SAMPLE_F32:return JXL_TYPE_FLOAT;
+    default:return JXL_TYPE_UINT8;
+  }
+}
+
+std::string ValidateJxlRawPixels(const JxlRawPixels &pixels) {
+  if (pixels.channels < RAW_GRAY || pixels.channels > RAW_ARGB) {
+    return "Unknown channels of raw pixels";
+  }
+  if (pixels.sampleType < SAMPLE_U8 || pixels.sampleType > SAMPLE_F32) {
+    return "Unknown sample type of raw pixels";
+  }
+  if (pixels.data == nullptr) {
+    return "Pixels must be provided in a direct byte buffer";
+  }
+  uint64_t rowSize = static_cast<uint64_t>(pixels.width) * JxlRawChannelsCount(pixels.channels)
+      * RgbaSampleSize(pixels.sampleType);
+  if (pixels.width == 0 || pixels.height == 0 || pixels.stride < rowSize) {
+    return "Invalid image dimensions or stride";
+  }
+  if (pixels.size < static_cast<uint64_t>(pixels.stride) * (pixels.height - 1) + rowSize) {
+    return "Pixels must be provided in a direct byte buffer large enough to hold the image";
+  }
+  return "";
+}
+
+JxlRawFrame PrepareJxlRawFrame(const JxlRawPixels &pixels, pooled_uint8_vector &storage) {
+  uint32_t channelsCount = JxlRawChannelsCount(pixels.channels);
+  JxlRawFrame frame = {
+      .data = pixels.data,
+      .size = pixels.size,
+      .stride = pixels.stride,
+      .colorspace = channelsCount == 1 ? mono : (channelsCount == 3 ? rgb : rgba),
+      .dataFormat = JxlRawDataFormat(pixels.sampleType),
+      .pixelFormat = {channelsCount, JxlRawDataType(pixels.sampleType), JXL_NATIVE_ENDIAN,
+                      pixels.stride},
+  };
+
+  if (channelsCount != 4 || (pixels.channels == RAW_RGBA && !pixels.premultiplied)) {
+    return frame;
+  }
+
+  RgbaChannelOrder order = pixels.channels == RAW_BGRA ? ORDER_BGRA
+                                                       : (pixels.channels == RAW_ARGB ? ORDER_ARGB
+                                                                                      : ORDER_RGBA);
+  uint32_t stride = pixels.width * 4 * RgbaSampleSize(pixels.sampleType);
+  storage.resize(static_cast<size_t>(stride) * pixels.height);
+  AdaptToRgba(pixels.data, pixels.stride, storage.data(), stride, pixels.width, pixels.height,
+              pixels.sampleType, order, pixels.premultiplied);
+  frame.data = storage.data();
+  frame.size = storage.size();
+  frame.stride = stride;
+  frame.pixelFormat.align = stride;
+  return frame;
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "encode.h"
+#include "definitions.h"
+#include "JxlDefinitions.h"
+#include "imagebit/RgbaAdapt.h"
+
+namespace coder {
+
+/**
+ * Channels of raw pixels in memory order, values are shared with java side
+ */
+enum JxlRawChannels {
+  RAW_GRAY = 1,
+  RAW_RGB = 2,
+  RAW_RGBA = 3,
+  RAW_BGRA = 4,
+  RAW_ARGB = 5,
+};
+
+/**
+ * Caller owned pixels described only by their format, there is no bitmap behind them
+ */
+struct JxlRawPixels {
+  const uint8_t *data;
+  // Bytes available at data
+  size_t size;
+  uint32_t width;
+  uint32_t height;
+  // Bytes between starts of consecutive rows
+  uint32_t stride;
+  JxlRawChannels channels;
+  RgbaSampleType sampleType;
+  // Colors are associated with alpha, ignored for layouts without alpha
+  bool premultiplied;
+};
+
+/**
+ * Pixels in a layout libjxl takes as is
+ */
+struct JxlRawFrame {
+  const uint8_t *data;
+  size_t size;
+  uint32_t stride;
+  JxlColorPixelType colorspace;
+  JxlEncodingPixelDataFormat dataFormat;
+  JxlPixelFormat pixelFormat;
+};
+
+uint32_t JxlRawChannelsCount(JxlRawChannels channels);
+
+/**
+ * @return empty string when the descriptor is valid, the reason otherwise
+ */
+std::string ValidateJxlRawPixels(const JxlRawPixels &pixels);
+
+/**
+ * Gray, RGB and straight alpha RGBA are handed to libjxl from the caller memory with their stride,
+ * other layouts go through the single adapter pass into the storage.
+ * The returned frame points either to the caller pixels or to the storage.
+ */
+JxlRawFrame PrepareJxlRawFrame(const JxlRawPixels &pixels, pooled_uint8_vector &storage);
+
+}
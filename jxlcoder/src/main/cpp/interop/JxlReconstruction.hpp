@@ -33,6 +33,7 @@
 #include "jxl/decode_cxx.h"
 #include "jxl/resizable_parallel_runner.h"
 #include "jxl/resizable_parallel_runner_cxx.h"
+#include "JxlMemoryManager.hpp"
 
 namespace coder {
 class JxlReconstruction {
@@ -42,9 +43,10 @@ class JxlReconstruction {
   }
 
   bool reconstruct() {
-    auto runner = JxlResizableParallelRunnerMake(nullptr);
+    JxlMemoryTracker memoryTracker;
+    auto runner = JxlResizableParallelRunnerMake(memoryTracker.manager());
 
-    auto dec = JxlDecoderMake(nullptr);
+    auto dec = JxlDecoderMake(memoryTracker.manager());
     if (JXL_DEC_SUCCESS !=
         JxlDecoderSubscribeEvents(dec.get(), JXL_DEC_JPEG_RECONSTRUCTION | JXL_DEC_FULL_IMAGE)) {
       return false;
@@ -55,6 +57,7 @@ class JxlReconstruction {
     JxlDecoderStatus status = JxlDecoderProcessInput(dec.get());
 
     if (status == JXL_DEC_ERROR) {
+      memoryTracker.throwIfBudgetExceeded();
       return false;
     }
 
@@ -79,6 +82,7 @@ class JxlReconstruction {
     }
 
     if (decProcessResult != JXL_DEC_FULL_IMAGE) {
+      memoryTracker.throwIfBudgetExceeded();
       return false;
     }
 
@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlResourceGovernor.hpp"
+#include <mutex>
+#include <algorithm>
+
+namespace coder {
+
+namespace {
+
+std::mutex limitsLock;
+JxlResourceLimits globalLimits;
+
+JxlResourceGovernor *&currentGovernorRef() {
+  static thread_local JxlResourceGovernor *governor = nullptr;
+  return governor;
+}
+
+}
+
+void setJxlResourceLimits(const JxlResourceLimits &limits) {
+  std::lock_guard<std::mutex> lock(limitsLock);
+  globalLimits = limits;
+}
+
+JxlResourceLimits jxlResourceLimits() {
+  std::lock_guard<std::mutex> lock(limitsLock);
+  return globalLimits;
+}
+
+JxlResourceGovernor::JxlResourceGovernor(const JxlResourceLimits &limits)
+    : limits(limits), startTime(std::chrono::steady_clock::now()), installed(true),
+      previous(currentGovernorRef()) {
+  if (limits.maxWallTimeMillis > 0) {
+    auto token = std::make_shared<concurrency::CancellationToken>(
+        concurrency::currentCancellationTokenRef());
+    token->setTimeout(limits.maxWallTimeMillis);
+    deadlineScope.emplace(token);
+  }
+  currentGovernorRef() = this;
+}
+
+JxlResourceGovernor::JxlResourceGovernor(Detached, const JxlResourceLimits &limits)
+    : limits(limits), startTime(std::chrono::steady_clock::now()), installed(false),
+      previous(nullptr) {
+}
+
+JxlResourceGovernor::~JxlResourceGovernor() {
+  if (installed) {
+    currentGovernorRef() = previous;
+  }
+}
+
+JxlResourceGovernor *JxlResourceGovernor::current() {
+  return currentGovernorRef();
+}
+
+void JxlResourceGovernor::checkImageSize(uint64_t width, uint64_t height) {
+  uint64_t pixels = width * height;
+  if (limits.maxPixels != 0 && pixels > limits.maxPixels) {
+    throw JxlResourceLimitException("Image " + std::to_string(width) + "x" + std::to_string(height)
+                                        + " exceeds the limit of " + std::to_string(limits.maxPixels)
+                                        + " pixels");
+  }
+}
+
+void JxlResourceGovernor::checkFrameCount(uint64_t count) {
+  if (limits.maxFrames != 0 && count > limits.maxFrames) {
+    throw JxlResourceLimitException("Image has " + std::to_string(count)
+                                        + " frames which exceeds the limit of "
+                                        + std::to_string(limits.maxFrames));
+  }
+}
+
+void JxlResourceGovernor::onFrame(uint64_t frameBytes) {
+  frames += 1;
+  checkFrameCount(frames);
+  decodedBytes += frameBytes;
+  if (limits.maxDecodedBytes != 0 && decodedBytes > limits.maxDecodedBytes) {
+    throw JxlResourceLimitException("Decoded data exceeds the limit of "
+                                        + std::to_string(limits.maxDecodedBytes) + " bytes");
+  }
+  checkTime();
+}
+
+int64_t JxlResourceGovernor::remainingMillis() const {
+  if (limits.maxWallTimeMillis <= 0) {
+    return 0;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime).count();
+  return std::max<int64_t>(limits.maxWallTimeMillis - elapsed, 1);
+}
+
+void JxlResourceGovernor::checkTime() const {
+  if (limits.maxWallTimeMillis <= 0) {
+    return;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - startTime).count();
+  if (elapsed >= limits.maxWallTimeMillis) {
+    throw JxlResourceLimitException("Operation exceeds the time limit of "
+                                        + std::to_string(limits.maxWallTimeMillis) + " ms");
+  }
+}
+
+JxlGovernorScope::JxlGovernorScope(JxlResourceGovernor &governor) : previous(currentGovernorRef()) {
+  governor.checkTime();
+  int64_t remaining = governor.remainingMillis();
+  if (remaining > 0) {
+    auto token = std::make_shared<concurrency::CancellationToken>(
+        concurrency::currentCancellationTokenRef());
+    token->setTimeout(remaining);
+    deadlineScope.emplace(token);
+  }
+  currentGovernorRef() = &governor;
+}
+
+JxlGovernorScope::~JxlGovernorScope() {
+  currentGovernorRef() = previous;
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include "cancellation.hpp"
+
+namespace coder {
+
+/**
+ * Limits applied to every decode and transcode, zero disables a limit
+ */
+struct JxlResourceLimits {
+  uint64_t maxPixels = 0;
+  uint64_t maxFrames = 0;
+  // Total bytes of all decoded frames of one operation
+  uint64_t maxDecodedBytes = 0;
+  int64_t maxWallTimeMillis = 0;
+};
+
+void setJxlResourceLimits(const JxlResourceLimits &limits);
+JxlResourceLimits jxlResourceLimits();
+
+class JxlResourceLimitException : public std::runtime_error {
+ public:
+  explicit JxlResourceLimitException(const std::string &message) : std::runtime_error(message) {}
+};
+
+/**
+ * Enforces JxlResourceLimits over a single operation, installed for the current thread for its lifetime.
+ * Dimensions and frame counts are verified as soon as they are known from headers, so inputs over
+ * the limits are rejected before pixel buffers are allocated.
+ * Wall time is enforced through a cancellation token linked to the caller's one,
+ * so long libjxl calls are interrupted by the parallel runner as well.
+ */
+class JxlResourceGovernor {
+ public:
+  explicit JxlResourceGovernor(const JxlResourceLimits &limits = jxlResourceLimits());
+
+  struct Detached {};
+
+  /**
+   * Governor accounting over several calls, e.g. every frame of an animation during a decoder lifetime.
+   * It isn't installed on construction, each call installs it with JxlGovernorScope.
+   */
+  explicit JxlResourceGovernor(Detached, const JxlResourceLimits &limits = jxlResourceLimits());
+  ~JxlResourceGovernor();
+
+  JxlResourceGovernor(const JxlResourceGovernor &) = delete;
+  JxlResourceGovernor &operator=(const JxlResourceGovernor &) = delete;
+
+  // Governor of the operation running on the current thread, or nullptr
+  static JxlResourceGovernor *current();
+
+  void checkImageSize(uint64_t width, uint64_t height);
+  void checkFrameCount(uint64_t frames);
+  // Accounts a frame about to be decoded, frameBytes is the size of its output buffer
+  void onFrame(uint64_t frameBytes);
+  void checkTime() const;
+
+ private:
+  friend class JxlGovernorScope;
+
+  // Time left before the deadline, or zero when wall time isn't limited
+  int64_t remainingMillis() const;
+
+  JxlResourceLimits limits;
+  std::chrono::steady_clock::time_point startTime;
+  uint64_t frames = 0;
+  uint64_t decodedBytes = 0;
+  bool installed;
+  JxlResourceGovernor *previous;
+  std::optional<concurrency::CancellationScope> deadlineScope;
+};
+
+/**
+ * Installs a detached governor for the current thread for the lifetime of the scope,
+ * its remaining wall time is armed on a token linked to the caller's one
+ */
+class JxlGovernorScope {
+ public:
+  explicit JxlGovernorScope(JxlResourceGovernor &governor);
+  ~JxlGovernorScope();
+
+  JxlGovernorScope(const JxlGovernorScope &) = delete;
+  JxlGovernorScope &operator=(const JxlGovernorScope &) = delete;
+
+ private:
+  JxlResourceGovernor *previous;
+  std::optional<concurrency::CancellationScope> deadlineScope;
+};
+
+}
@@ -0,0 +1,170 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "JxlThroughputModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace coder {
+
+// Megapixels per second on a mid-range phone using all of its cores, efforts 1...10
+static constexpr std::array<double, 10> lossyPriorRates = {
+    40, 25, 15, 10, 6, 4, 2.5, 0.6, 0.2, 0.05,
+};
+static constexpr std::array<double, 10> losslessPriorRates = {
+    30, 12, 6, 1.5, 1, 0.7, 0.4, 0.15, 0.05, 0.01,
+};
+
+// Fixed costs of the encoder dominate smaller images, they would understate the throughput
+static constexpr uint64_t minCalibrationPixels = 256 * 256;
+// Weight of the newest sample once a bucket has seen enough of them
+static constexpr double calibrationSmoothing = 0.25;
+static constexpr uint32_t maxCountedSamples = 1000;
+// Share of the budget planned to be used, the rest absorbs misprediction
+static constexpr double planningMargin = 0.85;
+static constexpr int fastestDecodingSpeed = 4;
+static constexpr float stateVersion = 1;
+
+namespace {
+
+int ClampEffort(int effort) {
+  return std::clamp(effort, jxlModelMinEffort, jxlModelMaxEffort);
+}
+
+double PriorLogRate(JxlCompressionOption option, int effort) {
+  const auto &rates = option == loseless ? losslessPriorRates : lossyPriorRates;
+  return std::log(rates[ClampEffort(effort) - jxlModelMinEffort]);
+}
+
+template<class Bucket>
+void Blend(Bucket &bucket, double logRate) {
+  const double weight = std::max(calibrationSmoothing, 1.0 / (bucket.samples + 1));
+  bucket.logRate += weight * (logRate - bucket.logRate);
+  bucket.samples = std::min(bucket.samples + 1, maxCountedSamples);
+}
+
+}
+
+JxlThroughputModel::JxlThroughputModel() = default;
+
+size_t JxlThroughputModel::bucketIndex(JxlCompressionOption option, int effort) const {
+  return (option == loseless ? bucketsPerOption : 0) + ClampEffort(effort) - jxlModelMinEffort;
+}
+
+double JxlThroughputModel::logRateLocked(size_t index) const {
+  const Bucket &bucket = buckets[index];
+  if (bucket.samples > 0) {
+    return bucket.logRate;
+  }
+  const JxlCompressionOption option = index >= bucketsPerOption ? loseless : lossy;
+  const int effort = static_cast<int>(index % bucketsPerOption) + jxlModelMinEffort;
+  return PriorLogRate(option, effort) + deviceFactor.logRate;
+}
+
+double JxlThroughputModel::megapixelsPerSecond(JxlCompressionOption option, int effort) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return std::exp(logRateLocked(bucketIndex(option, effort)));
+}
+
+double JxlThroughputModel::predictMillis(JxlCompressionOption option, int effort,
+                                         uint64_t pixels) const {
+  const double megapixels = static_cast<double>(pixels) / 1e6;
+  return megapixels / megapixelsPerSecond(option, effort) * 1000.0;
+}
+
+void JxlThroughputModel::record(JxlCompressionOption option, int effort, uint64_t pixels,
+                                double millis) {
+  if (pixels < minCalibrationPixels || !(millis > 0)) {
+    return;
+  }
+  const double logRate = std::log(static_cast<double>(pixels) / 1e6 / (millis / 1000.0));
+  std::lock_guard<std::mutex> lock(mutex);
+  Blend(buckets[bucketIndex(option, effort)], logRate);
+  Blend(deviceFactor, logRate - PriorLogRate(option, effort));
+}
+
+std::vector<float> JxlThroughputModel::exportState() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<float> state;
+  state.reserve(3 + buckets.size() * 2);
+  state.push_back(stateVersion);
+  state.push_back(static_cast<float>(deviceFactor.logRate));
+  state.push_back(static_cast<float>(deviceFactor.samples));
+  for (const Bucket &bucket: buckets) {
+    state.push_back(static_cast<float>(bucket.logRate));
+    state.push_back(static_cast<float>(bucket.samples));
+  }
+  return state;
+}
+
+bool JxlThroughputModel::importState(const float *state, size_t count) {
+  if (count != 3 + buckets.size() * 2 || state[0] != stateVersion) {
+    return false;
+  }
+  for (size_t i = 1; i < count; ++i) {
+    if (!std::isfinite(state[i]) || (i % 2 == 0 && state[i] < 0)) {
+      return false;
+    }
+  }
+  auto samples = [](float value) {
+    return std::min(static_cast<uint32_t>(value), maxCountedSamples);
+  };
+  std::lock_guard<std::mutex> lock(mutex);
+  deviceFactor.logRate = state[1];
+  deviceFactor.samples = samples(state[2]);
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    buckets[i].logRate = state[3 + i * 2];
+    buckets[i].samples = samples(state[4 + i * 2]);
+  }
+  return true;
+}
+
+void JxlThroughputModel::reset() {
+  std::lock_guard<std::mutex> lock(mutex);
+  buckets = {};
+  deviceFactor = {};
+}
+
+JxlThroughputModel &JxlThroughputModel::shared() {
+  static JxlThroughputModel model;
+  return model;
+}
+
+JxlEncodePlan PlanJxlEncode(const JxlThroughputModel &model, JxlCompressionOption option,
+                            uint64_t pixels, double budgetMillis, int maxEffort, int decodingSpeed) {
+  for (int effort = ClampEffort(maxEffort); effort >= jxlModelMinEffort; --effort) {
+    const double predicted = model.predictMillis(option, effort, pixels);
+    if (predicted <= budgetMillis * planningMargin) {
+      return {effort, decodingSpeed, predicted, false};
+    }
+  }
+  return {jxlModelMinEffort, fastestDecodingSpeed,
+          model.predictMillis(option, jxlModelMinEffort, pixels), true};
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "JxlDefinitions.h"
+
+namespace coder {
+
+static constexpr int jxlModelMinEffort = 1;
+static constexpr int jxlModelMaxEffort = 10;
+
+/**
+ * Encode throughput of this device in megapixels per second for each compression option and effort.
+ * Starts from rough priors of a mid-range phone and is calibrated by every finished encode,
+ * efforts that were never seen on the device are scaled by how fast the seen ones turned out to be.
+ * Rates are averaged in log space, so a single stall doesn't wreck the estimate.
+ */
+class JxlThroughputModel {
+ public:
+  JxlThroughputModel();
+
+  double megapixelsPerSecond(JxlCompressionOption option, int effort) const;
+
+  double predictMillis(JxlCompressionOption option, int effort, uint64_t pixels) const;
+
+  /**
+   * Feeds an encode of the whole image on the default runner.
+   * Encodes interrupted at a deadline may be fed as well, elapsed time is then a lower bound
+   * of the real one and still moves the estimate the right way.
+   */
+  void record(JxlCompressionOption option, int effort, uint64_t pixels, double millis);
+
+  /**
+   * Flat state for persisting between process launches, restored by importState
+   */
+  std::vector<float> exportState() const;
+
+  // False when the state was written by an incompatible version, the model is left untouched then
+  bool importState(const float *state, size_t count);
+
+  void reset();
+
+  static JxlThroughputModel &shared();
+
+ private:
+  struct Bucket {
+    double logRate = 0;
+    uint32_t samples = 0;
+  };
+
+  static constexpr size_t bucketsPerOption = jxlModelMaxEffort - jxlModelMinEffort + 1;
+
+  size_t bucketIndex(JxlCompressionOption option, int effort) const;
+
+  double logRateLocked(size_t index) const;
+
+  mutable std::mutex mutex;
+  std::array<Bucket, bucketsPerOption * 2> buckets;
+  // How much faster than the priors this device is, applied to uncalibrated buckets
+  Bucket deviceFactor;
+};
+
+struct JxlEncodePlan {
+  int effort;
+  int decodingSpeed;
+  double predictedMillis;
+  // Still predicted to miss the budget at the cheapest settings
+  bool overBudget;
+};
+
+/**
+ * Picks the highest effort up to maxEffort that is predicted to finish within the budget with some margin.
+ * When even the lowest effort doesn't fit the fastest decoding tier is used instead of the requested one,
+ * higher tiers skip some of the costlier encoder searches.
+ */
+JxlEncodePlan PlanJxlEncode(const JxlThroughputModel &model, JxlCompressionOption option,
+                            uint64_t pixels, double budgetMillis, int maxEffort, int decodingSpeed);
+
+}
@@ -33,6 +33,7 @@ import android.os.Build
 import androidx.annotation.IntRange
 import androidx.annotation.Keep
 import java.io.Closeable
+import java.nio.ByteBuffer
 
 @Keep
 class JxlAnimatedEncoder @Keep constructor(
@@ -44,7 +45,8 @@ class JxlAnimatedEncoder @Keep constructor(
     @IntRange(from = 1L, to = 9L) effort: Int = 7,
     @IntRange(from = 0, to = 100) quality: Int = 0,
     decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
-    dataPixelFormat: JxlEncodingDataPixelFormat = JxlEncodingDataPixelFormat.UNSIGNED_8
+    dataPixelFormat: JxlEncodingDataPixelFormat = JxlEncodingDataPixelFormat.UNSIGNED_8,
+    profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
 ) : Closeable {
 
     private var coordinator: Long = -1
@@ -63,6 +65,7 @@ class JxlAnimatedEncoder @Keep constructor(
             effort,
             decodingSpeed.value,
             dataPixelFormat.cValue,
+            profile.value,
         )
     }
 
@@ -71,6 +74,25 @@ class JxlAnimatedEncoder @Keep constructor(
         addFrameImpl(coordinator, bitmap, duration)
     }
 
+    /**
+     * Adds a frame from caller pixels, channels must match the channels configuration of the encoder
+     * with alpha in any 4 channel order, samples of any type are scaled into [JxlEncodingDataPixelFormat]
+     */
+    fun addFrame(pixels: JxlRawPixels, @IntRange(from = 1) duration: Int) {
+        assertOpen()
+        addRawFrameImpl(
+            coordinator,
+            pixels.buffer,
+            pixels.width,
+            pixels.height,
+            pixels.stride,
+            pixels.channels.value,
+            pixels.sampleType.value,
+            pixels.premultiplied,
+            duration
+        )
+    }
+
     fun encode(): ByteArray {
         assertOpen()
         val bos = encodeAnimatedImpl(coordinator)
@@ -89,10 +111,23 @@ class JxlAnimatedEncoder @Keep constructor(
         effort: Int,
         decodingSpeed: Int,
         dataPixelFormat: Int,
+        profile: Int,
     ): Long
 
     private external fun encodeAnimatedImpl(coordinatorPtr: Long): ByteArray
     private external fun addFrameImpl(coordinatorPtr: Long, bitmap: Bitmap, duration: Int)
+    private external fun addRawFrameImpl(
+        coordinatorPtr: Long,
+        byteBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        stride: Int,
+        channels: Int,
+        sampleType: Int,
+        premultiplied: Boolean,
+        duration: Int,
+    )
+
     private external fun closeAndReleaseAnimatedEncoder(coordinatorPtr: Long)
 
     private fun assertOpen() {
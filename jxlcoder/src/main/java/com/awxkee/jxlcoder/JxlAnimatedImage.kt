@@ -37,7 +37,11 @@ import androidx.annotation.Keep
 import androidx.annotation.RequiresApi
 import java.io.Closeable
 import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.math.ceil
 import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.sqrt
 
 @Keep
 class JxlAnimatedImage : Closeable {
@@ -150,6 +154,68 @@ class JxlAnimatedImage : Closeable {
         return getFrameImpl(coordinator, frame, scaleWidth, scaleHeight)
     }
 
+    /**
+     * Decodes [frameCount] frames starting from [firstFrame] into one atlas for a single texture upload.
+     * Frames are decoded in a single pass and resized into cells of [cellWidth] x [cellHeight]
+     * with the scale mode of this image, a frame smaller than its cell is placed at the cell origin.
+     * @param columns cells in an atlas row, 0 chooses a square-ish grid
+     * @param padding transparent pixels between cells and around the atlas
+     * @param output direct byte buffer receiving the atlas at its position, which is advanced,
+     * a new one is allocated when null
+     */
+    @Keep
+    public fun decodeAtlas(
+        firstFrame: Int,
+        frameCount: Int,
+        cellWidth: Int,
+        cellHeight: Int,
+        columns: Int = 0,
+        padding: Int = 1,
+        premultiplied: Boolean = true,
+        output: ByteBuffer? = null,
+    ): JxlAtlas {
+        assertOpen()
+        if (frameCount < 1 || cellWidth < 1 || cellHeight < 1 || padding < 0) {
+            throw IllegalArgumentException("Atlas needs at least one frame, positive cell size and non negative padding")
+        }
+        val atlasColumns = if (columns > 0) min(columns, frameCount) else ceil(sqrt(frameCount.toDouble())).toInt()
+        val atlasRows = (frameCount + atlasColumns - 1) / atlasColumns
+        val width = atlasColumns * cellWidth + (atlasColumns + 1) * padding
+        val height = atlasRows * cellHeight + (atlasRows + 1) * padding
+        val stride = width * 4
+        val buffer = output ?: ByteBuffer.allocateDirect(stride * height).order(ByteOrder.nativeOrder())
+        val offset = buffer.position()
+        val table = IntArray(frameCount * 5)
+        decodeAtlasImpl(
+            coordinator,
+            firstFrame,
+            frameCount,
+            cellWidth,
+            cellHeight,
+            atlasColumns,
+            padding,
+            premultiplied,
+            buffer,
+            offset,
+            table,
+        )
+        buffer.position(offset + stride * height)
+        val frames = (0 until frameCount).map {
+            JxlAtlasFrame(
+                index = firstFrame + it,
+                x = table[it * 5],
+                y = table[it * 5 + 1],
+                width = table[it * 5 + 2],
+                height = table[it * 5 + 3],
+                duration = table[it * 5 + 4],
+            )
+        }
+        val pixels = buffer.duplicate()
+        pixels.position(offset)
+        pixels.limit(offset + stride * height)
+        return JxlAtlas(width, height, stride, pixels.slice(), frames, premultiplied)
+    }
+
     @Keep
     fun getWidth(): Int {
         assertOpen()
@@ -179,6 +245,20 @@ class JxlAnimatedImage : Closeable {
         height: Int
     ): Bitmap
 
+    private external fun decodeAtlasImpl(
+        coordinatorPtr: Long,
+        firstFrame: Int,
+        frameCount: Int,
+        cellWidth: Int,
+        cellHeight: Int,
+        columns: Int,
+        padding: Int,
+        premultiplied: Boolean,
+        output: ByteBuffer,
+        outputOffset: Int,
+        frameTable: IntArray,
+    )
+
     private external fun getLoopsCount(coordinatorPtr: Long): Int
     private external fun getFrameDurationImpl(coordinatorPtr: Long, frame: Int): Int
     private external fun getNumberOfFrames(coordinatorPtr: Long): Int
@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import java.nio.ByteBuffer
+
+/**
+ * Range of animation frames laid out in a grid of one RGBA 8888 buffer,
+ * suitable for a single texture upload, e.g. glTexImage2D with GL_RGBA and GL_UNSIGNED_BYTE.
+ * Padding and unused cells are transparent black.
+ * @param pixels view over the atlas bytes of the output buffer
+ * @param stride bytes between atlas rows, always width * 4
+ * @param premultiplied whether color samples are multiplied by alpha
+ */
+class JxlAtlas(
+    val width: Int,
+    val height: Int,
+    val stride: Int,
+    val pixels: ByteBuffer,
+    val frames: List<JxlAtlasFrame>,
+    val premultiplied: Boolean,
+) {
+    /**
+     * Bytes of the atlas in [pixels]
+     */
+    val byteCount: Int
+        get() = stride * height
+}
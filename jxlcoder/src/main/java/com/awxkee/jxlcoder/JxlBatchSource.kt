@@ -0,0 +1,70 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.os.ParcelFileDescriptor
+import java.nio.ByteBuffer
+
+/**
+ * Single input of [JxlCoder.decodeSampledBatch].
+ * Width and height follow [JxlCoder.decodeSampled] semantics, non-positive values keep original size.
+ */
+class JxlBatchSource private constructor(
+    internal val data: Any?,
+    internal val fd: Int,
+    val width: Int,
+    val height: Int,
+) {
+    constructor(byteArray: ByteArray, width: Int = 0, height: Int = 0) : this(
+        byteArray,
+        -1,
+        width,
+        height
+    )
+
+    /**
+     * @param byteBuffer must be a direct byte buffer
+     */
+    constructor(byteBuffer: ByteBuffer, width: Int = 0, height: Int = 0) : this(
+        byteBuffer,
+        -1,
+        width,
+        height
+    )
+
+    /**
+     * Descriptor is read from the start and is not closed by the decoder
+     */
+    constructor(fileDescriptor: ParcelFileDescriptor, width: Int = 0, height: Int = 0) : this(
+        null,
+        fileDescriptor.fd,
+        width,
+        height
+    )
+}
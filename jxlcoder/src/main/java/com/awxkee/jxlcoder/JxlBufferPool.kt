@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.os.Build
+import androidx.annotation.Keep
+
+/**
+ * Native cache of large pixel buffers reused between decode and encode stages and calls.
+ * Forward [android.content.ComponentCallbacks2.onTrimMemory] into [onTrimMemory]
+ * so cached memory is returned under memory pressure.
+ */
+@Keep
+object JxlBufferPool {
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+    }
+
+    /**
+     * Upper bound of memory kept cached between calls, 0 disables caching
+     */
+    fun setMaxPooledBytes(bytes: Long) {
+        setMaxPooledBytesImpl(bytes)
+    }
+
+    fun onTrimMemory(level: Int) {
+        trimMemoryImpl(level)
+    }
+
+    /**
+     * Releases all cached buffers
+     */
+    fun clear() {
+        trimMemoryImpl(Int.MAX_VALUE)
+    }
+
+    val stats: JxlBufferPoolStats
+        get() {
+            val values = LongArray(4)
+            getStatsImpl(values)
+            return JxlBufferPoolStats(
+                hits = values[0],
+                misses = values[1],
+                pooledBytes = values[2],
+                maxPooledBytes = values[3],
+            )
+        }
+
+    private external fun trimMemoryImpl(level: Int)
+
+    private external fun setMaxPooledBytesImpl(bytes: Long)
+
+    private external fun getStatsImpl(stats: LongArray)
+}
@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.os.Build
+import androidx.annotation.Keep
+import java.io.Closeable
+
+/**
+ * Cooperative cancellation handle for native decode and encode calls.
+ * Pass it into a call and invoke [cancel] from any thread, or set a timeout,
+ * the call then aborts within a few milliseconds with [JxlCancellationException].
+ *
+ * @param timeoutMillis deadline relative to creation time, 0 means no deadline
+ */
+@Keep
+class JxlCancellationToken(timeoutMillis: Long = 0) : Closeable {
+
+    private var handle: Long = 0L
+    private val lock = Any()
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+        handle = createTokenImpl(timeoutMillis)
+    }
+
+    internal val nativeHandle: Long
+        get() {
+            synchronized(lock) {
+                if (handle == 0L) {
+                    throw IllegalStateException("Cancellation token is already closed")
+                }
+                return handle
+            }
+        }
+
+    fun cancel() {
+        synchronized(lock) {
+            if (handle != 0L) {
+                cancelImpl(handle)
+            }
+        }
+    }
+
+    val isCancelled: Boolean
+        get() {
+            synchronized(lock) {
+                return handle != 0L && isCancelledImpl(handle)
+            }
+        }
+
+    override fun close() {
+        synchronized(lock) {
+            if (handle != 0L) {
+                releaseTokenImpl(handle)
+                handle = 0L
+            }
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private external fun createTokenImpl(timeoutMillis: Long): Long
+    private external fun cancelImpl(handle: Long)
+    private external fun isCancelledImpl(handle: Long): Boolean
+    private external fun releaseTokenImpl(handle: Long)
+}
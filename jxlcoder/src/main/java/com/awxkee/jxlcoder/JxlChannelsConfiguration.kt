@@ -37,4 +37,11 @@ enum class JxlChannelsConfiguration(internal val cValue: Int) {
      * so it's your responsibility to ensure that image is correctly grayed before sending it is as mono and R channel contains required intensity values
      */
     MONOCHROME(3),
+
+    /**
+     * Image content is analyzed before encoding, opaque alpha is dropped and images where
+     * all the gamut channels are the same are stored as MONOCHROME, F16 images holding only 8-bit levels are stored as 8-bit.
+     * Decoded image stays the same. Animations and streaming encoding can't see all the pixels upfront and use RGBA.
+     */
+    AUTO(4),
 }
\ No newline at end of file
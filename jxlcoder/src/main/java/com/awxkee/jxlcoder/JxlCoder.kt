@@ -29,7 +29,9 @@
 package com.awxkee.jxlcoder
 
 import android.graphics.Bitmap
+import android.graphics.ColorSpace
 import android.os.Build
+import android.os.ParcelFileDescriptor
 import android.util.Size
 import androidx.annotation.IntRange
 import androidx.annotation.Keep
@@ -52,6 +54,7 @@ object JxlCoder {
         preferredColorConfig: PreferredColorConfig = PreferredColorConfig.DEFAULT,
         scaleMode: ScaleMode = ScaleMode.FIT,
         toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
     ): Bitmap {
         return decodeSampledImpl(
             byteArray,
@@ -61,6 +64,7 @@ object JxlCoder {
             scaleMode.value,
             JxlResizeFilter.CATMULL_ROM.value,
             jxlToneMapper = toneMapper.value,
+            cancellationToken = cancellationToken?.nativeHandle ?: 0L,
         )
     }
 
@@ -75,6 +79,7 @@ object JxlCoder {
         scaleMode: ScaleMode = ScaleMode.FIT,
         jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
         toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
     ): Bitmap {
         return decodeSampledImpl(
             byteArray,
@@ -84,6 +89,7 @@ object JxlCoder {
             scaleMode.value,
             jxlResizeFilter.value,
             jxlToneMapper = toneMapper.value,
+            cancellationToken = cancellationToken?.nativeHandle ?: 0L,
         )
     }
 
@@ -98,6 +104,7 @@ object JxlCoder {
         scaleMode: ScaleMode = ScaleMode.FIT,
         jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
         toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
     ): Bitmap {
         return decodeByteBufferSampledImpl(
             byteArray,
@@ -107,6 +114,161 @@ object JxlCoder {
             scaleMode.value,
             jxlResizeFilter.value,
             jxlToneMapper = toneMapper.value,
+            cancellationToken = cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Decodes the image straight into a model input tensor at the position of the direct [output] buffer,
+     * the position is advanced past the tensor. The image is color managed into sRGB and resized
+     * to the tensor size, [ScaleMode.FIT] is not supported since it would leave the tensor partially filled.
+     * @return count of written bytes
+     */
+    fun decodeTensor(
+        byteArray: ByteArray,
+        spec: JxlTensorSpec,
+        output: ByteBuffer,
+        scaleMode: ScaleMode = ScaleMode.RESIZE,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
+    ): Int {
+        val written = decodeTensorImpl(
+            byteArray,
+            spec.width,
+            spec.height,
+            spec.channels,
+            spec.layout.value,
+            spec.sampleType.value,
+            spec.mean,
+            spec.std,
+            scaleMode.value,
+            jxlResizeFilter.value,
+            toneMapper.value,
+            output,
+            output.position(),
+            cancellationToken?.nativeHandle ?: 0L,
+        ).toInt()
+        output.position(output.position() + written)
+        return written
+    }
+
+    /**
+     * Decodes image into 4:2:0 planes of [target] for video encoders, resizing it to the target size.
+     * Color managed and resized rows are converted to luma and filtered chroma in a single pass,
+     * alpha is dropped and transparent areas come out composed over black.
+     * @param scaleMode only [ScaleMode.FILL] and [ScaleMode.RESIZE] fill the whole frame and are supported
+     */
+    fun decodeYuv(
+        byteArray: ByteArray,
+        target: JxlYuvTarget,
+        scaleMode: ScaleMode = ScaleMode.RESIZE,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
+    ) {
+        decodeYuvImpl(
+            byteArray,
+            target.width,
+            target.height,
+            target.yPlane,
+            target.uPlane,
+            target.vPlane,
+            target.yRowStride,
+            target.uvRowStride,
+            target.uvPixelStride,
+            target.matrix.value,
+            target.range.value,
+            scaleMode.value,
+            jxlResizeFilter.value,
+            toneMapper.value,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Decodes image once and produces a bitmap for every spec from the same color managed pixels.
+     * Smaller outputs are resampled from an already produced larger one when it is cheaper.
+     * @return bitmaps in the order of specs
+     */
+    fun decodeMultiple(
+        byteArray: ByteArray,
+        specs: List<JxlOutputSpec>,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
+    ): List<Bitmap> {
+        return decodeMultipleFrom(byteArray, specs, jxlResizeFilter, toneMapper, cancellationToken)
+    }
+
+    /**
+     * @param byteBuffer must be a direct byte buffer
+     * @see decodeMultiple
+     */
+    fun decodeMultiple(
+        byteBuffer: ByteBuffer,
+        specs: List<JxlOutputSpec>,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        cancellationToken: JxlCancellationToken? = null,
+    ): List<Bitmap> {
+        return decodeMultipleFrom(byteBuffer, specs, jxlResizeFilter, toneMapper, cancellationToken)
+    }
+
+    private fun decodeMultipleFrom(
+        source: Any,
+        specs: List<JxlOutputSpec>,
+        jxlResizeFilter: JxlResizeFilter,
+        toneMapper: JxlToneMapper,
+        cancellationToken: JxlCancellationToken?,
+    ): List<Bitmap> {
+        return decodeMultipleImpl(
+            source,
+            specs.map { it.width }.toIntArray(),
+            specs.map { it.height }.toIntArray(),
+            specs.map { it.scaleMode.value }.toIntArray(),
+            specs.map { it.preferredColorConfig.value }.toIntArray(),
+            jxlResizeFilter.value,
+            toneMapper.value,
+            cancellationToken?.nativeHandle ?: 0L,
+        ).toList()
+    }
+
+    /**
+     * Decodes many images at once sharing one native call and the native thread pool.
+     * Small images are decoded one per worker, large ones use all threads each.
+     * Failures don't stop the batch and are reported per source.
+     * @param sequential decode images one after another exactly as separate [decodeSampled] calls
+     * would, useful as throughput baseline for [JxlBatchResult.megapixelsPerSecond]
+     */
+    fun decodeSampledBatch(
+        sources: List<JxlBatchSource>,
+        preferredColorConfig: PreferredColorConfig = PreferredColorConfig.DEFAULT,
+        scaleMode: ScaleMode = ScaleMode.FIT,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+        sequential: Boolean = false,
+        cancellationToken: JxlCancellationToken? = null,
+    ): JxlBatchResult {
+        val stats = LongArray(2)
+        val results = decodeSampledBatchImpl(
+            sources.map { it.data }.toTypedArray(),
+            sources.map { it.fd }.toIntArray(),
+            sources.map { it.width }.toIntArray(),
+            sources.map { it.height }.toIntArray(),
+            preferredColorConfig.value,
+            scaleMode.value,
+            jxlResizeFilter.value,
+            toneMapper.value,
+            sequential,
+            cancellationToken?.nativeHandle ?: 0L,
+            stats,
+        )
+        return JxlBatchResult(
+            bitmaps = results.map { it as? Bitmap },
+            errors = results.map { it as? Throwable },
+            elapsedNanos = stats[0],
+            decodedPixels = stats[1],
         )
     }
 
@@ -117,30 +279,506 @@ object JxlCoder {
         effort: JxlEffort = JxlEffort.SQUIRREL,
         @IntRange(from = 0, to = 100) quality: Int = 0,
         decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        cancellationToken: JxlCancellationToken? = null,
     ): ByteArray {
-        var dataSpaceValue: Int = -1
-        var bitmapColorSpace: String? = null
-        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
-            val colorSpaceValue = bitmap.colorSpace?.name
-            if (colorSpaceValue != null) {
-                bitmapColorSpace = colorSpaceValue
-            }
-
-            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
-                dataSpaceValue = bitmap.colorSpace?.dataSpace ?: -1
-            }
-        }
-
         return encodeImpl(
             bitmap,
             channelsConfiguration.cValue,
             compressionOption.cValue,
             effort.value,
-            bitmapColorSpace,
-            dataSpaceValue,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            quality,
+            decodingSpeed.value,
+            profile.value,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Same as [encode] writing the image straight into a direct [output] buffer from its position,
+     * the position is advanced past the written image.
+     * Fails when the remaining space of the buffer can't hold the image.
+     * @return count of written bytes
+     */
+    fun encode(
+        bitmap: Bitmap,
+        output: ByteBuffer,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        cancellationToken: JxlCancellationToken? = null,
+    ): Int {
+        require(output.isDirect) { "Output buffer must be direct" }
+        val written = encodeInto(
+            bitmap, channelsConfiguration, compressionOption, effort, quality, decodingSpeed, profile,
+            output, null, output.position(), -1, cancellationToken
+        ).toInt()
+        output.position(output.position() + written)
+        return written
+    }
+
+    /**
+     * Same as [encode] writing the image into a pre-sized [output] array starting at [offset],
+     * fails when the array can't hold the image
+     * @return count of written bytes
+     */
+    fun encode(
+        bitmap: Bitmap,
+        output: ByteArray,
+        offset: Int = 0,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        cancellationToken: JxlCancellationToken? = null,
+    ): Int {
+        return encodeInto(
+            bitmap, channelsConfiguration, compressionOption, effort, quality, decodingSpeed, profile,
+            null, output, offset, -1, cancellationToken
+        ).toInt()
+    }
+
+    /**
+     * Same as [encode] writing the image into [output] at its current position,
+     * the descriptor is not closed by the encoder
+     * @return count of written bytes
+     */
+    fun encode(
+        bitmap: Bitmap,
+        output: ParcelFileDescriptor,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        cancellationToken: JxlCancellationToken? = null,
+    ): Long {
+        return encodeInto(
+            bitmap, channelsConfiguration, compressionOption, effort, quality, decodingSpeed, profile,
+            null, null, 0, output.fd, cancellationToken
+        )
+    }
+
+    private fun encodeInto(
+        bitmap: Bitmap,
+        channelsConfiguration: JxlChannelsConfiguration,
+        compressionOption: JxlCompressionOption,
+        effort: JxlEffort,
+        quality: Int,
+        decodingSpeed: JxlDecodingSpeed,
+        profile: JxlEncodingProfile,
+        outputBuffer: ByteBuffer?,
+        outputArray: ByteArray?,
+        outputOffset: Int,
+        outputFd: Int,
+        cancellationToken: JxlCancellationToken?,
+    ): Long {
+        return encodeIntoImpl(
+            bitmap,
+            channelsConfiguration.cValue,
+            compressionOption.cValue,
+            effort.value,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            quality,
+            decodingSpeed.value,
+            profile.value,
+            outputBuffer,
+            outputArray,
+            outputOffset,
+            outputFd,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Lossy encoding that fits the image into [maxBytes], the bitmap is converted once
+     * and several distances are tried concurrently while the search narrows.
+     * The search stops at the first image in `[maxBytes * (1 - tolerance), maxBytes]`,
+     * otherwise the best quality image that fits is returned.
+     * Fails when the image doesn't fit even at the greatest distance.
+     */
+    fun encodeToTargetSize(
+        bitmap: Bitmap,
+        maxBytes: Long,
+        tolerance: Float = 0.05f,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        cancellationToken: JxlCancellationToken? = null,
+    ): JxlTargetSizeResult {
+        val distance = FloatArray(1)
+        val data = encodeToTargetSizeImpl(
+            bitmap,
+            channelsConfiguration.cValue,
+            effort.value,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            decodingSpeed.value,
+            maxBytes,
+            tolerance,
+            distance,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+        return JxlTargetSizeResult(data = data, distance = distance[0])
+    }
+
+    /**
+     * Lossy encoding at the greatest distance whose decoded image still scores at least [targetScore]
+     * by [metric], e.g. 90 of SSIMULACRA2 for visually lossless images.
+     * Candidates are encoded concurrently, decoded in-process and compared against the converted bitmap,
+     * translucent images are compared over dark and light backgrounds.
+     * The search stops at the first image scoring in `[targetScore, targetScore + tolerance]`.
+     * Fails when the score can't be reached even at the smallest distance.
+     */
+    fun encodeToTargetQuality(
+        bitmap: Bitmap,
+        targetScore: Float,
+        metric: JxlQualityMetric = JxlQualityMetric.SSIMULACRA2,
+        tolerance: Float = 1f,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        cancellationToken: JxlCancellationToken? = null,
+    ): JxlTargetQualityResult {
+        val distanceAndScore = FloatArray(2)
+        val data = encodeToTargetQualityImpl(
+            bitmap,
+            channelsConfiguration.cValue,
+            effort.value,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            decodingSpeed.value,
+            metric.value,
+            targetScore,
+            tolerance,
+            distanceAndScore,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+        return JxlTargetQualityResult(
+            data = data,
+            distance = distanceAndScore[0],
+            score = distanceAndScore[1],
+        )
+    }
+
+    /**
+     * Encodes with the highest effort up to [maxEffort] that is predicted to finish within [budgetMillis],
+     * the prediction comes from [JxlThroughputModel] calibrated by previous encodes on this device.
+     * When even the lowest effort doesn't fit, it's used with the fastest decoding tier.
+     * With [allowFallback] the planned effort is abandoned for the lowest one once it's at risk
+     * of missing the budget. The deadline is observed between libjxl jobs, so it's a target and not a guarantee.
+     */
+    fun encodeWithTimeBudget(
+        bitmap: Bitmap,
+        budgetMillis: Long,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        maxEffort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        allowFallback: Boolean = true,
+        cancellationToken: JxlCancellationToken? = null,
+    ): JxlTimeBudgetResult {
+        val report = FloatArray(6)
+        val data = encodeWithTimeBudgetImpl(
+            bitmap,
+            channelsConfiguration.cValue,
+            compressionOption.cValue,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            quality,
+            maxEffort.value,
+            decodingSpeed.value,
+            budgetMillis,
+            allowFallback,
+            report,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+        JxlThroughputModel.persist()
+        return JxlTimeBudgetResult(
+            data = data,
+            effort = JxlEffort.entries.first { it.value == report[0].toInt() },
+            decodingSpeed = JxlDecodingSpeed.entries.first { it.value == report[1].toInt() },
+            fellBack = report[2] != 0f,
+            predictedEncodeMillis = report[3],
+            encodeMillis = report[4],
+            totalMillis = report[5],
+        )
+    }
+
+    /**
+     * Encodes several renditions of [bitmap] in a single pass over its pixels.
+     * The bitmap is converted once, every smaller size is downscaled with [resizeFilter] from the previous one
+     * and renditions are encoded concurrently on the shared pool as soon as their size is ready.
+     * @return results in the order of [renditions]
+     */
+    fun encodeRenditions(
+        bitmap: Bitmap,
+        renditions: List<JxlRendition>,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        resizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        cancellationToken: JxlCancellationToken? = null,
+    ): List<JxlRenditionResult> {
+        require(renditions.isNotEmpty()) { "Renditions must not be empty" }
+        val sizes = IntArray(renditions.size * 2)
+        val timings = FloatArray(renditions.size * 2)
+        val data = encodeRenditionsImpl(
+            bitmap,
+            bitmapColorSpaceName(bitmap),
+            bitmapDataSpace(bitmap),
+            renditions.map { it.maxDimension }.toIntArray(),
+            renditions.map { it.quality }.toIntArray(),
+            renditions.map { it.effort.value }.toIntArray(),
+            renditions.map { it.channelsConfiguration.cValue }.toIntArray(),
+            renditions.map { it.compressionOption.cValue }.toIntArray(),
+            decodingSpeed.value,
+            resizeFilter.value,
+            sizes,
+            timings,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+        return data.mapIndexed { index, bytes ->
+            JxlRenditionResult(
+                data = bytes,
+                width = sizes[index * 2],
+                height = sizes[index * 2 + 1],
+                scaleMillis = timings[index * 2],
+                encodeMillis = timings[index * 2 + 1],
+            )
+        }
+    }
+
+    /**
+     * Encodes pixels of a direct buffer without a bitmap, channels of the stored image follow
+     * [JxlRawPixels.channels] and its bit depth follows [JxlRawPixels.sampleType].
+     * @param colorSpace space of the pixels, sRGB when not provided
+     */
+    fun encode(
+        pixels: JxlRawPixels,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        colorSpace: ColorSpace? = null,
+        cancellationToken: JxlCancellationToken? = null,
+    ): ByteArray {
+        return encodeRawImpl(
+            pixels.buffer,
+            pixels.width,
+            pixels.height,
+            pixels.stride,
+            pixels.channels.value,
+            pixels.sampleType.value,
+            pixels.premultiplied,
+            compressionOption.cValue,
+            effort.value,
+            colorSpace?.let { colorSpaceName(it) },
+            colorSpace?.let { colorSpaceDataSpace(it) } ?: -1,
+            quality,
+            decodingSpeed.value,
+            profile.value,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Encodes a camera frame straight from its YUV planes, rectangles requested by the encoder
+     * are converted to RGB on demand instead of building an RGBA bitmap first.
+     * The frame is stored opaque in sRGB.
+     */
+    fun encode(
+        source: JxlYuvSource,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        cancellationToken: JxlCancellationToken? = null,
+    ): ByteArray {
+        return encodeYuvImpl(
+            source.yPlane,
+            source.uPlane,
+            source.vPlane,
+            source.width,
+            source.height,
+            source.yRowStride,
+            source.uvRowStride,
+            source.uvPixelStride,
+            source.matrix.value,
+            source.range.value,
+            compressionOption.cValue,
+            effort.value,
+            quality,
+            decodingSpeed.value,
+            cancellationToken?.nativeHandle ?: 0L,
+        )
+    }
+
+    /**
+     * Encodes large images with bounded memory, pixels are pulled from [source] in groups
+     * and the output is streamed instead of being built from a whole converted copy of the image.
+     */
+    fun encodeStreaming(
+        source: JxlStreamingSource,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        cancellationToken: JxlCancellationToken? = null,
+    ): ByteArray {
+        return encodeStreamingFrom(
+            source, channelsConfiguration, compressionOption, effort, quality,
+            decodingSpeed, -1, cancellationToken
+        ).first!!
+    }
+
+    /**
+     * Same as [encodeStreaming] writing the image into [output] at its current position,
+     * the descriptor is not closed by the encoder
+     * @return count of written bytes
+     */
+    fun encodeStreaming(
+        source: JxlStreamingSource,
+        output: ParcelFileDescriptor,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        cancellationToken: JxlCancellationToken? = null,
+    ): Long {
+        return encodeStreamingFrom(
+            source, channelsConfiguration, compressionOption, effort, quality,
+            decodingSpeed, output.fd, cancellationToken
+        ).second
+    }
+
+    private fun encodeStreamingFrom(
+        source: JxlStreamingSource,
+        channelsConfiguration: JxlChannelsConfiguration,
+        compressionOption: JxlCompressionOption,
+        effort: JxlEffort,
+        quality: Int,
+        decodingSpeed: JxlDecodingSpeed,
+        outputFd: Int,
+        cancellationToken: JxlCancellationToken?,
+    ): Pair<ByteArray?, Long> {
+        val written = LongArray(1)
+        val result = encodeStreamingImpl(
+            source.bitmap,
+            source.buffer,
+            source.fd,
+            source.offset,
+            source.width,
+            source.height,
+            source.stride,
+            source.layout.value,
+            source.premultiplied,
+            channelsConfiguration.cValue,
+            compressionOption.cValue,
+            effort.value,
+            source.bitmap?.let { bitmapColorSpaceName(it) },
+            source.bitmap?.let { bitmapDataSpace(it) } ?: -1,
             quality,
             decodingSpeed.value,
+            outputFd,
+            written,
+            cancellationToken?.nativeHandle ?: 0L,
         )
+        return Pair(result, written[0])
+    }
+
+    /**
+     * Encodes many images sharing the native thread pool, every image gets its share of the cores
+     * instead of each encoder spawning a thread per core.
+     * Results are handed to [callback] on the calling thread as soon as each image completes,
+     * so the order is not the order of [sources]. Failures don't stop the batch,
+     * an exception thrown by the callback cancels it and is rethrown.
+     * Raw sources are encoded as by [encodeStreaming] and always use [JxlEncodingProfile.DEFAULT].
+     * @param maxInFlightBytes bound of source frames held by images being encoded at once,
+     * an image larger than the bound is still encoded alone, non-positive values remove the bound
+     */
+    fun encodeBatch(
+        sources: List<JxlStreamingSource>,
+        callback: JxlBatchEncodeCallback,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+        profile: JxlEncodingProfile = JxlEncodingProfile.DEFAULT,
+        maxInFlightBytes: Long = 256L * 1024 * 1024,
+        cancellationToken: JxlCancellationToken? = null,
+    ): JxlBatchEncodeResult {
+        val stats = LongArray(5)
+        encodeBatchImpl(
+            sources.map { it.bitmap }.toTypedArray(),
+            sources.map { it.buffer }.toTypedArray(),
+            sources.map { it.fd }.toIntArray(),
+            sources.map { it.offset }.toLongArray(),
+            sources.map { it.width }.toIntArray(),
+            sources.map { it.height }.toIntArray(),
+            sources.map { it.stride }.toIntArray(),
+            sources.map { it.layout.value }.toIntArray(),
+            sources.map { it.premultiplied }.toBooleanArray(),
+            sources.map { source -> source.bitmap?.let { bitmapColorSpaceName(it) } }.toTypedArray(),
+            sources.map { source -> source.bitmap?.let { bitmapDataSpace(it) } ?: -1 }.toIntArray(),
+            channelsConfiguration.cValue,
+            compressionOption.cValue,
+            effort.value,
+            quality,
+            decodingSpeed.value,
+            profile.value,
+            maxInFlightBytes,
+            callback,
+            cancellationToken?.nativeHandle ?: 0L,
+            stats,
+        )
+        return JxlBatchEncodeResult(
+            encoded = stats[3].toInt(),
+            failed = stats[4].toInt(),
+            elapsedNanos = stats[0],
+            encodedPixels = stats[1],
+            encodedBytes = stats[2],
+        )
+    }
+
+    internal fun bitmapColorSpaceName(bitmap: Bitmap): String? {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+            return bitmap.colorSpace?.name
+        }
+        return null
+    }
+
+    private fun colorSpaceName(colorSpace: ColorSpace): String? {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+            return colorSpace.name
+        }
+        return null
+    }
+
+    private fun colorSpaceDataSpace(colorSpace: ColorSpace): Int {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            return colorSpace.dataSpace
+        }
+        return -1
+    }
+
+    internal fun bitmapDataSpace(bitmap: Bitmap): Int {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            return bitmap.colorSpace?.dataSpace ?: -1
+        }
+        return -1
     }
 
     object Convenience {
@@ -226,6 +864,7 @@ object JxlCoder {
         scaleMode: Int,
         jxlResizeSampler: Int,
         jxlToneMapper: Int,
+        cancellationToken: Long,
     ): Bitmap
 
     private external fun decodeByteBufferSampledImpl(
@@ -236,8 +875,34 @@ object JxlCoder {
         scaleMode: Int,
         jxlResizeSampler: Int,
         jxlToneMapper: Int,
+        cancellationToken: Long,
     ): Bitmap
 
+    private external fun decodeMultipleImpl(
+        source: Any,
+        widths: IntArray,
+        heights: IntArray,
+        scaleModes: IntArray,
+        preferredColorConfigs: IntArray,
+        jxlResizeSampler: Int,
+        jxlToneMapper: Int,
+        cancellationToken: Long,
+    ): Array<Bitmap>
+
+    private external fun decodeSampledBatchImpl(
+        sources: Array<Any?>,
+        fds: IntArray,
+        widths: IntArray,
+        heights: IntArray,
+        preferredColorConfig: Int,
+        scaleMode: Int,
+        jxlResizeSampler: Int,
+        jxlToneMapper: Int,
+        sequential: Boolean,
+        cancellationToken: Long,
+        stats: LongArray,
+    ): Array<Any?>
+
     private external fun encodeImpl(
         bitmap: Bitmap,
         colorSpace: Int,
@@ -246,9 +911,203 @@ object JxlCoder {
         bitmapColorSpace: String?,
         dataSpaceValue: Int,
         quality: Int,
-        decodingSpeed: Int
+        decodingSpeed: Int,
+        profile: Int,
+        cancellationToken: Long,
+    ): ByteArray
+
+    private external fun encodeIntoImpl(
+        bitmap: Bitmap,
+        colorSpace: Int,
+        compressionOption: Int,
+        loosyLevel: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        profile: Int,
+        outputBuffer: ByteBuffer?,
+        outputArray: ByteArray?,
+        outputOffset: Int,
+        outputFd: Int,
+        cancellationToken: Long,
+    ): Long
+
+    private external fun encodeToTargetSizeImpl(
+        bitmap: Bitmap,
+        colorSpace: Int,
+        effort: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        decodingSpeed: Int,
+        maxBytes: Long,
+        tolerance: Float,
+        chosenDistance: FloatArray,
+        cancellationToken: Long,
+    ): ByteArray
+
+    private external fun encodeToTargetQualityImpl(
+        bitmap: Bitmap,
+        colorSpace: Int,
+        effort: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        decodingSpeed: Int,
+        metric: Int,
+        targetScore: Float,
+        tolerance: Float,
+        distanceAndScore: FloatArray,
+        cancellationToken: Long,
+    ): ByteArray
+
+    private external fun encodeWithTimeBudgetImpl(
+        bitmap: Bitmap,
+        colorSpace: Int,
+        compressionOption: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        maxEffort: Int,
+        decodingSpeed: Int,
+        budgetMillis: Long,
+        allowFallback: Boolean,
+        report: FloatArray,
+        cancellationToken: Long,
     ): ByteArray
 
+    private external fun encodeRenditionsImpl(
+        bitmap: Bitmap,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        maxDimensions: IntArray,
+        qualities: IntArray,
+        efforts: IntArray,
+        channels: IntArray,
+        compressionOptions: IntArray,
+        decodingSpeed: Int,
+        resizeFilter: Int,
+        sizes: IntArray,
+        timings: FloatArray,
+        cancellationToken: Long,
+    ): Array<ByteArray>
+
+    private external fun encodeRawImpl(
+        byteBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        stride: Int,
+        channels: Int,
+        sampleType: Int,
+        premultiplied: Boolean,
+        compressionOption: Int,
+        effort: Int,
+        colorSpaceName: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        profile: Int,
+        cancellationToken: Long,
+    ): ByteArray
+
+    private external fun decodeTensorImpl(
+        byteArray: ByteArray,
+        width: Int,
+        height: Int,
+        channels: Int,
+        layout: Int,
+        sampleType: Int,
+        mean: FloatArray?,
+        std: FloatArray?,
+        scaleMode: Int,
+        resizeFilter: Int,
+        toneMapper: Int,
+        output: ByteBuffer,
+        outputOffset: Int,
+        cancellationToken: Long,
+    ): Long
+
+    private external fun decodeYuvImpl(
+        byteArray: ByteArray,
+        width: Int,
+        height: Int,
+        yPlane: ByteBuffer,
+        uPlane: ByteBuffer,
+        vPlane: ByteBuffer,
+        yRowStride: Int,
+        uvRowStride: Int,
+        uvPixelStride: Int,
+        matrix: Int,
+        range: Int,
+        scaleMode: Int,
+        resizeFilter: Int,
+        toneMapper: Int,
+        cancellationToken: Long,
+    )
+
+    private external fun encodeYuvImpl(
+        yPlane: ByteBuffer,
+        uPlane: ByteBuffer,
+        vPlane: ByteBuffer,
+        width: Int,
+        height: Int,
+        yRowStride: Int,
+        uvRowStride: Int,
+        uvPixelStride: Int,
+        matrix: Int,
+        range: Int,
+        compressionOption: Int,
+        effort: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        cancellationToken: Long,
+    ): ByteArray
+
+    private external fun encodeStreamingImpl(
+        bitmap: Bitmap?,
+        byteBuffer: ByteBuffer?,
+        inputFd: Int,
+        inputOffset: Long,
+        width: Int,
+        height: Int,
+        stride: Int,
+        layout: Int,
+        premultiplied: Boolean,
+        colorSpace: Int,
+        compressionOption: Int,
+        effort: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        outputFd: Int,
+        written: LongArray,
+        cancellationToken: Long,
+    ): ByteArray?
+
+    private external fun encodeBatchImpl(
+        bitmaps: Array<Bitmap?>,
+        buffers: Array<ByteBuffer?>,
+        fds: IntArray,
+        offsets: LongArray,
+        widths: IntArray,
+        heights: IntArray,
+        strides: IntArray,
+        layouts: IntArray,
+        premultiplied: BooleanArray,
+        bitmapColorSpaces: Array<String?>,
+        dataSpaceValues: IntArray,
+        colorSpace: Int,
+        compressionOption: Int,
+        effort: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        profile: Int,
+        maxInFlightBytes: Long,
+        callback: JxlBatchEncodeCallback,
+        cancellationToken: Long,
+        stats: LongArray,
+    )
+
     private val MAGIC_1 = byteArrayOf(0xFF.toByte(), 0x0A)
     private val MAGIC_2 = byteArrayOf(
         0x0.toByte(),
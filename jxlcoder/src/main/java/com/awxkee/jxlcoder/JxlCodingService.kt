@@ -0,0 +1,308 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.graphics.Bitmap
+import android.os.Build
+import androidx.annotation.IntRange
+import androidx.annotation.Keep
+import java.io.Closeable
+import java.nio.ByteBuffer
+
+/**
+ * Asynchronous decode and encode service running jobs on the native shared pool.
+ * Jobs are started by priority, limited by [maxConcurrentJobs] and by an estimate of memory
+ * held by running jobs [maxInFlightBytes].
+ * Jobs that aren't started yet might be re-prioritized with [setPriority] or dropped with [cancel].
+ */
+@Keep
+class JxlCodingService(
+    val maxConcurrentJobs: Int = 2,
+    val maxInFlightBytes: Long = 256L * 1024L * 1024L,
+) : Closeable {
+
+    private var handle: Long = 0L
+    private val lock = Any()
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+        handle = createServiceImpl(maxConcurrentJobs, maxInFlightBytes)
+    }
+
+    /**
+     * @return job id
+     */
+    fun decodeSampled(
+        byteArray: ByteArray,
+        width: Int,
+        height: Int,
+        callback: JxlJobCallback<Bitmap>,
+        priority: JxlJobPriority = JxlJobPriority.VISIBLE,
+        preferredColorConfig: PreferredColorConfig = PreferredColorConfig.DEFAULT,
+        scaleMode: ScaleMode = ScaleMode.FIT,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+    ): Long {
+        synchronized(lock) {
+            assertOpen()
+            return enqueueDecodeImpl(
+                handle,
+                byteArray,
+                null,
+                width,
+                height,
+                preferredColorConfig.value,
+                scaleMode.value,
+                jxlResizeFilter.value,
+                toneMapper.value,
+                priority.value,
+                callback,
+            )
+        }
+    }
+
+    /**
+     * @param byteBuffer direct byte buffer, contents are copied before the call returns
+     * @return job id
+     */
+    fun decodeSampled(
+        byteBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        callback: JxlJobCallback<Bitmap>,
+        priority: JxlJobPriority = JxlJobPriority.VISIBLE,
+        preferredColorConfig: PreferredColorConfig = PreferredColorConfig.DEFAULT,
+        scaleMode: ScaleMode = ScaleMode.FIT,
+        jxlResizeFilter: JxlResizeFilter = JxlResizeFilter.MITCHELL_NETRAVALI,
+        toneMapper: JxlToneMapper = JxlToneMapper.REC2408,
+    ): Long {
+        synchronized(lock) {
+            assertOpen()
+            return enqueueDecodeImpl(
+                handle,
+                null,
+                byteBuffer,
+                width,
+                height,
+                preferredColorConfig.value,
+                scaleMode.value,
+                jxlResizeFilter.value,
+                toneMapper.value,
+                priority.value,
+                callback,
+            )
+        }
+    }
+
+    /**
+     * Bitmap must not be recycled or mutated until the callback is invoked
+     * @return job id
+     */
+    fun encode(
+        bitmap: Bitmap,
+        callback: JxlJobCallback<ByteArray>,
+        priority: JxlJobPriority = JxlJobPriority.BACKGROUND,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+    ): Long {
+        synchronized(lock) {
+            assertOpen()
+            return enqueueEncodeImpl(
+                handle,
+                bitmap,
+                channelsConfiguration.cValue,
+                compressionOption.cValue,
+                effort.value,
+                JxlCoder.bitmapColorSpaceName(bitmap),
+                JxlCoder.bitmapDataSpace(bitmap),
+                quality,
+                decodingSpeed.value,
+                priority.value,
+                callback,
+            )
+        }
+    }
+
+    /**
+     * Encodes [bitmap] at [instantEffort] on the calling thread and returns it right away,
+     * then the same converted pixels are encoded at [effort] as a job of this service
+     * and the result is delivered to [callback].
+     * The bitmap is read once, it might be recycled as soon as this returns.
+     * Write the replacement into a temporary file and rename it over the instant one,
+     * so readers never observe a partially written image.
+     */
+    fun encodeTiered(
+        bitmap: Bitmap,
+        callback: JxlJobCallback<ByteArray>,
+        priority: JxlJobPriority = JxlJobPriority.BACKGROUND,
+        channelsConfiguration: JxlChannelsConfiguration = JxlChannelsConfiguration.RGB,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+        instantEffort: JxlEffort = JxlEffort.LIGHTNING,
+        effort: JxlEffort = JxlEffort.SQUIRREL,
+        @IntRange(from = 0, to = 100) quality: Int = 0,
+        decodingSpeed: JxlDecodingSpeed = JxlDecodingSpeed.SLOWEST,
+    ): JxlTieredEncodeResult {
+        val pixelsHandle = LongArray(1)
+        // Not holding the lock, so other jobs may be submitted while the instant image is encoded
+        val data = encodeInstantImpl(
+            bitmap,
+            channelsConfiguration.cValue,
+            compressionOption.cValue,
+            instantEffort.value,
+            JxlCoder.bitmapColorSpaceName(bitmap),
+            JxlCoder.bitmapDataSpace(bitmap),
+            quality,
+            decodingSpeed.value,
+            pixelsHandle,
+        )
+        synchronized(lock) {
+            if (handle == 0L) {
+                releasePixelsImpl(pixelsHandle[0])
+            }
+            assertOpen()
+            val jobId = enqueueEncodePixelsImpl(
+                handle,
+                pixelsHandle[0],
+                compressionOption.cValue,
+                effort.value,
+                quality,
+                decodingSpeed.value,
+                priority.value,
+                callback,
+            )
+            return JxlTieredEncodeResult(data = data, jobId = jobId)
+        }
+    }
+
+    /**
+     * @return false if the job has already started or finished
+     */
+    fun setPriority(jobId: Long, priority: JxlJobPriority): Boolean {
+        synchronized(lock) {
+            assertOpen()
+            return setPriorityImpl(handle, jobId, priority.value)
+        }
+    }
+
+    /**
+     * Pending jobs are dropped immediately, running jobs abort cooperatively.
+     * In both cases callback receives [JxlCancellationException].
+     * @return false if the job is unknown or already finished
+     */
+    fun cancel(jobId: Long): Boolean {
+        synchronized(lock) {
+            assertOpen()
+            return cancelImpl(handle, jobId)
+        }
+    }
+
+    private fun assertOpen() {
+        if (handle == 0L) {
+            throw IllegalStateException("Coding service is already closed")
+        }
+    }
+
+    override fun close() {
+        synchronized(lock) {
+            if (handle != 0L) {
+                closeAndReleaseServiceImpl(handle)
+                handle = 0L
+            }
+        }
+    }
+
+    protected fun finalize() {
+        close()
+    }
+
+    private external fun createServiceImpl(maxConcurrentJobs: Int, maxInFlightBytes: Long): Long
+
+    private external fun enqueueDecodeImpl(
+        handle: Long,
+        byteArray: ByteArray?,
+        byteBuffer: ByteBuffer?,
+        width: Int,
+        height: Int,
+        preferredColorConfig: Int,
+        scaleMode: Int,
+        jxlResizeSampler: Int,
+        jxlToneMapper: Int,
+        priority: Int,
+        callback: JxlJobCallback<Bitmap>,
+    ): Long
+
+    private external fun enqueueEncodeImpl(
+        handle: Long,
+        bitmap: Bitmap,
+        colorSpace: Int,
+        compressionOption: Int,
+        effort: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        priority: Int,
+        callback: JxlJobCallback<ByteArray>,
+    ): Long
+
+    private external fun encodeInstantImpl(
+        bitmap: Bitmap,
+        colorSpace: Int,
+        compressionOption: Int,
+        effort: Int,
+        bitmapColorSpace: String?,
+        dataSpaceValue: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        pixelsHandle: LongArray,
+    ): ByteArray
+
+    // Takes ownership of the converted pixels
+    private external fun enqueueEncodePixelsImpl(
+        handle: Long,
+        pixelsHandle: Long,
+        compressionOption: Int,
+        effort: Int,
+        quality: Int,
+        decodingSpeed: Int,
+        priority: Int,
+        callback: JxlJobCallback<ByteArray>,
+    ): Long
+
+    private external fun releasePixelsImpl(pixelsHandle: Long)
+
+    private external fun setPriorityImpl(handle: Long, jobId: Long, priority: Int): Boolean
+    private external fun cancelImpl(handle: Long, jobId: Long): Boolean
+    private external fun closeAndReleaseServiceImpl(handle: Long)
+}
@@ -0,0 +1,70 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.os.Build
+import androidx.annotation.Keep
+
+/**
+ * Accounting of memory used by libjxl decoders and encoders together with the output image buffers.
+ * When a single operation needs more than the budget it fails with [JxlMemoryBudgetExceededException]
+ * instead of growing until the process is killed.
+ */
+@Keep
+object JxlMemoryBudget {
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+    }
+
+    /**
+     * Budget of every operation started after the call, 0 removes the limit
+     */
+    fun setBudget(bytes: Long) {
+        setBudgetImpl(bytes)
+    }
+
+    val stats: JxlMemoryStats
+        get() {
+            val values = LongArray(4)
+            getStatsImpl(values)
+            return JxlMemoryStats(
+                currentBytes = values[0],
+                lastOperationPeakBytes = values[1],
+                maxOperationPeakBytes = values[2],
+                budgetBytes = values[3],
+            )
+        }
+
+    private external fun setBudgetImpl(bytes: Long)
+
+    private external fun getStatsImpl(stats: LongArray)
+}
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.graphics.Bitmap
+import android.os.Build
+import androidx.annotation.Keep
+
+/**
+ * Native image metrics, the same engine is used by [JxlCoder.encodeToTargetQuality].
+ * Bitmaps of any supported config are compared unpremultiplied and treated as sRGB.
+ */
+@Keep
+object JxlMetrics {
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+    }
+
+    /**
+     * @param alphaAware when true translucent images are blended over a dark and a light background
+     * and the worse score is returned, otherwise alpha is ignored
+     */
+    fun compute(
+        reference: Bitmap,
+        distorted: Bitmap,
+        metric: JxlQualityMetric = JxlQualityMetric.SSIMULACRA2,
+        alphaAware: Boolean = false,
+    ): Double {
+        return computeImpl(reference, distorted, metric.value, alphaAware)
+    }
+
+    fun ssimulacra2(reference: Bitmap, distorted: Bitmap, alphaAware: Boolean = false): Double {
+        return compute(reference, distorted, JxlQualityMetric.SSIMULACRA2, alphaAware)
+    }
+
+    fun psnr(reference: Bitmap, distorted: Bitmap, alphaAware: Boolean = false): Double {
+        return compute(reference, distorted, JxlQualityMetric.PSNR, alphaAware)
+    }
+
+    /**
+     * Feeds [data] to a progressive decoder in small increments and scores every partial render
+     * of the first frame with SSIMULACRA2 against the complete image.
+     * Lengths are accurate to about 1/256 of the stream, use it to compare [JxlEncodingProfile]s.
+     * @param qualityScore SSIMULACRA2 score a partial render must reach to count as [JxlProgressionReport.qualityBytes]
+     */
+    fun measureProgression(data: ByteArray, qualityScore: Float = 90f): JxlProgressionReport {
+        val report = LongArray(5)
+        measureProgressionImpl(data, qualityScore, report)
+        return JxlProgressionReport(
+            totalBytes = report[0],
+            firstRenderBytes = report[1],
+            dcBytes = report[2],
+            qualityBytes = report[3],
+            progressionSteps = report[4].toInt(),
+        )
+    }
+
+    private external fun computeImpl(
+        reference: Bitmap,
+        distorted: Bitmap,
+        metric: Int,
+        alphaAware: Boolean,
+    ): Double
+
+    private external fun measureProgressionImpl(
+        data: ByteArray,
+        qualityScore: Float,
+        report: LongArray,
+    ): Boolean
+}
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.graphics.Bitmap
+import android.os.ParcelFileDescriptor
+import java.nio.ByteBuffer
+
+/**
+ * Pixels of [JxlCoder.encodeStreaming], they are converted for the encoder in small rectangles
+ * when requested, so the whole image is never copied.
+ * Also an input of [JxlCoder.encodeBatch], where bitmaps are converted as a whole.
+ */
+class JxlStreamingSource private constructor(
+    internal val bitmap: Bitmap?,
+    internal val buffer: ByteBuffer?,
+    internal val fd: Int,
+    internal val offset: Long,
+    internal val width: Int,
+    internal val height: Int,
+    internal val stride: Int,
+    internal val layout: JxlRawLayout,
+    internal val premultiplied: Boolean,
+) {
+    /**
+     * Bitmap stays locked for the whole encoding
+     */
+    constructor(bitmap: Bitmap) : this(
+        bitmap,
+        null,
+        -1,
+        0,
+        0,
+        0,
+        0,
+        JxlRawLayout.RGBA_8888,
+        false
+    )
+
+    /**
+     * @param byteBuffer must be a direct byte buffer
+     * @param stride bytes between starts of consecutive rows
+     */
+    constructor(
+        byteBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        stride: Int,
+        layout: JxlRawLayout,
+        premultiplied: Boolean = false,
+    ) : this(null, byteBuffer, -1, 0, width, height, stride, layout, premultiplied)
+
+    /**
+     * Rows are read from the descriptor starting at [offset], the descriptor is not closed by the encoder
+     */
+    constructor(
+        fileDescriptor: ParcelFileDescriptor,
+        offset: Long,
+        width: Int,
+        height: Int,
+        stride: Int,
+        layout: JxlRawLayout,
+        premultiplied: Boolean = false,
+    ) : this(null, null, fileDescriptor.fd, offset, width, height, stride, layout, premultiplied)
+}
@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import androidx.annotation.IntRange
+
+/**
+ * Input tensor of a model that [JxlCoder.decodeTensor] writes into.
+ * Float samples are in 0...1 before the normalization (value - mean) / std is applied per channel.
+ * @param channels 1 for BT.709 luma, 3 for RGB, 4 for RGBA
+ * @param mean per channel mean, e.g. 0.485, 0.456, 0.406 for ImageNet models
+ * @param std per channel standard deviation, e.g. 0.229, 0.224, 0.225 for ImageNet models
+ */
+class JxlTensorSpec(
+    val width: Int,
+    val height: Int,
+    @IntRange(from = 1, to = 4) val channels: Int = 3,
+    val layout: JxlTensorLayout = JxlTensorLayout.NHWC,
+    val sampleType: JxlTensorSampleType = JxlTensorSampleType.FLOAT_32,
+    val mean: FloatArray? = null,
+    val std: FloatArray? = null,
+) {
+    /**
+     * Bytes of the tensor in the output buffer
+     */
+    val byteCount: Int
+        get() = width * height * channels * sampleType.size
+}
@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.os.Build
+import androidx.annotation.Keep
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.File
+import java.io.IOException
+
+/**
+ * Encode throughput of this device per compression option and effort,
+ * used by [JxlCoder.encodeWithTimeBudget] to pick the effort fitting a time budget.
+ * Starts from estimates of a mid-range phone and is calibrated by every finished encode of the process,
+ * set [storage] once at startup to keep the calibration between launches.
+ */
+@Keep
+object JxlThroughputModel {
+
+    init {
+        if (Build.VERSION.SDK_INT >= 21) {
+            System.loadLibrary("jxlcoder")
+        }
+    }
+
+    /**
+     * File the calibration is restored from when set, it's saved there after each time budgeted encode
+     */
+    @Volatile
+    var storage: File? = null
+        set(value) {
+            field = value
+            if (value != null) {
+                load(value)
+            }
+        }
+
+    /**
+     * Predicted time in milliseconds libjxl takes to encode an image of the size on this device
+     */
+    fun predictMillis(
+        width: Int,
+        height: Int,
+        effort: JxlEffort,
+        compressionOption: JxlCompressionOption = JxlCompressionOption.LOSSY,
+    ): Float {
+        return predictMillisImpl(compressionOption.cValue, effort.value, width.toLong() * height)
+    }
+
+    fun exportState(): FloatArray {
+        return exportStateImpl()
+    }
+
+    /**
+     * @return false when the state was saved by an incompatible version, the model is not changed then
+     */
+    fun importState(state: FloatArray): Boolean {
+        return importStateImpl(state)
+    }
+
+    /**
+     * Drops the calibration and returns to the built-in estimates
+     */
+    fun reset() {
+        resetImpl()
+    }
+
+    /**
+     * @return false when the file is missing, unreadable or incompatible
+     */
+    fun load(file: File): Boolean {
+        return try {
+            DataInputStream(file.inputStream().buffered()).use { input ->
+                val state = FloatArray(input.readInt())
+                for (i in state.indices) {
+                    state[i] = input.readFloat()
+                }
+                importState(state)
+            }
+        } catch (e: IOException) {
+            false
+        }
+    }
+
+    @Throws(IOException::class)
+    fun save(file: File) {
+        val state = exportState()
+        val temporary = File(file.path + ".tmp")
+        DataOutputStream(temporary.outputStream().buffered()).use { output ->
+            output.writeInt(state.size)
+            state.forEach { output.writeFloat(it) }
+        }
+        if (!temporary.renameTo(file)) {
+            temporary.delete()
+            throw IOException("Can't replace $file")
+        }
+    }
+
+    internal fun persist() {
+        val file = storage ?: return
+        try {
+            save(file)
+        } catch (e: IOException) {
+            // The encoded image is still valid, the calibration is saved again on the next encode
+        }
+    }
+
+    private external fun predictMillisImpl(compressionOption: Int, effort: Int, pixels: Long): Float
+
+    private external fun exportStateImpl(): FloatArray
+
+    private external fun importStateImpl(state: FloatArray): Boolean
+
+    private external fun resetImpl()
+}
@@ -0,0 +1,48 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+/**
+ * @param data encoded image
+ * @param effort effort the image was encoded with
+ * @param decodingSpeed decoding speed tier the image was encoded with
+ * @param fellBack true when the planned effort risked missing the deadline and was replaced by the lowest one
+ * @param predictedEncodeMillis time libjxl was predicted to take at the planned effort
+ * @param encodeMillis time libjxl has taken, including the abandoned attempt when the encoder has fallen back
+ * @param totalMillis whole time of the call including the bitmap conversion
+ */
+class JxlTimeBudgetResult(
+    val data: ByteArray,
+    val effort: JxlEffort,
+    val decodingSpeed: JxlDecodingSpeed,
+    val fellBack: Boolean,
+    val predictedEncodeMillis: Float,
+    val encodeMillis: Float,
+    val totalMillis: Float,
+)
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.graphics.ImageFormat
+import android.media.Image
+import java.nio.ByteBuffer
+
+/**
+ * 4:2:0 camera frame for [JxlCoder.encode], planes are converted to RGB by rectangles
+ * while the encoder asks for them, so an RGBA copy of the frame is never allocated.
+ * Planes must be direct byte buffers and stay untouched until the encoding returns.
+ * @param uvPixelStride bytes between chroma samples of a row, 1 for planar and 2 for interleaved chroma
+ */
+class JxlYuvSource(
+    val yPlane: ByteBuffer,
+    val uPlane: ByteBuffer,
+    val vPlane: ByteBuffer,
+    val width: Int,
+    val height: Int,
+    val yRowStride: Int,
+    val uvRowStride: Int,
+    val uvPixelStride: Int,
+    val matrix: JxlYuvMatrix = JxlYuvMatrix.BT601,
+    val range: JxlYuvRange = JxlYuvRange.FULL,
+) {
+
+    companion object {
+
+        /**
+         * Planes of a [ImageFormat.YUV_420_888] image, e.g. from CameraX or ImageReader,
+         * the image must stay open until the encoding returns
+         */
+        fun fromImage(
+            image: Image,
+            matrix: JxlYuvMatrix = JxlYuvMatrix.BT601,
+            range: JxlYuvRange = JxlYuvRange.FULL,
+        ): JxlYuvSource {
+            if (image.format != ImageFormat.YUV_420_888) {
+                throw IllegalArgumentException("Only YUV_420_888 images are supported")
+            }
+            val planes = image.planes
+            if (planes[1].rowStride != planes[2].rowStride || planes[1].pixelStride != planes[2].pixelStride) {
+                throw IllegalArgumentException("Chroma planes must share their strides")
+            }
+            return JxlYuvSource(
+                planes[0].buffer,
+                planes[1].buffer,
+                planes[2].buffer,
+                image.width,
+                image.height,
+                planes[0].rowStride,
+                planes[1].rowStride,
+                planes[1].pixelStride,
+                matrix,
+                range,
+            )
+        }
+
+        /**
+         * NV21 frame of the legacy camera API: luma followed by interleaved V and U samples
+         * @param buffer direct byte buffer holding the frame from its start
+         */
+        fun fromNv21(
+            buffer: ByteBuffer,
+            width: Int,
+            height: Int,
+            matrix: JxlYuvMatrix = JxlYuvMatrix.BT601,
+            range: JxlYuvRange = JxlYuvRange.FULL,
+        ): JxlYuvSource {
+            val lumaSize = width * height
+            val chromaRowStride = (width + 1) / 2 * 2
+            return JxlYuvSource(
+                buffer.region(0, lumaSize),
+                buffer.region(lumaSize + 1, buffer.capacity() - lumaSize - 1),
+                buffer.region(lumaSize, buffer.capacity() - lumaSize),
+                width,
+                height,
+                width,
+                chromaRowStride,
+                2,
+                matrix,
+                range,
+            )
+        }
+
+        private fun ByteBuffer.region(offset: Int, length: Int): ByteBuffer {
+            val duplicate = duplicate()
+            duplicate.clear()
+            duplicate.position(offset)
+            duplicate.limit(offset + length)
+            return duplicate.slice()
+        }
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Radzivon Bartoshyk
+ * jxl-coder [https://github.com/awxkee/jxl-coder]
+ *
+ * Created by Radzivon Bartoshyk on 19/10/2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+package com.awxkee.jxlcoder
+
+import android.graphics.ImageFormat
+import android.media.Image
+import java.nio.ByteBuffer
+
+/**
+ * Caller owned 4:2:0 planes for [JxlCoder.decodeYuv], e.g. a MediaCodec input buffer.
+ * Planes must be direct byte buffers, chroma is subsampled with a filter and sited as H.264 and HEVC expect.
+ * @param uvPixelStride bytes between chroma samples of a row, 1 for I420 and 2 for NV12
+ */
+class JxlYuvTarget(
+    val yPlane: ByteBuffer,
+    val uPlane: ByteBuffer,
+    val vPlane: ByteBuffer,
+    val width: Int,
+    val height: Int,
+    val yRowStride: Int,
+    val uvRowStride: Int,
+    val uvPixelStride: Int,
+    val matrix: JxlYuvMatrix = JxlYuvMatrix.BT709,
+    val range: JxlYuvRange = JxlYuvRange.LIMITED,
+) {
+
+    companion object {
+
+        /**
+         * Bytes of a tightly packed I420 or NV12 frame
+         */
+        fun frameSize(width: Int, height: Int): Int {
+            return width * height + (width + 1) / 2 * ((height + 1) / 2) * 2
+        }
+
+        /**
+         * I420 frame: luma, then U and then V planes, packed from the position of [buffer]
+         */
+        fun i420(
+            buffer: ByteBuffer,
+            width: Int,
+            height: Int,
+            matrix: JxlYuvMatrix = JxlYuvMatrix.BT709,
+            range: JxlYuvRange = JxlYuvRange.LIMITED,
+        ): JxlYuvTarget {
+            val start = buffer.position()
+            val lumaSize = width * height
+            val chromaWidth = (width + 1) / 2
+            val chromaSize = chromaWidth * ((height + 1) / 2)
+            return JxlYuvTarget(
+                buffer.region(start, lumaSize),
+                buffer.region(start + lumaSize, chromaSize),
+                buffer.region(start + lumaSize + chromaSize, chromaSize),
+                width,
+                height,
+                width,
+                chromaWidth,
+                1,
+                matrix,
+                range,
+            )
+        }
+
+        /**
+         * NV12 frame: luma followed by interleaved U and V samples, packed from the position of [buffer]
+         */
+        fun nv12(
+            buffer: ByteBuffer,
+            width: Int,
+            height: Int,
+            matrix: JxlYuvMatrix = JxlYuvMatrix.BT709,
+            range: JxlYuvRange = JxlYuvRange.LIMITED,
+        ): JxlYuvTarget {
+            val start = buffer.position()
+            val lumaSize = width * height
+            val chromaRowStride = (width + 1) / 2 * 2
+            val chromaSize = chromaRowStride * ((height + 1) / 2)
+            return JxlYuvTarget(
+                buffer.region(start, lumaSize),
+                buffer.region(start + lumaSize, chromaSize),
+                buffer.region(start + lumaSize + 1, chromaSize - 1),
+                width,
+                height,
+                width,
+                chromaRowStride,
+                2,
+                matrix,
+                range,
+            )
+        }
+
+        /**
+         * Writable [ImageFormat.YUV_420_888] image, e.g. from MediaCodec.getInputImage or ImageWriter
+         */
+        fun fromImage(
+            image: Image,
+            matrix: JxlYuvMatrix = JxlYuvMatrix.BT709,
+            range: JxlYuvRange = JxlYuvRange.LIMITED,
+        ): JxlYuvTarget {
+            if (image.format != ImageFormat.YUV_420_888) {
+                throw IllegalArgumentException("Only YUV_420_888 images are supported")
+            }
+            val planes = image.planes
+            if (planes[1].rowStride != planes[2].rowStride || planes[1].pixelStride != planes[2].pixelStride) {
+                throw IllegalArgumentException("Chroma planes must share their strides")
+            }
+            return JxlYuvTarget(
+                planes[0].buffer,
+                planes[1].buffer,
+                planes[2].buffer,
+                image.width,
+                image.height,
+                planes[0].rowStride,
+                planes[1].rowStride,
+                planes[1].pixelStride,
+                matrix,
+                range,
+            )
+        }
+
+        private fun ByteBuffer.region(offset: Int, length: Int): ByteBuffer {
+            val duplicate = duplicate()
+            duplicate.clear()
+            duplicate.position(offset)
+            duplicate.limit(offset + length)
+            return duplicate.slice()
+        }
+    }
+}